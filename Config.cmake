@@ -31,6 +31,7 @@ option(MAUENG_ENABLE_DEBUG_RENDERING "Enable debug rendering" ON)
 option(MAUENG_LOG_TO_FILE "Log to file" OFF)
 option(MAUENG_ENABLE_ASSERTS "Enable asserts" ON)
 option(MAUENG_USE_IMGUI "Load & use IMGUI" OFF)
+option(MAUENG_ENABLE_SHADER_HOT_RELOAD "Recompile & reload shaders when their source changes" ON)
 
 option(MAUENG_ENABLE_PROFILER "Enable profiling" ON)
 option(MAUENG_USE_OPTICK "Use Optick instead of custom profiler" ON)
@@ -45,6 +46,7 @@ if(MAUENG_DISTRIBUTION)
     set(MAUENG_LOG_TO_FILE ON CACHE BOOL "Log to file" FORCE)
     set(MAUENG_ENABLE_ASSERTS OFF CACHE BOOL "Enable asserts" FORCE)
     set(MAUENG_USE_IMGUI OFF CACHE BOOL "Load & use IMGUI" FORCE)
+    set(MAUENG_ENABLE_SHADER_HOT_RELOAD OFF CACHE BOOL "Recompile & reload shaders when their source changes" FORCE)
     set(MAUENG_ENABLE_PROFILER OFF CACHE BOOL "Enable profiling" FORCE)
     set(MAUENG_USE_OPTICK OFF CACHE BOOL "Use Optick instead of custom profiler" FORCE)
 endif()
@@ -58,7 +60,8 @@ message(STATUS "Debug config: ")
 message(STATUS "MAUENG_ENABLE_DEBUG_RENDERING: ${MAUENG_ENABLE_DEBUG_RENDERING}")
 message(STATUS "MAUENG_LOG_TO_FILE: ${MAUENG_LOG_TO_FILE}")
 message(STATUS "MAUENG_ENABLE_ASSERTS: ${MAUENG_ENABLE_ASSERTS}")
-message(STATUS "MAUENG_USE_IMGUI: ${MAUENG_USE_IMGUI} \n")
+message(STATUS "MAUENG_USE_IMGUI: ${MAUENG_USE_IMGUI}")
+message(STATUS "MAUENG_ENABLE_SHADER_HOT_RELOAD: ${MAUENG_ENABLE_SHADER_HOT_RELOAD} \n")
 
 message(STATUS "Profiling config: ")
 message(STATUS "MAUENG_ENABLE_PROFILER: ${MAUENG_ENABLE_PROFILER}")
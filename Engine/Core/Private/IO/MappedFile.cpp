@@ -0,0 +1,112 @@
+#include "IO/MappedFile.h"
+
+#if defined(_WIN32)
+	#ifndef WIN32_LEAN_AND_MEAN
+		#define WIN32_LEAN_AND_MEAN
+	#endif
+	#ifndef NOMINMAX
+		#define NOMINMAX
+	#endif
+	#include <Windows.h>
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+namespace MauCor
+{
+	MappedFile::~MappedFile()
+	{
+		Close();
+	}
+
+	bool MappedFile::Open(char const* path) noexcept
+	{
+		Close();
+
+#if defined(_WIN32)
+		HANDLE const file{ CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr) };
+		if (file == INVALID_HANDLE_VALUE)
+		{
+			return false;
+		}
+
+		LARGE_INTEGER size{};
+		if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+		{
+			CloseHandle(file);
+			return false;
+		}
+
+		HANDLE const mapping{ CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr) };
+		if (!mapping)
+		{
+			CloseHandle(file);
+			return false;
+		}
+
+		void const* pView{ MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) };
+		if (!pView)
+		{
+			CloseHandle(mapping);
+			CloseHandle(file);
+			return false;
+		}
+
+		m_File = file;
+		m_Mapping = mapping;
+		m_pData = static_cast<std::byte const*>(pView);
+		m_Size = static_cast<std::size_t>(size.QuadPart);
+#else
+		int const file{ open(path, O_RDONLY) };
+		if (file < 0)
+		{
+			return false;
+		}
+
+		struct stat info{};
+		if (fstat(file, &info) != 0 || info.st_size == 0)
+		{
+			close(file);
+			return false;
+		}
+
+		void* pView{ mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_PRIVATE, file, 0) };
+		// The mapping keeps the file alive
+		close(file);
+		if (pView == MAP_FAILED)
+		{
+			return false;
+		}
+
+		m_pData = static_cast<std::byte const*>(pView);
+		m_Size = static_cast<std::size_t>(info.st_size);
+#endif
+
+		return true;
+	}
+
+	void MappedFile::Close() noexcept
+	{
+		if (!m_pData)
+		{
+			return;
+		}
+
+#if defined(_WIN32)
+		UnmapViewOfFile(m_pData);
+		CloseHandle(m_Mapping);
+		CloseHandle(m_File);
+
+		m_Mapping = nullptr;
+		m_File = nullptr;
+#else
+		munmap(const_cast<std::byte*>(m_pData), m_Size);
+#endif
+
+		m_pData = nullptr;
+		m_Size = 0;
+	}
+}
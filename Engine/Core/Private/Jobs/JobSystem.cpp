@@ -0,0 +1,182 @@
+#include "Jobs/JobSystem.h"
+
+#include "CoreServiceLocator.h"
+
+namespace MauCor
+{
+	namespace
+	{
+		// Queue owned by the calling thread, 0 for any thread that is not a worker
+		thread_local uint32_t t_QueueIdx{ 0 };
+	}
+
+	JobSystem::JobSystem()
+	{
+		// Leave one hardware thread for the main thread, it helps out whenever it waits on jobs
+		uint32_t const hardwareThreads{ std::max(std::thread::hardware_concurrency(), 1u) };
+		uint32_t const numWorkers{ hardwareThreads - 1 };
+
+		m_NumQueues = numWorkers + 1;
+		m_Queues = std::make_unique<WorkQueue[]>(m_NumQueues);
+
+		m_Workers.reserve(numWorkers);
+		for (uint32_t i{ 0 }; i < numWorkers; ++i)
+		{
+			m_Workers.emplace_back([this, i]() { WorkerLoop(i + 1); });
+		}
+	}
+
+	JobSystem::~JobSystem()
+	{
+		{
+			std::scoped_lock const lock{ m_SleepMutex };
+			m_IsRunning.store(false, std::memory_order_release);
+		}
+		m_WakeCondition.notify_all();
+
+		for (auto& w : m_Workers)
+		{
+			if (w.joinable())
+			{
+				w.join();
+			}
+		}
+	}
+
+	void JobSystem::Schedule(Job&& job, JobCounter* pCounter) noexcept
+	{
+		if (pCounter)
+		{
+			pCounter->m_Count.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		// No workers, just execute it immediately
+		if (m_Workers.empty())
+		{
+			job();
+			if (pCounter)
+			{
+				pCounter->m_Count.fetch_sub(1, std::memory_order_release);
+			}
+			return;
+		}
+
+		// Count the job before it is visible, so a thief can never decrement below zero
+		m_NumQueuedJobs.fetch_add(1, std::memory_order_release);
+
+		auto& queue{ m_Queues[GetQueueIndexForThisThread()] };
+		{
+			std::scoped_lock const lock{ queue.mutex };
+			queue.jobs.emplace_back(std::move(job), pCounter);
+		}
+
+		{
+			// Taking the lock prevents a worker from missing the wake up between checking its predicate & going to sleep
+			std::scoped_lock const lock{ m_SleepMutex };
+		}
+		m_WakeCondition.notify_one();
+	}
+
+	void JobSystem::Wait(JobCounter const& counter) noexcept
+	{
+		ME_PROFILE_FUNCTION()
+
+		uint32_t const queueIdx{ GetQueueIndexForThisThread() };
+		while (not counter.IsDone())
+		{
+			if (not TryExecuteJob(queueIdx))
+			{
+				std::this_thread::yield();
+			}
+		}
+	}
+
+	bool JobSystem::IsWorkerThread() const noexcept
+	{
+		return GetQueueIndexForThisThread() != 0;
+	}
+
+	void JobSystem::WorkerLoop(uint32_t queueIdx) noexcept
+	{
+		ME_PROFILE_THREAD("Job Worker")
+
+		t_QueueIdx = queueIdx;
+
+		while (m_IsRunning.load(std::memory_order_acquire))
+		{
+			if (TryExecuteJob(queueIdx))
+			{
+				continue;
+			}
+
+			std::unique_lock lock{ m_SleepMutex };
+			m_WakeCondition.wait(lock, [this]()
+				{
+					return m_NumQueuedJobs.load(std::memory_order_acquire) > 0 or not m_IsRunning.load(std::memory_order_acquire);
+				});
+		}
+	}
+
+	bool JobSystem::TryExecuteJob(uint32_t queueIdx) noexcept
+	{
+		QueuedJob job{};
+		if (not TryPop(queueIdx, job) and not TrySteal(queueIdx, job))
+		{
+			return false;
+		}
+
+		m_NumQueuedJobs.fetch_sub(1, std::memory_order_acq_rel);
+
+		job.job();
+
+		if (job.pCounter)
+		{
+			job.pCounter->m_Count.fetch_sub(1, std::memory_order_release);
+		}
+
+		return true;
+	}
+
+	bool JobSystem::TryPop(uint32_t queueIdx, QueuedJob& outJob) noexcept
+	{
+		auto& queue{ m_Queues[queueIdx] };
+
+		std::scoped_lock const lock{ queue.mutex };
+		if (queue.jobs.empty())
+		{
+			return false;
+		}
+
+		// Newest job first, its data is most likely still in cache
+		outJob = std::move(queue.jobs.back());
+		queue.jobs.pop_back();
+		return true;
+	}
+
+	bool JobSystem::TrySteal(uint32_t thiefIdx, QueuedJob& outJob) noexcept
+	{
+		for (uint32_t i{ 1 }; i < m_NumQueues; ++i)
+		{
+			auto& queue{ m_Queues[(thiefIdx + i) % m_NumQueues] };
+
+			// Don't block on a contended queue, just try the next victim
+			std::unique_lock const lock{ queue.mutex, std::try_to_lock };
+			if (not lock.owns_lock() or queue.jobs.empty())
+			{
+				continue;
+			}
+
+			// Oldest job, usually the largest chunk of remaining work
+			outJob = std::move(queue.jobs.front());
+			queue.jobs.pop_front();
+			return true;
+		}
+
+		return false;
+	}
+
+	uint32_t JobSystem::GetQueueIndexForThisThread() const noexcept
+	{
+		return t_QueueIdx;
+	}
+}
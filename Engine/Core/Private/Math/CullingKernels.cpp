@@ -0,0 +1,162 @@
+#include "Math/CullingKernels.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+#include "Math/SIMD.h"
+
+namespace MauCor
+{
+	namespace
+	{
+		// Reference path, also handles the tail that does not fill a SIMD register
+		std::size_t CullScalar(Frustum const& frustum, AABBStreams const& s, uint32_t* pOut, std::size_t begin, std::size_t end) noexcept
+		{
+			std::size_t count{ 0 };
+			for (std::size_t i{ begin }; i < end; ++i)
+			{
+				bool isVisible{ true };
+				for (auto const& plane : frustum.planes)
+				{
+					// Distance of the center to the plane, plus the box's projected half size onto the plane normal
+					float const distance{ plane.x * s.pCenterX[i] + plane.y * s.pCenterY[i] + plane.z * s.pCenterZ[i] + plane.w };
+					float const radius{ std::abs(plane.x) * s.pExtentX[i] + std::abs(plane.y) * s.pExtentY[i] + std::abs(plane.z) * s.pExtentZ[i] };
+
+					if (distance + radius < 0.f)
+					{
+						isVisible = false;
+						break;
+					}
+				}
+
+				if (isVisible)
+				{
+					pOut[count++] = static_cast<uint32_t>(i);
+				}
+			}
+
+			return count;
+		}
+
+		// Writes the index of every set bit of the mask, lowest first
+		inline std::size_t WriteVisible(uint32_t mask, std::size_t first, uint32_t* pOut) noexcept
+		{
+			std::size_t count{ 0 };
+			while (mask != 0)
+			{
+				pOut[count++] = static_cast<uint32_t>(first + std::countr_zero(mask));
+				mask &= mask - 1;
+			}
+			return count;
+		}
+
+#ifdef MAUCOR_X86_SIMD
+		// 4 boxes per iteration, every register holds one component of 4 boxes
+		std::size_t CullSSE(Frustum const& frustum, AABBStreams const& s, uint32_t* pOut, std::size_t& i, std::size_t end) noexcept
+		{
+			__m128 const zero{ _mm_setzero_ps() };
+
+			std::size_t count{ 0 };
+			for (; i + 4 <= end; i += 4)
+			{
+				__m128 const cx{ _mm_loadu_ps(s.pCenterX + i) };
+				__m128 const cy{ _mm_loadu_ps(s.pCenterY + i) };
+				__m128 const cz{ _mm_loadu_ps(s.pCenterZ + i) };
+				__m128 const ex{ _mm_loadu_ps(s.pExtentX + i) };
+				__m128 const ey{ _mm_loadu_ps(s.pExtentY + i) };
+				__m128 const ez{ _mm_loadu_ps(s.pExtentZ + i) };
+
+				int mask{ 0xF };
+				for (auto const& plane : frustum.planes)
+				{
+					__m128 distance{ _mm_set1_ps(plane.w) };
+					distance = _mm_add_ps(distance, _mm_mul_ps(_mm_set1_ps(plane.x), cx));
+					distance = _mm_add_ps(distance, _mm_mul_ps(_mm_set1_ps(plane.y), cy));
+					distance = _mm_add_ps(distance, _mm_mul_ps(_mm_set1_ps(plane.z), cz));
+
+					distance = _mm_add_ps(distance, _mm_mul_ps(_mm_set1_ps(std::abs(plane.x)), ex));
+					distance = _mm_add_ps(distance, _mm_mul_ps(_mm_set1_ps(std::abs(plane.y)), ey));
+					distance = _mm_add_ps(distance, _mm_mul_ps(_mm_set1_ps(std::abs(plane.z)), ez));
+
+					mask &= _mm_movemask_ps(_mm_cmpge_ps(distance, zero));
+					// All 4 outside, no need to test the other planes
+					if (mask == 0)
+					{
+						break;
+					}
+				}
+
+				count += WriteVisible(static_cast<uint32_t>(mask), i, pOut + count);
+			}
+
+			return count;
+		}
+
+		// 8 boxes per iteration, same approach as the SSE path
+		MAUCOR_TARGET_AVX2 std::size_t CullAVX2(Frustum const& frustum, AABBStreams const& s, uint32_t* pOut, std::size_t& i, std::size_t end) noexcept
+		{
+			__m256 const zero{ _mm256_setzero_ps() };
+
+			std::size_t count{ 0 };
+			for (; i + 8 <= end; i += 8)
+			{
+				__m256 const cx{ _mm256_loadu_ps(s.pCenterX + i) };
+				__m256 const cy{ _mm256_loadu_ps(s.pCenterY + i) };
+				__m256 const cz{ _mm256_loadu_ps(s.pCenterZ + i) };
+				__m256 const ex{ _mm256_loadu_ps(s.pExtentX + i) };
+				__m256 const ey{ _mm256_loadu_ps(s.pExtentY + i) };
+				__m256 const ez{ _mm256_loadu_ps(s.pExtentZ + i) };
+
+				int mask{ 0xFF };
+				for (auto const& plane : frustum.planes)
+				{
+					__m256 distance{ _mm256_set1_ps(plane.w) };
+					distance = _mm256_fmadd_ps(_mm256_set1_ps(plane.x), cx, distance);
+					distance = _mm256_fmadd_ps(_mm256_set1_ps(plane.y), cy, distance);
+					distance = _mm256_fmadd_ps(_mm256_set1_ps(plane.z), cz, distance);
+
+					distance = _mm256_fmadd_ps(_mm256_set1_ps(std::abs(plane.x)), ex, distance);
+					distance = _mm256_fmadd_ps(_mm256_set1_ps(std::abs(plane.y)), ey, distance);
+					distance = _mm256_fmadd_ps(_mm256_set1_ps(std::abs(plane.z)), ez, distance);
+
+					mask &= _mm256_movemask_ps(_mm256_cmp_ps(distance, zero, _CMP_GE_OQ));
+					if (mask == 0)
+					{
+						break;
+					}
+				}
+
+				count += WriteVisible(static_cast<uint32_t>(mask), i, pOut + count);
+			}
+
+			return count;
+		}
+#endif
+	}
+
+	std::size_t CullAABBs(Frustum const& frustum, AABBStreams const& streams, uint32_t* pOutVisible, std::size_t begin, std::size_t end, ESIMDLevel level) noexcept
+	{
+		// Never run a path the CPU does not support
+		level = std::min(level, GetSupportedSIMDLevel());
+
+		std::size_t i{ begin };
+		std::size_t count{ 0 };
+#ifdef MAUCOR_X86_SIMD
+		switch (level)
+		{
+		case ESIMDLevel::AVX2:
+			count += CullAVX2(frustum, streams, pOutVisible + count, i, end);
+			[[fallthrough]];
+		case ESIMDLevel::SSE:
+			count += CullSSE(frustum, streams, pOutVisible + count, i, end);
+			break;
+		default:
+			break;
+		}
+#endif
+		count += CullScalar(frustum, streams, pOutVisible + count, i, end);
+
+		return count;
+	}
+}
@@ -0,0 +1,286 @@
+#include "Math/DynamicBVH.h"
+
+namespace MauCor
+{
+	DynamicBVH::DynamicBVH(float minMargin, float relativeMargin) noexcept :
+		m_MinMargin{ minMargin },
+		m_RelativeMargin{ relativeMargin }
+	{
+	}
+
+	int32_t DynamicBVH::CreateProxy(AABB const& aabb, uint32_t userData)
+	{
+		ME_CORE_ASSERT(aabb.IsValid());
+
+		int32_t const proxyID{ AllocateNode() };
+
+		Node& leaf{ m_Nodes[proxyID] };
+		leaf.aabb = Fatten(aabb);
+		leaf.userData = userData;
+		leaf.height = 0;
+
+		InsertLeaf(proxyID);
+		++m_ProxyCount;
+
+		return proxyID;
+	}
+
+	void DynamicBVH::DestroyProxy(int32_t proxyID) noexcept
+	{
+		ME_CORE_ASSERT(proxyID >= 0 && proxyID < static_cast<int32_t>(m_Nodes.size()));
+		ME_CORE_ASSERT(m_Nodes[proxyID].IsLeaf());
+
+		RemoveLeaf(proxyID);
+		FreeNode(proxyID);
+		--m_ProxyCount;
+	}
+
+	bool DynamicBVH::MoveProxy(int32_t proxyID, AABB const& aabb)
+	{
+		ME_CORE_ASSERT(proxyID >= 0 && proxyID < static_cast<int32_t>(m_Nodes.size()));
+		ME_CORE_ASSERT(m_Nodes[proxyID].IsLeaf());
+
+		// Most moves stay inside the fattened box
+		if (m_Nodes[proxyID].aabb.Contains(aabb))
+		{
+			return false;
+		}
+
+		RemoveLeaf(proxyID);
+		m_Nodes[proxyID].aabb = Fatten(aabb);
+		InsertLeaf(proxyID);
+
+		return true;
+	}
+
+	void DynamicBVH::Clear() noexcept
+	{
+		m_Nodes.clear();
+		m_Root = NULL_NODE;
+		m_FreeList = NULL_NODE;
+		m_ProxyCount = 0;
+	}
+
+	int32_t DynamicBVH::AllocateNode()
+	{
+		if (m_FreeList == NULL_NODE)
+		{
+			m_Nodes.emplace_back();
+			return static_cast<int32_t>(m_Nodes.size() - 1);
+		}
+
+		int32_t const nodeIdx{ m_FreeList };
+		m_FreeList = m_Nodes[nodeIdx].parent;
+		m_Nodes[nodeIdx] = Node{};
+		return nodeIdx;
+	}
+
+	void DynamicBVH::FreeNode(int32_t nodeIdx) noexcept
+	{
+		Node& node{ m_Nodes[nodeIdx] };
+		node.parent = m_FreeList;
+		node.left = NULL_NODE;
+		node.right = NULL_NODE;
+		node.height = -1;
+
+		m_FreeList = nodeIdx;
+	}
+
+	void DynamicBVH::InsertLeaf(int32_t leafIdx)
+	{
+		if (m_Root == NULL_NODE)
+		{
+			m_Root = leafIdx;
+			m_Nodes[leafIdx].parent = NULL_NODE;
+			return;
+		}
+
+		AABB const leafAABB{ m_Nodes[leafIdx].aabb };
+
+		// Find the best sibling, descend while a child is cheaper than pairing with the current node
+		int32_t siblingIdx{ m_Root };
+		while (!m_Nodes[siblingIdx].IsLeaf())
+		{
+			Node const& node{ m_Nodes[siblingIdx] };
+
+			float const area{ node.aabb.SurfaceArea() };
+			float const combinedArea{ AABB::Merge(node.aabb, leafAABB).SurfaceArea() };
+
+			// Cost of making a new parent for this node & the leaf
+			float const cost{ 2.f * combinedArea };
+			// Every ancestor grows when descending further
+			float const inheritanceCost{ 2.f * (combinedArea - area) };
+
+			auto const childCost{ [&](int32_t childIdx)
+				{
+					Node const& child{ m_Nodes[childIdx] };
+					float const mergedArea{ AABB::Merge(child.aabb, leafAABB).SurfaceArea() };
+					return child.IsLeaf() ? mergedArea + inheritanceCost : mergedArea - child.aabb.SurfaceArea() + inheritanceCost;
+				} };
+
+			float const leftCost{ childCost(node.left) };
+			float const rightCost{ childCost(node.right) };
+
+			if (cost < leftCost && cost < rightCost)
+			{
+				break;
+			}
+
+			siblingIdx = leftCost < rightCost ? node.left : node.right;
+		}
+
+		// The new parent takes the sibling's place
+		int32_t const oldParentIdx{ m_Nodes[siblingIdx].parent };
+		int32_t const newParentIdx{ AllocateNode() };
+
+		Node& newParent{ m_Nodes[newParentIdx] };
+		newParent.parent = oldParentIdx;
+		newParent.aabb = AABB::Merge(leafAABB, m_Nodes[siblingIdx].aabb);
+		newParent.height = m_Nodes[siblingIdx].height + 1;
+		newParent.left = siblingIdx;
+		newParent.right = leafIdx;
+
+		if (oldParentIdx != NULL_NODE)
+		{
+			Node& oldParent{ m_Nodes[oldParentIdx] };
+			(oldParent.left == siblingIdx ? oldParent.left : oldParent.right) = newParentIdx;
+		}
+		else
+		{
+			m_Root = newParentIdx;
+		}
+
+		m_Nodes[siblingIdx].parent = newParentIdx;
+		m_Nodes[leafIdx].parent = newParentIdx;
+
+		RefitAncestors(newParentIdx);
+	}
+
+	void DynamicBVH::RemoveLeaf(int32_t leafIdx) noexcept
+	{
+		if (leafIdx == m_Root)
+		{
+			m_Root = NULL_NODE;
+			return;
+		}
+
+		int32_t const parentIdx{ m_Nodes[leafIdx].parent };
+		Node const& parent{ m_Nodes[parentIdx] };
+		int32_t const grandParentIdx{ parent.parent };
+		int32_t const siblingIdx{ parent.left == leafIdx ? parent.right : parent.left };
+
+		// The sibling takes the parent's place
+		if (grandParentIdx != NULL_NODE)
+		{
+			Node& grandParent{ m_Nodes[grandParentIdx] };
+			(grandParent.left == parentIdx ? grandParent.left : grandParent.right) = siblingIdx;
+			m_Nodes[siblingIdx].parent = grandParentIdx;
+			FreeNode(parentIdx);
+
+			RefitAncestors(grandParentIdx);
+		}
+		else
+		{
+			m_Root = siblingIdx;
+			m_Nodes[siblingIdx].parent = NULL_NODE;
+			FreeNode(parentIdx);
+		}
+	}
+
+	void DynamicBVH::RefitAncestors(int32_t nodeIdx) noexcept
+	{
+		while (nodeIdx != NULL_NODE)
+		{
+			nodeIdx = Balance(nodeIdx);
+
+			Node& node{ m_Nodes[nodeIdx] };
+			Node const& left{ m_Nodes[node.left] };
+			Node const& right{ m_Nodes[node.right] };
+
+			node.height = 1 + std::max(left.height, right.height);
+			node.aabb = AABB::Merge(left.aabb, right.aabb);
+
+			nodeIdx = node.parent;
+		}
+	}
+
+	int32_t DynamicBVH::Balance(int32_t nodeIdx) noexcept
+	{
+		// A is the node, B & C its children
+		int32_t const aIdx{ nodeIdx };
+		Node& a{ m_Nodes[aIdx] };
+		if (a.IsLeaf() || a.height < 2)
+		{
+			return aIdx;
+		}
+
+		int32_t const bIdx{ a.left };
+		int32_t const cIdx{ a.right };
+		Node& b{ m_Nodes[bIdx] };
+		Node& c{ m_Nodes[cIdx] };
+
+		int32_t const balance{ c.height - b.height };
+
+		// Rotate the higher child up, it takes A's place & A takes over one of its children
+		auto const rotateUp{ [&](int32_t upIdx, Node& up, Node& other, bool upIsRight)
+			{
+				int32_t const fIdx{ up.left };
+				int32_t const gIdx{ up.right };
+				Node& f{ m_Nodes[fIdx] };
+				Node& g{ m_Nodes[gIdx] };
+
+				up.left = aIdx;
+				up.parent = a.parent;
+				a.parent = upIdx;
+
+				if (up.parent != NULL_NODE)
+				{
+					Node& upParent{ m_Nodes[up.parent] };
+					(upParent.left == aIdx ? upParent.left : upParent.right) = upIdx;
+				}
+				else
+				{
+					m_Root = upIdx;
+				}
+
+				// The higher grandchild stays with the rotated node, the other one moves to A
+				bool const keepF{ f.height > g.height };
+				int32_t const keptIdx{ keepF ? fIdx : gIdx };
+				int32_t const movedIdx{ keepF ? gIdx : fIdx };
+				Node& kept{ m_Nodes[keptIdx] };
+				Node& moved{ m_Nodes[movedIdx] };
+
+				up.right = keptIdx;
+				(upIsRight ? a.right : a.left) = movedIdx;
+				moved.parent = aIdx;
+
+				a.aabb = AABB::Merge(other.aabb, moved.aabb);
+				up.aabb = AABB::Merge(a.aabb, kept.aabb);
+
+				a.height = 1 + std::max(other.height, moved.height);
+				up.height = 1 + std::max(a.height, kept.height);
+			} };
+
+		if (balance > 1)
+		{
+			rotateUp(cIdx, c, b, true);
+			return cIdx;
+		}
+
+		if (balance < -1)
+		{
+			rotateUp(bIdx, b, c, false);
+			return bIdx;
+		}
+
+		return aIdx;
+	}
+
+	AABB DynamicBVH::Fatten(AABB const& aabb) const noexcept
+	{
+		glm::vec3 const extents{ aabb.Extents() };
+		float const largestExtent{ std::max({ extents.x, extents.y, extents.z }) };
+
+		return aabb.Fattened(std::max(m_MinMargin, largestExtent * m_RelativeMargin));
+	}
+}
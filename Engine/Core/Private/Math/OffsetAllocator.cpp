@@ -0,0 +1,324 @@
+#include "Math/OffsetAllocator.h"
+
+#include <algorithm>
+#include <bit>
+
+namespace MauCor
+{
+	namespace
+	{
+		// Sizes as a float with a 3 bit mantissa, the bin index
+		uint32_t constexpr MANTISSA_BITS{ 3 };
+		uint32_t constexpr MANTISSA_VALUE{ 1 << MANTISSA_BITS };
+		uint32_t constexpr MANTISSA_MASK{ MANTISSA_VALUE - 1 };
+
+		// Allocations search from the bin that only holds ranges that are large enough
+		[[nodiscard]] uint32_t SizeToBinRoundUp(uint32_t size) noexcept
+		{
+			if (size < MANTISSA_VALUE)
+			{
+				return size;
+			}
+
+			uint32_t const mantissaStartBit{ static_cast<uint32_t>(std::bit_width(size)) - 1 - MANTISSA_BITS };
+			uint32_t const exponent{ mantissaStartBit + 1 };
+			uint32_t mantissa{ (size >> mantissaStartBit) & MANTISSA_MASK };
+
+			if ((size & ((1u << mantissaStartBit) - 1)) != 0)
+			{
+				// Overflowing into the exponent is fine, that is the next bin
+				++mantissa;
+			}
+
+			return (exponent << MANTISSA_BITS) + mantissa;
+		}
+
+		// Free ranges go in the bin of the largest size they can hold
+		[[nodiscard]] uint32_t SizeToBinRoundDown(uint32_t size) noexcept
+		{
+			if (size < MANTISSA_VALUE)
+			{
+				return size;
+			}
+
+			uint32_t const mantissaStartBit{ static_cast<uint32_t>(std::bit_width(size)) - 1 - MANTISSA_BITS };
+			uint32_t const exponent{ mantissaStartBit + 1 };
+			uint32_t const mantissa{ (size >> mantissaStartBit) & MANTISSA_MASK };
+
+			return (exponent << MANTISSA_BITS) | mantissa;
+		}
+
+		// Lowest set bit at or above startBit, UINT32_MAX when there is none
+		[[nodiscard]] uint32_t FindLowestSetBitAfter(uint32_t mask, uint32_t startBit) noexcept
+		{
+			uint32_t const maskAfter{ startBit < 32 ? mask & ~((1u << startBit) - 1) : 0u };
+			return maskAfter != 0 ? static_cast<uint32_t>(std::countr_zero(maskAfter)) : UINT32_MAX;
+		}
+	}
+
+	OffsetAllocator::OffsetAllocator(uint32_t size, uint32_t maxAllocations) :
+		m_Size{ size },
+		m_MaxAllocations{ maxAllocations }
+	{
+		Reset();
+	}
+
+	OffsetAllocator::Allocation OffsetAllocator::Allocate(uint32_t size) noexcept
+	{
+		// A split needs a node for the remainder
+		if (size == 0 || m_FreeNodes.empty())
+		{
+			return {};
+		}
+
+		uint32_t const minBin{ SizeToBinRoundUp(size) };
+		uint32_t const minTop{ minBin / BINS_PER_LEAF };
+		uint32_t const minLeaf{ minBin % BINS_PER_LEAF };
+
+		uint32_t nodeIdx{ UNUSED };
+		uint32_t top{ minTop };
+		uint32_t leaf{ UINT32_MAX };
+
+		// Larger leaf bin of the same top bin first
+		if (minTop < TOP_BIN_COUNT && (m_UsedBinsTop & (1u << minTop)))
+		{
+			leaf = FindLowestSetBitAfter(m_UsedBins[top], minLeaf);
+		}
+
+		// Otherwise any leaf of a larger top bin
+		if (leaf == UINT32_MAX)
+		{
+			top = FindLowestSetBitAfter(m_UsedBinsTop, minTop + 1);
+			if (top != UINT32_MAX)
+			{
+				leaf = static_cast<uint32_t>(std::countr_zero(static_cast<uint32_t>(m_UsedBins[top])));
+			}
+		}
+
+		if (leaf != UINT32_MAX)
+		{
+			// Everything in the bin fits, take the head
+			nodeIdx = m_BinHeads[top * BINS_PER_LEAF + leaf];
+		}
+		else
+		{
+			// The bin the size falls in can still hold a range that is large enough, only searched when nothing else fits
+			for (uint32_t idx{ m_BinHeads[SizeToBinRoundDown(size)] }; idx != UNUSED; idx = m_Nodes[idx].binNext)
+			{
+				if (m_Nodes[idx].size >= size)
+				{
+					nodeIdx = idx;
+					break;
+				}
+			}
+
+			if (nodeIdx == UNUSED)
+			{
+				return {};
+			}
+		}
+
+		uint32_t const nodeTotalSize{ m_Nodes[nodeIdx].size };
+		UnlinkFromBin(nodeIdx);
+
+		m_Nodes[nodeIdx].size = size;
+		m_Nodes[nodeIdx].isUsed = true;
+
+		// The rest goes back as a free range right after the allocation
+		if (uint32_t const remainder{ nodeTotalSize - size }; remainder > 0)
+		{
+			uint32_t const newNodeIdx{ InsertNodeIntoBin(remainder, m_Nodes[nodeIdx].offset + size) };
+			Node& allocated{ m_Nodes[nodeIdx] };
+
+			if (allocated.neighbourNext != UNUSED)
+			{
+				m_Nodes[allocated.neighbourNext].neighbourPrev = newNodeIdx;
+			}
+			m_Nodes[newNodeIdx].neighbourPrev = nodeIdx;
+			m_Nodes[newNodeIdx].neighbourNext = allocated.neighbourNext;
+			allocated.neighbourNext = newNodeIdx;
+		}
+
+		return { m_Nodes[nodeIdx].offset, nodeIdx };
+	}
+
+	void OffsetAllocator::Free(Allocation allocation) noexcept
+	{
+		if (!allocation.IsValid())
+		{
+			return;
+		}
+
+		uint32_t const nodeIdx{ allocation.metadata };
+		ME_CORE_ASSERT(nodeIdx < m_Nodes.size() && m_Nodes[nodeIdx].isUsed);
+
+		Node& node{ m_Nodes[nodeIdx] };
+		uint32_t offset{ node.offset };
+		uint32_t size{ node.size };
+
+		// Merge with the free neighbours
+		if (node.neighbourPrev != UNUSED && !m_Nodes[node.neighbourPrev].isUsed)
+		{
+			Node const& prev{ m_Nodes[node.neighbourPrev] };
+			offset = prev.offset;
+			size += prev.size;
+
+			uint32_t const prevIdx{ node.neighbourPrev };
+			node.neighbourPrev = prev.neighbourPrev;
+			RemoveNodeFromBin(prevIdx);
+		}
+
+		if (node.neighbourNext != UNUSED && !m_Nodes[node.neighbourNext].isUsed)
+		{
+			Node const& next{ m_Nodes[node.neighbourNext] };
+			size += next.size;
+
+			uint32_t const nextIdx{ node.neighbourNext };
+			node.neighbourNext = next.neighbourNext;
+			RemoveNodeFromBin(nextIdx);
+		}
+
+		uint32_t const neighbourPrev{ node.neighbourPrev };
+		uint32_t const neighbourNext{ node.neighbourNext };
+
+		node = {};
+		m_FreeNodes.emplace_back(nodeIdx);
+
+		uint32_t const combinedIdx{ InsertNodeIntoBin(size, offset) };
+		if (neighbourPrev != UNUSED)
+		{
+			m_Nodes[combinedIdx].neighbourPrev = neighbourPrev;
+			m_Nodes[neighbourPrev].neighbourNext = combinedIdx;
+		}
+		if (neighbourNext != UNUSED)
+		{
+			m_Nodes[combinedIdx].neighbourNext = neighbourNext;
+			m_Nodes[neighbourNext].neighbourPrev = combinedIdx;
+		}
+	}
+
+	void OffsetAllocator::Reset()
+	{
+		m_FreeStorage = 0;
+		m_UsedBinsTop = 0;
+		m_UsedBins.fill(0);
+		m_BinHeads.fill(UNUSED);
+
+		m_Nodes.assign(m_MaxAllocations, Node{});
+
+		// Popped from the back, so the first nodes get used first
+		m_FreeNodes.resize(m_MaxAllocations);
+		for (uint32_t i{ 0 }; i < m_MaxAllocations; ++i)
+		{
+			m_FreeNodes[i] = m_MaxAllocations - i - 1;
+		}
+
+		if (m_Size > 0)
+		{
+			InsertNodeIntoBin(m_Size, 0);
+		}
+	}
+
+	uint32_t OffsetAllocator::GetAllocationSize(Allocation allocation) const noexcept
+	{
+		return allocation.IsValid() ? m_Nodes[allocation.metadata].size : 0;
+	}
+
+	OffsetAllocator::StorageReport OffsetAllocator::GetStorageReport() const noexcept
+	{
+		if (m_UsedBinsTop == 0)
+		{
+			return { m_FreeStorage, 0 };
+		}
+
+		// Ranges in a bin are only sorted by bin, the highest one has to be searched
+		uint32_t const top{ static_cast<uint32_t>(std::bit_width(m_UsedBinsTop)) - 1 };
+		uint32_t const leaf{ static_cast<uint32_t>(std::bit_width(static_cast<uint32_t>(m_UsedBins[top]))) - 1 };
+
+		uint32_t largest{ 0 };
+		for (uint32_t nodeIdx{ m_BinHeads[top * BINS_PER_LEAF + leaf] }; nodeIdx != UNUSED; nodeIdx = m_Nodes[nodeIdx].binNext)
+		{
+			largest = std::max(largest, m_Nodes[nodeIdx].size);
+		}
+
+		return { m_FreeStorage, largest };
+	}
+
+	uint32_t OffsetAllocator::InsertNodeIntoBin(uint32_t size, uint32_t offset) noexcept
+	{
+		ME_CORE_ASSERT(!m_FreeNodes.empty());
+
+		uint32_t const bin{ SizeToBinRoundDown(size) };
+		uint32_t const top{ bin / BINS_PER_LEAF };
+		uint32_t const leaf{ bin % BINS_PER_LEAF };
+
+		if (m_BinHeads[bin] == UNUSED)
+		{
+			m_UsedBins[top] |= static_cast<uint8_t>(1u << leaf);
+			m_UsedBinsTop |= 1u << top;
+		}
+
+		uint32_t const nodeIdx{ m_FreeNodes.back() };
+		m_FreeNodes.pop_back();
+
+		uint32_t const headIdx{ m_BinHeads[bin] };
+		m_Nodes[nodeIdx] = { .offset = offset, .size = size, .binNext = headIdx };
+		if (headIdx != UNUSED)
+		{
+			m_Nodes[headIdx].binPrev = nodeIdx;
+		}
+		m_BinHeads[bin] = nodeIdx;
+
+		m_FreeStorage += size;
+
+		return nodeIdx;
+	}
+
+	void OffsetAllocator::RemoveNodeFromBin(uint32_t nodeIdx) noexcept
+	{
+		UnlinkFromBin(nodeIdx);
+
+		m_Nodes[nodeIdx] = {};
+		m_FreeNodes.emplace_back(nodeIdx);
+	}
+
+	void OffsetAllocator::UnlinkFromBin(uint32_t nodeIdx) noexcept
+	{
+		Node& node{ m_Nodes[nodeIdx] };
+
+		if (node.binPrev != UNUSED)
+		{
+			m_Nodes[node.binPrev].binNext = node.binNext;
+			if (node.binNext != UNUSED)
+			{
+				m_Nodes[node.binNext].binPrev = node.binPrev;
+			}
+		}
+		else
+		{
+			// Head of its bin
+			uint32_t const bin{ SizeToBinRoundDown(node.size) };
+			uint32_t const top{ bin / BINS_PER_LEAF };
+			uint32_t const leaf{ bin % BINS_PER_LEAF };
+
+			m_BinHeads[bin] = node.binNext;
+			if (node.binNext != UNUSED)
+			{
+				m_Nodes[node.binNext].binPrev = UNUSED;
+			}
+
+			if (m_BinHeads[bin] == UNUSED)
+			{
+				m_UsedBins[top] &= static_cast<uint8_t>(~(1u << leaf));
+				if (m_UsedBins[top] == 0)
+				{
+					m_UsedBinsTop &= ~(1u << top);
+				}
+			}
+		}
+
+		node.binPrev = UNUSED;
+		node.binNext = UNUSED;
+		m_FreeStorage -= node.size;
+	}
+}
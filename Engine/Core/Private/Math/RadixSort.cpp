@@ -0,0 +1,63 @@
+#include "Math/RadixSort.h"
+
+#include <array>
+
+namespace MauCor
+{
+	void RadixSort(std::vector<uint64_t>& keys, std::vector<uint32_t>& values, std::vector<uint64_t>& keyScratch, std::vector<uint32_t>& valueScratch) noexcept
+	{
+		ME_CORE_ASSERT(keys.size() == values.size());
+
+		std::size_t const count{ keys.size() };
+		if (count < 2)
+		{
+			return;
+		}
+
+		uint32_t constexpr PASS_COUNT{ sizeof(uint64_t) };
+		uint32_t constexpr BUCKET_COUNT{ 256 };
+
+		// Histograms of every pass in one read of the keys
+		std::array<std::array<std::size_t, BUCKET_COUNT>, PASS_COUNT> histograms{};
+		for (uint64_t const key : keys)
+		{
+			for (uint32_t pass{ 0 }; pass < PASS_COUNT; ++pass)
+			{
+				++histograms[pass][(key >> (pass * 8)) & 0xFF];
+			}
+		}
+
+		keyScratch.resize(count);
+		valueScratch.resize(count);
+
+		for (uint32_t pass{ 0 }; pass < PASS_COUNT; ++pass)
+		{
+			auto& histogram{ histograms[pass] };
+
+			// All keys share this byte, the pass would not move anything
+			if (histogram[(keys[0] >> (pass * 8)) & 0xFF] == count)
+			{
+				continue;
+			}
+
+			// Counts to offsets
+			std::size_t offset{ 0 };
+			for (auto& bucket : histogram)
+			{
+				std::size_t const bucketCount{ bucket };
+				bucket = offset;
+				offset += bucketCount;
+			}
+
+			for (std::size_t i{ 0 }; i < count; ++i)
+			{
+				std::size_t const dst{ histogram[(keys[i] >> (pass * 8)) & 0xFF]++ };
+				keyScratch[dst] = keys[i];
+				valueScratch[dst] = values[i];
+			}
+
+			keys.swap(keyScratch);
+			values.swap(valueScratch);
+		}
+	}
+}
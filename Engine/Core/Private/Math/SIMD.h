@@ -0,0 +1,19 @@
+#ifndef MAUCOR_SIMD_H
+#define MAUCOR_SIMD_H
+
+// Intrinsics for the SIMD kernels, MAUCOR_X86_SIMD is only defined when the SSE & AVX2 paths can be compiled
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+	#define MAUCOR_X86_SIMD
+	#include <immintrin.h>
+
+	#if defined(_MSC_VER) && !defined(__clang__)
+		#include <intrin.h>
+		// MSVC allows AVX2 intrinsics in any function, no matter the /arch flag
+		#define MAUCOR_TARGET_AVX2
+	#else
+		#include <cpuid.h>
+		#define MAUCOR_TARGET_AVX2 __attribute__((target("avx2,fma")))
+	#endif
+#endif
+
+#endif
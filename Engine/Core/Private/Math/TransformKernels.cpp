@@ -0,0 +1,275 @@
+#include "Math/TransformKernels.h"
+
+#include <algorithm>
+
+#include "Math/SIMD.h"
+
+namespace MauCor
+{
+	namespace
+	{
+		// Reference path, also handles the tail that does not fill a SIMD register
+		void ComposeScalar(TRSStreams const& s, float* pOut, std::size_t begin, std::size_t end) noexcept
+		{
+			for (std::size_t i{ begin }; i < end; ++i)
+			{
+				float const x{ s.pRotationX[i] };
+				float const y{ s.pRotationY[i] };
+				float const z{ s.pRotationZ[i] };
+				float const w{ s.pRotationW[i] };
+
+				float const xx{ x * x }, yy{ y * y }, zz{ z * z };
+				float const xy{ x * y }, xz{ x * z }, yz{ y * z };
+				float const wx{ w * x }, wy{ w * y }, wz{ w * z };
+
+				float const sx{ s.pScaleX[i] };
+				float const sy{ s.pScaleY[i] };
+				float const sz{ s.pScaleZ[i] };
+
+				float* m{ pOut + i * 16 };
+
+				m[0] = (1.f - 2.f * (yy + zz)) * sx;
+				m[1] = 2.f * (xy + wz) * sx;
+				m[2] = 2.f * (xz - wy) * sx;
+				m[3] = 0.f;
+
+				m[4] = 2.f * (xy - wz) * sy;
+				m[5] = (1.f - 2.f * (xx + zz)) * sy;
+				m[6] = 2.f * (yz + wx) * sy;
+				m[7] = 0.f;
+
+				m[8] = 2.f * (xz + wy) * sz;
+				m[9] = 2.f * (yz - wx) * sz;
+				m[10] = (1.f - 2.f * (xx + yy)) * sz;
+				m[11] = 0.f;
+
+				m[12] = s.pTranslationX[i];
+				m[13] = s.pTranslationY[i];
+				m[14] = s.pTranslationZ[i];
+				m[15] = 1.f;
+			}
+		}
+
+#ifdef MAUCOR_X86_SIMD
+		// 4 entities per iteration, every register holds one matrix element of 4 entities which is transposed back to 4 matrices on store
+		std::size_t ComposeSSE(TRSStreams const& s, float* pOut, std::size_t begin, std::size_t end) noexcept
+		{
+			__m128 const one{ _mm_set1_ps(1.f) };
+			__m128 const two{ _mm_set1_ps(2.f) };
+			__m128 const zero{ _mm_setzero_ps() };
+
+			std::size_t i{ begin };
+			for (; i + 4 <= end; i += 4)
+			{
+				__m128 const x{ _mm_loadu_ps(s.pRotationX + i) };
+				__m128 const y{ _mm_loadu_ps(s.pRotationY + i) };
+				__m128 const z{ _mm_loadu_ps(s.pRotationZ + i) };
+				__m128 const w{ _mm_loadu_ps(s.pRotationW + i) };
+
+				__m128 const x2{ _mm_mul_ps(x, two) };
+				__m128 const y2{ _mm_mul_ps(y, two) };
+				__m128 const z2{ _mm_mul_ps(z, two) };
+
+				__m128 const xx{ _mm_mul_ps(x, x2) }, yy{ _mm_mul_ps(y, y2) }, zz{ _mm_mul_ps(z, z2) };
+				__m128 const xy{ _mm_mul_ps(x, y2) }, xz{ _mm_mul_ps(x, z2) }, yz{ _mm_mul_ps(y, z2) };
+				__m128 const wx{ _mm_mul_ps(w, x2) }, wy{ _mm_mul_ps(w, y2) }, wz{ _mm_mul_ps(w, z2) };
+
+				__m128 const sx{ _mm_loadu_ps(s.pScaleX + i) };
+				__m128 const sy{ _mm_loadu_ps(s.pScaleY + i) };
+				__m128 const sz{ _mm_loadu_ps(s.pScaleZ + i) };
+
+				__m128 c0x{ _mm_mul_ps(_mm_sub_ps(one, _mm_add_ps(yy, zz)), sx) };
+				__m128 c0y{ _mm_mul_ps(_mm_add_ps(xy, wz), sx) };
+				__m128 c0z{ _mm_mul_ps(_mm_sub_ps(xz, wy), sx) };
+				__m128 c0w{ zero };
+
+				__m128 c1x{ _mm_mul_ps(_mm_sub_ps(xy, wz), sy) };
+				__m128 c1y{ _mm_mul_ps(_mm_sub_ps(one, _mm_add_ps(xx, zz)), sy) };
+				__m128 c1z{ _mm_mul_ps(_mm_add_ps(yz, wx), sy) };
+				__m128 c1w{ zero };
+
+				__m128 c2x{ _mm_mul_ps(_mm_add_ps(xz, wy), sz) };
+				__m128 c2y{ _mm_mul_ps(_mm_sub_ps(yz, wx), sz) };
+				__m128 c2z{ _mm_mul_ps(_mm_sub_ps(one, _mm_add_ps(xx, yy)), sz) };
+				__m128 c2w{ zero };
+
+				__m128 c3x{ _mm_loadu_ps(s.pTranslationX + i) };
+				__m128 c3y{ _mm_loadu_ps(s.pTranslationY + i) };
+				__m128 c3z{ _mm_loadu_ps(s.pTranslationZ + i) };
+				__m128 c3w{ one };
+
+				_MM_TRANSPOSE4_PS(c0x, c0y, c0z, c0w);
+				_MM_TRANSPOSE4_PS(c1x, c1y, c1z, c1w);
+				_MM_TRANSPOSE4_PS(c2x, c2y, c2z, c2w);
+				_MM_TRANSPOSE4_PS(c3x, c3y, c3z, c3w);
+
+				// After the transpose cNx holds column N of the first entity, cNy of the second, ...
+				float* m{ pOut + i * 16 };
+				_mm_storeu_ps(m + 0, c0x);  _mm_storeu_ps(m + 4, c1x);  _mm_storeu_ps(m + 8, c2x);  _mm_storeu_ps(m + 12, c3x);
+				_mm_storeu_ps(m + 16, c0y); _mm_storeu_ps(m + 20, c1y); _mm_storeu_ps(m + 24, c2y); _mm_storeu_ps(m + 28, c3y);
+				_mm_storeu_ps(m + 32, c0z); _mm_storeu_ps(m + 36, c1z); _mm_storeu_ps(m + 40, c2z); _mm_storeu_ps(m + 44, c3z);
+				_mm_storeu_ps(m + 48, c0w); _mm_storeu_ps(m + 52, c1w); _mm_storeu_ps(m + 56, c2w); _mm_storeu_ps(m + 60, c3w);
+			}
+
+			return i;
+		}
+
+		// Transposes 4x4 blocks within each 128 bit lane, rN's low lane ends up in entity N, the high lane in entity N + 4
+		MAUCOR_TARGET_AVX2 inline void Transpose4x4Lanes(__m256& r0, __m256& r1, __m256& r2, __m256& r3) noexcept
+		{
+			__m256 const t0{ _mm256_unpacklo_ps(r0, r1) };
+			__m256 const t1{ _mm256_unpackhi_ps(r0, r1) };
+			__m256 const t2{ _mm256_unpacklo_ps(r2, r3) };
+			__m256 const t3{ _mm256_unpackhi_ps(r2, r3) };
+
+			r0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+			r1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+			r2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+			r3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+		}
+
+		// 8 entities per iteration, same approach as the SSE path
+		MAUCOR_TARGET_AVX2 std::size_t ComposeAVX2(TRSStreams const& s, float* pOut, std::size_t begin, std::size_t end) noexcept
+		{
+			__m256 const one{ _mm256_set1_ps(1.f) };
+			__m256 const two{ _mm256_set1_ps(2.f) };
+			__m256 const zero{ _mm256_setzero_ps() };
+
+			std::size_t i{ begin };
+			for (; i + 8 <= end; i += 8)
+			{
+				__m256 const x{ _mm256_loadu_ps(s.pRotationX + i) };
+				__m256 const y{ _mm256_loadu_ps(s.pRotationY + i) };
+				__m256 const z{ _mm256_loadu_ps(s.pRotationZ + i) };
+				__m256 const w{ _mm256_loadu_ps(s.pRotationW + i) };
+
+				__m256 const x2{ _mm256_mul_ps(x, two) };
+				__m256 const y2{ _mm256_mul_ps(y, two) };
+				__m256 const z2{ _mm256_mul_ps(z, two) };
+
+				__m256 const xx{ _mm256_mul_ps(x, x2) }, yy{ _mm256_mul_ps(y, y2) }, zz{ _mm256_mul_ps(z, z2) };
+				__m256 const xy{ _mm256_mul_ps(x, y2) }, xz{ _mm256_mul_ps(x, z2) }, yz{ _mm256_mul_ps(y, z2) };
+				__m256 const wx{ _mm256_mul_ps(w, x2) }, wy{ _mm256_mul_ps(w, y2) }, wz{ _mm256_mul_ps(w, z2) };
+
+				__m256 const sx{ _mm256_loadu_ps(s.pScaleX + i) };
+				__m256 const sy{ _mm256_loadu_ps(s.pScaleY + i) };
+				__m256 const sz{ _mm256_loadu_ps(s.pScaleZ + i) };
+
+				__m256 c0x{ _mm256_mul_ps(_mm256_sub_ps(one, _mm256_add_ps(yy, zz)), sx) };
+				__m256 c0y{ _mm256_mul_ps(_mm256_add_ps(xy, wz), sx) };
+				__m256 c0z{ _mm256_mul_ps(_mm256_sub_ps(xz, wy), sx) };
+				__m256 c0w{ zero };
+
+				__m256 c1x{ _mm256_mul_ps(_mm256_sub_ps(xy, wz), sy) };
+				__m256 c1y{ _mm256_mul_ps(_mm256_sub_ps(one, _mm256_add_ps(xx, zz)), sy) };
+				__m256 c1z{ _mm256_mul_ps(_mm256_add_ps(yz, wx), sy) };
+				__m256 c1w{ zero };
+
+				__m256 c2x{ _mm256_mul_ps(_mm256_add_ps(xz, wy), sz) };
+				__m256 c2y{ _mm256_mul_ps(_mm256_sub_ps(yz, wx), sz) };
+				__m256 c2z{ _mm256_mul_ps(_mm256_sub_ps(one, _mm256_add_ps(xx, yy)), sz) };
+				__m256 c2w{ zero };
+
+				__m256 c3x{ _mm256_loadu_ps(s.pTranslationX + i) };
+				__m256 c3y{ _mm256_loadu_ps(s.pTranslationY + i) };
+				__m256 c3z{ _mm256_loadu_ps(s.pTranslationZ + i) };
+				__m256 c3w{ one };
+
+				Transpose4x4Lanes(c0x, c0y, c0z, c0w);
+				Transpose4x4Lanes(c1x, c1y, c1z, c1w);
+				Transpose4x4Lanes(c2x, c2y, c2z, c2w);
+				Transpose4x4Lanes(c3x, c3y, c3z, c3w);
+
+				__m256 const* columns[4][4]
+				{
+					{ &c0x, &c1x, &c2x, &c3x },
+					{ &c0y, &c1y, &c2y, &c3y },
+					{ &c0z, &c1z, &c2z, &c3z },
+					{ &c0w, &c1w, &c2w, &c3w }
+				};
+
+				float* m{ pOut + i * 16 };
+				for (std::size_t e{ 0 }; e < 4; ++e)
+				{
+					for (std::size_t c{ 0 }; c < 4; ++c)
+					{
+						_mm_storeu_ps(m + e * 16 + c * 4, _mm256_castps256_ps128(*columns[e][c]));
+						_mm_storeu_ps(m + (e + 4) * 16 + c * 4, _mm256_extractf128_ps(*columns[e][c], 1));
+					}
+				}
+			}
+
+			return i;
+		}
+
+		[[nodiscard]] ESIMDLevel DetectSIMDLevel() noexcept
+		{
+#if defined(_MSC_VER) && !defined(__clang__)
+			int info[4]{};
+			__cpuid(info, 0);
+			int const maxLeaf{ info[0] };
+
+			__cpuid(info, 1);
+			bool const hasSSE41{ (info[2] & (1 << 19)) != 0 };
+			bool const hasOSXSave{ (info[2] & (1 << 27)) != 0 };
+			bool const hasAVX{ (info[2] & (1 << 28)) != 0 };
+
+			bool hasAVX2{ false };
+			if (maxLeaf >= 7 && hasOSXSave && hasAVX)
+			{
+				// The OS has to save the YMM registers on a context switch as well
+				bool const osSavesYMM{ (_xgetbv(0) & 0x6) == 0x6 };
+
+				__cpuidex(info, 7, 0);
+				hasAVX2 = osSavesYMM && (info[1] & (1 << 5)) != 0;
+			}
+
+			if (hasAVX2)
+			{
+				return ESIMDLevel::AVX2;
+			}
+			return hasSSE41 ? ESIMDLevel::SSE : ESIMDLevel::Scalar;
+#else
+			__builtin_cpu_init();
+			if (__builtin_cpu_supports("avx2"))
+			{
+				return ESIMDLevel::AVX2;
+			}
+			return __builtin_cpu_supports("sse4.1") ? ESIMDLevel::SSE : ESIMDLevel::Scalar;
+#endif
+		}
+#endif
+	}
+
+	ESIMDLevel GetSupportedSIMDLevel() noexcept
+	{
+#ifdef MAUCOR_X86_SIMD
+		static ESIMDLevel const level{ DetectSIMDLevel() };
+		return level;
+#else
+		return ESIMDLevel::Scalar;
+#endif
+	}
+
+	void ComposeTRSMatrices(TRSStreams const& streams, float* pOutMatrices, std::size_t begin, std::size_t end, ESIMDLevel level) noexcept
+	{
+		// Never run a path the CPU does not support
+		level = std::min(level, GetSupportedSIMDLevel());
+
+		std::size_t i{ begin };
+#ifdef MAUCOR_X86_SIMD
+		switch (level)
+		{
+		case ESIMDLevel::AVX2:
+			i = ComposeAVX2(streams, pOutMatrices, i, end);
+			[[fallthrough]];
+		case ESIMDLevel::SSE:
+			i = ComposeSSE(streams, pOutMatrices, i, end);
+			break;
+		default:
+			break;
+		}
+#endif
+		ComposeScalar(streams, pOutMatrices, i, end);
+	}
+}
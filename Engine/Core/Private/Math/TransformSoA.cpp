@@ -0,0 +1,154 @@
+#include "Math/TransformSoA.h"
+
+#include "CoreServiceLocator.h"
+
+namespace MauCor
+{
+	namespace
+	{
+		// 256KiB of output matrices per job, a multiple of the AVX2 width
+		std::size_t constexpr MATRICES_PER_JOB{ 4096 };
+	}
+
+	void TransformSoA::Reserve(std::size_t count)
+	{
+		for (Stream* pStream : { &m_TranslationX, &m_TranslationY, &m_TranslationZ,
+								 &m_RotationX, &m_RotationY, &m_RotationZ, &m_RotationW,
+								 &m_ScaleX, &m_ScaleY, &m_ScaleZ })
+		{
+			pStream->reserve(count);
+		}
+	}
+
+	void TransformSoA::Resize(std::size_t count)
+	{
+		for (Stream* pStream : { &m_TranslationX, &m_TranslationY, &m_TranslationZ,
+								 &m_RotationX, &m_RotationY, &m_RotationZ })
+		{
+			pStream->resize(count, 0.f);
+		}
+
+		for (Stream* pStream : { &m_RotationW, &m_ScaleX, &m_ScaleY, &m_ScaleZ })
+		{
+			pStream->resize(count, 1.f);
+		}
+	}
+
+	void TransformSoA::Clear() noexcept
+	{
+		Resize(0);
+	}
+
+	uint32_t TransformSoA::Add(glm::vec3 const& translation, Rotator const& rotation, glm::vec3 const& scale)
+	{
+		auto const idx{ static_cast<uint32_t>(Size()) };
+		Resize(Size() + 1);
+
+		SetTranslation(idx, translation);
+		SetRotation(idx, rotation);
+		SetScale(idx, scale);
+
+		return idx;
+	}
+
+	void TransformSoA::RemoveSwapBack(uint32_t idx) noexcept
+	{
+		ME_CORE_ASSERT(idx < Size());
+
+		for (Stream* pStream : { &m_TranslationX, &m_TranslationY, &m_TranslationZ,
+								 &m_RotationX, &m_RotationY, &m_RotationZ, &m_RotationW,
+								 &m_ScaleX, &m_ScaleY, &m_ScaleZ })
+		{
+			(*pStream)[idx] = pStream->back();
+			pStream->pop_back();
+		}
+	}
+
+	void TransformSoA::SetTranslation(uint32_t idx, glm::vec3 const& translation) noexcept
+	{
+		m_TranslationX[idx] = translation.x;
+		m_TranslationY[idx] = translation.y;
+		m_TranslationZ[idx] = translation.z;
+	}
+
+	void TransformSoA::SetRotation(uint32_t idx, Rotator const& rotation) noexcept
+	{
+		m_RotationX[idx] = rotation.rotation.x;
+		m_RotationY[idx] = rotation.rotation.y;
+		m_RotationZ[idx] = rotation.rotation.z;
+		m_RotationW[idx] = rotation.rotation.w;
+	}
+
+	void TransformSoA::SetScale(uint32_t idx, glm::vec3 const& scale) noexcept
+	{
+		m_ScaleX[idx] = scale.x;
+		m_ScaleY[idx] = scale.y;
+		m_ScaleZ[idx] = scale.z;
+	}
+
+	void TransformSoA::Translate(uint32_t idx, glm::vec3 const& translation) noexcept
+	{
+		SetTranslation(idx, GetTranslation(idx) + translation);
+	}
+
+	void TransformSoA::Rotate(uint32_t idx, Rotator const& rotation) noexcept
+	{
+		SetRotation(idx, GetRotation(idx) * rotation);
+	}
+
+	void TransformSoA::Scale(uint32_t idx, glm::vec3 const& scale) noexcept
+	{
+		SetScale(idx, GetScale(idx) * scale);
+	}
+
+	glm::vec3 TransformSoA::GetTranslation(uint32_t idx) const noexcept
+	{
+		return { m_TranslationX[idx], m_TranslationY[idx], m_TranslationZ[idx] };
+	}
+
+	Rotator TransformSoA::GetRotation(uint32_t idx) const noexcept
+	{
+		// glm::quat's constructor takes w first
+		return Rotator{ glm::quat{ m_RotationW[idx], m_RotationX[idx], m_RotationY[idx], m_RotationZ[idx] } };
+	}
+
+	glm::vec3 TransformSoA::GetScale(uint32_t idx) const noexcept
+	{
+		return { m_ScaleX[idx], m_ScaleY[idx], m_ScaleZ[idx] };
+	}
+
+	TRSStreams TransformSoA::Streams() const noexcept
+	{
+		return TRSStreams
+		{
+			.pTranslationX = m_TranslationX.data(),
+			.pTranslationY = m_TranslationY.data(),
+			.pTranslationZ = m_TranslationZ.data(),
+
+			.pRotationX = m_RotationX.data(),
+			.pRotationY = m_RotationY.data(),
+			.pRotationZ = m_RotationZ.data(),
+			.pRotationW = m_RotationW.data(),
+
+			.pScaleX = m_ScaleX.data(),
+			.pScaleY = m_ScaleY.data(),
+			.pScaleZ = m_ScaleZ.data()
+		};
+	}
+
+	void TransformSoA::ComputeMatrices(std::span<glm::mat4> outMatrices, ESIMDLevel level) const noexcept
+	{
+		ME_PROFILE_FUNCTION()
+
+		ME_CORE_ASSERT(outMatrices.size() >= Size());
+
+		TRSStreams const streams{ Streams() };
+		// glm::mat4 is 16 tightly packed floats in column major order, the layout the kernels write
+		float* const pOut{ reinterpret_cast<float*>(outMatrices.data()) };
+
+		JOB_SYSTEM.ParallelFor(Size(), MATRICES_PER_JOB, [&](std::size_t begin, std::size_t end)
+			{
+				ComposeTRSMatrices(streams, pOut, begin, end, level);
+			});
+	}
+}
@@ -5,6 +5,7 @@
 
 #include "Logger/Logger.h"
 #include "GameTime.h"
+#include "Jobs/JobSystem.h"
 
 #include <Profiler/ProfilerMacros.h>
 
@@ -17,12 +18,14 @@ namespace MauCor
 		static void RegisterLogger(std::unique_ptr<Logger>&& pLogger);
 
 		[[nodiscard]] static MauCor::Time& GetTime() { return MauCor::Time::GetInstance(); }
+		[[nodiscard]] static MauCor::JobSystem& GetJobSystem() { return MauCor::JobSystem::GetInstance(); }
 
 	private:
 		static std::unique_ptr<Logger> m_pLogger;
 	};
 
 #define TIME MauCor::CoreServiceLocator::GetTime()
+#define JOB_SYSTEM MauCor::CoreServiceLocator::GetJobSystem()
 
 #pragma region EasyAccessHelpers
 #define LOGGER MauCor::CoreServiceLocator::GetLogger()
@@ -3,6 +3,7 @@
 
 #include "Singleton.h"
 
+#include <algorithm>
 #include <chrono>
 
 namespace MauEng
@@ -19,6 +20,8 @@ namespace MauCor
 		[[nodiscard]] inline float constexpr ElapsedSec() const noexcept { return m_ElapsedSec; }
 		// Get the time a fixed update tick takes
 		[[nodiscard]] inline float constexpr FixedTimeStepSec() const noexcept { return (m_MsFixedTimeStep / 1000.f); }
+		// How far the frame is into the next fixed step [0, 1), used to interpolate between the last two fixed steps
+		[[nodiscard]] inline float constexpr FixedAlpha() const noexcept { return std::clamp(m_MsLag / m_MsFixedTimeStep, 0.f, 1.f); }
 
 
 		Time(Time const&) = delete;
@@ -39,6 +42,8 @@ namespace MauCor
 		float const m_MsPerFrame{ 16.7f };
 		// Ms for a single fixed timestep tick
 		float const m_MsFixedTimeStep{ 20.f };
+		// Lag is capped, so a long hitch (loading, a breakpoint, ...) doesn't cause a burst of fixed steps that take even longer
+		float const m_MsMaxLag{ 250.f };
 
 		float m_ElapsedSec{ 0.f };
 		float m_MsLag{ 0.f };
@@ -56,7 +61,7 @@ namespace MauCor
 			auto const currentTime{ std::chrono::high_resolution_clock::now() };
 			m_ElapsedSec = std::chrono::duration<float>(currentTime - m_LastTime).count();
 
-			m_MsLag += m_ElapsedSec * 1000.f;
+			m_MsLag = std::min(m_MsLag + m_ElapsedSec * 1000.f, m_MsMaxLag);
 			m_LastTime = std::chrono::high_resolution_clock::now();
 		}
 
@@ -0,0 +1,42 @@
+#ifndef MAUCOR_MAPPEDFILE_H
+#define MAUCOR_MAPPEDFILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace MauCor
+{
+	// Read only view of a whole file, mapped into memory by the OS
+	// Pages are only read from disk when they are touched, the mapping stays valid until the object is destroyed.
+	class MappedFile final
+	{
+	public:
+		MappedFile() = default;
+		~MappedFile();
+
+		// Map the file at path, returns false (& leaves the object closed) on failure
+		[[nodiscard]] bool Open(char const* path) noexcept;
+		void Close() noexcept;
+
+		[[nodiscard]] bool IsOpen() const noexcept { return m_pData != nullptr; }
+		[[nodiscard]] std::span<std::byte const> Data() const noexcept { return { m_pData, m_Size }; }
+		[[nodiscard]] std::size_t Size() const noexcept { return m_Size; }
+
+		MappedFile(MappedFile const&) = delete;
+		MappedFile(MappedFile&&) = delete;
+		MappedFile& operator=(MappedFile const&) = delete;
+		MappedFile& operator=(MappedFile&&) = delete;
+
+	private:
+		std::byte const* m_pData{ nullptr };
+		std::size_t m_Size{ 0 };
+
+#if defined(_WIN32)
+		void* m_File{ nullptr };
+		void* m_Mapping{ nullptr };
+#endif
+	};
+}
+
+#endif
@@ -0,0 +1,158 @@
+#ifndef MAUCOR_JOBSYSTEM_H
+#define MAUCOR_JOBSYSTEM_H
+
+#include "Singleton.h"
+
+#include <algorithm>
+#include <atomic>
+#include <concepts>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace MauCor
+{
+	// Size of a cache line, used to align job ranges & avoid false sharing between workers
+	std::size_t constexpr CACHE_LINE_SIZE{ 64 };
+
+	// Tracks a group of scheduled jobs, pass it to Wait to block until all of them finished
+	class JobCounter final
+	{
+	public:
+		JobCounter() = default;
+		~JobCounter() = default;
+
+		[[nodiscard]] bool IsDone() const noexcept { return m_Count.load(std::memory_order_acquire) == 0; }
+
+		JobCounter(JobCounter const&) = delete;
+		JobCounter(JobCounter&&) = delete;
+		JobCounter& operator=(JobCounter const&) = delete;
+		JobCounter& operator=(JobCounter&&) = delete;
+
+	private:
+		friend class JobSystem;
+		std::atomic<uint32_t> m_Count{ 0 };
+	};
+
+	// Work stealing thread pool
+	// Each worker owns a queue, it pops its own work LIFO and steals from the other queues FIFO when it runs dry.
+	// Threads that are not workers (e.g. the main thread) share one extra queue and help execute jobs while they wait.
+	class JobSystem final : public Singleton<JobSystem>
+	{
+	public:
+		using Job = std::function<void()>;
+
+		/**
+		 * @brief Schedule a job on the worker pool.
+		 * @param job Job to execute.
+		 * @param pCounter Optional counter, incremented now & decremented once the job has been executed.
+		 */
+		void Schedule(Job&& job, JobCounter* pCounter = nullptr) noexcept;
+
+		/**
+		 * @brief Wait until all jobs tracked by the counter are done.
+		 * @param counter Counter to wait on.
+		 * @note The calling thread executes (or steals) jobs while it waits, so waiting from inside a job is allowed.
+		 */
+		void Wait(JobCounter const& counter) noexcept;
+
+		/**
+		 * @brief Split [0, count) into ranges of grainSize and execute them on the worker pool, returns when all ranges are done.
+		 * @tparam Func Function type, called as func(begin, end).
+		 * @param count Number of elements.
+		 * @param grainSize Number of elements per job.
+		 * @param func Function to execute for each range.
+		 */
+		template<typename Func>
+			requires std::invocable<Func&, std::size_t, std::size_t>
+		void ParallelFor(std::size_t count, std::size_t grainSize, Func&& func) noexcept
+		{
+			if (count == 0)
+			{
+				return;
+			}
+
+			grainSize = std::max<std::size_t>(grainSize, 1);
+
+			// Not worth splitting up
+			if (count <= grainSize or NumWorkers() == 0)
+			{
+				func(std::size_t{ 0 }, count);
+				return;
+			}
+
+			JobCounter counter{};
+			for (std::size_t begin{ grainSize }; begin < count; begin += grainSize)
+			{
+				std::size_t const end{ std::min(begin + grainSize, count) };
+				Schedule([&func, begin, end]() { func(begin, end); }, &counter);
+			}
+
+			// The calling thread takes the first range itself
+			func(std::size_t{ 0 }, grainSize);
+
+			Wait(counter);
+		}
+
+		[[nodiscard]] uint32_t NumWorkers() const noexcept { return static_cast<uint32_t>(m_Workers.size()); }
+
+		// Is the calling thread one of the pool's worker threads
+		[[nodiscard]] bool IsWorkerThread() const noexcept;
+
+		// Index of the calling thread, 0 for threads outside the pool & [1, NumWorkers()] for the workers
+		// Useful to index per thread data without locking, threads outside the pool do share index 0
+		[[nodiscard]] uint32_t ThreadIndex() const noexcept { return GetQueueIndexForThisThread(); }
+		[[nodiscard]] uint32_t NumThreadIndices() const noexcept { return m_NumQueues; }
+
+		JobSystem(JobSystem const&) = delete;
+		JobSystem(JobSystem&&) = delete;
+		JobSystem& operator=(JobSystem const&) = delete;
+		JobSystem& operator=(JobSystem&&) = delete;
+
+	private:
+		friend class Singleton<JobSystem>;
+		JobSystem();
+		virtual ~JobSystem() override;
+
+		struct QueuedJob final
+		{
+			Job job;
+			JobCounter* pCounter{ nullptr };
+		};
+
+		struct alignas(CACHE_LINE_SIZE) WorkQueue final
+		{
+			std::mutex mutex;
+			std::deque<QueuedJob> jobs;
+		};
+
+		// Index 0 is the shared queue for non worker threads, worker i uses queue i + 1
+		std::unique_ptr<WorkQueue[]> m_Queues;
+		uint32_t m_NumQueues{ 0 };
+
+		std::vector<std::thread> m_Workers;
+
+		std::mutex m_SleepMutex;
+		std::condition_variable m_WakeCondition;
+
+		std::atomic<uint32_t> m_NumQueuedJobs{ 0 };
+		std::atomic<bool> m_IsRunning{ true };
+
+		void WorkerLoop(uint32_t queueIdx) noexcept;
+
+		// Pop from our own queue, or steal from one of the others, returns false when no work was found
+		[[nodiscard]] bool TryExecuteJob(uint32_t queueIdx) noexcept;
+
+		[[nodiscard]] bool TryPop(uint32_t queueIdx, QueuedJob& outJob) noexcept;
+		[[nodiscard]] bool TrySteal(uint32_t thiefIdx, QueuedJob& outJob) noexcept;
+
+		[[nodiscard]] uint32_t GetQueueIndexForThisThread() const noexcept;
+	};
+}
+
+#endif
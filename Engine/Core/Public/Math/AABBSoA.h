@@ -0,0 +1,80 @@
+#ifndef MAUCOR_AABBSOA_H
+#define MAUCOR_AABBSOA_H
+
+#include "Math/AlignedAllocator.h"
+#include "Math/CullingKernels.h"
+
+#include <vector>
+
+namespace MauCor
+{
+	// Structure of arrays box store in the layout CullAABBs reads
+	class AABBSoA final
+	{
+	public:
+		AABBSoA() = default;
+		~AABBSoA() = default;
+
+		void Resize(std::size_t count)
+		{
+			for (auto* pStream : { &m_CenterX, &m_CenterY, &m_CenterZ, &m_ExtentX, &m_ExtentY, &m_ExtentZ })
+			{
+				pStream->resize(count);
+			}
+		}
+
+		void Clear() noexcept
+		{
+			for (auto* pStream : { &m_CenterX, &m_CenterY, &m_CenterZ, &m_ExtentX, &m_ExtentY, &m_ExtentZ })
+			{
+				pStream->clear();
+			}
+		}
+
+		void Add(AABB const& aabb)
+		{
+			Resize(Size() + 1);
+			Set(Size() - 1, aabb);
+		}
+
+		void Set(std::size_t idx, AABB const& aabb) noexcept
+		{
+			glm::vec3 const center{ aabb.Center() };
+			glm::vec3 const extents{ aabb.Extents() };
+
+			m_CenterX[idx] = center.x;
+			m_CenterY[idx] = center.y;
+			m_CenterZ[idx] = center.z;
+
+			m_ExtentX[idx] = extents.x;
+			m_ExtentY[idx] = extents.y;
+			m_ExtentZ[idx] = extents.z;
+		}
+
+		[[nodiscard]] std::size_t Size() const noexcept { return m_CenterX.size(); }
+
+		[[nodiscard]] AABBStreams Streams() const noexcept
+		{
+			return { m_CenterX.data(), m_CenterY.data(), m_CenterZ.data(), m_ExtentX.data(), m_ExtentY.data(), m_ExtentZ.data() };
+		}
+
+		AABBSoA(AABBSoA const&) = delete;
+		AABBSoA(AABBSoA&&) = delete;
+		AABBSoA& operator=(AABBSoA const&) = delete;
+		AABBSoA& operator=(AABBSoA&&) = delete;
+
+	private:
+		// 32 bytes, the width of an AVX register
+		using Stream = std::vector<float, AlignedAllocator<float, 32>>;
+
+		Stream m_CenterX{};
+		Stream m_CenterY{};
+		Stream m_CenterZ{};
+
+		Stream m_ExtentX{};
+		Stream m_ExtentY{};
+		Stream m_ExtentZ{};
+	};
+}
+
+#endif
@@ -0,0 +1,41 @@
+#ifndef MAUCOR_ALIGNEDALLOCATOR_H
+#define MAUCOR_ALIGNEDALLOCATOR_H
+
+#include <cstddef>
+#include <new>
+
+namespace MauCor
+{
+	// Allocator for over aligned arrays, so SIMD loads never straddle a cache line
+	// Not final, some standard libraries derive from the allocator to get the empty base optimisation
+	template<typename T, std::size_t Alignment>
+	struct AlignedAllocator
+	{
+		using value_type = T;
+
+		template<typename U>
+		struct rebind final
+		{
+			using other = AlignedAllocator<U, Alignment>;
+		};
+
+		AlignedAllocator() noexcept = default;
+		template<typename U>
+		AlignedAllocator(AlignedAllocator<U, Alignment> const&) noexcept {}
+
+		[[nodiscard]] T* allocate(std::size_t n)
+		{
+			return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t{ Alignment }));
+		}
+
+		void deallocate(T* p, std::size_t) noexcept
+		{
+			::operator delete(p, std::align_val_t{ Alignment });
+		}
+
+		template<typename U>
+		[[nodiscard]] bool operator==(AlignedAllocator<U, Alignment> const&) const noexcept { return true; }
+	};
+}
+
+#endif
@@ -0,0 +1,142 @@
+#ifndef MAUCOR_BOUNDS_H
+#define MAUCOR_BOUNDS_H
+
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include "glm/vec3.hpp"
+#include "glm/mat4x4.hpp"
+#include "glm/common.hpp"
+#include "glm/geometric.hpp"
+#include "glm/vector_relational.hpp"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+namespace MauCor
+{
+	// Axis aligned bounding box, default constructed boxes are empty (min > max) so growing them works without a special case
+	struct AABB final
+	{
+		glm::vec3 min{ FLT_MAX };
+		glm::vec3 max{ -FLT_MAX };
+
+		[[nodiscard]] bool IsValid() const noexcept { return min.x <= max.x && min.y <= max.y && min.z <= max.z; }
+
+		[[nodiscard]] glm::vec3 Center() const noexcept { return (min + max) * .5f; }
+		// Half the size along every axis
+		[[nodiscard]] glm::vec3 Extents() const noexcept { return (max - min) * .5f; }
+
+		// Used as the cost metric when building trees, the chance a random ray hits the box scales with it
+		[[nodiscard]] float SurfaceArea() const noexcept
+		{
+			glm::vec3 const size{ max - min };
+			return 2.f * (size.x * size.y + size.y * size.z + size.z * size.x);
+		}
+
+		void Grow(glm::vec3 const& point) noexcept
+		{
+			min = glm::min(min, point);
+			max = glm::max(max, point);
+		}
+
+		void Grow(AABB const& other) noexcept
+		{
+			min = glm::min(min, other.min);
+			max = glm::max(max, other.max);
+		}
+
+		[[nodiscard]] bool Contains(AABB const& other) const noexcept
+		{
+			return glm::all(glm::lessThanEqual(min, other.min)) && glm::all(glm::greaterThanEqual(max, other.max));
+		}
+
+		[[nodiscard]] bool Overlaps(AABB const& other) const noexcept
+		{
+			return glm::all(glm::lessThanEqual(min, other.max)) && glm::all(glm::greaterThanEqual(max, other.min));
+		}
+
+		[[nodiscard]] AABB Fattened(float margin) const noexcept
+		{
+			return AABB{ min - glm::vec3{ margin }, max + glm::vec3{ margin } };
+		}
+
+		// Bounds of the box after transforming it, tighter than transforming the 8 corners & cheaper too (Arvo)
+		[[nodiscard]] AABB Transformed(glm::mat4 const& mat) const noexcept
+		{
+			glm::vec3 const center{ mat * glm::vec4{ Center(), 1.f } };
+			glm::vec3 const extents{ Extents() };
+
+			glm::vec3 newExtents{};
+			for (int axis{ 0 }; axis < 3; ++axis)
+			{
+				newExtents[axis] = std::abs(mat[0][axis]) * extents.x
+					+ std::abs(mat[1][axis]) * extents.y
+					+ std::abs(mat[2][axis]) * extents.z;
+			}
+
+			return AABB{ center - newExtents, center + newExtents };
+		}
+
+		[[nodiscard]] static AABB Merge(AABB const& lhs, AABB const& rhs) noexcept
+		{
+			return AABB{ glm::min(lhs.min, rhs.min), glm::max(lhs.max, rhs.max) };
+		}
+
+		// Empty (invalid) when the boxes don't overlap
+		[[nodiscard]] static AABB Intersection(AABB const& lhs, AABB const& rhs) noexcept
+		{
+			return AABB{ glm::max(lhs.min, rhs.min), glm::min(lhs.max, rhs.max) };
+		}
+	};
+
+	struct BoundingSphere final
+	{
+		glm::vec3 center{};
+		float radius{ 0.f };
+
+		[[nodiscard]] bool Overlaps(AABB const& aabb) const noexcept
+		{
+			glm::vec3 const closest{ glm::clamp(center, aabb.min, aabb.max) };
+			glm::vec3 const offset{ closest - center };
+			return glm::dot(offset, offset) <= radius * radius;
+		}
+	};
+
+	struct Ray final
+	{
+		glm::vec3 origin{};
+		// Normalised, distances along the ray are in world units
+		glm::vec3 direction{ 0.f, 0.f, 1.f };
+
+		/**
+		 * @brief Slab test against a box.
+		 * @param aabb Box to test.
+		 * @param maxDistance Hits further away than this are ignored.
+		 * @param outDistance Distance to the entry point, 0 when the origin is inside the box.
+		 * @return True on a hit.
+		 */
+		[[nodiscard]] bool Intersects(AABB const& aabb, float maxDistance, float& outDistance) const noexcept
+		{
+			// Division by 0 gives +-inf, which the min/max below handle for axis aligned rays
+			glm::vec3 const invDirection{ 1.f / direction };
+			glm::vec3 const t0{ (aabb.min - origin) * invDirection };
+			glm::vec3 const t1{ (aabb.max - origin) * invDirection };
+
+			glm::vec3 const tMin{ glm::min(t0, t1) };
+			glm::vec3 const tMax{ glm::max(t0, t1) };
+
+			float const enter{ std::max({ tMin.x, tMin.y, tMin.z, 0.f }) };
+			float const exit{ std::min({ tMax.x, tMax.y, tMax.z, maxDistance }) };
+
+			if (enter > exit)
+			{
+				return false;
+			}
+
+			outDistance = enter;
+			return true;
+		}
+	};
+}
+
+#endif
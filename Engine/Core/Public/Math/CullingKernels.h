@@ -0,0 +1,34 @@
+#ifndef MAUCOR_CULLINGKERNELS_H
+#define MAUCOR_CULLINGKERNELS_H
+
+#include "Math/TransformKernels.h"
+#include "Math/Frustum.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace MauCor
+{
+	// Boxes as center & half size, one stream per component
+	struct AABBStreams final
+	{
+		float const* pCenterX{ nullptr };
+		float const* pCenterY{ nullptr };
+		float const* pCenterZ{ nullptr };
+
+		float const* pExtentX{ nullptr };
+		float const* pExtentY{ nullptr };
+		float const* pExtentZ{ nullptr };
+	};
+
+	/**
+	 * @brief Test boxes against the six planes of a frustum & keep the ones that are (partially) inside.
+	 * @param streams Boxes, indexed [begin, end).
+	 * @param pOutVisible Output, room for end - begin indices. Indices of the visible boxes are written in ascending order.
+	 * @param level SIMD path to use, SSE tests 4 & AVX2 8 boxes per iteration. Falls back to the highest supported level.
+	 * @return Number of visible boxes.
+	 */
+	[[nodiscard]] std::size_t CullAABBs(Frustum const& frustum, AABBStreams const& streams, uint32_t* pOutVisible, std::size_t begin, std::size_t end, ESIMDLevel level = GetSupportedSIMDLevel()) noexcept;
+}
+
+#endif
@@ -0,0 +1,226 @@
+#ifndef MAUCOR_DYNAMICBVH_H
+#define MAUCOR_DYNAMICBVH_H
+
+#include "Math/Bounds.h"
+#include "Math/Frustum.h"
+
+#include <concepts>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace MauCor
+{
+	// Dynamic bounding volume hierarchy over boxes that move, get added & get removed every frame (Box2D style)
+	// Leaves store a fattened box, a proxy that moves but stays inside it costs nothing. Once it leaves, it's removed & reinserted,
+	// which refits its ancestors. Insertion picks the sibling with the lowest surface area cost & rotations keep the tree balanced.
+	// Queries only read the tree, several threads may query at once as long as nobody modifies it.
+	class DynamicBVH final
+	{
+	public:
+		static constexpr int32_t NULL_NODE{ -1 };
+
+		/**
+		 * @param minMargin Boxes are fattened by at least this much on every side.
+		 * @param relativeMargin Boxes are also fattened by this fraction of their largest half size, so big & small objects reinsert about as often.
+		 */
+		explicit DynamicBVH(float minMargin = 0.1f, float relativeMargin = 0.1f) noexcept;
+		~DynamicBVH() = default;
+
+		// Returns the proxy ID, stable until the proxy is destroyed
+		[[nodiscard]] int32_t CreateProxy(AABB const& aabb, uint32_t userData);
+		void DestroyProxy(int32_t proxyID) noexcept;
+		// Returns true when the proxy had to be reinserted because it left its fattened box
+		bool MoveProxy(int32_t proxyID, AABB const& aabb);
+		void Clear() noexcept;
+
+		[[nodiscard]] uint32_t GetUserData(int32_t proxyID) const noexcept { return m_Nodes[proxyID].userData; }
+		[[nodiscard]] AABB const& GetFatAABB(int32_t proxyID) const noexcept { return m_Nodes[proxyID].aabb; }
+
+		// Bounds of everything in the tree (fattened), invalid when the tree is empty
+		[[nodiscard]] AABB GetBounds() const noexcept { return m_Root != NULL_NODE ? m_Nodes[m_Root].aabb : AABB{}; }
+		[[nodiscard]] std::size_t ProxyCount() const noexcept { return m_ProxyCount; }
+		// 0 for a single leaf, -1 when empty
+		[[nodiscard]] int32_t Height() const noexcept { return m_Root != NULL_NODE ? m_Nodes[m_Root].height : -1; }
+
+		// Calls func(proxyID) for every proxy whose fattened box overlaps the box
+		template<typename Func>
+			requires std::invocable<Func, int32_t>
+		void Query(AABB const& aabb, Func&& func) const
+		{
+			Traverse([&aabb](AABB const& nodeAABB) { return aabb.Overlaps(nodeAABB); }, func);
+		}
+
+		// Calls func(proxyID) for every proxy whose fattened box overlaps the sphere
+		template<typename Func>
+			requires std::invocable<Func, int32_t>
+		void Query(BoundingSphere const& sphere, Func&& func) const
+		{
+			Traverse([&sphere](AABB const& nodeAABB) { return sphere.Overlaps(nodeAABB); }, func);
+		}
+
+		// Calls func(proxyID) for every proxy whose fattened box is (partially) inside the frustum
+		// Subtrees that are completely inside are reported without testing their nodes
+		template<typename Func>
+			requires std::invocable<Func, int32_t>
+		void Query(Frustum const& frustum, Func&& func) const
+		{
+			if (m_Root == NULL_NODE)
+			{
+				return;
+			}
+
+			std::vector<std::pair<int32_t, bool>> stack{};
+			stack.reserve(64);
+			stack.emplace_back(m_Root, false);
+
+			while (!stack.empty())
+			{
+				auto const [nodeIdx, isInside] { stack.back() };
+				stack.pop_back();
+
+				Node const& node{ m_Nodes[nodeIdx] };
+
+				bool childrenInside{ isInside };
+				if (!isInside)
+				{
+					EFrustumTest const result{ frustum.Test(node.aabb) };
+					if (result == EFrustumTest::Outside)
+					{
+						continue;
+					}
+					childrenInside = result == EFrustumTest::Inside;
+				}
+
+				if (node.IsLeaf())
+				{
+					func(nodeIdx);
+					continue;
+				}
+
+				stack.emplace_back(node.left, childrenInside);
+				stack.emplace_back(node.right, childrenInside);
+			}
+		}
+
+		/**
+		 * @brief Cast a ray through the tree, nearest nodes are not guaranteed to be visited first.
+		 * @param func Called as func(proxyID, distance) for every fattened box the ray hits, returns the new max distance.
+		 *        Return the exact hit distance to only look for closer hits, or maxDistance to keep everything.
+		 */
+		template<typename Func>
+			requires std::invocable<Func, int32_t, float>
+		void Raycast(Ray const& ray, float maxDistance, Func&& func) const
+		{
+			if (m_Root == NULL_NODE)
+			{
+				return;
+			}
+
+			std::vector<int32_t> stack{};
+			stack.reserve(64);
+			stack.emplace_back(m_Root);
+
+			while (!stack.empty())
+			{
+				int32_t const nodeIdx{ stack.back() };
+				stack.pop_back();
+
+				Node const& node{ m_Nodes[nodeIdx] };
+
+				float distance{ 0.f };
+				if (!ray.Intersects(node.aabb, maxDistance, distance))
+				{
+					continue;
+				}
+
+				if (node.IsLeaf())
+				{
+					maxDistance = std::min(maxDistance, static_cast<float>(func(nodeIdx, distance)));
+					continue;
+				}
+
+				stack.emplace_back(node.left);
+				stack.emplace_back(node.right);
+			}
+		}
+
+		DynamicBVH(DynamicBVH const&) = delete;
+		DynamicBVH(DynamicBVH&&) = delete;
+		DynamicBVH& operator=(DynamicBVH const&) = delete;
+		DynamicBVH& operator=(DynamicBVH&&) = delete;
+
+	private:
+		struct Node final
+		{
+			AABB aabb{};
+
+			// Parent, or the next free node while the node is on the free list
+			int32_t parent{ NULL_NODE };
+			int32_t left{ NULL_NODE };
+			int32_t right{ NULL_NODE };
+
+			// Leaves are 0, free nodes -1
+			int32_t height{ -1 };
+			uint32_t userData{ 0 };
+
+			[[nodiscard]] bool IsLeaf() const noexcept { return left == NULL_NODE; }
+		};
+
+		std::vector<Node> m_Nodes{};
+		int32_t m_Root{ NULL_NODE };
+		int32_t m_FreeList{ NULL_NODE };
+		std::size_t m_ProxyCount{ 0 };
+
+		float m_MinMargin;
+		float m_RelativeMargin;
+
+		[[nodiscard]] int32_t AllocateNode();
+		void FreeNode(int32_t nodeIdx) noexcept;
+
+		void InsertLeaf(int32_t leafIdx);
+		void RemoveLeaf(int32_t leafIdx) noexcept;
+		// Walk from nodeIdx to the root, rebalancing & refitting every node on the way
+		void RefitAncestors(int32_t nodeIdx) noexcept;
+		// Rotates the node's subtree if it's unbalanced, returns the node that took its place
+		[[nodiscard]] int32_t Balance(int32_t nodeIdx) noexcept;
+
+		[[nodiscard]] AABB Fatten(AABB const& aabb) const noexcept;
+
+		template<typename NodeTest, typename Func>
+		void Traverse(NodeTest&& test, Func& func) const
+		{
+			if (m_Root == NULL_NODE)
+			{
+				return;
+			}
+
+			std::vector<int32_t> stack{};
+			stack.reserve(64);
+			stack.emplace_back(m_Root);
+
+			while (!stack.empty())
+			{
+				int32_t const nodeIdx{ stack.back() };
+				stack.pop_back();
+
+				Node const& node{ m_Nodes[nodeIdx] };
+				if (!test(node.aabb))
+				{
+					continue;
+				}
+
+				if (node.IsLeaf())
+				{
+					func(nodeIdx);
+					continue;
+				}
+
+				stack.emplace_back(node.left);
+				stack.emplace_back(node.right);
+			}
+		}
+	};
+}
+
+#endif
@@ -0,0 +1,90 @@
+#ifndef MAUCOR_FRUSTUM_H
+#define MAUCOR_FRUSTUM_H
+
+#include "Math/Bounds.h"
+
+#include <array>
+#include <cstdint>
+
+namespace MauCor
+{
+	enum class EFrustumTest : uint8_t
+	{
+		Outside,
+		Intersecting,
+		Inside
+	};
+
+	// Six planes of a camera frustum, extracted from a view projection matrix (depth in [0, 1])
+	struct Frustum final
+	{
+		// xyz is the normal pointing into the frustum, w the distance, a point is inside a plane when dot(xyz, p) + w >= 0
+		// Left, right, bottom, top, near, far
+		std::array<glm::vec4, 6> planes{};
+
+		[[nodiscard]] static Frustum FromViewProjection(glm::mat4 const& viewProj) noexcept
+		{
+			// Rows of the (column major) matrix, Gribb & Hartmann
+			auto const row{ [&viewProj](int r) { return glm::vec4{ viewProj[0][r], viewProj[1][r], viewProj[2][r], viewProj[3][r] }; } };
+			glm::vec4 const row0{ row(0) };
+			glm::vec4 const row1{ row(1) };
+			glm::vec4 const row2{ row(2) };
+			glm::vec4 const row3{ row(3) };
+
+			Frustum frustum{};
+			frustum.planes = { row3 + row0, row3 - row0, row3 + row1, row3 - row1, row2, row3 - row2 };
+
+			for (auto& plane : frustum.planes)
+			{
+				plane /= glm::length(glm::vec3{ plane });
+			}
+
+			return frustum;
+		}
+
+		[[nodiscard]] EFrustumTest Test(AABB const& aabb) const noexcept
+		{
+			glm::vec3 const center{ aabb.Center() };
+			glm::vec3 const extents{ aabb.Extents() };
+
+			EFrustumTest result{ EFrustumTest::Inside };
+			for (auto const& plane : planes)
+			{
+				glm::vec3 const normal{ plane };
+				float const distance{ glm::dot(normal, center) + plane.w };
+				// Projected half size of the box onto the plane normal
+				float const radius{ glm::dot(extents, glm::abs(normal)) };
+
+				if (distance < -radius)
+				{
+					return EFrustumTest::Outside;
+				}
+				if (distance < radius)
+				{
+					result = EFrustumTest::Intersecting;
+				}
+			}
+
+			return result;
+		}
+
+		[[nodiscard]] bool Intersects(AABB const& aabb) const noexcept
+		{
+			return Test(aabb) != EFrustumTest::Outside;
+		}
+
+		[[nodiscard]] bool Intersects(BoundingSphere const& sphere) const noexcept
+		{
+			for (auto const& plane : planes)
+			{
+				if (glm::dot(glm::vec3{ plane }, sphere.center) + plane.w < -sphere.radius)
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+	};
+}
+
+#endif
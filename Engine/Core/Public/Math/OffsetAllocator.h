@@ -0,0 +1,94 @@
+#ifndef MAUCOR_OFFSETALLOCATOR_H
+#define MAUCOR_OFFSETALLOCATOR_H
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace MauCor
+{
+	// Hands out ranges of an address space that lives somewhere else (e.g. a GPU buffer), in whatever unit the caller uses
+	// Two level segregated fit (TLSF): free ranges are binned by size on a small float scale (8 bins per power of two),
+	// bitmasks find the first bin that is large enough. Allocate & Free are O(1), freed ranges merge with free neighbours right away.
+	class OffsetAllocator final
+	{
+	public:
+		static constexpr uint32_t NO_SPACE{ UINT32_MAX };
+
+		struct Allocation final
+		{
+			uint32_t offset{ NO_SPACE };
+			// Node of the allocation, needed to free it
+			uint32_t metadata{ NO_SPACE };
+
+			[[nodiscard]] bool IsValid() const noexcept { return offset != NO_SPACE; }
+		};
+
+		struct StorageReport final
+		{
+			uint32_t totalFreeSpace;
+			uint32_t largestFreeRegion;
+		};
+
+		// Every allocation & every free range between them takes a node, so maxAllocations is best about twice the live allocations
+		explicit OffsetAllocator(uint32_t size, uint32_t maxAllocations = 128 * 1024);
+		~OffsetAllocator() = default;
+
+		// Returns an invalid allocation when there is no range large enough or no node left
+		[[nodiscard]] Allocation Allocate(uint32_t size) noexcept;
+		void Free(Allocation allocation) noexcept;
+		// Frees everything
+		void Reset();
+
+		[[nodiscard]] uint32_t GetAllocationSize(Allocation allocation) const noexcept;
+		[[nodiscard]] StorageReport GetStorageReport() const noexcept;
+		[[nodiscard]] uint32_t GetSize() const noexcept { return m_Size; }
+
+		OffsetAllocator(OffsetAllocator const&) = default;
+		OffsetAllocator(OffsetAllocator&&) = default;
+		OffsetAllocator& operator=(OffsetAllocator const&) = default;
+		OffsetAllocator& operator=(OffsetAllocator&&) = default;
+
+	private:
+		static constexpr uint32_t TOP_BIN_COUNT{ 32 };
+		static constexpr uint32_t BINS_PER_LEAF{ 8 };
+		static constexpr uint32_t LEAF_BIN_COUNT{ TOP_BIN_COUNT * BINS_PER_LEAF };
+		static constexpr uint32_t UNUSED{ UINT32_MAX };
+
+		struct Node final
+		{
+			uint32_t offset{ 0 };
+			uint32_t size{ 0 };
+
+			// Free ranges of the same bin
+			uint32_t binPrev{ UNUSED };
+			uint32_t binNext{ UNUSED };
+			// Ranges next to this one in the address space, used or not
+			uint32_t neighbourPrev{ UNUSED };
+			uint32_t neighbourNext{ UNUSED };
+
+			bool isUsed{ false };
+		};
+
+		uint32_t m_Size;
+		uint32_t m_MaxAllocations;
+		uint32_t m_FreeStorage{ 0 };
+
+		// Bit per top bin that has a non empty leaf bin, bit per leaf bin that has a free range
+		uint32_t m_UsedBinsTop{ 0 };
+		std::array<uint8_t, TOP_BIN_COUNT> m_UsedBins{};
+		// First free range of each leaf bin
+		std::array<uint32_t, LEAF_BIN_COUNT> m_BinHeads{};
+
+		std::vector<Node> m_Nodes;
+		std::vector<uint32_t> m_FreeNodes;
+
+		uint32_t InsertNodeIntoBin(uint32_t size, uint32_t offset) noexcept;
+		// Unlinks & releases the node
+		void RemoveNodeFromBin(uint32_t nodeIdx) noexcept;
+		// Only unlinks, the node stays valid
+		void UnlinkFromBin(uint32_t nodeIdx) noexcept;
+	};
+}
+
+#endif
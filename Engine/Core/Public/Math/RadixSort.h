@@ -0,0 +1,19 @@
+#ifndef MAUCOR_RADIXSORT_H
+#define MAUCOR_RADIXSORT_H
+
+#include <cstdint>
+#include <vector>
+
+namespace MauCor
+{
+	/**
+	 * @brief Stable LSD radix sort of 64 bit keys & the values that go with them, 8 bits per pass.
+	 * Passes where every key has the same byte are skipped, so keys that only use part of their bits only pay for those.
+	 * @param keys Sorted in place.
+	 * @param values Same size as keys, moved along with their key.
+	 * @param keyScratch, valueScratch Resized to the key count, owned by the caller so repeated sorts don't reallocate. May be swapped with keys & values.
+	 */
+	void RadixSort(std::vector<uint64_t>& keys, std::vector<uint32_t>& values, std::vector<uint64_t>& keyScratch, std::vector<uint32_t>& valueScratch) noexcept;
+}
+
+#endif
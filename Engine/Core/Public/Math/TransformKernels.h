@@ -0,0 +1,45 @@
+#ifndef MAUCOR_TRANSFORMKERNELS_H
+#define MAUCOR_TRANSFORMKERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace MauCor
+{
+	enum class ESIMDLevel : uint8_t
+	{
+		Scalar,
+		SSE,
+		AVX2
+	};
+
+	// Highest SIMD level the CPU running the engine supports, detected once
+	[[nodiscard]] ESIMDLevel GetSupportedSIMDLevel() noexcept;
+
+	// Translation, rotation (quaternion) & scale of a range of entities, one stream per component
+	struct TRSStreams final
+	{
+		float const* pTranslationX{ nullptr };
+		float const* pTranslationY{ nullptr };
+		float const* pTranslationZ{ nullptr };
+
+		float const* pRotationX{ nullptr };
+		float const* pRotationY{ nullptr };
+		float const* pRotationZ{ nullptr };
+		float const* pRotationW{ nullptr };
+
+		float const* pScaleX{ nullptr };
+		float const* pScaleY{ nullptr };
+		float const* pScaleZ{ nullptr };
+	};
+
+	/**
+	 * @brief Build translate * rotate * scale matrices straight from the streams, without any intermediate matrices.
+	 * @param streams TRS input, indexed [begin, end).
+	 * @param pOutMatrices Output, 16 floats per entity in glm's column major layout (so a glm::mat4 array can be passed), indexed [begin, end).
+	 * @param level SIMD path to use, SSE handles 4 & AVX2 8 entities per iteration. Falls back to the highest supported level.
+	 */
+	void ComposeTRSMatrices(TRSStreams const& streams, float* pOutMatrices, std::size_t begin, std::size_t end, ESIMDLevel level = GetSupportedSIMDLevel()) noexcept;
+}
+
+#endif
@@ -0,0 +1,78 @@
+#ifndef MAUCOR_TRANSFORMSOA_H
+#define MAUCOR_TRANSFORMSOA_H
+
+#include "Math/TransformKernels.h"
+#include "Math/Rotator.h"
+#include "Math/AlignedAllocator.h"
+
+#include <span>
+#include <vector>
+
+namespace MauCor
+{
+	// Opt-in structure of arrays transform store, for large sets of transforms that are updated together (instanced props, particles, ...)
+	// Every component lives in its own stream so the matrices can be built with the SIMD kernels in ComposeTRSMatrices.
+	class TransformSoA final
+	{
+	public:
+		TransformSoA() = default;
+		~TransformSoA() = default;
+
+		void Reserve(std::size_t count);
+		// New transforms are identity transforms
+		void Resize(std::size_t count);
+		void Clear() noexcept;
+
+		// Returns the index of the new transform
+		uint32_t Add(glm::vec3 const& translation = {}, Rotator const& rotation = {}, glm::vec3 const& scale = glm::vec3{ 1.f });
+		// Swap the last transform into idx & shrink, indices of other transforms stay valid except for the last one
+		void RemoveSwapBack(uint32_t idx) noexcept;
+
+		[[nodiscard]] std::size_t Size() const noexcept { return m_TranslationX.size(); }
+
+		void SetTranslation(uint32_t idx, glm::vec3 const& translation) noexcept;
+		void SetRotation(uint32_t idx, Rotator const& rotation) noexcept;
+		void SetScale(uint32_t idx, glm::vec3 const& scale) noexcept;
+
+		void Translate(uint32_t idx, glm::vec3 const& translation) noexcept;
+		void Rotate(uint32_t idx, Rotator const& rotation) noexcept;
+		void Scale(uint32_t idx, glm::vec3 const& scale) noexcept;
+
+		[[nodiscard]] glm::vec3 GetTranslation(uint32_t idx) const noexcept;
+		[[nodiscard]] Rotator GetRotation(uint32_t idx) const noexcept;
+		[[nodiscard]] glm::vec3 GetScale(uint32_t idx) const noexcept;
+
+		[[nodiscard]] TRSStreams Streams() const noexcept;
+
+		/**
+		 * @brief Build the matrices of all transforms, split up over the job system.
+		 * @param outMatrices Output, at least Size() matrices.
+		 * @param level SIMD path to use (mostly useful for benchmarking), defaults to the best the CPU supports.
+		 */
+		void ComputeMatrices(std::span<glm::mat4> outMatrices, ESIMDLevel level = GetSupportedSIMDLevel()) const noexcept;
+
+		TransformSoA(TransformSoA const&) = delete;
+		TransformSoA(TransformSoA&&) = delete;
+		TransformSoA& operator=(TransformSoA const&) = delete;
+		TransformSoA& operator=(TransformSoA&&) = delete;
+
+	private:
+		// 32 bytes, the width of an AVX register
+		using Stream = std::vector<float, AlignedAllocator<float, 32>>;
+
+		Stream m_TranslationX{};
+		Stream m_TranslationY{};
+		Stream m_TranslationZ{};
+
+		Stream m_RotationX{};
+		Stream m_RotationY{};
+		Stream m_RotationZ{};
+		Stream m_RotationW{};
+
+		Stream m_ScaleX{};
+		Stream m_ScaleY{};
+		Stream m_ScaleZ{};
+	};
+}
+
+#endif
@@ -0,0 +1,93 @@
+#include "CommandBuffer.h"
+
+#include <algorithm>
+
+namespace MauEng::ECS
+{
+	CommandBuffer::CommandBuffer() :
+		CommandBuffer{ [](ECSWorld& world, EntityID id) { world.DestroyEntity(id); } }
+	{
+	}
+
+	CommandBuffer::CommandBuffer(DestroyEntityFunction destroyEntity) :
+		m_DestroyEntity{ std::move(destroyEntity) },
+		m_pThreadBuffers{ std::make_unique<ThreadBuffer[]>(JOB_SYSTEM.NumThreadIndices()) },
+		m_NumThreadBuffers{ JOB_SYSTEM.NumThreadIndices() }
+	{
+	}
+
+	void CommandBuffer::DestroyEntity(EntityID id)
+	{
+		Record([this, id](ECSWorld& world)
+			{
+				m_DestroyEntity(world, id);
+			}, id);
+	}
+
+	void CommandBuffer::Playback(ECSWorld& world)
+	{
+		ME_PROFILE_FUNCTION()
+
+		m_PlaybackOrder.clear();
+
+		uint32_t usedBuffers{ 0 };
+		for (uint32_t i{ 0 }; i < m_NumThreadBuffers; ++i)
+		{
+			auto& buffer{ m_pThreadBuffers[i] };
+			std::scoped_lock const lock{ buffer.mutex };
+
+			if (buffer.commands.empty())
+			{
+				continue;
+			}
+
+			++usedBuffers;
+			for (auto& command : buffer.commands)
+			{
+				m_PlaybackOrder.emplace_back(&command);
+			}
+		}
+
+		if (m_PlaybackOrder.empty())
+		{
+			return;
+		}
+
+		// Each buffer is already in order, only commands recorded on multiple threads have to be merged
+		if (usedBuffers > 1)
+		{
+			std::ranges::sort(m_PlaybackOrder, {}, &RecordedCommand::sequence);
+		}
+
+		for (RecordedCommand* pCommand : m_PlaybackOrder)
+		{
+			// The entity may have been destroyed by an earlier command or outside of the buffer
+			if (pCommand->target != NULL_ENTITY_ID && !world.IsValid(pCommand->target))
+			{
+				continue;
+			}
+
+			pCommand->command(world);
+		}
+
+		m_PlaybackOrder.clear();
+		for (uint32_t i{ 0 }; i < m_NumThreadBuffers; ++i)
+		{
+			m_pThreadBuffers[i].commands.clear();
+		}
+	}
+
+	bool CommandBuffer::Empty() const noexcept
+	{
+		for (uint32_t i{ 0 }; i < m_NumThreadBuffers; ++i)
+		{
+			std::scoped_lock const lock{ m_pThreadBuffers[i].mutex };
+			if (!m_pThreadBuffers[i].commands.empty())
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+}
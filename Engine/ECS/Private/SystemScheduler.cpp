@@ -0,0 +1,169 @@
+#include "SystemScheduler.h"
+
+#include <algorithm>
+
+namespace MauEng::ECS
+{
+	namespace
+	{
+		[[nodiscard]] bool Intersects(std::vector<uint32_t> const& lhs, std::vector<uint32_t> const& rhs) noexcept
+		{
+			auto lhsIt{ lhs.begin() };
+			auto rhsIt{ rhs.begin() };
+			while (lhsIt != lhs.end() && rhsIt != rhs.end())
+			{
+				if (*lhsIt == *rhsIt)
+				{
+					return true;
+				}
+
+				*lhsIt < *rhsIt ? ++lhsIt : ++rhsIt;
+			}
+			return false;
+		}
+	}
+
+	void SystemScheduler::Add(System&& system)
+	{
+		for (auto* pTypes : { &system.reads, &system.writes })
+		{
+			std::ranges::sort(*pTypes);
+			auto const [first, last] { std::ranges::unique(*pTypes) };
+			pTypes->erase(first, last);
+		}
+
+		// Writing implies reading, keep a type in one set only
+		std::erase_if(system.reads, [&system](uint32_t type) { return std::ranges::binary_search(system.writes, type); });
+
+		m_Systems.emplace_back(std::move(system));
+		m_IsGraphDirty = true;
+	}
+
+	bool SystemScheduler::Conflicts(System const& lhs, System const& rhs) noexcept
+	{
+		return Intersects(lhs.writes, rhs.writes)
+			|| Intersects(lhs.writes, rhs.reads)
+			|| Intersects(lhs.reads, rhs.writes);
+	}
+
+	void SystemScheduler::BuildGraph(ECSWorld& world)
+	{
+		ME_PROFILE_FUNCTION()
+
+		m_IsGraphDirty = false;
+		m_pPreparedWorld = &world;
+		m_Phases.clear();
+
+		for (auto& system : m_Systems)
+		{
+			system.dependents.clear();
+			system.dependencyCount = 0;
+		}
+
+		auto const systemCount{ static_cast<uint32_t>(m_Systems.size()) };
+		for (uint32_t i{ 0 }; i < systemCount; ++i)
+		{
+			if (m_Systems[i].isMainThread)
+			{
+				m_Phases.emplace_back(i, i + 1, true);
+				continue;
+			}
+
+			if (m_Phases.empty() || m_Phases.back().isMainThread)
+			{
+				m_Phases.emplace_back(i, i, false);
+			}
+			Phase& phase{ m_Phases.back() };
+
+			// Systems keep the order they were added in, a system waits for every earlier conflicting system of its phase
+			for (uint32_t j{ phase.begin }; j < i; ++j)
+			{
+				if (Conflicts(m_Systems[j], m_Systems[i]))
+				{
+					m_Systems[j].dependents.emplace_back(i);
+					++m_Systems[i].dependencyCount;
+				}
+			}
+
+			phase.end = i + 1;
+		}
+
+		m_RemainingDependencies = std::make_unique<std::atomic<uint32_t>[]>(m_Systems.size());
+
+		// Storages are never destroyed, creating them once per schedule is enough
+		for (auto const& system : m_Systems)
+		{
+			if (system.createStorages)
+			{
+				system.createStorages(world);
+			}
+		}
+	}
+
+	void SystemScheduler::Run(ECSWorld& world)
+	{
+		ME_PROFILE_FUNCTION()
+
+		if (m_IsGraphDirty || m_pPreparedWorld != &world)
+		{
+			BuildGraph(world);
+		}
+
+		for (auto const& phase : m_Phases)
+		{
+			if (phase.isMainThread)
+			{
+				m_Systems[phase.begin].func(world);
+			}
+			else
+			{
+				RunPhase(world, phase);
+			}
+		}
+	}
+
+	void SystemScheduler::RunPhase(ECSWorld& world, Phase const& phase)
+	{
+		// Not worth scheduling, or nobody to schedule on
+		if (phase.end - phase.begin == 1 || JOB_SYSTEM.NumWorkers() == 0)
+		{
+			for (uint32_t i{ phase.begin }; i < phase.end; ++i)
+			{
+				m_Systems[i].func(world);
+			}
+			return;
+		}
+
+		for (uint32_t i{ phase.begin }; i < phase.end; ++i)
+		{
+			m_RemainingDependencies[i].store(m_Systems[i].dependencyCount, std::memory_order_relaxed);
+		}
+
+		MauCor::JobCounter counter{};
+
+		// Every finished system releases its dependents, the last dependency to finish schedules them
+		std::function<void(uint32_t)> runSystem{};
+		runSystem = [&](uint32_t idx)
+			{
+				m_Systems[idx].func(world);
+
+				for (uint32_t const dependent : m_Systems[idx].dependents)
+				{
+					if (m_RemainingDependencies[dependent].fetch_sub(1, std::memory_order_acq_rel) == 1)
+					{
+						JOB_SYSTEM.Schedule([&runSystem, dependent]() { runSystem(dependent); }, &counter);
+					}
+				}
+			};
+
+		for (uint32_t i{ phase.begin }; i < phase.end; ++i)
+		{
+			if (m_Systems[i].dependencyCount == 0)
+			{
+				JOB_SYSTEM.Schedule([&runSystem, i]() { runSystem(i); }, &counter);
+			}
+		}
+
+		JOB_SYSTEM.Wait(counter);
+	}
+}
@@ -0,0 +1,392 @@
+#include "WorldSnapshot.h"
+
+#include <fstream>
+#include <unordered_map>
+
+namespace MauEng::ECS
+{
+	namespace
+	{
+		uint32_t constexpr SNAPSHOT_MAGIC{ 0x4E53454D }; // "MESN"
+		// Raw arrays start on a cache line, so they can be used straight from the mapped file
+		uint64_t constexpr DATA_ALIGNMENT{ 64 };
+
+		struct FileHeader final
+		{
+			uint32_t magic;
+			uint32_t version;
+			uint32_t entityCount;
+			uint32_t blockCount;
+			uint32_t pathCount;
+			uint32_t padding;
+			uint64_t pathTableOffset;
+		};
+
+		struct BlockHeader final
+		{
+			uint64_t typeHash;
+			uint32_t isAsset;
+			uint32_t componentSize;
+			uint32_t count;
+			uint32_t padding;
+			// uint32_t per component, index into the snapshot's entities
+			uint64_t entitiesOffset;
+			// Raw components, or a uint32_t path index per component for asset components
+			uint64_t dataOffset;
+		};
+
+		[[nodiscard]] uint64_t AlignUp(uint64_t value, uint64_t alignment) noexcept
+		{
+			return (value + alignment - 1) / alignment * alignment;
+		}
+
+		void WriteAt(std::vector<std::byte>& file, uint64_t offset, void const* pData, std::size_t size)
+		{
+			if (file.size() < offset + size)
+			{
+				file.resize(offset + size);
+			}
+			std::memcpy(file.data() + offset, pData, size);
+		}
+
+		[[nodiscard]] bool IsInBounds(std::size_t fileSize, uint64_t offset, uint64_t size) noexcept
+		{
+			return offset <= fileSize && size <= fileSize - offset;
+		}
+	}
+
+	void WorldSnapshot::AddEntry(ComponentEntry&& entry)
+	{
+		if (FindEntry(entry.typeHash))
+		{
+			ME_LOG_ERROR(LogEngine, "Snapshot component type {} is registered twice", entry.name);
+			return;
+		}
+
+		m_Components.emplace_back(std::move(entry));
+	}
+
+	WorldSnapshot::ComponentEntry const* WorldSnapshot::FindEntry(uint64_t typeHash) const noexcept
+	{
+		auto const it{ std::ranges::find(m_Components, typeHash, &ComponentEntry::typeHash) };
+		return it != end(m_Components) ? &*it : nullptr;
+	}
+
+	bool WorldSnapshot::Save(ECSWorld const& world, char const* path) const
+	{
+		ME_PROFILE_FUNCTION()
+
+		struct GatheredBlock final
+		{
+			ComponentEntry const* pEntry;
+			std::vector<EntityID> entities;
+			std::vector<std::byte> data;
+			std::vector<std::string> paths;
+		};
+
+		std::vector<GatheredBlock> blocks(m_Components.size());
+		for (std::size_t i{ 0 }; i < m_Components.size(); ++i)
+		{
+			blocks[i].pEntry = &m_Components[i];
+			m_Components[i].gather(world, blocks[i].entities, blocks[i].data, blocks[i].paths);
+		}
+
+		// Snapshot entities are numbered in the order they are first seen
+		std::unordered_map<EntityID, uint32_t> entityIndices{};
+		std::unordered_map<std::string, uint32_t> pathIndices{};
+		std::vector<std::string const*> pathTable{};
+
+		for (auto const& block : blocks)
+		{
+			for (EntityID const id : block.entities)
+			{
+				entityIndices.try_emplace(id, static_cast<uint32_t>(entityIndices.size()));
+			}
+
+			for (auto const& assetPath : block.paths)
+			{
+				if (auto const [it, inserted] { pathIndices.try_emplace(assetPath, static_cast<uint32_t>(pathTable.size())) }; inserted)
+				{
+					pathTable.emplace_back(&it->first);
+				}
+			}
+		}
+
+		std::vector<std::byte> file{};
+
+		FileHeader header{};
+		header.magic = SNAPSHOT_MAGIC;
+		header.version = VERSION;
+		header.entityCount = static_cast<uint32_t>(entityIndices.size());
+		header.blockCount = static_cast<uint32_t>(blocks.size());
+		header.pathCount = static_cast<uint32_t>(pathTable.size());
+
+		uint64_t offset{ sizeof(FileHeader) + blocks.size() * sizeof(BlockHeader) };
+		std::vector<uint32_t> indices{};
+
+		for (std::size_t b{ 0 }; b < blocks.size(); ++b)
+		{
+			auto const& block{ blocks[b] };
+
+			BlockHeader blockHeader{};
+			blockHeader.typeHash = block.pEntry->typeHash;
+			blockHeader.isAsset = block.pEntry->isAsset;
+			blockHeader.componentSize = block.pEntry->isAsset ? sizeof(uint32_t) : block.pEntry->size;
+			blockHeader.count = static_cast<uint32_t>(block.entities.size());
+
+			indices.clear();
+			for (EntityID const id : block.entities)
+			{
+				indices.emplace_back(entityIndices.at(id));
+			}
+
+			blockHeader.entitiesOffset = offset;
+			WriteAt(file, offset, indices.data(), indices.size() * sizeof(uint32_t));
+			offset = AlignUp(offset + indices.size() * sizeof(uint32_t), DATA_ALIGNMENT);
+
+			blockHeader.dataOffset = offset;
+			if (block.pEntry->isAsset)
+			{
+				indices.clear();
+				for (auto const& assetPath : block.paths)
+				{
+					indices.emplace_back(pathIndices.at(assetPath));
+				}
+
+				WriteAt(file, offset, indices.data(), indices.size() * sizeof(uint32_t));
+				offset += indices.size() * sizeof(uint32_t);
+			}
+			else
+			{
+				WriteAt(file, offset, block.data.data(), block.data.size());
+				offset += block.data.size();
+			}
+			offset = AlignUp(offset, DATA_ALIGNMENT);
+
+			WriteAt(file, sizeof(FileHeader) + b * sizeof(BlockHeader), &blockHeader, sizeof(BlockHeader));
+		}
+
+		// Path table, a length followed by the characters for every path
+		header.pathTableOffset = offset;
+		for (std::string const* pPath : pathTable)
+		{
+			auto const length{ static_cast<uint32_t>(pPath->size()) };
+			WriteAt(file, offset, &length, sizeof(uint32_t));
+			WriteAt(file, offset + sizeof(uint32_t), pPath->data(), length);
+			offset += sizeof(uint32_t) + length;
+		}
+
+		WriteAt(file, 0, &header, sizeof(FileHeader));
+		file.resize(offset);
+
+		std::ofstream out{ path, std::ios::binary | std::ios::trunc };
+		if (!out)
+		{
+			ME_LOG_ERROR(LogEngine, "Could not open {} to save the snapshot", path);
+			return false;
+		}
+
+		out.write(reinterpret_cast<char const*>(file.data()), static_cast<std::streamsize>(file.size()));
+		return static_cast<bool>(out);
+	}
+
+	bool WorldSnapshot::Load(ECSWorld& world, char const* path, std::vector<EntityID>* pOutEntities) const
+	{
+		PreparedSnapshot prepared{};
+		if (!Prepare(path, prepared))
+		{
+			return false;
+		}
+
+		Instantiate(world, prepared, pOutEntities);
+		return true;
+	}
+
+	bool WorldSnapshot::Prepare(char const* path, PreparedSnapshot& outPrepared) const
+	{
+		ME_PROFILE_FUNCTION()
+
+		ME_ASSERT(!outPrepared.IsValid());
+
+		MauCor::MappedFile& file{ outPrepared.m_File };
+		if (!file.Open(path))
+		{
+			ME_LOG_ERROR(LogEngine, "Could not open snapshot {}", path);
+			return false;
+		}
+
+		auto const data{ file.Data() };
+		std::byte const* const pBase{ data.data() };
+
+		// Close the file again on failure, so the prepared snapshot isn't mistaken for a valid one
+		auto const fail{ [&outPrepared]()
+			{
+				outPrepared.m_File.Close();
+				outPrepared.m_PathTable.clear();
+				outPrepared.m_Blocks.clear();
+				outPrepared.m_EntityCount = 0;
+				return false;
+			} };
+
+		if (data.size() < sizeof(FileHeader))
+		{
+			ME_LOG_ERROR(LogEngine, "Snapshot {} is too small", path);
+			return fail();
+		}
+
+		FileHeader header{};
+		std::memcpy(&header, pBase, sizeof(FileHeader));
+
+		if (header.magic != SNAPSHOT_MAGIC || header.version != VERSION)
+		{
+			ME_LOG_ERROR(LogEngine, "Snapshot {} is not a snapshot of version {}", path, VERSION);
+			return fail();
+		}
+
+		if (!IsInBounds(data.size(), sizeof(FileHeader), static_cast<uint64_t>(header.blockCount) * sizeof(BlockHeader))
+			|| !IsInBounds(data.size(), header.pathTableOffset, 0))
+		{
+			ME_LOG_ERROR(LogEngine, "Snapshot {} is corrupt", path);
+			return fail();
+		}
+
+		// Validate every block before touching the world, so a corrupt file doesn't leave a half loaded world behind
+		std::vector<BlockHeader> blockHeaders(header.blockCount);
+		std::memcpy(blockHeaders.data(), pBase + sizeof(FileHeader), blockHeaders.size() * sizeof(BlockHeader));
+
+		for (auto const& block : blockHeaders)
+		{
+			if (!IsInBounds(data.size(), block.entitiesOffset, static_cast<uint64_t>(block.count) * sizeof(uint32_t))
+				|| !IsInBounds(data.size(), block.dataOffset, static_cast<uint64_t>(block.count) * block.componentSize)
+				|| block.dataOffset % DATA_ALIGNMENT != 0)
+			{
+				ME_LOG_ERROR(LogEngine, "Snapshot {} is corrupt", path);
+				return fail();
+			}
+		}
+
+		auto& pathTable{ outPrepared.m_PathTable };
+		pathTable.reserve(header.pathCount);
+		uint64_t pathOffset{ header.pathTableOffset };
+		for (uint32_t i{ 0 }; i < header.pathCount; ++i)
+		{
+			uint32_t length{ 0 };
+			if (!IsInBounds(data.size(), pathOffset, sizeof(uint32_t)))
+			{
+				ME_LOG_ERROR(LogEngine, "Snapshot {} is corrupt", path);
+				return fail();
+			}
+			std::memcpy(&length, pBase + pathOffset, sizeof(uint32_t));
+			pathOffset += sizeof(uint32_t);
+
+			if (!IsInBounds(data.size(), pathOffset, length))
+			{
+				ME_LOG_ERROR(LogEngine, "Snapshot {} is corrupt", path);
+				return fail();
+			}
+			pathTable.emplace_back(reinterpret_cast<char const*>(pBase + pathOffset), length);
+			pathOffset += length;
+		}
+
+		outPrepared.m_EntityCount = header.entityCount;
+		outPrepared.m_Blocks.reserve(blockHeaders.size());
+
+		for (auto const& block : blockHeaders)
+		{
+			ComponentEntry const* pEntry{ FindEntry(block.typeHash) };
+			// Asset blocks hold a path index per component, anything else would read past the block
+			if (!pEntry || pEntry->isAsset != static_cast<bool>(block.isAsset) || block.componentSize != (pEntry->isAsset ? sizeof(uint32_t) : pEntry->size))
+			{
+				ME_LOG_WARN(LogEngine, "Skipping an unknown or changed component type in snapshot {}", path);
+				continue;
+			}
+
+			uint32_t const* pIndices{ reinterpret_cast<uint32_t const*>(pBase + block.entitiesOffset) };
+			for (uint32_t i{ 0 }; i < block.count; ++i)
+			{
+				if (pIndices[i] >= header.entityCount)
+				{
+					ME_LOG_ERROR(LogEngine, "Snapshot {} is corrupt", path);
+					return fail();
+				}
+			}
+
+			auto& prepared{ outPrepared.m_Blocks.emplace_back() };
+			prepared.componentIdx = static_cast<uint32_t>(pEntry - m_Components.data());
+
+			if (!pEntry->isAsset)
+			{
+				prepared.entityIndices.assign(pIndices, pIndices + block.count);
+				prepared.pData = pBase + block.dataOffset;
+				continue;
+			}
+
+			// Group the entities per asset, so each asset is only created once
+			uint32_t const* pPathIndices{ reinterpret_cast<uint32_t const*>(pBase + block.dataOffset) };
+			auto& assetOffsets{ prepared.assetOffsets };
+			assetOffsets.assign(pathTable.size() + 1, 0);
+			for (uint32_t i{ 0 }; i < block.count; ++i)
+			{
+				if (pPathIndices[i] >= pathTable.size())
+				{
+					ME_LOG_ERROR(LogEngine, "Snapshot {} is corrupt", path);
+					return fail();
+				}
+				++assetOffsets[pPathIndices[i] + 1];
+			}
+			for (std::size_t p{ 1 }; p < assetOffsets.size(); ++p)
+			{
+				assetOffsets[p] += assetOffsets[p - 1];
+			}
+
+			prepared.entityIndices.resize(block.count);
+			std::vector<uint32_t> cursors{ assetOffsets.begin(), assetOffsets.end() - 1 };
+			for (uint32_t i{ 0 }; i < block.count; ++i)
+			{
+				prepared.entityIndices[cursors[pPathIndices[i]]++] = pIndices[i];
+			}
+		}
+
+		return true;
+	}
+
+	void WorldSnapshot::Instantiate(ECSWorld& world, PreparedSnapshot const& prepared, std::vector<EntityID>* pOutEntities) const
+	{
+		ME_PROFILE_FUNCTION()
+
+		ME_ASSERT(prepared.IsValid());
+
+		std::vector<EntityID> entities(prepared.m_EntityCount);
+		world.CreateEntities(entities.size(), entities);
+
+		std::vector<EntityID> blockEntities{};
+		for (auto const& block : prepared.m_Blocks)
+		{
+			ME_ASSERT(block.componentIdx < m_Components.size());
+			ComponentEntry const& entry{ m_Components[block.componentIdx] };
+
+			blockEntities.resize(block.entityIndices.size());
+			std::ranges::transform(block.entityIndices, blockEntities.begin(), [&entities](uint32_t idx) { return entities[idx]; });
+
+			if (!entry.isAsset)
+			{
+				entry.insertRaw(world, blockEntities, block.pData);
+				continue;
+			}
+
+			for (std::size_t p{ 0 }; p < prepared.m_PathTable.size(); ++p)
+			{
+				std::span<EntityID const> const group{ blockEntities.data() + block.assetOffsets[p], block.assetOffsets[p + 1] - block.assetOffsets[p] };
+				if (!group.empty())
+				{
+					entry.createFromAsset(world, prepared.m_PathTable[p], group);
+				}
+			}
+		}
+
+		if (pOutEntities)
+		{
+			*pOutEntities = std::move(entities);
+		}
+	}
+}
@@ -0,0 +1,143 @@
+#ifndef MAUENG_COMMANDBUFFER_H
+#define MAUENG_COMMANDBUFFER_H
+
+#include "ECSWorld.h"
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace MauEng::ECS
+{
+	template<typename Func>
+	concept EntityInitCallable = std::invocable<Func, ECSWorld&, EntityID>;
+
+	template<typename Func>
+	concept WorldCommandCallable = std::invocable<Func, ECSWorld&>;
+
+	// How an entity recorded with DestroyEntity is torn down on playback
+	using DestroyEntityFunction = std::function<void(ECSWorld&, EntityID)>;
+
+	// Records structural changes (creating & destroying entities, adding & removing components) so they can be applied later at one point in the frame.
+	// Recording is safe from inside a View::Each & from any thread, every thread of the job system records into its own buffer.
+	// Playback applies the commands in the order they were recorded, commands on entities that were destroyed in the meantime are skipped.
+	class CommandBuffer final
+	{
+	public:
+		// Destroys entities with ECSWorld::DestroyEntity, which skips the pre remove callbacks
+		CommandBuffer();
+		// Destroys entities with the given function, e.g. to also destroy their children & run the pre remove callbacks
+		explicit CommandBuffer(DestroyEntityFunction destroyEntity);
+		~CommandBuffer() = default;
+
+		/**
+		 * @brief Create an entity on playback.
+		 * @param init Called as init(world, entity) right after the entity was created, use it to add the initial components.
+		 */
+		template<typename Func>
+			requires EntityInitCallable<Func>
+		void CreateEntity(Func&& init)
+		{
+			Record([init = std::forward<Func>(init)](ECSWorld& world) mutable
+				{
+					EntityID const id{ world.CreateEntity() };
+					init(world, id);
+				});
+		}
+
+		// Destroy an entity on playback, with the destroy function the buffer was created with
+		void DestroyEntity(EntityID id);
+
+		/**
+		 * @brief Add or replace a component on playback.
+		 * @tparam ComponentType Type of component to construct.
+		 * @tparam Args Argument types to construct the component, the arguments are copied into the buffer.
+		 * @param id Entity to add the component to.
+		 * @param args Arguments to construct the component with, the component itself is only constructed on playback.
+		 */
+		template<typename ComponentType, typename... Args>
+			requires std::is_constructible_v<ComponentType, Args...>
+		void AddComponent(EntityID id, Args&&... args)
+		{
+			Record([id, ...args = std::forward<Args>(args)](ECSWorld& world) mutable
+				{
+					world.AddOrReplaceComponent<ComponentType>(id, std::move(args)...);
+				}, id);
+		}
+
+		/**
+		 * @brief Remove components from an entity on playback.
+		 * @tparam FirstComponentType Type of component to remove.
+		 * @tparam OtherComponentTypes Other types to remove.
+		 * @param id Entity to remove the components from.
+		 */
+		template<typename FirstComponentType, typename... OtherComponentTypes>
+		void RemoveComponent(EntityID id)
+		{
+			Record([id](ECSWorld& world)
+				{
+					world.RemoveComponentWithCallbackCheck<FirstComponentType, OtherComponentTypes...>(id);
+				}, id);
+		}
+
+		/**
+		 * @brief Record any other command.
+		 * @param command Called as command(world) on playback.
+		 * @param target Optional entity the command applies to, the command is skipped when that entity is no longer valid.
+		 */
+		template<typename Func>
+			requires WorldCommandCallable<Func>
+		void Record(Func&& command, EntityID target = NULL_ENTITY_ID)
+		{
+			auto& buffer{ m_pThreadBuffers[JOB_SYSTEM.ThreadIndex()] };
+			uint64_t const sequence{ m_Sequence.fetch_add(1, std::memory_order_relaxed) };
+
+			// Only contended by threads outside the job system, those share one buffer
+			std::scoped_lock const lock{ buffer.mutex };
+			buffer.commands.emplace_back(sequence, target, std::forward<Func>(command));
+		}
+
+		/**
+		 * @brief Execute all recorded commands in the order they were recorded & clear the buffer.
+		 * @param world World to apply the commands to.
+		 * @note Call from one thread while nothing is recording or iterating the world.
+		 */
+		void Playback(ECSWorld& world);
+
+		[[nodiscard]] bool Empty() const noexcept;
+
+		CommandBuffer(CommandBuffer const&) = delete;
+		CommandBuffer(CommandBuffer&&) = delete;
+		CommandBuffer& operator=(CommandBuffer const&) = delete;
+		CommandBuffer& operator=(CommandBuffer&&) = delete;
+
+	private:
+		struct RecordedCommand final
+		{
+			uint64_t sequence;
+			EntityID target;
+			std::function<void(ECSWorld&)> command;
+		};
+
+		struct alignas(MauCor::CACHE_LINE_SIZE) ThreadBuffer final
+		{
+			mutable std::mutex mutex;
+			std::vector<RecordedCommand> commands;
+		};
+
+		DestroyEntityFunction m_DestroyEntity;
+
+		// One per job system thread index
+		std::unique_ptr<ThreadBuffer[]> m_pThreadBuffers;
+		uint32_t m_NumThreadBuffers{ 0 };
+
+		std::atomic<uint64_t> m_Sequence{ 0 };
+
+		// Reused between playbacks, commands of all threads merged in recording order
+		std::vector<RecordedCommand*> m_PlaybackOrder;
+	};
+}
+
+#endif
@@ -0,0 +1,89 @@
+#ifndef MAUENG_DIRTYLIST_H
+#define MAUENG_DIRTYLIST_H
+
+#include "EntityID.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace MauEng::ECS
+{
+	// Compact list of entities that were modified since the last Clear, so update passes only have to visit those instead of sweeping a full view.
+	// Pushing is lock free & may happen from multiple threads (e.g. inside a ParallelEach), reserving may not.
+	class DirtyList final
+	{
+	public:
+		static constexpr uint32_t INVALID_INDEX{ UINT32_MAX };
+
+		DirtyList() = default;
+		~DirtyList() = default;
+
+		/**
+		 * @brief Make sure count more entities can be pushed without reallocating.
+		 * @param count Amount of entities that may still be pushed.
+		 * @note Not thread safe, call it during structural changes (e.g. when a component is constructed).
+		 */
+		void Reserve(std::size_t count) noexcept
+		{
+			std::size_t const required{ Size() + count };
+			if (required > m_Entities.size())
+			{
+				m_Entities.resize(std::max(required, m_Entities.size() * 2));
+			}
+		}
+
+		/**
+		 * @brief Add an entity to the list.
+		 * @param id Entity to add.
+		 * @return Index of the entity in the list, INVALID_INDEX if the list ran out of reserved space.
+		 */
+		[[nodiscard]] uint32_t Push(EntityID id) noexcept
+		{
+			uint32_t const idx{ m_Size.fetch_add(1, std::memory_order_relaxed) };
+			if (idx >= m_Entities.size())
+			{
+				m_Size.fetch_sub(1, std::memory_order_relaxed);
+				m_HasOverflowed.store(true, std::memory_order_relaxed);
+				return INVALID_INDEX;
+			}
+
+			m_Entities[idx] = id;
+			return idx;
+		}
+
+		// Empty the list & start a new generation, entries pushed during an older generation are no longer valid
+		void Clear() noexcept
+		{
+			m_Size.store(0, std::memory_order_relaxed);
+			m_HasOverflowed.store(false, std::memory_order_relaxed);
+			++m_Generation;
+		}
+
+		[[nodiscard]] std::span<EntityID const> Entities() const noexcept { return { m_Entities.data(), Size() }; }
+		[[nodiscard]] std::size_t Size() const noexcept { return std::min<std::size_t>(m_Size.load(std::memory_order_relaxed), m_Entities.size()); }
+		[[nodiscard]] bool Empty() const noexcept { return Size() == 0; }
+
+		[[nodiscard]] uint32_t Generation() const noexcept { return m_Generation; }
+
+		// Was an entity dropped because there was not enough reserved space, when true the list is incomplete and a full pass is required
+		[[nodiscard]] bool HasOverflowed() const noexcept { return m_HasOverflowed.load(std::memory_order_relaxed); }
+
+		DirtyList(DirtyList const&) = delete;
+		DirtyList(DirtyList&&) = delete;
+		DirtyList& operator=(DirtyList const&) = delete;
+		DirtyList& operator=(DirtyList&&) = delete;
+
+	private:
+		std::vector<EntityID> m_Entities{};
+		std::atomic<uint32_t> m_Size{ 0 };
+		std::atomic<bool> m_HasOverflowed{ false };
+
+		// Starts at 1 so zero initialised trackers are never part of the current generation
+		uint32_t m_Generation{ 1 };
+	};
+}
+
+#endif
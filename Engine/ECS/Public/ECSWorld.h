@@ -4,6 +4,7 @@
 #include "EntityID.h"
 #include <memory>
 #include <concepts>
+#include <span>
 
 #include "CoreServiceLocator.h"
 #include "Asserts/Asserts.h"
@@ -18,6 +19,9 @@ namespace MauEng::ECS
 	template<typename ComponentType, typename Func>
 	concept PreDestroyCallable = std::invocable<Func, ComponentType const&, EntityID>;
 
+	template<typename ComponentType, typename Func>
+	concept ComponentCallable = std::invocable<Func, ComponentType&, EntityID>;
+
 	class ECSWorld final
 	{
 	public:
@@ -45,9 +49,30 @@ namespace MauEng::ECS
 		// Create an entity and add it to the ECS
 		[[nodiscard]] EntityID CreateEntity() & noexcept;
 
+		/**
+		 * @brief Create multiple entities at once, cheaper than creating them one by one.
+		 * @param count Amount of entities to create.
+		 * @param outEntities Output, the first count elements are set to the new entities.
+		 */
+		void CreateEntities(std::size_t count, std::span<EntityID> outEntities) &
+		{
+			ME_ASSERT(outEntities.size() >= count);
+			m_pImpl->CreateEntities(outEntities.first(count));
+		}
+
 		// Destroy an Entity & remove it from the ECS
 		void DestroyEntity(EntityID id) & noexcept;
 
+		/**
+		 * @brief Destroy multiple entities at once, cheaper than destroying them one by one.
+		 * @param entities Entities to destroy, all of them have to be valid.
+		 * @note Like DestroyEntity, pre remove callbacks are not called.
+		 */
+		void DestroyEntities(std::span<EntityID const> entities) &
+		{
+			m_pImpl->DestroyEntities(entities);
+		}
+
 		// Checks if the entity is valid
 		[[nodiscard]] bool IsValid(EntityID id) const& noexcept;
 
@@ -165,6 +190,38 @@ namespace MauEng::ECS
 			m_pImpl->Insert(begin, end, component);
 		}
 
+		/**
+		 * @brief Add a copy of the same component to every entity in the range.
+		 * @tparam ComponentType Type of component to insert.
+		 * @param entities Entities to add the component to, none of them may have the component yet.
+		 * @param component Component to copy.
+		*/
+		template<typename ComponentType>
+		void Insert(std::span<EntityID const> entities, ComponentType const& component) &
+		{
+			m_pImpl->Insert(entities, component);
+		}
+
+		/**
+		 * @brief Add a component to every entity in the range, the storage is grown once up front.
+		 * @tparam ComponentType Type of component to insert.
+		 * @param entities Entities to add the components to, none of them may have the component yet.
+		 * @param components One component per entity, copied into the storage.
+		*/
+		template<typename ComponentType>
+		void Insert(std::span<EntityID const> entities, std::span<ComponentType const> components) &
+		{
+			ME_ASSERT(entities.size() == components.size());
+			m_pImpl->Insert(entities, components);
+		}
+
+		// Make room for count more components of the given type
+		template<typename ComponentType>
+		void Reserve(std::size_t count) &
+		{
+			m_pImpl->Reserve<ComponentType>(count);
+		}
+
 #pragma endregion
 
 #pragma region Components
@@ -180,6 +237,73 @@ namespace MauEng::ECS
 			m_pImpl->RegisterPreRemoveCallback<ComponentType>(std::forward<Func>(callback));
 		}
 
+		/**
+		 * @brief Register a callback that is invoked right after a component of the given type was added to an entity.
+		 * @tparam ComponentType Component type to listen to.
+		 * @param callback Called as callback(component, entity), multiple callbacks per type are allowed.
+		 */
+		template<typename ComponentType, typename Func>
+			requires ComponentCallable<ComponentType, Func>
+		void RegisterOnConstructCallback(Func&& callback)
+		{
+			m_pImpl->RegisterOnConstructCallback<ComponentType>(std::forward<Func>(callback));
+		}
+
+		/**
+		 * @brief Register a callback that is invoked right after a component of the given type was replaced.
+		 * @tparam ComponentType Component type to listen to.
+		 * @param callback Called as callback(component, entity), multiple callbacks per type are allowed.
+		 */
+		template<typename ComponentType, typename Func>
+			requires ComponentCallable<ComponentType, Func>
+		void RegisterOnUpdateCallback(Func&& callback)
+		{
+			m_pImpl->RegisterOnUpdateCallback<ComponentType>(std::forward<Func>(callback));
+		}
+
+		/**
+		 * @brief Register a callback that is invoked right before a component of the given type is removed, also when its entity is destroyed.
+		 * @tparam ComponentType Component type to listen to.
+		 * @param callback Called as callback(component, entity), multiple callbacks per type are allowed.
+		 * @note Structural changes to the entity that is being destroyed are not allowed inside the callback.
+		 */
+		template<typename ComponentType, typename Func>
+			requires ComponentCallable<ComponentType, Func>
+		void RegisterOnDestroyCallback(Func&& callback)
+		{
+			m_pImpl->RegisterOnDestroyCallback<ComponentType>(std::forward<Func>(callback));
+		}
+
+		/**
+		 * @brief Entities that received a component of the given type since the set was last cleared.
+		 * @tparam ComponentType Component type to track.
+		 * @return The reactive set of the type, tracking starts on the first call.
+		 * @note The set is shared by every caller for the same type, don't clear it yourself. The scene manager clears all sets once per frame with ClearReactiveSets.
+		 */
+		template<typename ComponentType>
+		[[nodiscard]] ReactiveSet& OnConstruct() &
+		{
+			return m_pImpl->GetConstructedSet<ComponentType>();
+		}
+
+		/**
+		 * @brief Entities whose component of the given type was replaced or patched since the set was last cleared.
+		 * @tparam ComponentType Component type to track.
+		 * @return The reactive set of the type, tracking starts on the first call.
+		 * @note Changes through a plain reference (GetComponent) are not seen, use Patch or ReplaceComponent for tracked components.
+		 */
+		template<typename ComponentType>
+		[[nodiscard]] ReactiveSet& OnUpdate() &
+		{
+			return m_pImpl->GetUpdatedSet<ComponentType>();
+		}
+
+		// Clear the OnConstruct & OnUpdate sets of every tracked type
+		void ClearReactiveSets() & noexcept
+		{
+			m_pImpl->ClearReactiveSets();
+		}
+
 		template<typename ComponentType>
 		[[nodiscard]] std::size_t ComponentCount() const& noexcept
 		{
@@ -350,6 +474,23 @@ namespace MauEng::ECS
 			return m_pImpl->ReplaceComponent<ComponentType>(id, std::forward<Args>(args)...);
 		}
 
+		/**
+		 * @brief Modify a component in place & notify its update listeners (OnUpdate sets & update callbacks).
+		 * @tparam ComponentType Type of component to modify.
+		 * @param id Entity that owns the component.
+		 * @param func Called as func(component).
+		 * @return Modified component by reference.
+		*/
+		template<typename ComponentType, typename Func>
+			requires std::invocable<Func, ComponentType&>
+		ComponentType& Patch(EntityID id, Func&& func) & noexcept
+		{
+			ME_ASSERT(IsValid(id));
+			ME_ASSERT(HasComponent<ComponentType>(id));
+
+			return m_pImpl->Patch<ComponentType>(id, std::forward<Func>(func));
+		}
+
 		/**
 		 * @brief Add or replace a component in the ECS.
 		 * @tparam ComponentType Type of component to construct.
@@ -2,21 +2,37 @@
 #define MAUENG_ENTTIMPL_H
 
 //TODO fix include
+#include <algorithm>
+#include <memory>
+#include <span>
 #include <typeindex>
 
 #include "../../ECS/Libs/Entt/single_include/entt/entt.hpp"
 #include "EntityID.h"
+#include "ReactiveSet.h"
 
 namespace MauEng::ECS
 {
 	template<typename ComponentType>
 	using PreRemoveCallbackType = std::function<void(ComponentType const&, EntityID)>;
+	template<typename ComponentType>
+	using ComponentCallbackType = std::function<void(ComponentType&, EntityID)>;
 
 	struct ECSImpl final
 	{
 		entt::registry registry{};
 
 		std::unordered_map<std::type_index, std::function<void(entt::registry&, entt::entity)>> m_PreRemoveCallbacks;
+		std::unordered_map<std::type_index, std::vector<std::function<void(entt::registry&, entt::entity)>>> m_OnConstructCallbacks;
+		std::unordered_map<std::type_index, std::vector<std::function<void(entt::registry&, entt::entity)>>> m_OnUpdateCallbacks;
+		std::unordered_map<std::type_index, std::vector<std::function<void(entt::registry&, entt::entity)>>> m_OnDestroyCallbacks;
+
+		// Created on first use, the sets are referenced by the callbacks that fill them so they need a stable address
+		std::unordered_map<std::type_index, std::unique_ptr<ReactiveSet>> m_ConstructedSets;
+		std::unordered_map<std::type_index, std::unique_ptr<ReactiveSet>> m_UpdatedSets;
+
+		// Reused by the range functions, so bulk creation doesn't allocate every call
+		std::vector<entt::entity> m_EntityScratch;
 
 
 #pragma region Registry
@@ -37,6 +53,115 @@ namespace MauEng::ECS
 				};
 		}
 
+		template<typename ComponentType>
+		void RegisterOnConstructCallback(ComponentCallbackType<ComponentType>&& callback)
+		{
+			auto& callbacks{ m_OnConstructCallbacks[typeid(ComponentType)] };
+			// Only connect to the registry once per type, the trampoline invokes every registered callback
+			if (callbacks.empty())
+			{
+				registry.on_construct<ComponentType>().template connect<&ECSImpl::InvokeCallbacks<ComponentType, &ECSImpl::m_OnConstructCallbacks>>(*this);
+			}
+			callbacks.emplace_back(WrapCallback<ComponentType>(std::move(callback)));
+		}
+
+		template<typename ComponentType>
+		void RegisterOnUpdateCallback(ComponentCallbackType<ComponentType>&& callback)
+		{
+			auto& callbacks{ m_OnUpdateCallbacks[typeid(ComponentType)] };
+			if (callbacks.empty())
+			{
+				registry.on_update<ComponentType>().template connect<&ECSImpl::InvokeCallbacks<ComponentType, &ECSImpl::m_OnUpdateCallbacks>>(*this);
+			}
+			callbacks.emplace_back(WrapCallback<ComponentType>(std::move(callback)));
+		}
+
+		template<typename ComponentType>
+		void RegisterOnDestroyCallback(ComponentCallbackType<ComponentType>&& callback)
+		{
+			auto& callbacks{ m_OnDestroyCallbacks[typeid(ComponentType)] };
+			if (callbacks.empty())
+			{
+				registry.on_destroy<ComponentType>().template connect<&ECSImpl::InvokeCallbacks<ComponentType, &ECSImpl::m_OnDestroyCallbacks>>(*this);
+			}
+			callbacks.emplace_back(WrapCallback<ComponentType>(std::move(callback)));
+		}
+
+		template<typename ComponentType>
+		[[nodiscard]] ReactiveSet& GetConstructedSet()
+		{
+			auto& pSet{ m_ConstructedSets[typeid(ComponentType)] };
+			if (!pSet)
+			{
+				pSet = std::make_unique<ReactiveSet>();
+				RegisterOnConstructCallback<ComponentType>([pSet = pSet.get()](ComponentType&, EntityID id)
+					{
+						pSet->Insert(id);
+					});
+				RegisterOnDestroyCallback<ComponentType>([pSet = pSet.get()](ComponentType&, EntityID id)
+					{
+						pSet->Remove(id);
+					});
+			}
+			return *pSet;
+		}
+
+		template<typename ComponentType>
+		[[nodiscard]] ReactiveSet& GetUpdatedSet()
+		{
+			auto& pSet{ m_UpdatedSets[typeid(ComponentType)] };
+			if (!pSet)
+			{
+				pSet = std::make_unique<ReactiveSet>();
+				RegisterOnUpdateCallback<ComponentType>([pSet = pSet.get()](ComponentType&, EntityID id)
+					{
+						pSet->Insert(id);
+					});
+				RegisterOnDestroyCallback<ComponentType>([pSet = pSet.get()](ComponentType&, EntityID id)
+					{
+						pSet->Remove(id);
+					});
+			}
+			return *pSet;
+		}
+
+		void ClearReactiveSets() noexcept
+		{
+			for (auto& [type, pSet] : m_ConstructedSets)
+			{
+				pSet->Clear();
+			}
+			for (auto& [type, pSet] : m_UpdatedSets)
+			{
+				pSet->Clear();
+			}
+		}
+
+		template<typename ComponentType, auto CallbackMap>
+		void InvokeCallbacks(entt::registry& reg, entt::entity ent)
+		{
+			auto const it{ (this->*CallbackMap).find(typeid(ComponentType)) };
+			if (it == (this->*CallbackMap).end())
+			{
+				return;
+			}
+
+			for (auto const& callback : it->second)
+			{
+				callback(reg, ent);
+			}
+		}
+
+		template<typename ComponentType>
+		[[nodiscard]] static std::function<void(entt::registry&, entt::entity)> WrapCallback(ComponentCallbackType<ComponentType>&& callback)
+		{
+			return [callback = std::move(callback)](entt::registry& reg, entt::entity ent)
+				{
+					if (auto comp = reg.try_get<ComponentType>(ent))
+						callback(*comp, static_cast<EntityID>(ent));
+				};
+		}
+
 		template<typename... ComponentTypes>
 		void Compact() noexcept
 		{
@@ -61,6 +186,29 @@ namespace MauEng::ECS
 			registry.insert<ComponentType>(first, last, component);
 		}
 
+		template<typename ComponentType>
+		void Insert(std::span<EntityID const> entities, ComponentType const& component)
+		{
+			ToInternalEntities(entities);
+			Reserve<ComponentType>(entities.size());
+			registry.insert<ComponentType>(m_EntityScratch.begin(), m_EntityScratch.end(), component);
+		}
+
+		template<typename ComponentType>
+		void Insert(std::span<EntityID const> entities, std::span<ComponentType const> components)
+		{
+			ToInternalEntities(entities);
+			Reserve<ComponentType>(entities.size());
+			registry.insert<ComponentType>(m_EntityScratch.begin(), m_EntityScratch.end(), components.begin());
+		}
+
+		template<typename ComponentType>
+		void Reserve(std::size_t count)
+		{
+			auto& storage{ registry.storage<ComponentType>() };
+			storage.reserve(storage.size() + count);
+		}
+
 		template<typename... ComponentTypes>
 		[[nodiscard]] bool IsOwned() const noexcept
 		{
@@ -75,11 +223,32 @@ namespace MauEng::ECS
 			return static_cast<EntityID>(registry.create());
 		}
 
+		void CreateEntities(std::span<EntityID> outEntities)
+		{
+			m_EntityScratch.resize(outEntities.size());
+			registry.create(m_EntityScratch.begin(), m_EntityScratch.end());
+
+			std::ranges::transform(m_EntityScratch, outEntities.begin(), [](entt::entity ent) { return static_cast<EntityID>(ent); });
+		}
+
+		// Convert to entt's entity type for the range functions, into m_EntityScratch
+		void ToInternalEntities(std::span<EntityID const> entities)
+		{
+			m_EntityScratch.resize(entities.size());
+			std::ranges::transform(entities, m_EntityScratch.begin(), [](EntityID id) { return static_cast<entt::entity>(id); });
+		}
+
 		void DestroyEntity(EntityID id) noexcept
 		{
 			registry.destroy(static_cast<entt::entity>(id));
 		}
 
+		void DestroyEntities(std::span<EntityID const> entities)
+		{
+			ToInternalEntities(entities);
+			registry.destroy(m_EntityScratch.begin(), m_EntityScratch.end());
+		}
+
 		[[nodiscard]] bool IsValid(EntityID id) const noexcept
 		{
 			return registry.valid(static_cast<entt::entity>(id));
@@ -230,6 +399,12 @@ namespace MauEng::ECS
 			return registry.replace<ComponentType>(static_cast<entt::entity>(id), std::forward<Args>(args)...);
 		}
 
+		template<typename ComponentType, typename Func>
+		ComponentType& Patch(EntityID id, Func&& func)
+		{
+			return registry.patch<ComponentType>(static_cast<entt::entity>(id), std::forward<Func>(func));
+		}
+
 		template<typename ComponentType, typename... Args>
 		[[nodiscard]] ComponentType& AddOrReplaceComponent(EntityID id, Args&&... args) noexcept
 		{
@@ -39,7 +39,7 @@ namespace MauEng::ECS
 		 * @tparam Func Function type (usually automatically deduced)
 		 * @tparam ExecPolicy Execution policy when looping over elements multithreaded (usually automatically deduced)
 		 * @param func Function to execute for each entity
-		 * @param policy Policy to multithread with
+		 * @param policy Policy to multithread with, any non sequenced policy runs on the job system (see ParallelEach)
 		*/
 		template<typename Func, typename ExecPolicy = std::execution::sequenced_policy>
 			requires ( std::is_invocable_v<Func, ComponentTypes&...>
@@ -48,56 +48,10 @@ namespace MauEng::ECS
 					 && std::is_execution_policy_v<std::remove_cvref_t<ExecPolicy>>
 		void Each(Func&& func, ExecPolicy policy = ExecPolicy{}) const noexcept
 		{
-			// If we are caling the functon unsequential, use std::foreach
+			// If we are caling the functon unsequential, hand it to the engine's job system
 			if constexpr (!std::is_same_v<ExecPolicy, std::execution::sequenced_policy>)
 			{
-				auto const parallelFuncCall{ [&](InternalEntityType entity)
-					{
-						if constexpr (sizeof...(ComponentTypes) > 1)
-						{
-							static_assert(std::is_same_v<
-								decltype(m_Group.template get<ComponentTypes...>(InternalEntityType{})),
-								std::tuple<ComponentTypes&...>
-							> , "Group::get<ComponentTypes...> must return a tuple of references");
-
-							std::apply(
-								[&](ComponentTypes&... comps)
-								{
-									if constexpr (std::is_invocable_v<Func, EntityID, ComponentTypes&...>)
-									{
-										func(static_cast<EntityID>(entity), comps...);
-									}
-									else if constexpr (std::is_invocable_v<Func, ComponentTypes&...>)
-									{
-										func(comps...);
-									}
-									else if constexpr (std::is_invocable_v<Func>)
-									{
-										func();
-									}
-								},
-								m_Group.template get<ComponentTypes...>(entity)
-							);
-						}
-						else
-						{
-							if constexpr (std::is_invocable_v<Func, EntityID, ComponentTypes&...>)
-							{
-								func(static_cast<EntityID>(entity), m_Group.template get<ComponentTypes...>(entity));
-							}
-							else if constexpr (std::is_invocable_v<Func, ComponentTypes&...>)
-							{
-								func(m_Group.template get<ComponentTypes...>(entity));
-							}
-							else if constexpr (std::is_invocable_v<Func>)
-							{
-								func();
-							}
-						}
-
-					} };
-
-				std::for_each(policy, m_Group.begin(), m_Group.end(), parallelFuncCall);
+				ParallelEach(std::forward<Func>(func));
 			}
 			else
 			{
@@ -125,6 +79,36 @@ namespace MauEng::ECS
 			}
 		}
 
+		/**
+		 * @brief Iterate over all entities with the given components on the job system
+		 * @tparam Func Function type (usually automatically deduced)
+		 * @param func Function to execute for each entity, may be called from several threads at once
+		 * @param grainSize Minimum amount of entities per job, rounded up to cache line aligned ranges
+		*/
+		template<typename Func>
+			requires std::is_invocable_v<Func, ComponentTypes&...>
+				  || std::is_invocable_v<Func, EntityID, ComponentTypes&...>
+				  || std::is_invocable_v <Func>
+		void ParallelEach(Func&& func, std::size_t grainSize = DEFAULT_PARALLEL_GRAIN_SIZE) const noexcept
+		{
+			if (m_Group.empty())
+			{
+				return;
+			}
+
+			// Every entity in a group matches, so we can index the packed range directly
+			auto const first{ m_Group.begin() };
+
+			JOB_SYSTEM.ParallelFor(m_Group.size(), CacheAlignedGrainSize<ComponentTypes...>(grainSize),
+				[&](std::size_t begin, std::size_t end)
+				{
+					for (std::size_t i{ begin }; i < end; ++i)
+					{
+						InvokeForEntity(func, first[static_cast<std::ptrdiff_t>(i)]);
+					}
+				});
+		}
+
 		/**
 		 * @brief Sorts the group by the given component types.
 		 * @tparam FirstComponentType First component type to sort.
@@ -261,6 +245,30 @@ namespace MauEng::ECS
 
 	private:
 		GroupType m_Group;
+
+		template<typename Func>
+		void InvokeForEntity(Func& func, InternalEntityType entity) const noexcept
+		{
+			if constexpr (sizeof...(ComponentTypes) > 1)
+			{
+				static_assert(std::is_same_v<
+					decltype(m_Group.template get<ComponentTypes...>(InternalEntityType{})),
+					std::tuple<ComponentTypes&...>
+				>, "Group::get<ComponentTypes...> must return a tuple of references");
+
+				std::apply(
+					[&](ComponentTypes&... comps)
+					{
+						InvokeEachFunc<ComponentTypes...>(func, entity, comps...);
+					},
+					m_Group.template get<ComponentTypes...>(entity)
+				);
+			}
+			else
+			{
+				InvokeEachFunc<ComponentTypes...>(func, entity, m_Group.template get<ComponentTypes...>(entity));
+			}
+		}
 	};
 }
 
@@ -0,0 +1,67 @@
+#ifndef MAUENG_REACTIVESET_H
+#define MAUENG_REACTIVESET_H
+
+#include "../../ECS/Libs/Entt/single_include/entt/entt.hpp"
+#include "EntityID.h"
+
+#include <concepts>
+
+namespace MauEng::ECS
+{
+	// Set of entities whose component of a certain type was added or changed since the last Clear, every entity is in the set at most once.
+	// Entities are removed automatically when the component is removed, so everything in the set is safe to access.
+	class ReactiveSet final
+	{
+	public:
+		ReactiveSet() = default;
+		~ReactiveSet() = default;
+
+		void Insert(EntityID id)
+		{
+			auto const ent{ static_cast<entt::entity>(id) };
+			if (!m_Entities.contains(ent))
+			{
+				m_Entities.push(ent);
+			}
+		}
+
+		void Remove(EntityID id) noexcept
+		{
+			m_Entities.remove(static_cast<entt::entity>(id));
+		}
+
+		[[nodiscard]] bool Contains(EntityID id) const noexcept { return m_Entities.contains(static_cast<entt::entity>(id)); }
+		[[nodiscard]] std::size_t Size() const noexcept { return m_Entities.size(); }
+		[[nodiscard]] bool Empty() const noexcept { return m_Entities.empty(); }
+
+		// Consumers clear the set once they processed it, the set is shared by everyone that listens to the same component type
+		void Clear() noexcept
+		{
+			m_Entities.clear();
+		}
+
+		/**
+		 * @brief Call func for every entity in the set.
+		 * @param func Called as func(entity), the set may not be modified from inside func.
+		 */
+		template<typename Func>
+			requires std::invocable<Func, EntityID>
+		void Each(Func&& func) const
+		{
+			for (auto const ent : m_Entities)
+			{
+				func(static_cast<EntityID>(ent));
+			}
+		}
+
+		ReactiveSet(ReactiveSet const&) = delete;
+		ReactiveSet(ReactiveSet&&) = delete;
+		ReactiveSet& operator=(ReactiveSet const&) = delete;
+		ReactiveSet& operator=(ReactiveSet&&) = delete;
+
+	private:
+		entt::sparse_set m_Entities{};
+	};
+}
+
+#endif
@@ -0,0 +1,174 @@
+#ifndef MAUENG_SYSTEMSCHEDULER_H
+#define MAUENG_SYSTEMSCHEDULER_H
+
+#include "ECSWorld.h"
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace MauEng::ECS
+{
+	// Component types a system only reads
+	template<typename... ComponentTypes>
+	struct Read final {};
+
+	// Component types a system reads & writes
+	template<typename... ComponentTypes>
+	struct Write final {};
+
+	template<typename Func>
+	concept SystemCallable = std::invocable<Func, ECSWorld&>;
+
+	namespace Internal
+	{
+		[[nodiscard]] inline uint32_t NextComponentTypeIndex() noexcept
+		{
+			static std::atomic<uint32_t> next{ 0 };
+			return next.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		// Dense index per component type, only used to compare access sets
+		template<typename ComponentType>
+		[[nodiscard]] uint32_t ComponentTypeIndex() noexcept
+		{
+			static uint32_t const idx{ NextComponentTypeIndex() };
+			return idx;
+		}
+
+		template<typename Set, template<typename...> typename SetType>
+		struct IsAccessSet final : std::false_type {};
+
+		template<template<typename...> typename SetType, typename... ComponentTypes>
+		struct IsAccessSet<SetType<ComponentTypes...>, SetType> final : std::true_type {};
+
+		template<typename Set>
+		struct AccessSet;
+
+		template<template<typename...> typename SetType, typename... ComponentTypes>
+		struct AccessSet<SetType<ComponentTypes...>> final
+		{
+			static void Collect(std::vector<uint32_t>& outTypes)
+			{
+				(outTypes.emplace_back(ComponentTypeIndex<std::remove_cv_t<ComponentTypes>>()), ...);
+			}
+
+			// Storages are created lazily, which isn't safe while systems run in parallel
+			static void CreateStorages(ECSWorld& world)
+			{
+				(world.Reserve<std::remove_cv_t<ComponentTypes>>(0), ...);
+			}
+		};
+	}
+
+	// Runs the systems of a scene every frame, as parallel as their declared component access allows
+	// Systems are ordered as they were added, a system only waits for earlier systems it conflicts with (one of them writes a type the other uses).
+	// Systems must only touch the components they declared & make structural changes through a command buffer, the scheduler does no locking of its own.
+	class SystemScheduler final
+	{
+	public:
+		SystemScheduler() = default;
+		~SystemScheduler() = default;
+
+		/**
+		 * @brief Add a system that may run on any worker, in parallel with systems it doesn't conflict with.
+		 * @tparam ReadSet Read<...>, the component types the system only reads.
+		 * @tparam WriteSet Write<...>, the component types the system writes.
+		 * @param name Name of the system, for logging.
+		 * @param func Called as func(world) once per Run.
+		 */
+		template<typename ReadSet = Read<>, typename WriteSet = Write<>, typename Func>
+			requires SystemCallable<Func>
+		void AddSystem(std::string name, Func&& func)
+		{
+			static_assert(Internal::IsAccessSet<ReadSet, Read>::value, "ReadSet has to be a Read<...>");
+			static_assert(Internal::IsAccessSet<WriteSet, Write>::value, "WriteSet has to be a Write<...>");
+
+			System system{};
+			system.name = std::move(name);
+			system.func = std::forward<Func>(func);
+			Internal::AccessSet<ReadSet>::Collect(system.reads);
+			Internal::AccessSet<WriteSet>::Collect(system.writes);
+			system.createStorages = [](ECSWorld& world)
+				{
+					Internal::AccessSet<ReadSet>::CreateStorages(world);
+					Internal::AccessSet<WriteSet>::CreateStorages(world);
+				};
+
+			Add(std::move(system));
+		}
+
+		/**
+		 * @brief Add a system that runs alone on the thread calling Run, for work that isn't thread safe (input, timers, ...).
+		 * @param name Name of the system, for logging.
+		 * @param func Called as func(world) once per Run, after all earlier systems finished & before any later system starts.
+		 */
+		template<typename Func>
+			requires SystemCallable<Func>
+		void AddMainThreadSystem(std::string name, Func&& func)
+		{
+			System system{};
+			system.name = std::move(name);
+			system.func = std::forward<Func>(func);
+			system.isMainThread = true;
+
+			Add(std::move(system));
+		}
+
+		// Run every system once, returns when all of them are done
+		void Run(ECSWorld& world);
+
+		[[nodiscard]] std::size_t SystemCount() const noexcept { return m_Systems.size(); }
+
+		SystemScheduler(SystemScheduler const&) = delete;
+		SystemScheduler(SystemScheduler&&) = delete;
+		SystemScheduler& operator=(SystemScheduler const&) = delete;
+		SystemScheduler& operator=(SystemScheduler&&) = delete;
+
+	private:
+		struct System final
+		{
+			std::string name{};
+			std::function<void(ECSWorld&)> func{};
+			std::function<void(ECSWorld&)> createStorages{};
+
+			// Sorted component type indices
+			std::vector<uint32_t> reads{};
+			std::vector<uint32_t> writes{};
+			bool isMainThread{ false };
+
+			// Systems that have to wait for this one
+			std::vector<uint32_t> dependents{};
+			uint32_t dependencyCount{ 0 };
+		};
+
+		// Systems between two main thread systems, [begin, end) in m_Systems
+		struct Phase final
+		{
+			uint32_t begin{ 0 };
+			uint32_t end{ 0 };
+			bool isMainThread{ false };
+		};
+
+		std::vector<System> m_Systems{};
+		std::vector<Phase> m_Phases{};
+
+		// Dependencies left per system during a Run
+		std::unique_ptr<std::atomic<uint32_t>[]> m_RemainingDependencies{};
+
+		bool m_IsGraphDirty{ false };
+		// World the declared storages were created in, they are created again when the graph or the world changes
+		ECSWorld const* m_pPreparedWorld{ nullptr };
+
+		void Add(System&& system);
+		void BuildGraph(ECSWorld& world);
+		void RunPhase(ECSWorld& world, Phase const& phase);
+
+		[[nodiscard]] static bool Conflicts(System const& lhs, System const& rhs) noexcept;
+	};
+}
+
+#endif
@@ -5,8 +5,10 @@
 #include <memory>
 #include <concepts>
 #include <execution>
+#include <numeric>
 
 #include "Asserts/Asserts.h"
+#include "CoreServiceLocator.h"
 
 #include "EnttImpl.h"
 
@@ -17,6 +19,56 @@ namespace MauEng::ECS
 	template<typename... ExcludeTypes>
 	using ExcludeType = entt::exclude_t<ExcludeTypes...>;
 
+	// Default amount of entities per job when iterating in parallel, matches entt's component page size
+	std::size_t constexpr DEFAULT_PARALLEL_GRAIN_SIZE{ 1024 };
+
+	/**
+	 * @brief Round a grain size up so every range starts on a cache line in the entity array & each component array.
+	 * @tparam ComponentTypes Component types that are iterated.
+	 * @param grainSize Requested amount of elements per range.
+	 * @return The aligned grain size.
+	*/
+	template<typename... ComponentTypes>
+	[[nodiscard]] constexpr std::size_t CacheAlignedGrainSize(std::size_t grainSize) noexcept
+	{
+		std::size_t elementsPerLine{ MauCor::CACHE_LINE_SIZE / sizeof(InternalEntityType) };
+		((elementsPerLine = std::lcm(elementsPerLine,
+			std::is_empty_v<ComponentTypes> ? std::size_t{ 1 } : MauCor::CACHE_LINE_SIZE / std::gcd(MauCor::CACHE_LINE_SIZE, sizeof(ComponentTypes)))), ...);
+
+		grainSize = std::max(grainSize, std::size_t{ 1 });
+		return ((grainSize + elementsPerLine - 1) / elementsPerLine) * elementsPerLine;
+	}
+
+	// Calls an Each function with the arguments it accepts
+	template<typename... ComponentTypes, typename Func>
+	void InvokeEachFunc(Func& func, InternalEntityType entity, ComponentTypes&... comps) noexcept
+	{
+		if constexpr (std::is_invocable_v<Func, EntityID, ComponentTypes&...>)
+		{
+			func(static_cast<EntityID>(entity), comps...);
+		}
+		else if constexpr (std::is_invocable_v<Func, ComponentTypes&...>)
+		{
+			func(comps...);
+		}
+		else if constexpr (std::is_invocable_v<Func>)
+		{
+			func();
+		}
+	}
+
+	/**
+	 * @brief Iterate over a view or group on the job system.
+	 * @param viewOrGroup View or group to iterate over.
+	 * @param func Function to execute for each entity, may be called from several threads at once.
+	 * @param grainSize Minimum amount of entities per job.
+	*/
+	template<typename ViewOrGroup, typename Func>
+	void ParallelEach(ViewOrGroup const& viewOrGroup, Func&& func, std::size_t grainSize = DEFAULT_PARALLEL_GRAIN_SIZE) noexcept
+	{
+		viewOrGroup.ParallelEach(std::forward<Func>(func), grainSize);
+	}
+
 	template<typename... ComponentTypes>
 	class ViewWrapper
 	{
@@ -34,7 +86,7 @@ namespace MauEng::ECS
 		 * @tparam Func Function type (usually automatically deduced)
 		 * @tparam ExecPolicy Execution policy when looping over elements multithreaded (usually automatically deduced)
 		 * @param func Function to execute for each entity
-		 * @param policy Policy to multithread with
+		 * @param policy Policy to multithread with, any non sequenced policy runs on the job system (see ParallelEach)
 		*/
 		template<typename Func, typename ExecPolicy = std::execution::sequenced_policy>
 			requires (std::is_invocable_v<Func, ComponentTypes&...>
@@ -43,56 +95,10 @@ namespace MauEng::ECS
 			&& std::is_execution_policy_v<std::remove_cvref_t<ExecPolicy>>
 			void Each(Func&& func, ExecPolicy policy = ExecPolicy{}) const noexcept
 		{
-			// If we are caling the functon unsequential, use std::foreach
+			// If we are caling the functon unsequential, hand it to the engine's job system
 			if constexpr (!std::is_same_v<ExecPolicy, std::execution::sequenced_policy>)
 			{
-				auto const parallelFuncCall{ [&](InternalEntityType entity)
-					{
-						if constexpr(sizeof...(ComponentTypes) > 1)
-						{
-							static_assert(std::is_same_v<
-								decltype(m_View.template get<ComponentTypes...>(InternalEntityType{})),
-								std::tuple<ComponentTypes&...>
-							> , "View::get<ComponentTypes...> must return a tuple of references");
-
-							std::apply(
-								[&](ComponentTypes&... comps)
-								{
-									if constexpr (std::is_invocable_v<Func, EntityID, ComponentTypes&...>)
-									{
-										func(static_cast<EntityID>(entity), comps...);
-									}
-									else if constexpr (std::is_invocable_v<Func, ComponentTypes&...>)
-									{
-										func(comps...);
-									}
-									else if constexpr (std::is_invocable_v<Func>)
-									{
-										func();
-									}
-								},
-								m_View.template get<ComponentTypes...>(entity)
-							);
-						}
-						else
-						{
-							if constexpr (std::is_invocable_v<Func, EntityID, ComponentTypes&...>)
-							{
-								func(static_cast<EntityID>(entity), m_View.template get<ComponentTypes...>(entity));
-							}
-							else if constexpr (std::is_invocable_v<Func, ComponentTypes&...>)
-							{
-								func(m_View.template get<ComponentTypes...>(entity));
-							}
-							else if constexpr (std::is_invocable_v<Func>)
-							{
-								func();
-							}
-						}
-
-					} };
-
-				std::for_each(policy, m_View.begin(), m_View.end(), parallelFuncCall);
+				ParallelEach(std::forward<Func>(func));
 			}
 			else
 			{
@@ -120,6 +126,44 @@ namespace MauEng::ECS
 			}
 		}
 
+		/**
+		 * @brief Iterate over all entities with the given components on the job system
+		 * @tparam Func Function type (usually automatically deduced)
+		 * @param func Function to execute for each entity, may be called from several threads at once
+		 * @param grainSize Minimum amount of entities per job, rounded up to cache line aligned ranges
+		 * @note The view's leading storage is split up by dense index, entities missing one of the other components are skipped.
+		*/
+		template<typename Func>
+			requires std::is_invocable_v<Func, ComponentTypes&...>
+				  || std::is_invocable_v<Func, EntityID, ComponentTypes&...>
+				  || std::is_invocable_v <Func>
+		void ParallelEach(Func&& func, std::size_t grainSize = DEFAULT_PARALLEL_GRAIN_SIZE) const noexcept
+		{
+			auto const* pHandle{ m_View.handle() };
+			if (not pHandle or pHandle->empty())
+			{
+				return;
+			}
+
+			InternalEntityType const* pEntities{ pHandle->data() };
+
+			JOB_SYSTEM.ParallelFor(pHandle->size(), CacheAlignedGrainSize<ComponentTypes...>(grainSize),
+				[&](std::size_t begin, std::size_t end)
+				{
+					for (std::size_t i{ begin }; i < end; ++i)
+					{
+						InternalEntityType const entity{ pEntities[i] };
+						// Tombstones & entities that are not part of the view
+						if (not m_View.contains(entity))
+						{
+							continue;
+						}
+
+						InvokeForEntity(func, entity);
+					}
+				});
+		}
+
 		/**
 		  * @brief Get component(s) from an entity in the view
 		  * @tparam ComponentTs Function type (usually automatically deduced)
@@ -210,6 +254,30 @@ namespace MauEng::ECS
 
 	private:
 		ViewType m_View;
+
+		template<typename Func>
+		void InvokeForEntity(Func& func, InternalEntityType entity) const noexcept
+		{
+			if constexpr (sizeof...(ComponentTypes) > 1)
+			{
+				static_assert(std::is_same_v<
+					decltype(m_View.template get<ComponentTypes...>(InternalEntityType{})),
+					std::tuple<ComponentTypes&...>
+				>, "View::get<ComponentTypes...> must return a tuple of references");
+
+				std::apply(
+					[&](ComponentTypes&... comps)
+					{
+						InvokeEachFunc<ComponentTypes...>(func, entity, comps...);
+					},
+					m_View.template get<ComponentTypes...>(entity)
+				);
+			}
+			else
+			{
+				InvokeEachFunc<ComponentTypes...>(func, entity, m_View.template get<ComponentTypes...>(entity));
+			}
+		}
 	};
 }
 
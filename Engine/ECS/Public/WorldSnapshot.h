@@ -0,0 +1,209 @@
+#ifndef MAUENG_WORLDSNAPSHOT_H
+#define MAUENG_WORLDSNAPSHOT_H
+
+#include "ECSWorld.h"
+
+#include "IO/MappedFile.h"
+
+#include <cstring>
+#include <functional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace MauEng::ECS
+{
+	class WorldSnapshot;
+
+	// A snapshot file that was mapped & validated but not added to a world yet, see WorldSnapshot::Prepare
+	// Keeps the file mapped, components are inserted straight from it when instantiating.
+	class PreparedSnapshot final
+	{
+	public:
+		PreparedSnapshot() = default;
+		~PreparedSnapshot() = default;
+
+		[[nodiscard]] bool IsValid() const noexcept { return m_File.IsOpen(); }
+		[[nodiscard]] uint32_t EntityCount() const noexcept { return m_EntityCount; }
+
+		PreparedSnapshot(PreparedSnapshot const&) = delete;
+		PreparedSnapshot(PreparedSnapshot&&) = delete;
+		PreparedSnapshot& operator=(PreparedSnapshot const&) = delete;
+		PreparedSnapshot& operator=(PreparedSnapshot&&) = delete;
+
+	private:
+		friend class WorldSnapshot;
+
+		struct Block final
+		{
+			// Index into the registered components of the WorldSnapshot that prepared it
+			uint32_t componentIdx{ 0 };
+			// Snapshot entity index per component, for asset components grouped per path
+			std::vector<uint32_t> entityIndices{};
+			// Raw components in the mapped file, unused for asset components
+			std::byte const* pData{ nullptr };
+			// [assetOffsets[p], assetOffsets[p + 1]) of entityIndices use path p
+			std::vector<uint32_t> assetOffsets{};
+		};
+
+		MauCor::MappedFile m_File{};
+		std::vector<std::string> m_PathTable{};
+		std::vector<Block> m_Blocks{};
+		uint32_t m_EntityCount{ 0 };
+	};
+
+	// Versioned binary snapshot of the components in an ECSWorld
+	// Trivially copyable components are stored as raw arrays, one per type, & inserted straight from the mapped file when loading.
+	// Components that refer to an asset (e.g. a mesh) store an index into a path table instead, they are recreated once per unique path.
+	// Only registered component types are stored, entity IDs inside components are not remapped.
+	class WorldSnapshot final
+	{
+	public:
+		// Increment whenever the file layout changes, older snapshots are rejected
+		static constexpr uint32_t VERSION{ 1 };
+
+		WorldSnapshot() = default;
+		~WorldSnapshot() = default;
+
+		/**
+		 * @brief Store a component type as raw bytes.
+		 * @tparam ComponentType Trivially copyable component type.
+		 * @param name Stable name of the type, identifies it in the file so keep it the same between builds.
+		 * @param onLoaded Optional, called as onLoaded(world, entities) after the components were inserted, to recreate runtime state.
+		 * @note A change to the size of the type invalidates stored arrays of that type, they are skipped when loading.
+		 */
+		template<typename ComponentType>
+			requires std::is_trivially_copyable_v<ComponentType>
+		void RegisterComponent(std::string_view name, std::function<void(ECSWorld&, std::span<EntityID const>)> onLoaded = {})
+		{
+			ComponentEntry entry{};
+			entry.typeHash = HashName(name);
+			entry.name = name;
+			entry.size = sizeof(ComponentType);
+			entry.alignment = alignof(ComponentType);
+
+			entry.gather = [](ECSWorld const& world, std::vector<EntityID>& outEntities, std::vector<std::byte>& outData, std::vector<std::string>&)
+				{
+					world.View<ComponentType>().Each([&](EntityID id, ComponentType const& component)
+						{
+							outEntities.emplace_back(id);
+
+							std::size_t const offset{ outData.size() };
+							outData.resize(offset + sizeof(ComponentType));
+							std::memcpy(outData.data() + offset, &component, sizeof(ComponentType));
+						});
+				};
+
+			entry.insertRaw = [onLoaded = std::move(onLoaded)](ECSWorld& world, std::span<EntityID const> entities, std::byte const* pData)
+				{
+					world.Insert<ComponentType>(entities, std::span<ComponentType const>{ reinterpret_cast<ComponentType const*>(pData), entities.size() });
+					if (onLoaded)
+					{
+						onLoaded(world, entities);
+					}
+				};
+
+			AddEntry(std::move(entry));
+		}
+
+		/**
+		 * @brief Store a component type as a reference to an asset.
+		 * @tparam ComponentType Component type, doesn't have to be copyable.
+		 * @param name Stable name of the type.
+		 * @param getPath Called as getPath(component), returns the asset the component refers to.
+		 * @param create Called as create(world, path, entities) once per unique path, adds the component to all entities.
+		 */
+		template<typename ComponentType>
+		void RegisterAssetComponent(std::string_view name,
+									std::function<std::string(ComponentType const&)> getPath,
+									std::function<void(ECSWorld&, std::string const&, std::span<EntityID const>)> create)
+		{
+			ComponentEntry entry{};
+			entry.typeHash = HashName(name);
+			entry.name = name;
+			entry.isAsset = true;
+
+			entry.gather = [getPath = std::move(getPath)](ECSWorld const& world, std::vector<EntityID>& outEntities, std::vector<std::byte>&, std::vector<std::string>& outPaths)
+				{
+					world.View<ComponentType>().Each([&](EntityID id, ComponentType const& component)
+						{
+							outEntities.emplace_back(id);
+							outPaths.emplace_back(getPath(component));
+						});
+				};
+			entry.createFromAsset = std::move(create);
+
+			AddEntry(std::move(entry));
+		}
+
+		// Write all registered components in the world to a file, returns false when the file could not be written
+		[[nodiscard]] bool Save(ECSWorld const& world, char const* path) const;
+
+		/**
+		 * @brief Load a snapshot into the world, the entities are created next to the ones that already exist.
+		 * @param world World to load into.
+		 * @param path Snapshot file, mapped into memory while loading.
+		 * @param pOutEntities Optional, receives the created entities.
+		 * @return False when the file could not be opened or is not a valid snapshot of this version.
+		 */
+		[[nodiscard]] bool Load(ECSWorld& world, char const* path, std::vector<EntityID>* pOutEntities = nullptr) const;
+
+		/**
+		 * @brief First half of Load, maps & validates the file without touching a world.
+		 * @param path Snapshot file.
+		 * @param outPrepared Output, has to be closed. Only valid for this WorldSnapshot, don't register components until it's instantiated.
+		 * @return False when the file could not be opened or is not a valid snapshot of this version.
+		 * @note Safe to call from any thread, the heavy part of loading (reading & grouping) happens here.
+		 */
+		[[nodiscard]] bool Prepare(char const* path, PreparedSnapshot& outPrepared) const;
+
+		/**
+		 * @brief Second half of Load, creates the entities of a prepared snapshot in the world.
+		 * @param world World to load into, only call from the thread that owns it.
+		 * @param prepared Snapshot prepared by this WorldSnapshot, can be instantiated several times.
+		 * @param pOutEntities Optional, receives the created entities.
+		 */
+		void Instantiate(ECSWorld& world, PreparedSnapshot const& prepared, std::vector<EntityID>* pOutEntities = nullptr) const;
+
+		WorldSnapshot(WorldSnapshot const&) = delete;
+		WorldSnapshot(WorldSnapshot&&) = delete;
+		WorldSnapshot& operator=(WorldSnapshot const&) = delete;
+		WorldSnapshot& operator=(WorldSnapshot&&) = delete;
+
+	private:
+		struct ComponentEntry final
+		{
+			uint64_t typeHash{ 0 };
+			std::string name{};
+
+			uint32_t size{ 0 };
+			uint32_t alignment{ 0 };
+			bool isAsset{ false };
+
+			std::function<void(ECSWorld const&, std::vector<EntityID>&, std::vector<std::byte>&, std::vector<std::string>&)> gather{};
+			std::function<void(ECSWorld&, std::span<EntityID const>, std::byte const*)> insertRaw{};
+			std::function<void(ECSWorld&, std::string const&, std::span<EntityID const>)> createFromAsset{};
+		};
+
+		std::vector<ComponentEntry> m_Components{};
+
+		void AddEntry(ComponentEntry&& entry);
+		[[nodiscard]] ComponentEntry const* FindEntry(uint64_t typeHash) const noexcept;
+
+		// FNV-1a, stable between compilers unlike typeid names
+		[[nodiscard]] static constexpr uint64_t HashName(std::string_view name) noexcept
+		{
+			uint64_t hash{ 14695981039346656037ull };
+			for (char const c : name)
+			{
+				hash ^= static_cast<uint8_t>(c);
+				hash *= 1099511628211ull;
+			}
+			return hash;
+		}
+	};
+}
+
+#endif
@@ -9,5 +9,10 @@ namespace MauEng
 		meshID = RENDERER.LoadOrGetMeshID(path);
 	}
 
+	CStaticMesh::CStaticMesh(uint32_t loadedMeshID) noexcept :
+		meshID{ loadedMeshID }
+	{
+	}
+
 	CStaticMesh::~CStaticMesh(){ }
 }
@@ -2,6 +2,8 @@
 
 #include "Asserts/Asserts.h"
 #include "Components/CStaticMesh.h"
+#include "Components/CParent.h"
+#include "Components/CChildren.h"
 namespace MauEng
 {
 	Entity::Entity(ECS::ECSWorld* pWorld, ECS::EntityID id) :
@@ -11,7 +13,68 @@ namespace MauEng
 
 	void Entity::Destroy() noexcept
 	{
+		// Copy, destroying a child removes it from our children
+		if (auto const* pChildren{ TryGetComponent<CChildren>() })
+		{
+			auto const children{ pChildren->children };
+			for (auto const child : children)
+			{
+				if (m_pECSWorld->IsValid(child))
+				{
+					Entity{ m_pECSWorld, child }.Destroy();
+				}
+			}
+		}
+
+		RemoveParent();
+
 		m_pECSWorld->RemoveComponentWithCallbackCheck<CStaticMesh>(m_ID);
 		m_pECSWorld->DestroyEntity(m_ID);
 	}
+
+	void Entity::SetParent(Entity parent) noexcept
+	{
+		ME_ASSERT(parent.m_pECSWorld == m_pECSWorld);
+
+		// Parenting to ourselves or one of our descendants would create a cycle
+		for (Entity ancestor{ parent }; ancestor; ancestor = ancestor.GetParent())
+		{
+			if (ancestor == *this)
+			{
+				ME_LOG(MauCor::ELogPriority::Error, LogEngine, "Can not set parent, the parent is a descendant of the entity");
+				return;
+			}
+		}
+
+		RemoveParent();
+
+		parent.GetOrEmplaceComponent<CChildren>().children.emplace_back(m_ID);
+		AddOrReplaceComponent<CParent>(parent.ID());
+	}
+
+	void Entity::RemoveParent() noexcept
+	{
+		auto const* pParent{ TryGetComponent<CParent>() };
+		if (!pParent)
+		{
+			return;
+		}
+
+		if (auto* pSiblings{ m_pECSWorld->TryGetComponent<CChildren>(pParent->parent) })
+		{
+			std::erase(pSiblings->children, m_ID);
+		}
+
+		[[maybe_unused]] bool const removed{ RemoveComponent<CParent>() };
+	}
+
+	Entity Entity::GetParent() const noexcept
+	{
+		if (auto const* pParent{ TryGetComponent<CParent>() }; pParent && m_pECSWorld->IsValid(pParent->parent))
+		{
+			return Entity{ m_pECSWorld, pParent->parent };
+		}
+
+		return Entity{};
+	}
 }
@@ -0,0 +1,31 @@
+#include "Scene/Prefab.h"
+
+#include "InternalServiceLocator.h"
+
+namespace MauEng
+{
+	void Prefab::Instantiate(ECS::ECSWorld& world, std::span<ECS::EntityID const> entities) const
+	{
+		ME_PROFILE_FUNCTION()
+
+		if (entities.empty())
+		{
+			return;
+		}
+
+		if (!m_MeshPath.empty())
+		{
+			// One reference per instance, each is released when its CStaticMesh is removed
+			uint32_t const meshID{ RENDERER.LoadOrGetMeshID(m_MeshPath.c_str(), static_cast<uint32_t>(entities.size())) };
+			if (meshID != MauRen::INVALID_MESH_ID)
+			{
+				world.Insert<CStaticMesh>(entities, CStaticMesh{ meshID });
+			}
+		}
+
+		for (auto const& addComponent : m_Components)
+		{
+			addComponent(world, entities);
+		}
+	}
+}
@@ -0,0 +1,85 @@
+#include "Scene/RenderProxySystem.h"
+
+#include "InternalServiceLocator.h"
+
+#include "Components/CTransform.h"
+#include "Components/CStaticMesh.h"
+
+namespace MauEng
+{
+	void RenderProxySystem::RegisterCallbacks(ECS::ECSWorld& world)
+	{
+		// Instances are created in Update, by then the transform of a new entity is up to date
+		m_pAddedMeshes = &world.OnConstruct<CStaticMesh>();
+		m_pChangedMeshes = &world.OnUpdate<CStaticMesh>();
+
+		world.RegisterOnDestroyCallback<CStaticMesh>([this](CStaticMesh&, ECS::EntityID id)
+			{
+				DestroyInstance(id);
+			});
+	}
+
+	void RenderProxySystem::Update(ECS::ECSWorld const& world, std::span<ECS::EntityID const> updatedTransforms)
+	{
+		ME_PROFILE_FUNCTION()
+
+		// The mesh may have changed, instances can't switch meshes
+		m_pChangedMeshes->Each([this, &world](ECS::EntityID id)
+			{
+				DestroyInstance(id);
+				CreateInstance(world, id, world.GetComponent<CStaticMesh>(id).meshID);
+			});
+
+		m_pAddedMeshes->Each([this, &world](ECS::EntityID id)
+			{
+				if (!m_Instances.contains(id))
+				{
+					CreateInstance(world, id, world.GetComponent<CStaticMesh>(id).meshID);
+				}
+			});
+
+		if (m_Instances.empty())
+		{
+			return;
+		}
+
+		for (ECS::EntityID const id : updatedTransforms)
+		{
+			auto const it{ m_Instances.find(id) };
+			if (it == end(m_Instances))
+			{
+				continue;
+			}
+
+			RENDERER.UpdateMeshInstance(it->second, world.GetComponent<CTransform>(id).mat);
+		}
+	}
+
+	void RenderProxySystem::CreateInstance(ECS::ECSWorld const& world, ECS::EntityID id, uint32_t meshID)
+	{
+		if (meshID == MauRen::INVALID_MESH_ID)
+		{
+			return;
+		}
+
+		// Entities without a transform are drawn at the origin
+		auto const* pTransform{ world.TryGetComponent<CTransform>(id) };
+		uint32_t const instanceID{ RENDERER.CreateMeshInstance(pTransform ? pTransform->mat : glm::mat4{ 1.0f }, meshID) };
+		if (instanceID != MauRen::INVALID_MESH_INSTANCE_ID)
+		{
+			m_Instances[id] = instanceID;
+		}
+	}
+
+	void RenderProxySystem::DestroyInstance(ECS::EntityID id)
+	{
+		auto const it{ m_Instances.find(id) };
+		if (it == end(m_Instances))
+		{
+			return;
+		}
+
+		RENDERER.DestroyMeshInstance(it->second);
+		m_Instances.erase(it);
+	}
+}
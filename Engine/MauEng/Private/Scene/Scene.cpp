@@ -10,17 +10,43 @@ namespace MauEng
 			{
 				RENDERER.UnloadMesh(mesh.meshID);
 			});
+
+		m_TransformSystem.RegisterCallbacks(m_ECSWorld);
+		m_RenderProxySystem.RegisterCallbacks(m_ECSWorld);
+		m_SpatialSystem.RegisterCallbacks(m_ECSWorld);
+
+		RegisterSnapshotComponents();
+
+		// Not thread safe & expected to run before any game system
+		m_SystemScheduler.AddMainThreadSystem("Timers", [this](ECS::ECSWorld&)
+			{
+				m_TimerManager.Tick();
+			});
+		m_SystemScheduler.AddMainThreadSystem("Cameras", [this](ECS::ECSWorld&)
+			{
+				m_CameraManager.Tick();
+			});
+		m_SystemScheduler.AddMainThreadSystem("Players", [](ECS::ECSWorld&)
+			{
+				for (auto& p : INPUT_MANAGER.GetPlayers())
+				{
+					p->Tick();
+				}
+			});
 	}
 
 	void Scene::Tick()
 	{
-		m_TimerManager.Tick();
+		ME_PROFILE_FUNCTION()
 
-		m_CameraManager.Tick();
-		for (auto& p : INPUT_MANAGER.GetPlayers())
-		{
-			p->Tick();
-		}
+		m_SystemScheduler.Run(m_ECSWorld);
+	}
+
+	void Scene::FixedTick()
+	{
+		ME_PROFILE_FUNCTION()
+
+		m_FixedSystemScheduler.Run(m_ECSWorld);
 	}
 
 	void Scene::OnRender() const
@@ -28,23 +54,21 @@ namespace MauEng
 		ME_PROFILE_FUNCTION()
 		{
 			{
-				auto const view = GetECSWorld().View<CTransform>();
 				ME_PROFILE_SCOPE("UPDATE MATRICES")
-					view.Each([](CTransform& t){
-						t.UpdateMatrix();
-					}, std::execution::par_unseq);
+				m_TransformSystem.Update(m_ECSWorld, TIME.FixedAlpha());
 			}
 			{
-				ME_PROFILE_SCOPE("QUEUE DRAWS")
-				auto view{ GetECSWorld().View<CStaticMesh, CTransform>() };
-				view.Each([](CStaticMesh const& m, CTransform const& t)
-							{
-								RENDERER.QueueDraw(t.mat, m);
-							});
+				// Meshes are persistent instances in the renderer, only the transforms that moved are sent
+				ME_PROFILE_SCOPE("UPDATE RENDER PROXIES")
+				m_RenderProxySystem.Update(m_ECSWorld, m_TransformSystem.GetUpdatedTransforms());
+			}
+			{
+				ME_PROFILE_SCOPE("UPDATE SPATIAL INDEX")
+				m_SpatialSystem.Update(m_ECSWorld, m_TransformSystem.GetUpdatedTransforms());
 			}
 
 			ME_CHECK(GetCameraManager().GetActiveCamera());
-			RENDERER.PreLightQueue(GetCameraManager().GetActiveCamera()->GetProjectionMatrix() * GetCameraManager().GetActiveCamera()->GetViewMatrix());
+			RENDERER.PreLightQueue(GetCameraManager().GetActiveCamera()->GetProjectionMatrix() * GetCameraManager().GetActiveCamera()->GetViewMatrix(), m_SpatialSystem.GetBounds());
 			{
 				ME_PROFILE_SCOPE("QUEUE LIGHTS")
 
@@ -71,6 +95,76 @@ namespace MauEng
 		return ent;
 	}
 
+	void Scene::CreateEntities(std::span<CTransform const> transforms, std::span<ECS::EntityID> outEntities)
+	{
+		ME_PROFILE_FUNCTION()
+
+		m_ECSWorld.CreateEntities(transforms.size(), outEntities);
+		m_ECSWorld.Insert<CTransform>(outEntities.first(transforms.size()), transforms);
+	}
+
+	std::vector<ECS::EntityID> Scene::Instantiate(Prefab const& prefab, std::size_t count, std::span<CTransform const> transforms)
+	{
+		ME_PROFILE_FUNCTION()
+
+		ME_ASSERT(transforms.empty() || transforms.size() == count);
+
+		std::vector<ECS::EntityID> entities(count);
+		if (transforms.empty())
+		{
+			m_ECSWorld.CreateEntities(count, entities);
+			m_ECSWorld.Insert<CTransform>(entities, CTransform{});
+		}
+		else
+		{
+			CreateEntities(transforms, entities);
+		}
+
+		prefab.Instantiate(m_ECSWorld, entities);
+
+		return entities;
+	}
+
+	bool Scene::SaveSnapshot(char const* path) const
+	{
+		return m_SnapshotLayout.Save(m_ECSWorld, path);
+	}
+
+	bool Scene::LoadSnapshot(char const* path)
+	{
+		return m_SnapshotLayout.Load(m_ECSWorld, path);
+	}
+
+	void Scene::RegisterSnapshotComponents()
+	{
+		// Runtime state (dirty tracking, hierarchy flags) is reset when the transform is added
+		m_SnapshotLayout.RegisterComponent<CTransform>("CTransform");
+
+		m_SnapshotLayout.RegisterComponent<CLight>("CLight", [](ECS::ECSWorld& world, std::span<ECS::EntityID const> entities)
+			{
+				// The stored light IDs belonged to the renderer that saved the snapshot
+				for (ECS::EntityID const id : entities)
+				{
+					world.GetComponent<CLight>(id).lightID = RENDERER.CreateLight();
+				}
+			});
+
+		m_SnapshotLayout.RegisterAssetComponent<CStaticMesh>("CStaticMesh",
+			[](CStaticMesh const& mesh)
+			{
+				return RENDERER.GetMeshPath(mesh.meshID);
+			},
+			[](ECS::ECSWorld& world, std::string const& path, std::span<ECS::EntityID const> entities)
+			{
+				// One reference per entity, taken in one go
+				uint32_t const meshID{ RENDERER.LoadOrGetMeshID(path.c_str(), static_cast<uint32_t>(entities.size())) };
+				if (meshID != MauRen::INVALID_MESH_ID)
+				{
+					world.Insert<CStaticMesh>(entities, CStaticMesh{ meshID });
+				}
+			});
+	}
+
 	void Scene::DestroyEntity(Entity entity)
 	{
 		m_ECSWorld.DestroyEntity(entity);
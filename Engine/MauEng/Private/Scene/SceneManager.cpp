@@ -25,7 +25,9 @@ namespace MauEng
 	void SceneManager::FixedUpdate()
 	{
 		ME_PROFILE_FUNCTION()
-		//TODO
+
+		m_Scene->BeginFixedStep();
+		m_Scene->FixedTick();
 	}
 
 	void SceneManager::Render(glm::vec2 const& screenSize) const
@@ -34,6 +36,9 @@ namespace MauEng
 
 		m_Scene->OnRender();
 
+		// Every system that reads the reactive sets has run by now, changes made after this are seen next frame
+		m_Scene->GetECSWorld().ClearReactiveSets();
+
 		RENDERER.Render(m_Scene->GetCameraManager().GetActiveCamera());
 	}
 
@@ -42,6 +47,15 @@ namespace MauEng
 		ME_PROFILE_FUNCTION()
 
 		m_Scene->Tick();
+
+		{
+			ME_PROFILE_SCOPE("COMMAND BUFFER PLAYBACK")
+			m_Scene->GetCommandBuffer().Playback(m_Scene->GetECSWorld());
+		}
+		{
+			ME_PROFILE_SCOPE("SUB SCENE STREAMING")
+			m_Scene->UpdateStreaming();
+		}
 	}
 
 	void SceneManager::UpdateCamerasAspectRatio(float aspectRatio) noexcept
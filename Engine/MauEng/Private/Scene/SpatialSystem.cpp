@@ -0,0 +1,115 @@
+#include "Scene/SpatialSystem.h"
+
+#include "InternalServiceLocator.h"
+
+#include "Components/CTransform.h"
+#include "Components/CStaticMesh.h"
+
+namespace MauEng
+{
+	void SpatialSystem::RegisterCallbacks(ECS::ECSWorld& world)
+	{
+		world.RegisterOnConstructCallback<CStaticMesh>([this](CStaticMesh&, ECS::EntityID id)
+			{
+				m_ChangedMeshes.Insert(id);
+			});
+		world.RegisterOnUpdateCallback<CStaticMesh>([this](CStaticMesh&, ECS::EntityID id)
+			{
+				m_ChangedMeshes.Insert(id);
+			});
+
+		world.RegisterOnDestroyCallback<CStaticMesh>([this](CStaticMesh&, ECS::EntityID id)
+			{
+				m_ChangedMeshes.Remove(id);
+				RemoveProxy(id);
+			});
+	}
+
+	void SpatialSystem::Update(ECS::ECSWorld const& world, std::span<ECS::EntityID const> updatedTransforms)
+	{
+		ME_PROFILE_FUNCTION()
+
+		m_ChangedMeshes.Each([this, &world](ECS::EntityID id)
+			{
+				UpdateProxy(world, id);
+			});
+		m_ChangedMeshes.Clear();
+
+		if (m_Proxies.empty())
+		{
+			return;
+		}
+
+		for (ECS::EntityID const id : updatedTransforms)
+		{
+			if (m_Proxies.contains(id))
+			{
+				UpdateProxy(world, id);
+			}
+		}
+	}
+
+	bool SpatialSystem::Raycast(MauCor::Ray const& ray, float maxDistance, RaycastHit& outHit) const
+	{
+		bool hasHit{ false };
+		m_BVH.Raycast(ray, maxDistance, [&](int32_t proxyID, float)
+			{
+				float distance{ 0.f };
+				if (!ray.Intersects(m_Bounds[proxyID], maxDistance, distance))
+				{
+					return maxDistance;
+				}
+
+				// Only closer hits matter from here on
+				hasHit = true;
+				maxDistance = distance;
+				outHit = { GetEntity(proxyID), distance };
+				return distance;
+			});
+
+		return hasHit;
+	}
+
+	void SpatialSystem::UpdateProxy(ECS::ECSWorld const& world, ECS::EntityID id)
+	{
+		MauCor::AABB const meshBounds{ RENDERER.GetMeshBounds(world.GetComponent<CStaticMesh>(id).meshID) };
+		if (!meshBounds.IsValid())
+		{
+			RemoveProxy(id);
+			return;
+		}
+
+		// Entities without a transform are drawn at the origin
+		auto const* pTransform{ world.TryGetComponent<CTransform>(id) };
+		MauCor::AABB const worldBounds{ pTransform ? meshBounds.Transformed(pTransform->mat) : meshBounds };
+
+		auto const it{ m_Proxies.find(id) };
+		if (it != end(m_Proxies))
+		{
+			m_BVH.MoveProxy(it->second, worldBounds);
+			m_Bounds[it->second] = worldBounds;
+			return;
+		}
+
+		int32_t const proxyID{ m_BVH.CreateProxy(worldBounds, static_cast<uint32_t>(id)) };
+		if (static_cast<std::size_t>(proxyID) >= m_Bounds.size())
+		{
+			m_Bounds.resize(proxyID + 1);
+		}
+
+		m_Bounds[proxyID] = worldBounds;
+		m_Proxies.emplace(id, proxyID);
+	}
+
+	void SpatialSystem::RemoveProxy(ECS::EntityID id)
+	{
+		auto const it{ m_Proxies.find(id) };
+		if (it == end(m_Proxies))
+		{
+			return;
+		}
+
+		m_BVH.DestroyProxy(it->second);
+		m_Proxies.erase(it);
+	}
+}
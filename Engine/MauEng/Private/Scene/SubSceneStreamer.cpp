@@ -0,0 +1,148 @@
+#include "Scene/SubSceneStreamer.h"
+
+#include "InternalServiceLocator.h"
+
+#include "Components/CStaticMesh.h"
+
+namespace MauEng
+{
+	SubSceneStreamer::~SubSceneStreamer()
+	{
+		// Loading jobs write to the sub scenes
+		JOB_SYSTEM.Wait(m_LoadJobs);
+	}
+
+	SubSceneStreamer::SubSceneID SubSceneStreamer::StreamIn(ECS::WorldSnapshot const& layout, std::string path)
+	{
+		SubSceneID const id{ m_NextID++ };
+
+		auto& pSubScene{ m_SubScenes[id] };
+		pSubScene = std::make_unique<SubScene>();
+		pSubScene->path = std::move(path);
+
+		auto const prepare{ [pSubScene = pSubScene.get(), &layout]()
+			{
+				bool const isPrepared{ layout.Prepare(pSubScene->path.c_str(), *pSubScene->pPrepared) };
+				pSubScene->state.store(isPrepared ? EState::Ready : EState::Failed, std::memory_order_release);
+			} };
+
+		// Without workers nothing would pick the job up until someone waits
+		if (JOB_SYSTEM.NumWorkers() == 0)
+		{
+			prepare();
+		}
+		else
+		{
+			JOB_SYSTEM.Schedule(prepare, &m_LoadJobs);
+		}
+
+		return id;
+	}
+
+	void SubSceneStreamer::StreamOut(SubSceneID id)
+	{
+		auto const it{ m_SubScenes.find(id) };
+		if (it == end(m_SubScenes))
+		{
+			ME_LOG_WARN(LogEngine, "Tried to stream out unknown sub scene {}", id);
+			return;
+		}
+
+		it->second->isStreamedOut = true;
+	}
+
+	bool SubSceneStreamer::IsAttached(SubSceneID id) const noexcept
+	{
+		auto const it{ m_SubScenes.find(id) };
+		return it != end(m_SubScenes) && it->second->state.load(std::memory_order_acquire) == EState::Attached;
+	}
+
+	void SubSceneStreamer::Update(ECS::ECSWorld& world, ECS::WorldSnapshot const& layout)
+	{
+		if (m_SubScenes.empty())
+		{
+			return;
+		}
+
+		ME_PROFILE_FUNCTION()
+
+		for (auto it{ begin(m_SubScenes) }; it != end(m_SubScenes);)
+		{
+			SubScene& subScene{ *it->second };
+
+			switch (subScene.state.load(std::memory_order_acquire))
+			{
+			case EState::Loading:
+				++it;
+				continue;
+
+			case EState::Failed:
+				ME_LOG_ERROR(LogEngine, "Could not stream in sub scene {}", subScene.path);
+				it = m_SubScenes.erase(it);
+				continue;
+
+			case EState::Ready:
+				if (!subScene.isStreamedOut)
+				{
+					Attach(world, layout, subScene);
+					++it;
+				}
+				else
+				{
+					it = m_SubScenes.erase(it);
+				}
+				continue;
+
+			case EState::Attached:
+				if (subScene.isStreamedOut)
+				{
+					Detach(world, subScene);
+					it = m_SubScenes.erase(it);
+				}
+				else
+				{
+					++it;
+				}
+				continue;
+			}
+		}
+	}
+
+	void SubSceneStreamer::Attach(ECS::ECSWorld& world, ECS::WorldSnapshot const& layout, SubScene& subScene)
+	{
+		ME_PROFILE_SCOPE("ATTACH SUB SCENE")
+
+		layout.Instantiate(world, *subScene.pPrepared, &subScene.entities);
+		subScene.state.store(EState::Attached, std::memory_order_release);
+
+		// The components were copied into the world, unmap the file
+		subScene.pPrepared.reset();
+	}
+
+	void SubSceneStreamer::Detach(ECS::ECSWorld& world, SubScene& subScene)
+	{
+		ME_PROFILE_SCOPE("DETACH SUB SCENE")
+
+		// Entities may have been destroyed by the game in the meantime
+		std::erase_if(subScene.entities, [&world](ECS::EntityID id) { return !world.IsValid(id); });
+
+		// Release the mesh references once per mesh instead of once per entity
+		std::unordered_map<uint32_t, uint32_t> meshUseCounts{};
+		for (ECS::EntityID const id : subScene.entities)
+		{
+			if (auto const* pMesh{ world.TryGetComponent<CStaticMesh>(id) })
+			{
+				++meshUseCounts[pMesh->meshID];
+			}
+		}
+
+		for (auto const& [meshID, useCount] : meshUseCounts)
+		{
+			RENDERER.UnloadMesh(meshID, useCount);
+		}
+
+		// Bulk destroy skips the pre remove callbacks, the references were released above
+		world.DestroyEntities(subScene.entities);
+		subScene.entities.clear();
+	}
+}
@@ -0,0 +1,355 @@
+#include "Scene/TransformSystem.h"
+
+#include "Components/CTransform.h"
+#include "Components/CParent.h"
+#include "Components/CChildren.h"
+#include "Components/CInterpolated.h"
+
+namespace MauEng
+{
+	namespace
+	{
+		// Most hierarchies are small (a prop with a few attachments), batch several of them per job
+		std::size_t constexpr SUBTREES_PER_JOB{ 16 };
+	}
+
+	void TransformSystem::RegisterCallbacks(ECS::ECSWorld& world)
+	{
+		auto const trackTransform{ [this, &world](CTransform& t, ECS::EntityID id)
+			{
+				m_DirtyTransforms.Reserve(world.ComponentCount<CTransform>());
+
+				t.owner = id;
+				t.pDirtyList = &m_DirtyTransforms;
+				// The component may have been copied from another transform, don't trust its slot or parent state
+				t.dirtyListGeneration = 0;
+				t.hasParent = false;
+
+				if (world.HasComponent<CParent>(id))
+				{
+					m_IsHierarchyDirty = true;
+				}
+
+				t.MarkDirty();
+			} };
+		world.RegisterOnConstructCallback<CTransform>([trackTransform](CTransform& t, ECS::EntityID id)
+			{
+				// Don't interpolate from wherever the copied state came from
+				t.ResetInterpolation();
+				trackTransform(t, id);
+			});
+		world.RegisterOnUpdateCallback<CTransform>(trackTransform);
+
+		world.RegisterOnConstructCallback<CInterpolated>([&world](CInterpolated& i, ECS::EntityID id)
+			{
+				i.isMoving = false;
+				if (auto* pTransform{ world.TryGetComponent<CTransform>(id) })
+				{
+					pTransform->ResetInterpolation();
+				}
+			});
+
+		auto const markHierarchyDirty{ [this](auto&, ECS::EntityID)
+			{
+				m_IsHierarchyDirty = true;
+			} };
+		world.RegisterOnConstructCallback<CParent>(markHierarchyDirty);
+		world.RegisterOnUpdateCallback<CParent>(markHierarchyDirty);
+		world.RegisterOnDestroyCallback<CChildren>(markHierarchyDirty);
+
+		world.RegisterOnDestroyCallback<CParent>([this, &world](CParent&, ECS::EntityID id)
+			{
+				m_IsHierarchyDirty = true;
+
+				// Detached, the local transform becomes the world transform
+				if (auto* pTransform{ world.TryGetComponent<CTransform>(id) })
+				{
+					pTransform->hasParent = false;
+					pTransform->MarkDirty();
+				}
+			});
+	}
+
+	void TransformSystem::BeginFixedStep(ECS::ECSWorld& world)
+	{
+		ME_PROFILE_FUNCTION()
+
+		world.View<CInterpolated, CTransform>().ParallelEach([](CInterpolated& i, CTransform& t)
+			{
+				// Rendered in between until now, make sure it settles on its current state if it stops moving
+				if (i.isMoving)
+				{
+					t.MarkDirty();
+					i.isMoving = false;
+				}
+
+				t.ResetInterpolation();
+			});
+	}
+
+	void TransformSystem::Update(ECS::ECSWorld& world, float fixedAlpha)
+	{
+		ME_PROFILE_FUNCTION()
+
+		MarkMovingInterpolated(world);
+
+		bool const hierarchyRebuilt{ m_IsHierarchyDirty };
+		if (m_IsHierarchyDirty)
+		{
+			RebuildHierarchyOrder(world);
+		}
+
+		m_UpdatedTransforms.clear();
+
+		bool const hasOverflowed{ m_DirtyTransforms.HasOverflowed() };
+		if (hasOverflowed)
+		{
+			// Something was dropped from the list, fall back to a full sweep this frame
+			world.View<CTransform>().ParallelEach([](CTransform& t)
+				{
+					t.UpdateMatrix();
+				});
+
+			world.View<CTransform>().Each([this](ECS::EntityID id, CTransform const&)
+				{
+					m_UpdatedTransforms.emplace_back(id);
+				});
+		}
+		else
+		{
+			UpdateDirtyRoots(world);
+		}
+
+		InterpolateRoots(world, fixedAlpha);
+
+		// Reparenting changes world matrices without touching the transforms themselves
+		PropagateHierarchy(world, hierarchyRebuilt || hasOverflowed);
+
+		m_DirtyTransforms.Clear();
+	}
+
+	void TransformSystem::RebuildHierarchyOrder(ECS::ECSWorld& world)
+	{
+		ME_PROFILE_FUNCTION()
+
+		m_IsHierarchyDirty = false;
+		m_HierarchyOrder.clear();
+		m_SubtreeRanges.clear();
+
+		world.View<CParent>().Each([&world](ECS::EntityID id, CParent& p)
+			{
+				p.orderIdx = CParent::INVALID_ORDER;
+				p.parentOrderIdx = CParent::INVALID_ORDER;
+
+				if (auto* pTransform{ world.TryGetComponent<CTransform>(id) })
+				{
+					pTransform->hasParent = false;
+				}
+			});
+
+		struct StackEntry final
+		{
+			ECS::EntityID id;
+			ECS::EntityID parent;
+			uint32_t parentOrderIdx;
+		};
+		std::vector<StackEntry> stack{};
+
+		auto const pushChildren{ [&stack](CChildren const& c, ECS::EntityID parent, uint32_t parentOrderIdx)
+			{
+				// Reversed, so the first child is visited first
+				for (auto it{ c.children.rbegin() }; it != c.children.rend(); ++it)
+				{
+					stack.emplace_back(*it, parent, parentOrderIdx);
+				}
+			} };
+
+		world.View<CChildren>().Each([&](ECS::EntityID rootID, CChildren const& rootChildren)
+			{
+				// Roots are entities without a (valid) parent
+				if (auto const* pParent{ world.TryGetComponent<CParent>(rootID) }; pParent && world.IsValid(pParent->parent))
+				{
+					return;
+				}
+
+				auto const begin{ static_cast<uint32_t>(m_HierarchyOrder.size()) };
+				pushChildren(rootChildren, rootID, CParent::INVALID_ORDER);
+
+				while (!stack.empty())
+				{
+					StackEntry const entry{ stack.back() };
+					stack.pop_back();
+
+					if (!world.IsValid(entry.id))
+					{
+						continue;
+					}
+
+					// Skip stale children & entities that were already visited
+					auto* pParent{ world.TryGetComponent<CParent>(entry.id) };
+					if (!pParent || pParent->parent != entry.parent || pParent->orderIdx != CParent::INVALID_ORDER)
+					{
+						continue;
+					}
+
+					pParent->orderIdx = static_cast<uint32_t>(m_HierarchyOrder.size());
+					pParent->parentOrderIdx = entry.parentOrderIdx;
+					m_HierarchyOrder.emplace_back(entry.id);
+
+					if (auto* pTransform{ world.TryGetComponent<CTransform>(entry.id) })
+					{
+						pTransform->hasParent = true;
+					}
+
+					if (auto const* pChildren{ world.TryGetComponent<CChildren>(entry.id) })
+					{
+						pushChildren(*pChildren, entry.id, pParent->orderIdx);
+					}
+				}
+
+				auto const end{ static_cast<uint32_t>(m_HierarchyOrder.size()) };
+				if (end > begin)
+				{
+					m_SubtreeRanges.emplace_back(begin, end);
+				}
+			});
+
+		// Match the storages to the hierarchy order, so propagating walks memory linearly
+		world.Sort<CParent>([](CParent const& lhs, CParent const& rhs)
+			{
+				return lhs.orderIdx < rhs.orderIdx;
+			});
+		world.Sort<CTransform, CParent>();
+
+		m_HasChanged.resize(m_HierarchyOrder.size());
+	}
+
+	void TransformSystem::UpdateDirtyRoots(ECS::ECSWorld& world)
+	{
+		auto const dirty{ m_DirtyTransforms.Entities() };
+		uint32_t const generation{ m_DirtyTransforms.Generation() };
+
+		JOB_SYSTEM.ParallelFor(dirty.size(), ECS::DEFAULT_PARALLEL_GRAIN_SIZE, [&](std::size_t begin, std::size_t end)
+			{
+				for (std::size_t i{ begin }; i < end; ++i)
+				{
+					if (IsCurrentRootEntry(world, i, generation))
+					{
+						world.GetComponent<CTransform>(dirty[i]).UpdateMatrix();
+					}
+				}
+			});
+
+		for (std::size_t i{ 0 }; i < dirty.size(); ++i)
+		{
+			if (IsCurrentRootEntry(world, i, generation))
+			{
+				m_UpdatedTransforms.emplace_back(dirty[i]);
+			}
+		}
+	}
+
+	void TransformSystem::MarkMovingInterpolated(ECS::ECSWorld& world)
+	{
+		// Moving transforms need a new matrix every frame, even when nothing touched them since the last fixed step
+		world.View<CInterpolated, CTransform>().ParallelEach([](CInterpolated& i, CTransform& t)
+			{
+				i.isMoving = t.HasChangedSincePreviousState();
+				if (i.isMoving)
+				{
+					t.MarkDirty();
+				}
+			});
+	}
+
+	void TransformSystem::InterpolateRoots(ECS::ECSWorld& world, float fixedAlpha)
+	{
+		// Runs after the regular update, so the interpolated matrix replaces the current state's one before children are propagated
+		world.View<CInterpolated, CTransform>().ParallelEach([fixedAlpha](CInterpolated const& i, CTransform& t)
+			{
+				if (i.isMoving && !t.hasParent)
+				{
+					t.mat = t.CalculateInterpolatedMatrix(fixedAlpha);
+				}
+			});
+	}
+
+	bool TransformSystem::IsCurrentRootEntry(ECS::ECSWorld& world, std::size_t idx, uint32_t generation) const
+	{
+		ECS::EntityID const id{ m_DirtyTransforms.Entities()[idx] };
+		if (!world.IsValid(id))
+		{
+			return false;
+		}
+
+		// Entries of destroyed or re-added transforms are stale, the component itself knows which slot is current
+		// Parented transforms are handled by the hierarchy pass
+		auto const* pTransform{ world.TryGetComponent<CTransform>(id) };
+		return pTransform
+			&& pTransform->dirtyListIdx == idx
+			&& pTransform->dirtyListGeneration == generation
+			&& !pTransform->hasParent;
+	}
+
+	void TransformSystem::PropagateHierarchy(ECS::ECSWorld& world, bool updateAll)
+	{
+		if (m_HierarchyOrder.empty())
+		{
+			return;
+		}
+
+		ME_PROFILE_FUNCTION()
+
+		uint32_t const generation{ m_DirtyTransforms.Generation() };
+
+		// Parents precede their children in the order, so one sweep per subtree is enough
+		JOB_SYSTEM.ParallelFor(m_SubtreeRanges.size(), SUBTREES_PER_JOB, [&](std::size_t first, std::size_t last)
+			{
+				for (std::size_t r{ first }; r < last; ++r)
+				{
+					auto const [begin, end] { m_SubtreeRanges[r] };
+					for (uint32_t i{ begin }; i < end; ++i)
+					{
+						m_HasChanged[i] = false;
+
+						ECS::EntityID const id{ m_HierarchyOrder[i] };
+						auto* pTransform{ world.TryGetComponent<CTransform>(id) };
+						if (!pTransform)
+						{
+							continue;
+						}
+
+						CParent const& parent{ world.GetComponent<CParent>(id) };
+						CTransform const* pParentTransform{ world.TryGetComponent<CTransform>(parent.parent) };
+
+						bool parentChanged{ updateAll };
+						if (parent.parentOrderIdx == CParent::INVALID_ORDER)
+						{
+							// A root changed this frame if it is part of the current dirty list generation
+							parentChanged = parentChanged || (pParentTransform && pParentTransform->dirtyListGeneration == generation);
+						}
+						else
+						{
+							parentChanged = parentChanged || m_HasChanged[parent.parentOrderIdx];
+						}
+
+						if (!parentChanged && !pTransform->isDirty)
+						{
+							continue;
+						}
+
+						pTransform->UpdateMatrix(pParentTransform ? pParentTransform->mat : glm::mat4{ 1.0f });
+						m_HasChanged[i] = true;
+					}
+				}
+			});
+
+		for (std::size_t i{ 0 }; i < m_HierarchyOrder.size(); ++i)
+		{
+			if (m_HasChanged[i])
+			{
+				m_UpdatedTransforms.emplace_back(m_HierarchyOrder[i]);
+			}
+		}
+	}
+}
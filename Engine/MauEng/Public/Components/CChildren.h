@@ -0,0 +1,17 @@
+#ifndef MAUENG_CCHILDREN_H
+#define MAUENG_CCHILDREN_H
+
+#include "../../ECS/Public/EntityID.h"
+
+#include <vector>
+
+namespace MauEng
+{
+	// Direct children of an entity, maintained by Entity::SetParent & Entity::RemoveParent
+	struct CChildren final
+	{
+		std::vector<ECS::EntityID> children{};
+	};
+}
+
+#endif
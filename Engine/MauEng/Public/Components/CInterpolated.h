@@ -0,0 +1,16 @@
+#ifndef MAUENG_CINTERPOLATED_H
+#define MAUENG_CINTERPOLATED_H
+
+namespace MauEng
+{
+	// Opt-in for entities that are moved in FixedTick, their transform is rendered in between the last two fixed steps
+	// Without it an entity is rendered at its current transform, which stutters when the fixed rate & the frame rate differ.
+	// Only root transforms are interpolated, children follow their (interpolated) parent.
+	struct CInterpolated final
+	{
+		// Did the transform change during the last fixed step, maintained by the scene
+		bool isMoving{ false };
+	};
+}
+
+#endif
@@ -0,0 +1,25 @@
+#ifndef MAUENG_CPARENT_H
+#define MAUENG_CPARENT_H
+
+#include "../../ECS/Public/EntityID.h"
+
+#include <cstdint>
+
+namespace MauEng
+{
+	// Attaches an entity to a parent, the entity's transform is then relative to the parent's world matrix
+	// Use Entity::SetParent & Entity::RemoveParent instead of adding this component directly, they keep CChildren in sync
+	struct CParent final
+	{
+		ECS::EntityID parent{ ECS::NULL_ENTITY_ID };
+
+		static constexpr uint32_t INVALID_ORDER{ UINT32_MAX };
+
+		// Position in the scene's depth first hierarchy order, INVALID_ORDER when the entity is not reachable from a root
+		uint32_t orderIdx{ INVALID_ORDER };
+		// Position of the parent in the hierarchy order, INVALID_ORDER when the parent is a root
+		uint32_t parentOrderIdx{ INVALID_ORDER };
+	};
+}
+
+#endif
@@ -10,6 +10,8 @@ namespace MauEng
 		uint32_t meshID{ MauRen::INVALID_MESH_ID };
 
 		CStaticMesh(char const* path);
+		// Takes over a reference to a mesh that was already loaded, e.g. one of the references of a batch load
+		explicit CStaticMesh(uint32_t loadedMeshID) noexcept;
 		~CStaticMesh();
 
 		CStaticMesh(CStaticMesh const&) = default;
@@ -2,6 +2,7 @@
 #define MAUENG_CTRANSFORM_H
 
 #include "Math/Rotator.h"
+#include "../../ECS/Public/DirtyList.h"
 
 namespace MauEng
 {
@@ -11,14 +12,29 @@ namespace MauEng
         MauCor::Rotator rotation{ };
         glm::vec3 scale{ 1.0f };
 
+        // Dirty tracking, owner & list are assigned by the scene when the component is added
+        ECS::EntityID owner{ ECS::NULL_ENTITY_ID };
+        uint32_t dirtyListIdx{ ECS::DirtyList::INVALID_INDEX };
+
+		// World matrix, equal to the local matrix for transforms without a parent
 		glm::mat4 mat{ 1.0f };
 
+        ECS::DirtyList* pDirtyList{ nullptr };
+        uint32_t dirtyListGeneration{ 0 };
+
         bool isDirty{ false };
+        // Set by the scene while the entity is part of a hierarchy
+        bool hasParent{ false };
+
+        // State at the start of the last fixed step, only kept up to date for entities with CInterpolated
+        glm::vec3 previousTranslation{ };
+        MauCor::Rotator previousRotation{ };
+        glm::vec3 previousScale{ 1.0f };
 
         void Translate(glm::vec3 const& t) noexcept
         {
             translation += t;
-            isDirty = true;
+            MarkDirty();
         }
 
         void ResetTransformation() noexcept
@@ -26,30 +42,81 @@ namespace MauEng
             translation = glm::vec3{ 0.0f };
             rotation = MauCor::Rotator{};
             scale = glm::vec3{ 1.0f };
-            isDirty = true;
+            MarkDirty();
         }
 
         void Rotate(MauCor::Rotator const& rotator) noexcept
         {
             rotation *= rotator;
-            isDirty = true;
+            MarkDirty();
         }
 
         void Scale(glm::vec3 const& s) noexcept
         {
             scale *= s;
+            MarkDirty();
+        }
+
+        // Flag the matrix for an update, the first call each frame also adds the owner to the scene's dirty list
+        void MarkDirty() noexcept
+        {
             isDirty = true;
+
+            if (pDirtyList && dirtyListGeneration != pDirtyList->Generation())
+            {
+                uint32_t const idx{ pDirtyList->Push(owner) };
+                if (idx != ECS::DirtyList::INVALID_INDEX)
+                {
+                    dirtyListIdx = idx;
+                    dirtyListGeneration = pDirtyList->Generation();
+                }
+            }
+        }
+
+        // Start interpolating from the current state, use after teleporting so the jump isn't smoothed out
+        void ResetInterpolation() noexcept
+        {
+            previousTranslation = translation;
+            previousRotation = rotation;
+            previousScale = scale;
         }
 
+        [[nodiscard]] bool HasChangedSincePreviousState() const noexcept
+        {
+            return previousTranslation != translation
+                || previousRotation.rotation != rotation.rotation
+                || previousScale != scale;
+        }
+
+        // Matrix built from translation, rotation & scale, relative to the parent if there is one
+        [[nodiscard]] glm::mat4 CalculateLocalMatrix() const noexcept
+        {
+            return glm::translate(glm::mat4(1.0f), translation)
+                * glm::toMat4(rotation.rotation)
+                * glm::scale(glm::mat4(1.0f), scale);
+        }
+
+        // Parented transforms need their parent's matrix, they are updated by the scene's hierarchy pass instead
         void UpdateMatrix() noexcept
         {
-            if (!isDirty) return;
-            
-                mat = glm::translate(glm::mat4(1.0f), translation)
-                    * glm::toMat4(rotation.rotation)
-					* glm::scale(glm::mat4(1.0f), scale);
+            if (!isDirty || hasParent) return;
 
-				isDirty = false;
+            mat = CalculateLocalMatrix();
+            isDirty = false;
+        }
+
+        // Local matrix between the previous (alpha 0) & current (alpha 1) state
+        [[nodiscard]] glm::mat4 CalculateInterpolatedMatrix(float alpha) const noexcept
+        {
+            return glm::translate(glm::mat4(1.0f), glm::mix(previousTranslation, translation, alpha))
+                * glm::toMat4(glm::slerp(previousRotation.rotation, rotation.rotation, alpha))
+                * glm::scale(glm::mat4(1.0f), glm::mix(previousScale, scale, alpha));
+        }
+
+        void UpdateMatrix(glm::mat4 const& parentMat) noexcept
+        {
+            mat = parentMat * CalculateLocalMatrix();
+            isDirty = false;
         }
 
         [[nodiscard]] glm::mat4 GetMatrix() noexcept
@@ -60,4 +127,4 @@ namespace MauEng
     };
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -20,12 +20,27 @@ namespace MauEng
 		Entity& operator=(Entity const&) = default;
 		Entity& operator=(Entity&&) = default;
 
-		// Destroy the entity (remove from the ECS world that it lives in)
+		// Destroy the entity & its children (remove from the ECS world that it lives in)
 		void Destroy() noexcept;
 
 		// Returns the underlying entity ID
 		[[nodiscard]] ECS::EntityID ID() const noexcept { return m_ID; }
 
+#pragma region Hierarchy
+		/**
+		 * @brief Attach the entity to a parent, its transform becomes relative to the parent's transform.
+		 * @param parent Entity to attach to, must live in the same world.
+		 * @note Fails when the parent is the entity itself or one of its descendants.
+		*/
+		void SetParent(Entity parent) noexcept;
+
+		// Detach the entity from its parent, its local transform becomes its world transform
+		void RemoveParent() noexcept;
+
+		// Returns the parent, or an invalid entity when there is none
+		[[nodiscard]] Entity GetParent() const noexcept;
+#pragma endregion
+
 		/**
 		 * @brief Check if the entity has all the listed components.
 		 * @tparam ComponentTypes Component types to check.
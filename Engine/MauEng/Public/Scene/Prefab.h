@@ -0,0 +1,85 @@
+#ifndef MAUENG_PREFAB_H
+#define MAUENG_PREFAB_H
+
+#include "../../ECS/Public/ECSWorld.h"
+
+#include "Components/CStaticMesh.h"
+#include "Components/CLight.h"
+#include "Components/CTransform.h"
+
+#include <functional>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace MauEng
+{
+	// Template for a set of components that is spawned many times, see Scene::Instantiate
+	// Every component type is added to all instances at once, so each pool is only grown once per batch.
+	class Prefab final
+	{
+	public:
+		Prefab() = default;
+		~Prefab() = default;
+
+		/**
+		 * @brief Give every instance a copy of the same component.
+		 * @tparam ComponentType Type of component to add.
+		 * @param args Arguments to construct the component with, it is constructed once & copied into the instances.
+		 * @note Components that own a renderer resource can't be copied, use SetMesh for meshes & AddWith for lights.
+		 * Scene::Instantiate already adds the transforms.
+		 */
+		template<typename ComponentType, typename... Args>
+			requires std::is_constructible_v<ComponentType, Args...>
+		Prefab& Add(Args&&... args)
+		{
+			static_assert(!std::is_same_v<ComponentType, CStaticMesh>, "Use SetMesh, the mesh is loaded once per batch");
+			static_assert(!std::is_same_v<ComponentType, CLight>, "Use AddWith, every light needs its own renderer light");
+			static_assert(!std::is_same_v<ComponentType, CTransform>, "Pass the transforms to Scene::Instantiate");
+
+			m_Components.emplace_back([component = ComponentType{ std::forward<Args>(args)... }](ECS::ECSWorld& world, std::span<ECS::EntityID const> entities)
+				{
+					world.Insert<ComponentType>(entities, component);
+				});
+			return *this;
+		}
+
+		/**
+		 * @brief Construct the component separately for every instance.
+		 * @tparam ComponentType Type of component to add, default constructed.
+		 * @param init Called as init(component) for every instance to set its values.
+		 */
+		template<typename ComponentType, typename Func>
+			requires std::default_initializable<ComponentType> && std::invocable<Func, ComponentType&>
+		Prefab& AddWith(Func&& init)
+		{
+			static_assert(!std::is_same_v<ComponentType, CTransform>, "Pass the transforms to Scene::Instantiate");
+
+			m_Components.emplace_back([init = std::forward<Func>(init)](ECS::ECSWorld& world, std::span<ECS::EntityID const> entities)
+				{
+					world.Reserve<ComponentType>(entities.size());
+					for (ECS::EntityID const id : entities)
+					{
+						init(world.AddComponent<ComponentType>(id));
+					}
+				});
+			return *this;
+		}
+
+		// Every instance draws this mesh, it is looked up & referenced once per batch
+		Prefab& SetMesh(std::string path)
+		{
+			m_MeshPath = std::move(path);
+			return *this;
+		}
+
+		// Add the prefab's components to the entities, the entities should not have any of the prefab's components yet
+		void Instantiate(ECS::ECSWorld& world, std::span<ECS::EntityID const> entities) const;
+
+	private:
+		std::vector<std::function<void(ECS::ECSWorld&, std::span<ECS::EntityID const>)>> m_Components{};
+		std::string m_MeshPath{};
+	};
+}
+
+#endif
@@ -0,0 +1,43 @@
+#ifndef MAUENG_RENDERPROXYSYSTEM_H
+#define MAUENG_RENDERPROXYSYSTEM_H
+
+#include "../../ECS/Public/ECSWorld.h"
+
+#include <span>
+#include <unordered_map>
+
+namespace MauEng
+{
+	// Mirrors the static meshes of a scene as persistent mesh instances in the renderer
+	// Instances are created for new & changed CStaticMesh components during Update, afterwards only changed transforms are sent to the renderer.
+	class RenderProxySystem final
+	{
+	public:
+		RenderProxySystem() = default;
+		~RenderProxySystem() = default;
+
+		// Hook the static mesh components of the world up to the system, call once
+		void RegisterCallbacks(ECS::ECSWorld& world);
+
+		// Create the instances of added or replaced meshes & send the new world matrices of the given entities to the renderer
+		void Update(ECS::ECSWorld const& world, std::span<ECS::EntityID const> updatedTransforms);
+
+		RenderProxySystem(RenderProxySystem const&) = delete;
+		RenderProxySystem(RenderProxySystem&&) = delete;
+		RenderProxySystem& operator=(RenderProxySystem const&) = delete;
+		RenderProxySystem& operator=(RenderProxySystem&&) = delete;
+
+	private:
+		// Entity -> renderer mesh instance ID
+		std::unordered_map<ECS::EntityID, uint32_t> m_Instances{};
+
+		// Shared with the other readers of the world, only read here. The scene manager clears them every frame
+		ECS::ReactiveSet* m_pAddedMeshes{ nullptr };
+		ECS::ReactiveSet* m_pChangedMeshes{ nullptr };
+
+		void CreateInstance(ECS::ECSWorld const& world, ECS::EntityID id, uint32_t meshID);
+		void DestroyInstance(ECS::EntityID id);
+	};
+}
+
+#endif
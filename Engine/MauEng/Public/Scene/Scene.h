@@ -7,12 +7,25 @@
 
 #include "ServiceLocator.h"
 #include "../../ECS/Public/ECSWorld.h"
+#include "../../ECS/Public/CommandBuffer.h"
+#include "../../ECS/Public/WorldSnapshot.h"
+#include "../../ECS/Public/SystemScheduler.h"
 #include "Entity.h"
 
 #include "Components/CTransform.h"
+#include "Components/CParent.h"
+#include "Components/CChildren.h"
+#include "Components/CInterpolated.h"
+#include "TransformSystem.h"
+#include "RenderProxySystem.h"
+#include "SpatialSystem.h"
+#include "Prefab.h"
+#include "SubSceneStreamer.h"
 
 #include "Timer/TimerManager.h"
 
+#include <span>
+
 namespace MauEng
 {
 	// Base scene class to inherit from when creating a scene for the game
@@ -25,9 +38,16 @@ namespace MauEng
 		// Called when the scene is loaded
 		virtual void OnLoad(){}
 
-		// Called each frame
+		// Called each frame, runs the scene's systems
 		virtual void Tick();
 
+		// Called every TIME.FixedTimeStepSec(), zero or more times per frame before Tick, runs the scene's fixed systems
+		// Move entities with CInterpolated here to have them rendered smoothly at any frame rate.
+		virtual void FixedTick();
+
+		// Called by the scene manager before every FixedTick
+		void BeginFixedStep() { m_TransformSystem.BeginFixedStep(m_ECSWorld); }
+
 		// Called to render the scene
 		virtual void OnRender() const;
 
@@ -38,10 +58,66 @@ namespace MauEng
 
 #pragma region ECS
 		[[nodiscard]] Entity CreateEntity(glm::vec3 const& pos = {});
+		// Create one entity per transform in one go, outEntities must hold at least as many entities as there are transforms
+		void CreateEntities(std::span<CTransform const> transforms, std::span<ECS::EntityID> outEntities);
+		/**
+		 * @brief Spawn count instances of a prefab.
+		 * @param transforms Either empty (every instance starts at the origin) or one transform per instance.
+		 * @return The new entities.
+		 */
+		std::vector<ECS::EntityID> Instantiate(Prefab const& prefab, std::size_t count, std::span<CTransform const> transforms = {});
 		void DestroyEntity(Entity entity);
 
 		[[nodiscard]] ECS::ECSWorld& GetECSWorld() noexcept { return m_ECSWorld; }
 		[[nodiscard]] ECS::ECSWorld const& GetECSWorld() const noexcept { return m_ECSWorld; }
+
+		// Save all entities with snapshot components (transforms, meshes, lights & whatever the game registered) to a binary file
+		[[nodiscard]] bool SaveSnapshot(char const* path) const;
+		// Add the entities of a snapshot to the scene, much faster than rebuilding them with CreateEntity & AddComponent
+		[[nodiscard]] bool LoadSnapshot(char const* path);
+		// Register game components here to include them in snapshots
+		[[nodiscard]] ECS::WorldSnapshot& GetSnapshotLayout() noexcept { return m_SnapshotLayout; }
+
+		// Load a snapshot in the background & add its entities to the scene at a frame boundary once it's ready
+		[[nodiscard]] SubSceneStreamer::SubSceneID StreamIn(std::string path) { return m_SubSceneStreamer.StreamIn(m_SnapshotLayout, std::move(path)); }
+		// Remove all entities of a streamed in sub scene at the next frame boundary
+		void StreamOut(SubSceneStreamer::SubSceneID id) { m_SubSceneStreamer.StreamOut(id); }
+		[[nodiscard]] bool IsSubSceneAttached(SubSceneStreamer::SubSceneID id) const noexcept { return m_SubSceneStreamer.IsAttached(id); }
+		// Frame boundary, called by the scene manager after the command buffer was played back
+		void UpdateStreaming() { m_SubSceneStreamer.Update(m_ECSWorld, m_SnapshotLayout); }
+
+		/**
+		 * @brief Add a system that runs every Tick, in parallel with the systems it doesn't share written components with.
+		 * @tparam ReadSet ECS::Read<...>, the components the system reads.
+		 * @tparam WriteSet ECS::Write<...>, the components the system writes.
+		 * @param func Called as func(world), record structural changes in the command buffer.
+		 */
+		template<typename ReadSet = ECS::Read<>, typename WriteSet = ECS::Write<>, typename Func>
+			requires ECS::SystemCallable<Func>
+		void AddSystem(std::string name, Func&& func)
+		{
+			m_SystemScheduler.AddSystem<ReadSet, WriteSet>(std::move(name), std::forward<Func>(func));
+		}
+		// Like AddSystem, but the system runs every FixedTick instead
+		template<typename ReadSet = ECS::Read<>, typename WriteSet = ECS::Write<>, typename Func>
+			requires ECS::SystemCallable<Func>
+		void AddFixedSystem(std::string name, Func&& func)
+		{
+			m_FixedSystemScheduler.AddSystem<ReadSet, WriteSet>(std::move(name), std::forward<Func>(func));
+		}
+		// Add a system that runs alone on the main thread, ordered with the other systems as it was added
+		template<typename Func>
+			requires ECS::SystemCallable<Func>
+		void AddMainThreadSystem(std::string name, Func&& func)
+		{
+			m_SystemScheduler.AddMainThreadSystem(std::move(name), std::forward<Func>(func));
+		}
+
+		// Bounds of every static mesh, as of the last rendered frame
+		[[nodiscard]] SpatialSystem const& GetSpatialIndex() const noexcept { return m_SpatialSystem; }
+
+		// Structural changes recorded here are applied right after the scene's Tick, safe to use while iterating a view or from jobs
+		[[nodiscard]] ECS::CommandBuffer& GetCommandBuffer() noexcept { return m_CommandBuffer; }
 #pragma endregion
 
 		[[nodiscard]] CameraManager const& GetCameraManager() const noexcept { return m_CameraManager; }
@@ -60,7 +136,20 @@ namespace MauEng
 		MauCor::TimerManager m_TimerManager{};
 
 	private:
+		// Declared before the world so they outlive every transform & callback pointing to them
+		mutable TransformSystem m_TransformSystem{ };
+		mutable RenderProxySystem m_RenderProxySystem{ };
+		mutable SpatialSystem m_SpatialSystem{ };
 		mutable ECS::ECSWorld m_ECSWorld{ };
+		// Deferred destroys go through the same teardown as Entity::Destroy, so children & mesh references are released
+		ECS::CommandBuffer m_CommandBuffer{ [](ECS::ECSWorld& world, ECS::EntityID id) { Entity{ &world, id }.Destroy(); } };
+		ECS::SystemScheduler m_SystemScheduler{ };
+		ECS::SystemScheduler m_FixedSystemScheduler{ };
+		ECS::WorldSnapshot m_SnapshotLayout{ };
+		// After the layout, its loading jobs use the layout until the streamer is destroyed
+		SubSceneStreamer m_SubSceneStreamer{ };
+
+		void RegisterSnapshotComponents();
 
 	};
 }
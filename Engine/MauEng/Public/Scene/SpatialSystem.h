@@ -0,0 +1,114 @@
+#ifndef MAUENG_SPATIALSYSTEM_H
+#define MAUENG_SPATIALSYSTEM_H
+
+#include "../../ECS/Public/ECSWorld.h"
+#include "../../ECS/Public/ReactiveSet.h"
+
+#include "Math/DynamicBVH.h"
+
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace MauEng
+{
+	// Keeps the world bounds of a scene's static meshes in a dynamic BVH for culling & spatial queries
+	// Bounds follow the transforms the transform system updated, so queries see the state of the last rendered frame.
+	// Queries only read, they are safe to run from several jobs at once as long as Update isn't running.
+	class SpatialSystem final
+	{
+	public:
+		struct RaycastHit final
+		{
+			ECS::EntityID entity{ ECS::NULL_ENTITY_ID };
+			float distance{ 0.f };
+		};
+
+		SpatialSystem() = default;
+		~SpatialSystem() = default;
+
+		// Hook the static mesh components of the world up to the system, call once
+		void RegisterCallbacks(ECS::ECSWorld& world);
+
+		// Insert added or replaced meshes & move the bounds of the given entities
+		void Update(ECS::ECSWorld const& world, std::span<ECS::EntityID const> updatedTransforms);
+
+		// Calls func(entity) for every mesh whose world bounds overlap the box
+		template<typename Func>
+			requires std::invocable<Func, ECS::EntityID>
+		void Query(MauCor::AABB const& aabb, Func&& func) const
+		{
+			m_BVH.Query(aabb, [&](int32_t proxyID)
+				{
+					if (aabb.Overlaps(m_Bounds[proxyID]))
+					{
+						func(GetEntity(proxyID));
+					}
+				});
+		}
+
+		// Calls func(entity) for every mesh whose world bounds overlap the sphere
+		template<typename Func>
+			requires std::invocable<Func, ECS::EntityID>
+		void Query(MauCor::BoundingSphere const& sphere, Func&& func) const
+		{
+			m_BVH.Query(sphere, [&](int32_t proxyID)
+				{
+					if (sphere.Overlaps(m_Bounds[proxyID]))
+					{
+						func(GetEntity(proxyID));
+					}
+				});
+		}
+
+		// Calls func(entity) for every mesh whose world bounds are (partially) inside the frustum
+		template<typename Func>
+			requires std::invocable<Func, ECS::EntityID>
+		void Query(MauCor::Frustum const& frustum, Func&& func) const
+		{
+			m_BVH.Query(frustum, [&](int32_t proxyID)
+				{
+					if (frustum.Intersects(m_Bounds[proxyID]))
+					{
+						func(GetEntity(proxyID));
+					}
+				});
+		}
+
+		/**
+		 * @brief Find the closest mesh bounds hit by the ray.
+		 * @param ray Ray to cast, its direction has to be normalised.
+		 * @param maxDistance Hits further away are ignored.
+		 * @param outHit The closest hit, untouched when nothing was hit.
+		 * @return True on a hit.
+		 */
+		[[nodiscard]] bool Raycast(MauCor::Ray const& ray, float maxDistance, RaycastHit& outHit) const;
+
+		// Bounds of every mesh in the scene (slightly fattened), invalid when there are none
+		[[nodiscard]] MauCor::AABB GetBounds() const noexcept { return m_BVH.GetBounds(); }
+		[[nodiscard]] std::size_t Size() const noexcept { return m_BVH.ProxyCount(); }
+
+		SpatialSystem(SpatialSystem const&) = delete;
+		SpatialSystem(SpatialSystem&&) = delete;
+		SpatialSystem& operator=(SpatialSystem const&) = delete;
+		SpatialSystem& operator=(SpatialSystem&&) = delete;
+
+	private:
+		MauCor::DynamicBVH m_BVH{};
+
+		// Entity -> proxy in the BVH
+		std::unordered_map<ECS::EntityID, int32_t> m_Proxies{};
+		// Exact world bounds per proxy ID, the BVH only stores fattened ones
+		std::vector<MauCor::AABB> m_Bounds{};
+
+		// Fed by its own callbacks & cleared in Update, the shared OnConstruct & OnUpdate sets are only cleared once per frame by the scene manager (ECSWorld::ClearReactiveSets)
+		ECS::ReactiveSet m_ChangedMeshes{};
+
+		[[nodiscard]] ECS::EntityID GetEntity(int32_t proxyID) const noexcept { return static_cast<ECS::EntityID>(m_BVH.GetUserData(proxyID)); }
+
+		void UpdateProxy(ECS::ECSWorld const& world, ECS::EntityID id);
+		void RemoveProxy(ECS::EntityID id);
+	};
+}
+
+#endif
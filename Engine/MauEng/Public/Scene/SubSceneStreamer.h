@@ -0,0 +1,82 @@
+#ifndef MAUENG_SUBSCENESTREAMER_H
+#define MAUENG_SUBSCENESTREAMER_H
+
+#include "../../ECS/Public/ECSWorld.h"
+#include "../../ECS/Public/WorldSnapshot.h"
+
+#include "Jobs/JobSystem.h"
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace MauEng
+{
+	// Streams snapshot files in & out of a scene as sub scenes (a level chunk, an interior, ...)
+	// Reading & validating the file runs on the job system, the world only changes in Update, which the scene manager calls at the frame boundary.
+	// Attaching & detaching are bulk operations, the entities are created & destroyed in one go & every mesh is referenced or released once per sub scene.
+	class SubSceneStreamer final
+	{
+	public:
+		using SubSceneID = uint32_t;
+		static constexpr SubSceneID INVALID_SUB_SCENE_ID{ UINT32_MAX };
+
+		SubSceneStreamer() = default;
+		// Waits for sub scenes that are still being read
+		~SubSceneStreamer();
+
+		/**
+		 * @brief Start reading a snapshot in the background, it is attached during the first Update after it's ready.
+		 * @param layout Snapshot layout of the scene, has to outlive the streamer & can't change while sub scenes are loading.
+		 * @param path Snapshot file.
+		 * @return Handle to stream the sub scene out again.
+		 */
+		[[nodiscard]] SubSceneID StreamIn(ECS::WorldSnapshot const& layout, std::string path);
+		// Detach the sub scene during the next Update, or drop it as soon as it's read when it isn't attached yet
+		void StreamOut(SubSceneID id);
+
+		[[nodiscard]] bool IsAttached(SubSceneID id) const noexcept;
+
+		// Frame boundary, attach sub scenes that finished loading & detach the ones that were streamed out
+		void Update(ECS::ECSWorld& world, ECS::WorldSnapshot const& layout);
+
+		SubSceneStreamer(SubSceneStreamer const&) = delete;
+		SubSceneStreamer(SubSceneStreamer&&) = delete;
+		SubSceneStreamer& operator=(SubSceneStreamer const&) = delete;
+		SubSceneStreamer& operator=(SubSceneStreamer&&) = delete;
+
+	private:
+		enum class EState : uint8_t
+		{
+			Loading,
+			Ready,
+			Failed,
+			Attached
+		};
+
+		struct SubScene final
+		{
+			std::string path{};
+			// Written by the loading job, read on the main thread
+			std::atomic<EState> state{ EState::Loading };
+			// Released once the sub scene is attached
+			std::unique_ptr<ECS::PreparedSnapshot> pPrepared{ std::make_unique<ECS::PreparedSnapshot>() };
+
+			// Entities created when the sub scene was attached
+			std::vector<ECS::EntityID> entities{};
+			bool isStreamedOut{ false };
+		};
+
+		std::unordered_map<SubSceneID, std::unique_ptr<SubScene>> m_SubScenes{};
+		SubSceneID m_NextID{ 0 };
+
+		MauCor::JobCounter m_LoadJobs{};
+
+		void Attach(ECS::ECSWorld& world, ECS::WorldSnapshot const& layout, SubScene& subScene);
+		void Detach(ECS::ECSWorld& world, SubScene& subScene);
+	};
+}
+
+#endif
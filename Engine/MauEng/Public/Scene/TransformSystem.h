@@ -0,0 +1,66 @@
+#ifndef MAUENG_TRANSFORMSYSTEM_H
+#define MAUENG_TRANSFORMSYSTEM_H
+
+#include "../../ECS/Public/ECSWorld.h"
+#include "../../ECS/Public/DirtyList.h"
+
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace MauEng
+{
+	// Keeps the world matrices of a scene's transforms up to date
+	// Only transforms that changed are visited, parented transforms are propagated in one depth first sweep over the hierarchy.
+	class TransformSystem final
+	{
+	public:
+		TransformSystem() = default;
+		~TransformSystem() = default;
+
+		// Hook the transform & hierarchy components of the world up to the system, call once
+		void RegisterCallbacks(ECS::ECSWorld& world);
+
+		// Store the state of interpolated transforms, call before every fixed step
+		void BeginFixedStep(ECS::ECSWorld& world);
+
+		/**
+		 * @brief Recalculate the world matrices of all transforms that changed since the last call, parents are always updated before their children.
+		 * @param fixedAlpha Progress into the next fixed step, interpolated transforms are placed this far between their previous & current state.
+		 */
+		void Update(ECS::ECSWorld& world, float fixedAlpha = 1.f);
+
+		// Entities whose world matrix changed during the last Update, may contain duplicates
+		[[nodiscard]] std::span<ECS::EntityID const> GetUpdatedTransforms() const noexcept { return m_UpdatedTransforms; }
+
+		TransformSystem(TransformSystem const&) = delete;
+		TransformSystem(TransformSystem&&) = delete;
+		TransformSystem& operator=(TransformSystem const&) = delete;
+		TransformSystem& operator=(TransformSystem&&) = delete;
+
+	private:
+		ECS::DirtyList m_DirtyTransforms{};
+
+		// Every entity reachable from a root in depth first order, the CParent & CTransform storages are sorted to match
+		std::vector<ECS::EntityID> m_HierarchyOrder{};
+		// [begin, end) of each root's subtree in the hierarchy order, subtrees are independent so they can be updated in parallel
+		std::vector<std::pair<uint32_t, uint32_t>> m_SubtreeRanges{};
+		// Per hierarchy entry, did its world matrix change during the current update
+		std::vector<uint8_t> m_HasChanged{};
+
+		// Filled during Update, read by systems that mirror world matrices elsewhere (render proxies, ...)
+		std::vector<ECS::EntityID> m_UpdatedTransforms{};
+
+		// Parents changed since the last update, the order has to be rebuilt
+		bool m_IsHierarchyDirty{ false };
+
+		void RebuildHierarchyOrder(ECS::ECSWorld& world);
+		void UpdateDirtyRoots(ECS::ECSWorld& world);
+		void MarkMovingInterpolated(ECS::ECSWorld& world);
+		void InterpolateRoots(ECS::ECSWorld& world, float fixedAlpha);
+		[[nodiscard]] bool IsCurrentRootEntry(ECS::ECSWorld& world, std::size_t idx, uint32_t generation) const;
+		void PropagateHierarchy(ECS::ECSWorld& world, bool updateAll);
+	};
+}
+
+#endif
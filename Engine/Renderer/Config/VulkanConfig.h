@@ -55,6 +55,24 @@ namespace MauRen
 
 	uint32_t constexpr MAX_VERTICES{ 10'000'000 };      // Maximum number of vertices (for all meshes)
 	uint32_t constexpr MAX_INDICES{ 20'000'000 };       // Maximum number of indices (for all meshes)
+	uint32_t constexpr UPLOAD_STAGING_RING_SIZE{ 64 * 1024 * 1024 }; // Bytes, uploads that are larger than the whole ring are copied on their own
+	uint32_t constexpr MESH_COMPACTION_BUDGET{ 4 * 1024 * 1024 }; // Bytes of geometry moved a frame to close the gaps of unloaded meshes
+
+	// Pipeline cache kept between runs, relative to the working directory. Discarded when it was written by another device or driver
+	auto constexpr PIPELINE_CACHE_PATH{ "Cache/PipelineCache.bin" };
+
+	// Recompiles a shader when its GLSL changes & swaps in the pipelines using it, see VulkanShaderHotReloader
+	// Set by MAUENG_ENABLE_SHADER_HOT_RELOAD, off in distribution builds
+	#ifdef MAUENG_ENABLE_SHADER_HOT_RELOAD
+		bool constexpr ENABLE_SHADER_HOT_RELOAD{ true };
+		auto constexpr GLSLC_PATH{ MAUENG_GLSLC_PATH };
+		auto constexpr SHADER_SOURCE_DIR{ MAUENG_SHADER_SOURCE_DIR };
+	#else
+		bool constexpr ENABLE_SHADER_HOT_RELOAD{ false };
+		auto constexpr GLSLC_PATH{ "" };
+		auto constexpr SHADER_SOURCE_DIR{ "" };
+	#endif
+	uint32_t constexpr SHADER_HOT_RELOAD_POLL_MS{ 250 };
 
 	bool constexpr DEBUG_OUT_MAT{ true };
 
@@ -65,6 +83,10 @@ namespace MauRen
 	uint32_t constexpr SHADOW_MAP_SIZE{ 1024 * 4 };
 
 	bool constexpr DEBUG_RENDER_SCENE_AABB{ false };
+
+	// Cull the camera's instances in a compute pass & draw them with vkCmdDrawIndexedIndirectCount
+	// Falls back to the CPU culling when the device lacks drawIndirectCount
+	bool constexpr ENABLE_GPU_CULLING{ true };
 }
 
 #endif // MAUREN_VULKANCONFIG_H
\ No newline at end of file
@@ -3,6 +3,8 @@
 
 #include <vector>
 
+#include "Math/Bounds.h"
+
 #include "BindlessData.h"
 #include "Vertex.h"
 
@@ -13,6 +15,9 @@ namespace MauRen
 		std::vector<Vertex> vertices;
 		std::vector<uint32_t> indices;
 		std::vector<SubMeshData> subMeshes;
+
+		// Bounds of every vertex in model space (node transforms applied)
+		MauCor::AABB bounds;
 	};
 }
 
@@ -61,10 +61,13 @@ namespace MauRen
 
 		glm::mat4 const glmTransform{ glm::transpose(glm::mat4{ transform.a1 }) };
 		glm::mat3 const normalMatrix{ glm::transpose(glm::inverse(glm::mat3{ glmTransform })) };
+
+		MauCor::AABB subMeshBounds{};
 		for (unsigned j{ 0 }; j < mesh->mNumVertices; ++j)
 		{
 			aiVector3D const transformedPos{ transform * mesh->mVertices[j] };
 			glm::vec3 const position{ transformedPos.x, transformedPos.y, transformedPos.z };
+			subMeshBounds.Grow(position);
 
 			ME_ASSERT(mesh->HasTangentsAndBitangents());
 			ME_ASSERT(mesh->HasNormals());
@@ -165,8 +168,10 @@ namespace MauRen
 				.firstIndex = indexOffset,
 				.vertexOffset = static_cast<int32_t>(vertexOffset),
 				.vertexCount = static_cast<uint32_t>(mesh->mNumVertices),
-				.materialID = matID
+				.materialID = matID,
+				.bounds = subMeshBounds
 			});
+		model.bounds.Grow(subMeshBounds);
 	}
 
 
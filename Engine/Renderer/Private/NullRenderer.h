@@ -33,11 +33,16 @@ namespace MauRen
 		virtual void ResizeWindow() override {}
 
 		virtual void QueueDraw(glm::mat4 const&, MauEng::CStaticMesh const&) override {}
-		virtual void UnloadMesh(uint32_t) override {}
-		virtual uint32_t LoadOrGetMeshID(char const*) override { return INVALID_MESH_ID; }
+		virtual uint32_t CreateMeshInstance(glm::mat4 const&, uint32_t) override { return INVALID_MESH_INSTANCE_ID; }
+		virtual void UpdateMeshInstance(uint32_t, glm::mat4 const&) override {}
+		virtual void DestroyMeshInstance(uint32_t) override {}
+		virtual void UnloadMesh(uint32_t, uint32_t) override {}
+		virtual uint32_t LoadOrGetMeshID(char const*, uint32_t) override { return INVALID_MESH_ID; }
+		virtual std::string GetMeshPath(uint32_t) const override { return {}; }
+		virtual MauCor::AABB GetMeshBounds(uint32_t) const override { return {}; }
 
 		virtual void SetSceneAABBOverride(glm::vec3 const&, glm::vec3 const&) override {}
-		virtual void PreLightQueue(glm::mat4 const&) override {}
+		virtual void PreLightQueue(glm::mat4 const&, MauCor::AABB const&) override {}
 		virtual uint32_t CreateLight() override { return INVALID_LIGHT_ID; }
 		virtual void QueueLight(MauEng::CLight const&) override {}
 
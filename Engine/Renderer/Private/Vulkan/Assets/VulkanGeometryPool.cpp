@@ -0,0 +1,142 @@
+#include "VulkanGeometryPool.h"
+
+#include "Vulkan/VulkanMemoryAllocator.h"
+#include "Vulkan/Passes/GlobalBarrier.h"
+
+namespace MauRen
+{
+	void VulkanGeometryPool::Initialize()
+	{
+		auto const deviceContext{ VulkanDeviceContextManager::GetInstance().GetDeviceContext() };
+
+		VkPhysicalDeviceProperties properties{};
+		vkGetPhysicalDeviceProperties(deviceContext->GetPhysicalDevice(), &properties);
+		m_IsDeviceLocal = VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU != properties.deviceType;
+
+		VkDeviceSize constexpr VERTEX_BUFFER_SIZE{ sizeof(Vertex) * MAX_VERTICES };
+		VkDeviceSize constexpr INDEX_BUFFER_SIZE{ sizeof(uint32_t) * MAX_INDICES };
+
+		if (!m_IsDeviceLocal)
+		{
+			m_VertexBuffer = VulkanMappedBuffer{ VulkanBuffer{ VERTEX_BUFFER_SIZE,
+																VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+																VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT },
+												nullptr };
+			m_IndexBuffer = VulkanMappedBuffer{ VulkanBuffer{ INDEX_BUFFER_SIZE,
+																VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
+																VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT },
+												nullptr };
+
+			// Persistent mapping
+			vmaMapMemory(VulkanMemoryAllocator::GetInstance().GetAllocator(), m_VertexBuffer.buffer.alloc, &m_VertexBuffer.mapped);
+			vmaMapMemory(VulkanMemoryAllocator::GetInstance().GetAllocator(), m_IndexBuffer.buffer.alloc, &m_IndexBuffer.mapped);
+
+			ME_LOG_INFO(LogRenderer, "Integrated GPU ({}), mesh geometry is written directly to host visible memory", properties.deviceName);
+			return;
+		}
+
+		m_VertexBuffer.buffer = VulkanBuffer{ VERTEX_BUFFER_SIZE, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT };
+		m_IndexBuffer.buffer = VulkanBuffer{ INDEX_BUFFER_SIZE, VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT };
+	}
+
+	void VulkanGeometryPool::Destroy()
+	{
+		for (auto* b : { &m_VertexBuffer, &m_IndexBuffer })
+		{
+			b->UnMap();
+			b->buffer.Destroy();
+		}
+
+		m_VertexMoves.clear();
+		m_IndexMoves.clear();
+	}
+
+	void VulkanGeometryPool::Write(std::span<Vertex const> vertices, uint32_t vertexOffset, std::span<uint32_t const> indices, uint32_t indexOffset, VulkanUploadManager::CompletionCallback onComplete)
+	{
+		ME_PROFILE_FUNCTION()
+
+		ME_RENDERER_ASSERT(vertexOffset + vertices.size() <= MAX_VERTICES);
+		ME_RENDERER_ASSERT(indexOffset + indices.size() <= MAX_INDICES);
+
+		if (!m_IsDeviceLocal)
+		{
+			memcpy(static_cast<Vertex*>(m_VertexBuffer.mapped) + vertexOffset, vertices.data(), vertices.size_bytes());
+			memcpy(static_cast<uint32_t*>(m_IndexBuffer.mapped) + indexOffset, indices.data(), indices.size_bytes());
+
+			if (onComplete)
+			{
+				onComplete();
+			}
+			return;
+		}
+
+		// Both land in the same batch, so the callback covers the vertices as well
+		auto& uploadManager{ VulkanUploadManager::GetInstance() };
+		uploadManager.UploadBuffer(vertices.data(), vertices.size_bytes(), m_VertexBuffer.buffer.buffer, vertexOffset * sizeof(Vertex),
+			VK_PIPELINE_STAGE_2_VERTEX_ATTRIBUTE_INPUT_BIT | VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_2_TRANSFER_READ_BIT);
+		uploadManager.UploadBuffer(indices.data(), indices.size_bytes(), m_IndexBuffer.buffer.buffer, indexOffset * sizeof(uint32_t),
+			VK_PIPELINE_STAGE_2_INDEX_INPUT_BIT | VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_INDEX_READ_BIT | VK_ACCESS_2_TRANSFER_READ_BIT,
+			std::move(onComplete));
+	}
+
+	void VulkanGeometryPool::MoveVertices(uint32_t srcOffset, uint32_t dstOffset, uint32_t count)
+	{
+		ME_RENDERER_ASSERT(srcOffset + count <= MAX_VERTICES && dstOffset + count <= MAX_VERTICES);
+		ME_RENDERER_ASSERT(srcOffset + count <= dstOffset || dstOffset + count <= srcOffset);
+
+		if (!m_IsDeviceLocal)
+		{
+			auto* const pVertices{ static_cast<Vertex*>(m_VertexBuffer.mapped) };
+			memcpy(pVertices + dstOffset, pVertices + srcOffset, count * sizeof(Vertex));
+			return;
+		}
+
+		m_VertexMoves.emplace_back(srcOffset * sizeof(Vertex), dstOffset * sizeof(Vertex), count * sizeof(Vertex));
+	}
+
+	void VulkanGeometryPool::MoveIndices(uint32_t srcOffset, uint32_t dstOffset, uint32_t count)
+	{
+		ME_RENDERER_ASSERT(srcOffset + count <= MAX_INDICES && dstOffset + count <= MAX_INDICES);
+		ME_RENDERER_ASSERT(srcOffset + count <= dstOffset || dstOffset + count <= srcOffset);
+
+		if (!m_IsDeviceLocal)
+		{
+			auto* const pIndices{ static_cast<uint32_t*>(m_IndexBuffer.mapped) };
+			memcpy(pIndices + dstOffset, pIndices + srcOffset, count * sizeof(uint32_t));
+			return;
+		}
+
+		m_IndexMoves.emplace_back(srcOffset * sizeof(uint32_t), dstOffset * sizeof(uint32_t), count * sizeof(uint32_t));
+	}
+
+	void VulkanGeometryPool::RecordMoves(VkCommandBuffer commandBuffer)
+	{
+		ME_PROFILE_FUNCTION()
+
+		if (m_VertexMoves.empty() && m_IndexMoves.empty())
+		{
+			return;
+		}
+
+		// A move can read geometry an earlier frame moved
+		GlobalBarrier(commandBuffer,
+			VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT,
+			VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_READ_BIT);
+
+		if (!m_VertexMoves.empty())
+		{
+			vkCmdCopyBuffer(commandBuffer, m_VertexBuffer.buffer.buffer, m_VertexBuffer.buffer.buffer, static_cast<uint32_t>(m_VertexMoves.size()), m_VertexMoves.data());
+		}
+		if (!m_IndexMoves.empty())
+		{
+			vkCmdCopyBuffer(commandBuffer, m_IndexBuffer.buffer.buffer, m_IndexBuffer.buffer.buffer, static_cast<uint32_t>(m_IndexMoves.size()), m_IndexMoves.data());
+		}
+
+		m_VertexMoves.clear();
+		m_IndexMoves.clear();
+
+		GlobalBarrier(commandBuffer,
+			VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT,
+			VK_PIPELINE_STAGE_2_VERTEX_ATTRIBUTE_INPUT_BIT | VK_PIPELINE_STAGE_2_INDEX_INPUT_BIT, VK_ACCESS_2_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_2_INDEX_READ_BIT);
+	}
+}
@@ -0,0 +1,60 @@
+#ifndef MAUREN_VULKANGEOMETRYPOOL_H
+#define MAUREN_VULKANGEOMETRYPOOL_H
+
+#include "RendererPCH.h"
+#include "Vertex.h"
+#include "../VulkanBuffer.h"
+#include "../VulkanUploadManager.h"
+
+namespace MauRen
+{
+	/**
+	 * @brief The single vertex & index buffer every mesh lives in.
+	 *
+	 * Device local & filled through the VulkanUploadManager, so the geometry can only be drawn once its upload completed.
+	 * Integrated GPUs get host visible buffers instead that are written directly, there all memory is device local anyway.
+	 * Only moves data, which ranges are free is up to the caller.
+	 */
+	class VulkanGeometryPool final
+	{
+	public:
+		VulkanGeometryPool() = default;
+		~VulkanGeometryPool() = default;
+
+		void Initialize();
+		void Destroy();
+
+		// The ranges can't be in use by a frame in flight, the data is copied before this returns
+		// onComplete runs once the geometry can be drawn, right away when the pool is host visible
+		void Write(std::span<Vertex const> vertices, uint32_t vertexOffset, std::span<uint32_t const> indices, uint32_t indexOffset, VulkanUploadManager::CompletionCallback onComplete);
+
+		// Copies geometry inside the pool, the destination can't overlap the source or be in use by a frame in flight
+		// The source has to be done uploading
+		void MoveVertices(uint32_t srcOffset, uint32_t dstOffset, uint32_t count);
+		void MoveIndices(uint32_t srcOffset, uint32_t dstOffset, uint32_t count);
+
+		// Records the moves queued since the last call, has to be outside of rendering, after the upload acquires & before the draws
+		void RecordMoves(VkCommandBuffer commandBuffer);
+
+		[[nodiscard]] VkBuffer GetVertexBuffer() const noexcept { return m_VertexBuffer.buffer.buffer; }
+		[[nodiscard]] VkBuffer GetIndexBuffer() const noexcept { return m_IndexBuffer.buffer.buffer; }
+		[[nodiscard]] bool IsDeviceLocal() const noexcept { return m_IsDeviceLocal; }
+
+		VulkanGeometryPool(VulkanGeometryPool const&) = delete;
+		VulkanGeometryPool(VulkanGeometryPool&&) = delete;
+		VulkanGeometryPool& operator=(VulkanGeometryPool const&) = delete;
+		VulkanGeometryPool& operator=(VulkanGeometryPool&&) = delete;
+
+	private:
+		// Only mapped when host visible
+		VulkanMappedBuffer m_VertexBuffer{};
+		VulkanMappedBuffer m_IndexBuffer{};
+		bool m_IsDeviceLocal{ true };
+
+		// Copies within the vertex & index buffer
+		std::vector<VkBufferCopy> m_VertexMoves{};
+		std::vector<VkBufferCopy> m_IndexMoves{};
+	};
+}
+
+#endif
@@ -88,8 +88,14 @@ namespace MauRen
 
 	void VulkanImage::GenerateMipmaps(VulkanCommandPoolManager const& CmdPoolManager)
 	{
-		auto const deviceContext{ VulkanDeviceContextManager::GetInstance().GetDeviceContext() };
 		VkCommandBuffer const commandBuffer{ CmdPoolManager.BeginSingleTimeCommands() };
+		GenerateMipmaps(commandBuffer);
+		CmdPoolManager.EndSingleTimeCommands(commandBuffer);
+	}
+
+	void VulkanImage::GenerateMipmaps(VkCommandBuffer commandBuffer)
+	{
+		auto const deviceContext{ VulkanDeviceContextManager::GetInstance().GetDeviceContext() };
 
 		VkFormatProperties formatProperties{};
 		vkGetPhysicalDeviceFormatProperties(deviceContext->GetPhysicalDevice(), format, &formatProperties);
@@ -222,12 +228,10 @@ namespace MauRen
 			.pImageMemoryBarriers = &finalBarrier
 		};
 		vkCmdPipelineBarrier2(commandBuffer, &finalDepInfo);
-
-		CmdPoolManager.EndSingleTimeCommands(commandBuffer);
 	}
 
 
-	uint32_t VulkanImage::CreateImageView(VkImageAspectFlags aspectFlags)
+	uint32_t VulkanImage::CreateImageView(VkImageAspectFlags aspectFlags, uint32_t baseMipLevel, uint32_t levelCount)
 	{
 		auto const deviceContext{ VulkanDeviceContextManager::GetInstance().GetDeviceContext() };
 
@@ -237,8 +241,8 @@ namespace MauRen
 		viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
 		viewInfo.format = format;
 		viewInfo.subresourceRange.aspectMask = aspectFlags;
-		viewInfo.subresourceRange.baseMipLevel = 0;
-		viewInfo.subresourceRange.levelCount = mipLevels;
+		viewInfo.subresourceRange.baseMipLevel = baseMipLevel;
+		viewInfo.subresourceRange.levelCount = levelCount;
 		viewInfo.subresourceRange.baseArrayLayer = 0;
 		viewInfo.subresourceRange.layerCount = 1;
 
@@ -39,7 +39,10 @@ namespace MauRen
 									VkAccessFlags2 dstAccessMask);
 
 		void GenerateMipmaps(VulkanCommandPoolManager const& CmdPoolManager);
-		uint32_t CreateImageView(VkImageAspectFlags aspectFlags);
+		// Every mip has to be in VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, needs a graphics queue for the blits
+		void GenerateMipmaps(VkCommandBuffer commandBuffer);
+		// Returns the index into imageViews, views all mips by default
+		uint32_t CreateImageView(VkImageAspectFlags aspectFlags, uint32_t baseMipLevel = 0, uint32_t levelCount = VK_REMAINING_MIP_LEVELS);
 
 		void DestroyAllImageViews() noexcept;
 
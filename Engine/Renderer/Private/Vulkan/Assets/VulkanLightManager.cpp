@@ -44,81 +44,83 @@ namespace MauRen
 		return m_NextLightID++;
 	}
 
-	void VulkanLightManager::Draw(VkCommandBuffer const& commandBuffer, VulkanGraphicsPipelineContext const& graphicsPipelineContext, VulkanDescriptorContext& descriptorContext, VulkanSwapchainContext& swapChainContext, uint32_t frame)
+	void VulkanLightManager::DrawShadowPasses(VkCommandBuffer commandBuffer, uint32_t first, uint32_t last, VulkanGraphicsPipelineContext const& graphicsPipelineContext, VulkanDescriptorContext const& descriptorContext, uint32_t frame)
 	{
+		ME_PROFILE_FUNCTION()
+
+		ME_RENDERER_ASSERT(first <= last && last <= std::size(m_ShadowCasters));
+
 		VkClearValue constexpr depthClear{ .depthStencil = { 1.0f, 0 } };
 
-		for (uint32_t lightId{ 0 }; lightId < std::size(m_Lights); ++lightId)
+		for (uint32_t casterIdx{ first }; casterIdx < last; ++casterIdx)
 		{
+			uint32_t const lightId{ m_ShadowCasters[casterIdx] };
 			auto const& light{ m_Lights[lightId] };
-			if (light.castsShadows and light.type == static_cast<uint32_t>(MauEng::ELightType::DIRECTIONAL))
-			{
-				auto& depth = m_ShadowMaps[light.shadowMapIndex];
-
-				if (VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL != depth.layout)
-				{
-					depth.TransitionImageLayout(
-						commandBuffer,
-						VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL,
-						VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT,
-						VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT
-					);
-				}
-
-				ShadowPassPushConstant pc{ .lightIndex = lightId };
-
-				VkRenderingAttachmentInfo depthAttachment{};
-				depthAttachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
-				depthAttachment.imageView = depth.imageViews[0];
-				depthAttachment.imageLayout = depth.layout;
-				depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
-				depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
-				depthAttachment.clearValue = depthClear;
-
-				VkRenderingInfo renderInfoDepthPrepass{};
-				renderInfoDepthPrepass.sType = VK_STRUCTURE_TYPE_RENDERING_INFO;
-				renderInfoDepthPrepass.renderArea = VkRect2D{ VkOffset2D{ 0, 0 }, SHADOW_MAP_SIZE, SHADOW_MAP_SIZE };
-				renderInfoDepthPrepass.layerCount = 1;
-				renderInfoDepthPrepass.colorAttachmentCount = 0;
-				renderInfoDepthPrepass.pColorAttachments = nullptr;
-				renderInfoDepthPrepass.pDepthAttachment = &depthAttachment;
-				renderInfoDepthPrepass.pStencilAttachment = nullptr;
-
-				VkViewport viewport{};
-				viewport.x = 0.0f;
-				viewport.y = 0.0f;
-				viewport.width = (float)SHADOW_MAP_SIZE;
-				viewport.height = (float)SHADOW_MAP_SIZE;
-				viewport.minDepth = 0.0f;
-				viewport.maxDepth = 1.0f;
-				vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
-
-				VkRect2D scissor{};
-				scissor.offset = { 0, 0 };
-				scissor.extent = { SHADOW_MAP_SIZE, SHADOW_MAP_SIZE };
-				vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
-
-				vkCmdBeginRendering(commandBuffer, &renderInfoDepthPrepass);
-				vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, graphicsPipelineContext.GetShadowPassPipeline());
-					vkCmdPushConstants(
-						commandBuffer,
-						graphicsPipelineContext.GetShadowPassPipelineLayout(),
-						VK_SHADER_STAGE_VERTEX_BIT,
-						0,
-						sizeof(ShadowPassPushConstant),
-						&pc
-					);
-
-					VulkanMeshManager::GetInstance().Draw(commandBuffer, graphicsPipelineContext.GetShadowPassPipelineLayout(), 1, &descriptorContext.GetDescriptorSets()[frame], frame);
-				vkCmdEndRendering(commandBuffer);
+			auto& depth = m_ShadowMaps[light.shadowMapIndex];
 
+			if (VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL != depth.layout)
+			{
 				depth.TransitionImageLayout(
 					commandBuffer,
-					VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
-					VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
-					VK_ACCESS_SHADER_READ_BIT
+					VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL,
+					VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT,
+					VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT
 				);
 			}
+
+			ShadowPassPushConstant pc{ .lightIndex = lightId };
+
+			VkRenderingAttachmentInfo depthAttachment{};
+			depthAttachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
+			depthAttachment.imageView = depth.imageViews[0];
+			depthAttachment.imageLayout = depth.layout;
+			depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+			depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+			depthAttachment.clearValue = depthClear;
+
+			VkRenderingInfo renderInfoDepthPrepass{};
+			renderInfoDepthPrepass.sType = VK_STRUCTURE_TYPE_RENDERING_INFO;
+			renderInfoDepthPrepass.renderArea = VkRect2D{ VkOffset2D{ 0, 0 }, SHADOW_MAP_SIZE, SHADOW_MAP_SIZE };
+			renderInfoDepthPrepass.layerCount = 1;
+			renderInfoDepthPrepass.colorAttachmentCount = 0;
+			renderInfoDepthPrepass.pColorAttachments = nullptr;
+			renderInfoDepthPrepass.pDepthAttachment = &depthAttachment;
+			renderInfoDepthPrepass.pStencilAttachment = nullptr;
+
+			VkViewport viewport{};
+			viewport.x = 0.0f;
+			viewport.y = 0.0f;
+			viewport.width = (float)SHADOW_MAP_SIZE;
+			viewport.height = (float)SHADOW_MAP_SIZE;
+			viewport.minDepth = 0.0f;
+			viewport.maxDepth = 1.0f;
+			vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+
+			VkRect2D scissor{};
+			scissor.offset = { 0, 0 };
+			scissor.extent = { SHADOW_MAP_SIZE, SHADOW_MAP_SIZE };
+			vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+
+			vkCmdBeginRendering(commandBuffer, &renderInfoDepthPrepass);
+			vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, graphicsPipelineContext.GetShadowPassPipeline());
+				vkCmdPushConstants(
+					commandBuffer,
+					graphicsPipelineContext.GetShadowPassPipelineLayout(),
+					VK_SHADER_STAGE_VERTEX_BIT,
+					0,
+					sizeof(ShadowPassPushConstant),
+					&pc
+				);
+
+				VulkanMeshManager::GetInstance().Draw(commandBuffer, graphicsPipelineContext.GetShadowPassPipelineLayout(), 1, &descriptorContext.GetDescriptorSets()[frame], frame);
+			vkCmdEndRendering(commandBuffer);
+
+			depth.TransitionImageLayout(
+				commandBuffer,
+				VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+				VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+				VK_ACCESS_SHADER_READ_BIT
+			);
 		}
 	}
 
@@ -129,7 +131,7 @@ namespace MauRen
 		m_SceneAABBMax = max;
 	}
 
-	void VulkanLightManager::PreQueue(glm::mat4 const& viewProj)
+	void VulkanLightManager::PreQueue(glm::mat4 const& viewProj, MauCor::AABB const& sceneBounds)
 	{
 		if (not m_HasAABBBOverride)
 		{
@@ -157,6 +159,18 @@ namespace MauRen
 				sceneAABBMin = glm::min(sceneAABBMin, worldCorners[i]);
 				sceneAABBMax = glm::max(sceneAABBMax, worldCorners[i]);
 			}
+
+			// No need to fit the shadow maps around empty space, only around what is both in view & in the scene
+			if (sceneBounds.IsValid())
+			{
+				MauCor::AABB const clipped{ MauCor::AABB::Intersection({ sceneAABBMin, sceneAABBMax }, sceneBounds) };
+				if (clipped.IsValid())
+				{
+					sceneAABBMin = clipped.min;
+					sceneAABBMax = clipped.max;
+				}
+			}
+
 			m_SceneAABBMin = sceneAABBMin;
 			m_SceneAABBMax = sceneAABBMax;
 		}
@@ -164,6 +178,16 @@ namespace MauRen
 
 	void VulkanLightManager::PreDraw(VulkanDescriptorContext& descriptorContext, uint32_t frame)
 	{
+		m_ShadowCasters.clear();
+		for (uint32_t lightId{ 0 }; lightId < std::size(m_Lights); ++lightId)
+		{
+			auto const& light{ m_Lights[lightId] };
+			if (light.castsShadows and light.type == static_cast<uint32_t>(MauEng::ELightType::DIRECTIONAL))
+			{
+				m_ShadowCasters.emplace_back(lightId);
+			}
+		}
+
 		//TODO only do this when the contents change
 		{
 			ME_PROFILE_SCOPE("Light data update - buffer")
@@ -306,6 +330,7 @@ namespace MauRen
 	void VulkanLightManager::PostDraw()
 	{
 		m_Lights.clear();
+		m_ShadowCasters.clear();
 	}
 
 	void VulkanLightManager::CreateShadowMapSampler(VulkanDescriptorContext& descriptorContext)
@@ -28,10 +28,15 @@ namespace MauRen
 
 		[[nodiscard]] uint32_t CreateLight();
 
-		void Draw(VkCommandBuffer const& commandBuffer, VulkanGraphicsPipelineContext const& graphicsPipelineContext, VulkanDescriptorContext& descriptorContext, VulkanSwapchainContext& swapChainContext, uint32_t frame);
+		// Lights that get a shadow pass this frame, known after PreDraw
+		[[nodiscard]] uint32_t GetShadowPassCount() const noexcept { return static_cast<uint32_t>(std::size(m_ShadowCasters)); }
+		// Records the shadow passes [first, last) outside of rendering
+		// Every pass only touches its own shadow map, so different ranges can be recorded in parallel
+		void DrawShadowPasses(VkCommandBuffer commandBuffer, uint32_t first, uint32_t last, VulkanGraphicsPipelineContext const& graphicsPipelineContext, VulkanDescriptorContext const& descriptorContext, uint32_t frame);
 
 		void SetSceneAABBOverride(glm::vec3 const& min, glm::vec3 const& max);
-		void PreQueue(glm::mat4 const& viewProj);
+		// Fits the shadow casting scene box to the view, clipped to sceneBounds when those are valid
+		void PreQueue(glm::mat4 const& viewProj, MauCor::AABB const& sceneBounds);
 		void PreDraw(VulkanDescriptorContext& descriptorContext, uint32_t frame);
 		void QueueLight(VulkanCommandPoolManager& cmdPoolManager, VulkanDescriptorContext& descriptorContext, MauEng::CLight const& light);
 		void PostDraw();
@@ -54,6 +59,8 @@ namespace MauRen
 		std::unordered_map<uint32_t, uint32_t> m_LightShadowMapIDMap;
 
 		std::vector<Light> m_Lights; // All lights that are currently active
+		// Index into m_Lights of each light that gets a shadow pass
+		std::vector<uint32_t> m_ShadowCasters;
 		std::vector<VulkanMappedBuffer> m_LightBuffers;
 
 		// 1:1 copy of the shadow maps on GPU
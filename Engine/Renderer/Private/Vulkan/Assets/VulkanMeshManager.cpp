@@ -9,14 +9,34 @@
 #include "Vulkan/VulkanDescriptorContext.h"
 #include "Vulkan/VulkanMemoryAllocator.h"
 
+#include "Math/RadixSort.h"
+
 namespace MauRen
 {
+	namespace
+	{
+		// Batch sort key, from high to low bits: pipeline (8) | submesh (32) | material (24)
+		uint32_t constexpr BATCH_MATERIAL_BITS{ 24 };
+		uint32_t constexpr BATCH_SUBMESH_BITS{ 32 };
+
+		// Every mesh is drawn with the same pipeline per pass for now
+		uint8_t constexpr MESH_PIPELINE_ID{ 0 };
+
+		[[nodiscard]] uint64_t MakeBatchKey(uint8_t pipeline, uint32_t subMeshID, uint32_t materialID) noexcept
+		{
+			return (static_cast<uint64_t>(pipeline) << (BATCH_SUBMESH_BITS + BATCH_MATERIAL_BITS))
+				| (static_cast<uint64_t>(subMeshID) << BATCH_MATERIAL_BITS)
+				| (materialID & ((1u << BATCH_MATERIAL_BITS) - 1));
+		}
+	}
+
 	bool VulkanMeshManager::Initialize(VulkanCommandPoolManager const* CmdPoolManager)
 	{
 		m_CmdPoolManager = CmdPoolManager;
 
 		m_MeshData.reserve(MAX_MESHES);
 		m_SubMeshes.reserve(MAX_MESHES);
+		m_MeshGeometry.reserve(MAX_MESHES);
 
 		m_MeshInstanceDataBuffers.reserve(MAX_MESH_INSTANCES);
 		InitializeMeshInstanceDataBuffers();
@@ -24,27 +44,35 @@ namespace MauRen
 		m_DrawCommands.reserve(MAX_DRAW_COMMANDS);
 		InitializeDrawCommandBuffers();
 
-		CreateVertexAndIndexBuffers();
+		if constexpr (ENABLE_GPU_CULLING)
+		{
+			m_UseGPUCulling = VulkanDeviceContextManager::GetInstance().GetDeviceContext()->SupportsDrawIndirectCount();
+			if (m_UseGPUCulling)
+			{
+				m_GPUCulling.Initialize(m_MeshInstanceDataBuffers, m_DrawCommandBuffers);
+			}
+			else
+			{
+				LOGGER.Log(MauCor::ELogPriority::Warn, LogRenderer, "drawIndirectCount is not supported, culling on the CPU");
+			}
+		}
+
+		m_UploadAllInstances.fill(true);
 
-		m_BatchedDrawCommands.reserve(MAX_MESHES + 1);
-		m_BatchedDrawCommands.assign(MAX_MESHES + 1, INVALID_DRAW_COMMAND);
+		m_GeometryPool.Initialize();
 
 		return true;
 	}
 
 	bool VulkanMeshManager::Destroy()
 	{
-		for (auto & b : m_VertexBuffer)
+		if (m_UseGPUCulling)
 		{
-			b.UnMap();
-			b.buffer.Destroy();
-		}
-		for (auto& b : m_IndexBuffer)
-		{
-			b.UnMap();
-			b.buffer.Destroy();
+			m_GPUCulling.Destroy();
 		}
 
+		m_GeometryPool.Destroy();
+
 		for (auto& d : m_DrawCommandBuffers)
 		{
 			d.UnMap();
@@ -60,7 +88,7 @@ namespace MauRen
 		return true;
 	}
 
-	void VulkanMeshManager::UnloadMesh(uint32_t meshID) noexcept
+	void VulkanMeshManager::UnloadMesh(uint32_t meshID, uint32_t useCount) noexcept
 	{
 		ME_PROFILE_FUNCTION()
 
@@ -77,7 +105,8 @@ namespace MauRen
 		auto pathIt = m_LoadedMeshes_Path.find(path);
 		ME_RENDERER_ASSERT(pathIt != m_LoadedMeshes_Path.end());
 
-		pathIt->second.useCount--;
+		ME_RENDERER_ASSERT(pathIt->second.useCount >= useCount);
+		pathIt->second.useCount -= std::min(useCount, pathIt->second.useCount);
 
 		// Still in use
 		if (pathIt->second.useCount > 0)
@@ -85,41 +114,38 @@ namespace MauRen
 			return;
 		}
 
-		// Clear CPU-side model data if it somehow persisted
-		m_CPUModelData.erase(meshID);
-
 		MeshData& meshData{ m_MeshData[internalIndex] };
 		// Clean up submeshes
 		for (uint32_t i{ 0 }; i < meshData.subMeshCount; ++i)
 		{
 			VulkanMaterialManager::GetInstance().UnloadMaterial(m_SubMeshes[meshData.firstSubMesh + i].materialID);
-
-			m_FreeIndices.emplace_back(m_SubMeshes[meshData.firstSubMesh + i].firstIndex, m_SubMeshes[meshData.firstSubMesh + i].indexCount);
-			m_FreeVertices.emplace_back(m_SubMeshes[meshData.firstSubMesh + i].vertexOffset, m_SubMeshes[meshData.firstSubMesh + i].vertexCount);
-
 			m_SubMeshes[meshData.firstSubMesh + i] = {}; // Zeroing out
 		}
-		FreeRange::MergeFreeRanges(m_FreeIndices);
-		FreeRange::MergeFreeRanges(m_FreeVertices);
-		
+
+		MeshGeometry& geometry{ m_MeshGeometry[internalIndex] };
+		if (geometry.isResident)
+		{
+			UnloadGeometry(internalIndex);
+		}
+		else
+		{
+			// The upload still writes to the ranges & refers to the slot
+			geometry.isUnloaded = true;
+		}
+
 		m_MeshData[internalIndex] = {};
+		// Instances of this mesh reference its submeshes
+		m_ProxiesChanged = true;
 
 		m_LoadedMeshes.erase(meshIt);
 		m_LoadedMeshes_Path.erase(pathIt);
 		m_MeshID_path.erase(meshID);
-
-		for (auto& frameUploads : m_PendingUploads)
-		{
-			frameUploads.erase(
-				std::ranges::remove_if(frameUploads,
-				                       [meshID](PendingMeshUpload const& pu) { return pu.meshID == meshID; }).begin(),
-				frameUploads.end());
-		}
+		m_MeshID_sourcePath.erase(meshID);
 
 		ME_LOG_INFO(LogRenderer, "Unloaded mesh ID: {} ({})", meshID, path);
 	}
 
-	uint32_t VulkanMeshManager::LoadMesh(char const* path, VulkanCommandPoolManager& cmdPoolManager, VulkanDescriptorContext& descriptorContext) noexcept
+	uint32_t VulkanMeshManager::LoadMesh(char const* path, VulkanCommandPoolManager& cmdPoolManager, VulkanDescriptorContext& descriptorContext, uint32_t useCount) noexcept
 	{
 		ME_PROFILE_FUNCTION()
 
@@ -134,79 +160,99 @@ namespace MauRen
 		{
 			if (it->second.loadedMeshesID != INVALID_MESH_ID)
 			{
-				it->second.useCount++;
+				it->second.useCount += useCount;
 				return m_MeshData[it->second.loadedMeshesID].meshID;
 			}
 		}
 
 		LoadedModel const loadedModel{ ModelLoader::LoadModel(path, cmdPoolManager, descriptorContext) };
-		//ME_RENDERER_ASSERT(m_CurrentVertexOffset + loadedModel.vertices.size() <= MAX_VERTICES);
-		//ME_RENDERER_ASSERT(m_CurrentIndexOffset + loadedModel.indices.size() <= MAX_INDICES);
 
 		uint32_t const vertexCount{ static_cast<uint32_t>(loadedModel.vertices.size()) };
 		uint32_t const indexCount{ static_cast<uint32_t>(loadedModel.indices.size()) };
 
-		auto [usedVertexRange, vertexOffset] { FreeRange::TryUseFreeRange(m_FreeVertices, vertexCount) };
-		auto [usedIndexRange, indexOffset] { FreeRange::TryUseFreeRange(m_FreeIndices, indexCount) };
-
-		if (!usedVertexRange)
-		{
-			vertexOffset = m_CurrentVertexOffset;
-			m_CurrentVertexOffset += vertexCount;
-		}
-		else
+		auto const vertices{ m_VertexAllocator.Allocate(vertexCount) };
+		auto const indices{ m_IndexAllocator.Allocate(indexCount) };
+		auto const subMeshes{ m_SubMeshAllocator.Allocate(static_cast<uint32_t>(loadedModel.subMeshes.size())) };
+		if (!vertices.IsValid() || !indices.IsValid() || !subMeshes.IsValid())
 		{
-			ME_LOG_INFO(LogRenderer, "Reusing free range in vertex buffer for mesh: {}", path);
+			m_VertexAllocator.Free(vertices);
+			m_IndexAllocator.Free(indices);
+			m_SubMeshAllocator.Free(subMeshes);
+
+			for (auto const& sub : loadedModel.subMeshes)
+			{
+				VulkanMaterialManager::GetInstance().UnloadMaterial(sub.materialID);
+			}
+
+			// The free space may only be too scattered, compacting makes room for a later attempt
+			m_CompactVertices = true;
+			m_CompactIndices = true;
+
+			ME_LOG_ERROR(LogRenderer, "Not enough room in the geometry pool or for the submeshes of mesh: {}", path);
+			return INVALID_MESH_ID;
 		}
-		if (!usedIndexRange)
+
+		uint32_t const vertexOffset{ vertices.offset };
+		uint32_t const indexOffset{ indices.offset };
+
+		uint32_t internalIndex;
+		if (!m_FreeMeshSlots.empty())
 		{
-			indexOffset = m_CurrentIndexOffset;
-			m_CurrentIndexOffset += indexCount;
+			internalIndex = m_FreeMeshSlots.back();
+			m_FreeMeshSlots.pop_back();
 		}
 		else
 		{
-			ME_LOG_INFO(LogRenderer, "Reusing free range in index buffer for mesh: {}", path);
+			internalIndex = static_cast<uint32_t>(m_MeshData.size());
+			m_MeshData.emplace_back();
+			m_MeshGeometry.emplace_back();
 		}
 
 		MeshData meshData;
 		meshData.meshID = m_NextID;
-		meshData.firstSubMesh = m_SubMeshes.size();
+		meshData.firstSubMesh = subMeshes.offset;
 		meshData.subMeshCount = loadedModel.subMeshes.size();
+		meshData.bounds = loadedModel.bounds;
+
+		if (m_SubMeshes.size() < meshData.firstSubMesh + meshData.subMeshCount)
+		{
+			m_SubMeshes.resize(meshData.firstSubMesh + meshData.subMeshCount);
+		}
 
 		// Offset each submesh
-		for (auto& sub : loadedModel.subMeshes)
+		for (uint32_t i{ 0 }; i < meshData.subMeshCount; ++i)
 		{
-			SubMeshData entry{ sub };
+			SubMeshData entry{ loadedModel.subMeshes[i] };
 			entry.vertexOffset += vertexOffset;
 			entry.firstIndex += indexOffset;
 
-			m_SubMeshes.emplace_back(entry);
+			m_SubMeshes[meshData.firstSubMesh + i] = entry;
 		}
 
-		m_CPUModelData[m_NextID] =
-		{
-			.vertices = loadedModel.vertices,
-			.indices = loadedModel.indices,
-
-			.vertexOffset = vertexOffset,
-			.indexOffset = indexOffset,
-
-			.uses = 3
-		};
-
-		for (auto& pu : m_PendingUploads)
-		{
-			pu.emplace_back(m_NextID);
-		}
+		// Staged right away, so the model data doesn't have to be kept around
+		// The slot is only reused after the upload completed, so the index still refers to this mesh
+		m_GeometryPool.Write(loadedModel.vertices, vertexOffset, loadedModel.indices, indexOffset,
+			[this, internalIndex]
+			{
+				MeshGeometry& geometry{ m_MeshGeometry[internalIndex] };
+				if (geometry.isUnloaded)
+				{
+					UnloadGeometry(internalIndex);
+					return;
+				}
 
-		m_CurrentVertexOffset += static_cast<uint32_t>(loadedModel.vertices.size());
-		m_CurrentIndexOffset += static_cast<uint32_t>(loadedModel.indices.size());
+				geometry.isResident = true;
+				// Persistent instances of the mesh were left out until now
+				m_ProxiesChanged = true;
+			});
 
-		m_LoadedMeshes[m_NextID] = static_cast<uint32_t>(m_MeshData.size());
-		m_LoadedMeshes_Path[cleanPath] = { static_cast<uint32_t>(m_MeshData.size()), 1 };
+		m_LoadedMeshes[m_NextID] = internalIndex;
+		m_LoadedMeshes_Path[cleanPath] = { internalIndex, useCount };
 		m_MeshID_path[m_NextID] = cleanPath;
+		m_MeshID_sourcePath[m_NextID] = path;
 
-		m_MeshData.emplace_back(std::move(meshData));
+		m_MeshData[internalIndex] = std::move(meshData);
+		m_MeshGeometry[internalIndex] = { vertices, indices, subMeshes, vertexCount, indexCount, false, false };
 
 		return m_NextID++;
 	}
@@ -225,81 +271,693 @@ namespace MauRen
 		throw std::runtime_error("Mesh not found! ");
 	}
 
-	void VulkanMeshManager::PreDraw(VulkanDescriptorContext& descriptorContext, uint32_t frame)
+	std::string VulkanMeshManager::GetMeshPath(uint32_t meshID) const
+	{
+		auto const it{ m_MeshID_sourcePath.find(meshID) };
+		return it != end(m_MeshID_sourcePath) ? it->second : std::string{};
+	}
+
+	MauCor::AABB VulkanMeshManager::GetMeshBounds(uint32_t meshID) const noexcept
+	{
+		auto const it{ m_LoadedMeshes.find(meshID) };
+		return it != end(m_LoadedMeshes) ? m_MeshData[it->second].bounds : MauCor::AABB{};
+	}
+
+	uint32_t VulkanMeshManager::CreateMeshInstance(glm::mat4 const& transformMat, uint32_t meshID) noexcept
+	{
+		ME_RENDERER_ASSERT(m_LoadedMeshes.contains(meshID), "Creating an instance of a mesh that is not loaded");
+
+		uint32_t instanceID;
+		if (!m_FreeProxyIDs.empty())
+		{
+			instanceID = m_FreeProxyIDs.back();
+			m_FreeProxyIDs.pop_back();
+		}
+		else
+		{
+			instanceID = static_cast<uint32_t>(m_ProxyIndices.size());
+			m_ProxyIndices.emplace_back(INVALID_MESH_INSTANCE_ID);
+		}
+
+		m_ProxyIndices[instanceID] = static_cast<uint32_t>(m_Proxies.size());
+		m_Proxies.emplace_back(transformMat, meshID, 0u, 0u);
+		m_ProxyIDs.emplace_back(instanceID);
+
+		m_ProxiesChanged = true;
+
+		return instanceID;
+	}
+
+	void VulkanMeshManager::UpdateMeshInstance(uint32_t instanceID, glm::mat4 const& transformMat) noexcept
+	{
+		ME_RENDERER_ASSERT(instanceID < m_ProxyIndices.size() && m_ProxyIndices[instanceID] != INVALID_MESH_INSTANCE_ID);
+
+		auto& proxy{ m_Proxies[m_ProxyIndices[instanceID]] };
+		proxy.transformMat = transformMat;
+
+		// The rebuild picks up the new matrix
+		if (m_ProxiesChanged)
+		{
+			return;
+		}
+
+		for (uint32_t slot{ proxy.firstSlot }; slot < proxy.firstSlot + proxy.slotCount; ++slot)
+		{
+			uint32_t const instanceIdx{ m_ProxyInstanceSlots[slot] };
+			m_MeshInstanceData[instanceIdx].modelMatrix = transformMat;
+			if (!m_UseGPUCulling)
+			{
+				m_InstanceBounds.Set(instanceIdx, m_SubMeshes[m_MeshInstanceData[instanceIdx].subMeshID].bounds.Transformed(transformMat));
+			}
+
+			for (uint32_t frame{ 0 }; frame < MAX_FRAMES_IN_FLIGHT; ++frame)
+			{
+				if (!m_UploadAllInstances[frame])
+				{
+					m_DirtyInstances[frame].emplace_back(instanceIdx);
+				}
+			}
+		}
+	}
+
+	void VulkanMeshManager::DestroyMeshInstance(uint32_t instanceID) noexcept
 	{
+		ME_RENDERER_ASSERT(instanceID < m_ProxyIndices.size() && m_ProxyIndices[instanceID] != INVALID_MESH_INSTANCE_ID);
+
+		// Swap & pop to keep the proxies dense
+		uint32_t const idx{ m_ProxyIndices[instanceID] };
+		uint32_t const lastIdx{ static_cast<uint32_t>(m_Proxies.size() - 1) };
+		if (idx != lastIdx)
 		{
-			ME_PROFILE_SCOPE("Mesh GPU uploads")
+			m_Proxies[idx] = m_Proxies[lastIdx];
+			m_ProxyIDs[idx] = m_ProxyIDs[lastIdx];
+			m_ProxyIndices[m_ProxyIDs[idx]] = idx;
+		}
+
+		m_Proxies.pop_back();
+		m_ProxyIDs.pop_back();
+
+		m_ProxyIndices[instanceID] = INVALID_MESH_INSTANCE_ID;
+		m_FreeProxyIDs.emplace_back(instanceID);
+
+		m_ProxiesChanged = true;
+	}
+
+	void VulkanMeshManager::RebuildPersistentInstances() noexcept
+	{
+		ME_PROFILE_FUNCTION()
+
+		m_ProxiesChanged = false;
+
+		m_MeshInstanceData.clear();
+		m_DrawCommands.clear();
+		m_DrawCommandSubMeshes.clear();
+		m_ProxyInstanceSlots.clear();
+
+		// Count the instances of each submesh, so every submesh's instances can be placed in one contiguous range
+		m_SubMeshInstanceCursors.assign(m_SubMeshes.size(), 0);
+
+		uint32_t slotCount{ 0 };
+		for (auto& proxy : m_Proxies)
+		{
+			proxy.firstSlot = slotCount;
+			proxy.slotCount = 0;
+
+			auto const it{ m_LoadedMeshes.find(proxy.meshID) };
+			if (it == end(m_LoadedMeshes))
+			{
+				// Mesh got unloaded while it was still instanced
+				continue;
+			}
+
+			if (!m_MeshGeometry[it->second].isResident)
+			{
+				// Rebuilt again once the upload completed
+				continue;
+			}
 
-				// Update the vertex & index buffer
-				for (auto& upload : m_PendingUploads[frame])
+			auto const& meshData{ m_MeshData[it->second] };
+			for (uint32_t sub{ meshData.firstSubMesh }; sub < meshData.firstSubMesh + meshData.subMeshCount; ++sub)
+			{
+				++m_SubMeshInstanceCursors[sub];
+			}
+
+			proxy.slotCount = meshData.subMeshCount;
+			slotCount += meshData.subMeshCount;
+		}
+
+		// One draw command per used submesh, the cursor becomes the submesh's first instance
+		uint32_t instanceCount{ 0 };
+		for (uint32_t sub{ 0 }; sub < m_SubMeshInstanceCursors.size(); ++sub)
+		{
+			uint32_t const count{ m_SubMeshInstanceCursors[sub] };
+			if (count == 0)
+			{
+				continue;
+			}
+
+			auto const& subMesh{ m_SubMeshes[sub] };
+			m_DrawCommands.emplace_back(subMesh.indexCount, count, subMesh.firstIndex, subMesh.vertexOffset, instanceCount);
+			m_DrawCommandSubMeshes.emplace_back(sub);
+
+			m_SubMeshInstanceCursors[sub] = instanceCount;
+			instanceCount += count;
+		}
+
+		ME_RENDERER_ASSERT(instanceCount <= MAX_MESH_INSTANCES);
+		ME_RENDERER_ASSERT(m_DrawCommands.size() <= MAX_DRAW_COMMANDS);
+
+		m_MeshInstanceData.resize(instanceCount);
+		// The GPU culling transforms the submesh bounds itself
+		m_InstanceBounds.Resize(m_UseGPUCulling ? 0 : instanceCount);
+		m_ProxyInstanceSlots.resize(slotCount);
+
+		for (auto const& proxy : m_Proxies)
+		{
+			if (proxy.slotCount == 0)
+			{
+				continue;
+			}
+
+			auto const& meshData{ m_MeshData[m_LoadedMeshes.at(proxy.meshID)] };
+			for (uint32_t i{ 0 }; i < proxy.slotCount; ++i)
+			{
+				uint32_t const sub{ meshData.firstSubMesh + i };
+				uint32_t const instanceIdx{ m_SubMeshInstanceCursors[sub]++ };
+
+				m_MeshInstanceData[instanceIdx] = { proxy.transformMat, sub, m_SubMeshes[sub].materialID, meshData.flags };
+				if (!m_UseGPUCulling)
 				{
-					auto& data{ m_CPUModelData.at(upload.meshID) };
-					{
-						uint8_t* basePtr{ static_cast<uint8_t*>(m_VertexBuffer[frame].mapped) };
-
-						std::memcpy(basePtr + data.vertexOffset * sizeof(Vertex),
-							data.vertices.data(),
-							data.vertices.size() * sizeof(Vertex));
-					}
-					{
-						uint8_t* basePtr{ static_cast<uint8_t*>(m_IndexBuffer[frame].mapped) };
-
-						std::memcpy(basePtr + data.indexOffset * sizeof(uint32_t),
-							data.indices.data(),
-							data.indices.size() * sizeof(uint32_t));
-					}
-
-					data.uses--;
-
-					if (data.uses == 0)
-					{
-						m_CPUModelData.erase(upload.meshID);
-					}
+					m_InstanceBounds.Set(instanceIdx, m_SubMeshes[sub].bounds.Transformed(proxy.transformMat));
 				}
-			m_PendingUploads[frame].clear();
+				m_ProxyInstanceSlots[proxy.firstSlot + i] = instanceIdx;
+			}
+		}
+
+		m_UploadAllInstances.fill(true);
+		for (auto& dirty : m_DirtyInstances)
+		{
+			dirty.clear();
+		}
+	}
+
+	void VulkanMeshManager::BatchQueuedInstances() noexcept
+	{
+		ME_PROFILE_FUNCTION()
+
+		m_QueuedDrawCommands.clear();
+		m_QueuedDrawCommandSubMeshes.clear();
+		m_QueuedInstanceBounds.Clear();
+
+		auto const count{ static_cast<uint32_t>(m_QueuedInstanceData.size()) };
+		if (count == 0)
+		{
+			return;
+		}
+
+		ME_RENDERER_ASSERT(m_SubMeshes.size() <= MAX_MESHES);
+		ME_RENDERER_ASSERT(MAX_MATERIALS <= (1u << BATCH_MATERIAL_BITS));
+
+		m_BatchKeys.resize(count);
+		m_BatchIndices.resize(count);
+		for (uint32_t i{ 0 }; i < count; ++i)
+		{
+			auto const& instance{ m_QueuedInstanceData[i] };
+			m_BatchKeys[i] = MakeBatchKey(MESH_PIPELINE_ID, instance.subMeshID, instance.materialID);
+			m_BatchIndices[i] = i;
+		}
+
+		// Stable, so instances of a batch keep the order they were queued in
+		MauCor::RadixSort(m_BatchKeys, m_BatchIndices, m_BatchKeyScratch, m_BatchIndexScratch);
+
+		m_SortedQueuedInstanceData.resize(count);
+		for (uint32_t i{ 0 }; i < count; ++i)
+		{
+			m_SortedQueuedInstanceData[i] = m_QueuedInstanceData[m_BatchIndices[i]];
+		}
+		m_QueuedInstanceData.swap(m_SortedQueuedInstanceData);
+
+		// Material is per instance data, so a batch only breaks on pipeline or submesh
+		for (uint32_t i{ 0 }; i < count; ++i)
+		{
+			auto const& instance{ m_QueuedInstanceData[i] };
+			auto const& subMesh{ m_SubMeshes[instance.subMeshID] };
+
+			if (i == 0 || (m_BatchKeys[i] >> BATCH_MATERIAL_BITS) != (m_BatchKeys[i - 1] >> BATCH_MATERIAL_BITS))
+			{
+				// Relative to the queued instances, offset by the persistent instance count on upload
+				m_QueuedDrawCommands.emplace_back(subMesh.indexCount, 0u, subMesh.firstIndex, subMesh.vertexOffset, i);
+				m_QueuedDrawCommandSubMeshes.emplace_back(instance.subMeshID);
+			}
+			++m_QueuedDrawCommands.back().instanceCount;
+
+			if (!m_UseGPUCulling)
+			{
+				m_QueuedInstanceBounds.Add(subMesh.bounds.Transformed(instance.modelMatrix));
+			}
+		}
+	}
+
+	void VulkanMeshManager::CullInstances(uint32_t frame) noexcept
+	{
+		ME_PROFILE_FUNCTION()
+
+		m_VisibleInstanceData.clear();
+		m_VisibleDrawCommands.clear();
+
+		// Only cull against a frustum of this frame
+		m_IsViewCulled = m_HasCullingFrustum;
+		m_HasCullingFrustum = false;
+		if (!m_IsViewCulled)
+		{
+			return;
+		}
+
+		if (m_UseGPUCulling)
+		{
+			PrepareGPUCulling(frame);
+			return;
+		}
+
+		auto const persistentCount{ static_cast<uint32_t>(m_MeshInstanceData.size()) };
+		auto const queuedCount{ static_cast<uint32_t>(m_QueuedInstanceData.size()) };
+		m_VisibleIndices.resize(persistentCount + queuedCount);
+
+		std::size_t visibleCount{ MauCor::CullAABBs(m_CullingFrustum, m_InstanceBounds.Streams(), m_VisibleIndices.data(), 0, persistentCount) };
+		std::size_t const queuedVisibleCount{ MauCor::CullAABBs(m_CullingFrustum, m_QueuedInstanceBounds.Streams(), m_VisibleIndices.data() + visibleCount, 0, queuedCount) };
+
+		// Queued instances come after the persistent ones
+		for (std::size_t i{ visibleCount }; i < visibleCount + queuedVisibleCount; ++i)
+		{
+			m_VisibleIndices[i] += persistentCount;
+		}
+		visibleCount += queuedVisibleCount;
+
+		auto const getInstance{ [this, persistentCount](uint32_t idx) -> MeshInstanceData const&
+			{
+				return idx < persistentCount ? m_MeshInstanceData[idx] : m_QueuedInstanceData[idx - persistentCount];
+			} };
+
+		// Count the visible instances of each submesh, so they can be placed in one contiguous range per draw command
+		m_VisibleCursors.assign(m_SubMeshes.size(), 0);
+		for (std::size_t i{ 0 }; i < visibleCount; ++i)
+		{
+			++m_VisibleCursors[getInstance(m_VisibleIndices[i]).subMeshID];
+		}
+
+		// The visible instances live after the persistent & queued ones on the GPU
+		uint32_t const firstVisibleInstance{ persistentCount + queuedCount };
+		uint32_t instanceCount{ 0 };
+		for (uint32_t sub{ 0 }; sub < m_VisibleCursors.size(); ++sub)
+		{
+			uint32_t const count{ m_VisibleCursors[sub] };
+			if (count == 0)
+			{
+				continue;
+			}
+
+			auto const& subMesh{ m_SubMeshes[sub] };
+			m_VisibleDrawCommands.emplace_back(subMesh.indexCount, count, subMesh.firstIndex, subMesh.vertexOffset, firstVisibleInstance + instanceCount);
+
+			m_VisibleCursors[sub] = instanceCount;
+			instanceCount += count;
+		}
+
+		m_VisibleInstanceData.resize(visibleCount);
+		for (std::size_t i{ 0 }; i < visibleCount; ++i)
+		{
+			MeshInstanceData const& instance{ getInstance(m_VisibleIndices[i]) };
+			m_VisibleInstanceData[m_VisibleCursors[instance.subMeshID]++] = instance;
+		}
+	}
+
+	void VulkanMeshManager::PrepareGPUCulling(uint32_t frame) noexcept
+	{
+		ME_PROFILE_FUNCTION()
+
+		// Instance count of each submesh, straight from the draw commands so the instances themselves aren't touched
+		m_VisibleCursors.assign(m_SubMeshes.size(), 0);
+		for (std::size_t i{ 0 }; i < m_DrawCommands.size(); ++i)
+		{
+			m_VisibleCursors[m_DrawCommandSubMeshes[i]] += m_DrawCommands[i].instanceCount;
+		}
+		for (std::size_t i{ 0 }; i < m_QueuedDrawCommands.size(); ++i)
+		{
+			m_VisibleCursors[m_QueuedDrawCommandSubMeshes[i]] += m_QueuedDrawCommands[i].instanceCount;
+		}
+
+		ME_RENDERER_ASSERT(m_SubMeshes.size() <= MAX_MESHES);
+		GPUCullSubMesh* const pSubMeshes{ m_GPUCulling.GetSubMeshes(frame) };
+
+		// Every submesh gets room for all of its instances after the persistent & queued ones, the pass fills in how many are visible
+		auto const instanceCount{ static_cast<uint32_t>(m_MeshInstanceData.size() + m_QueuedInstanceData.size()) };
+		auto firstInstance{ instanceCount };
+		for (uint32_t sub{ 0 }; sub < m_VisibleCursors.size(); ++sub)
+		{
+			uint32_t const count{ m_VisibleCursors[sub] };
+			if (count == 0)
+			{
+				continue;
+			}
+
+			auto const& subMesh{ m_SubMeshes[sub] };
+			pSubMeshes[sub] = { subMesh.bounds.Center(), static_cast<uint32_t>(m_VisibleDrawCommands.size()), subMesh.bounds.Extents(), 0 };
+			m_VisibleDrawCommands.emplace_back(subMesh.indexCount, 0u, subMesh.firstIndex, subMesh.vertexOffset, firstInstance);
+
+			firstInstance += count;
+		}
+
+		// The late phase gets the same commands, writing its instances after the early ones
+		std::size_t const commandCount{ m_VisibleDrawCommands.size() };
+		for (std::size_t i{ 0 }; i < commandCount; ++i)
+		{
+			DrawCommand command{ m_VisibleDrawCommands[i] };
+			command.firstInstance += instanceCount;
+			m_VisibleDrawCommands.emplace_back(command);
+		}
+
+		// The pyramid is only built in frames that are culled on the GPU, so it still matches the last view that was
+		m_GPUCulling.SetView(frame, m_CullingFrustum, m_LastCullingViewProj, m_CullingViewProj, m_HasLastPyramid);
+		m_LastCullingViewProj = m_CullingViewProj;
+		m_HasLastPyramid = true;
+	}
+
+	void VulkanMeshManager::SetDepthPyramid(VkImageView view, VkSampler sampler, VkExtent2D extent, uint32_t mipLevels)
+	{
+		ME_RENDERER_ASSERT(m_UseGPUCulling);
+
+		m_GPUCulling.SetPyramid(view, sampler, extent, mipLevels);
+		m_HasLastPyramid = false;
+	}
+
+	void VulkanMeshManager::PreDraw(VulkanDescriptorContext& descriptorContext, uint32_t frame)
+	{
+		// The frame's fence was waited on, its retired ranges can be reused
+		RetireUnloadedRanges(frame);
+		CompactGeometry();
+
+		if (m_ProxiesChanged)
+		{
+			RebuildPersistentInstances();
 		}
 
-		//TODO only does this when contents change
+		BatchQueuedInstances();
+		CullInstances(frame);
+
+		// Instances written after the persistent & queued ones, by the CPU or by both GPU culling phases
+		auto const culledInstanceCount{ static_cast<uint32_t>(IsGPUCulled() ? 2 * (m_MeshInstanceData.size() + m_QueuedInstanceData.size()) : m_VisibleInstanceData.size()) };
+		// The GPU culling compacts its draw commands after the ones it fills in
+		auto const culledCommandCount{ static_cast<uint32_t>(m_UseGPUCulling ? m_VisibleDrawCommands.size() * 2 : m_VisibleDrawCommands.size()) };
+
+		auto* const pInstances{ static_cast<MeshInstanceData*>(m_MeshInstanceDataBuffers[frame].mapped) };
 		{
 			ME_PROFILE_SCOPE("Mesh instance data update - buffer")
 
-			memcpy(m_MeshInstanceDataBuffers[frame].mapped, m_MeshInstanceData.data(), m_MeshInstanceData.size() * sizeof(MeshInstanceData));
+			auto& dirty{ m_DirtyInstances[frame] };
+
+			// Past a certain amount of patches one big copy is cheaper than many small ones
+			if (m_UploadAllInstances[frame] || dirty.size() > m_MeshInstanceData.size() / 4)
+			{
+				memcpy(pInstances, m_MeshInstanceData.data(), m_MeshInstanceData.size() * sizeof(MeshInstanceData));
+			}
+			else
+			{
+				for (uint32_t const instanceIdx : dirty)
+				{
+					pInstances[instanceIdx] = m_MeshInstanceData[instanceIdx];
+				}
+			}
+
+			dirty.clear();
+
+			ME_RENDERER_ASSERT(m_MeshInstanceData.size() + m_QueuedInstanceData.size() + culledInstanceCount <= MAX_MESH_INSTANCES);
+			memcpy(pInstances + m_MeshInstanceData.size(), m_QueuedInstanceData.data(), m_QueuedInstanceData.size() * sizeof(MeshInstanceData));
+			memcpy(pInstances + m_MeshInstanceData.size() + m_QueuedInstanceData.size(), m_VisibleInstanceData.data(), m_VisibleInstanceData.size() * sizeof(MeshInstanceData));
 		}
 
+		auto* const pDrawCommands{ static_cast<DrawCommand*>(m_DrawCommandBuffers[frame].mapped) };
 		{
 			ME_PROFILE_SCOPE("Draw commands data update - buffer")
 
-			memcpy(m_DrawCommandBuffers[frame].mapped, m_DrawCommands.data(), m_DrawCommands.size() * sizeof(DrawCommand));
+			if (m_UploadAllInstances[frame])
+			{
+				memcpy(pDrawCommands, m_DrawCommands.data(), m_DrawCommands.size() * sizeof(DrawCommand));
+			}
+
+			ME_RENDERER_ASSERT(m_DrawCommands.size() + m_QueuedDrawCommands.size() + culledCommandCount <= MAX_DRAW_COMMANDS);
+
+			// Queued instances live after the persistent ones
+			auto const instanceOffset{ static_cast<uint32_t>(m_MeshInstanceData.size()) };
+			for (std::size_t i{ 0 }; i < m_QueuedDrawCommands.size(); ++i)
+			{
+				DrawCommand command{ m_QueuedDrawCommands[i] };
+				command.firstInstance += instanceOffset;
+				pDrawCommands[m_DrawCommands.size() + i] = command;
+			}
+
+			memcpy(pDrawCommands + m_DrawCommands.size() + m_QueuedDrawCommands.size(), m_VisibleDrawCommands.data(), m_VisibleDrawCommands.size() * sizeof(DrawCommand));
 		}
 
-		//TODO only does this when contents change
+		m_UploadAllInstances[frame] = false;
+
 		{
-			if (not m_MeshInstanceData.empty())
+			// The visible instance count changes nearly every frame, only rebind when the range has to grow
+			auto const instanceCount{ static_cast<uint32_t>(m_MeshInstanceData.size() + m_QueuedInstanceData.size() + culledInstanceCount) };
+			if (instanceCount > m_BoundInstanceCount[frame])
 			{
 				VkDescriptorBufferInfo bufferInfo = {};
 				bufferInfo.buffer = m_MeshInstanceDataBuffers[frame].buffer.buffer;
 				bufferInfo.offset = 0;
-				bufferInfo.range = m_MeshInstanceData.size() * sizeof(MeshInstanceData);
+				bufferInfo.range = instanceCount * sizeof(MeshInstanceData);
 
 				descriptorContext.BindMeshInstanceDataBuffer(bufferInfo, frame);
+				m_BoundInstanceCount[frame] = instanceCount;
+			}
+		}
+	}
+
+	void VulkanMeshManager::RetireUnloadedRanges(uint32_t frame) noexcept
+	{
+		// Anything recorded before the frame's last submission is done drawing these
+		for (auto const& allocation : m_RetiredIndices[frame])
+		{
+			m_IndexAllocator.Free(allocation);
+		}
+		for (auto const& allocation : m_RetiredVertices[frame])
+		{
+			m_VertexAllocator.Free(allocation);
+		}
+
+		for (auto const& allocation : m_RetiredSubMeshes[frame])
+		{
+			m_SubMeshAllocator.Free(allocation);
+		}
+		m_FreeMeshSlots.insert(end(m_FreeMeshSlots), begin(m_RetiredMeshSlots[frame]), end(m_RetiredMeshSlots[frame]));
+
+		m_CompactIndices |= !m_RetiredIndices[frame].empty();
+		m_CompactVertices |= !m_RetiredVertices[frame].empty();
+
+		m_RetiredIndices[frame].swap(m_UnloadedIndices);
+		m_RetiredVertices[frame].swap(m_UnloadedVertices);
+		m_RetiredSubMeshes[frame].swap(m_UnloadedSubMeshes);
+		m_RetiredMeshSlots[frame].swap(m_UnloadedMeshSlots);
+		m_UnloadedIndices.clear();
+		m_UnloadedVertices.clear();
+		m_UnloadedSubMeshes.clear();
+		m_UnloadedMeshSlots.clear();
+	}
+
+	void VulkanMeshManager::UnloadGeometry(uint32_t internalIndex) noexcept
+	{
+		// Only reused once no frame in flight can draw them anymore
+		MeshGeometry& geometry{ m_MeshGeometry[internalIndex] };
+		m_UnloadedIndices.emplace_back(geometry.indices);
+		m_UnloadedVertices.emplace_back(geometry.vertices);
+		m_UnloadedSubMeshes.emplace_back(geometry.subMeshes);
+		m_UnloadedMeshSlots.emplace_back(internalIndex);
+		geometry = {};
+	}
+
+	void VulkanMeshManager::CompactGeometry() noexcept
+	{
+		if (!m_CompactVertices && !m_CompactIndices)
+		{
+			return;
+		}
+
+		ME_PROFILE_FUNCTION()
+
+		// A mesh is moved at most once per pool a frame, so no copy reads what another one of this frame writes
+		std::vector<uint32_t> movedMeshes{};
+
+		uint32_t budget{ MESH_COMPACTION_BUDGET };
+		for (bool const vertices : { true, false })
+		{
+			movedMeshes.clear();
+
+			while (budget > 0)
+			{
+				uint32_t const moved{ CompactHighestMesh(vertices, movedMeshes) };
+				if (0 == moved)
+				{
+					break;
+				}
+
+				budget -= std::min(budget, moved);
+			}
+		}
+	}
+
+	uint32_t VulkanMeshManager::CompactHighestMesh(bool vertices, std::vector<uint32_t>& movedMeshes) noexcept
+	{
+		bool& compact{ vertices ? m_CompactVertices : m_CompactIndices };
+		MauCor::OffsetAllocator& allocator{ vertices ? m_VertexAllocator : m_IndexAllocator };
+
+		if (!compact)
+		{
+			return 0;
+		}
+
+		// Only one free range left, nothing to close
+		if (auto const report{ allocator.GetStorageReport() }; report.largestFreeRegion == report.totalFreeSpace)
+		{
+			compact = false;
+			return 0;
+		}
+
+		uint32_t highestMesh{ UINT32_MAX };
+		uint32_t highestOffset{ 0 };
+		for (uint32_t meshIdx{ 0 }; meshIdx < m_MeshGeometry.size(); ++meshIdx)
+		{
+			auto const& allocation{ vertices ? m_MeshGeometry[meshIdx].vertices : m_MeshGeometry[meshIdx].indices };
+			if (allocation.IsValid() && (UINT32_MAX == highestMesh || allocation.offset > highestOffset))
+			{
+				highestMesh = meshIdx;
+				highestOffset = allocation.offset;
+			}
+		}
+
+		if (UINT32_MAX == highestMesh || std::ranges::find(movedMeshes, highestMesh) != end(movedMeshes))
+		{
+			return 0;
+		}
+
+		// Still uploading (or unloaded while it was), tried again next frame
+		if (!m_MeshGeometry[highestMesh].isResident)
+		{
+			return 0;
+		}
+
+		MeshGeometry& geometry{ m_MeshGeometry[highestMesh] };
+		uint32_t const count{ vertices ? geometry.vertexCount : geometry.indexCount };
+
+		// The old range stays allocated until no frame in flight draws from it, so the new one never overlaps it
+		auto const allocation{ allocator.Allocate(count) };
+		if (!allocation.IsValid() || allocation.offset > highestOffset)
+		{
+			allocator.Free(allocation);
+			compact = false;
+			return 0;
+		}
+
+		auto const& meshData{ m_MeshData[highestMesh] };
+		if (vertices)
+		{
+			m_GeometryPool.MoveVertices(geometry.vertices.offset, allocation.offset, count);
+
+			int32_t const delta{ static_cast<int32_t>(allocation.offset) - static_cast<int32_t>(geometry.vertices.offset) };
+			for (uint32_t sub{ meshData.firstSubMesh }; sub < meshData.firstSubMesh + meshData.subMeshCount; ++sub)
+			{
+				m_SubMeshes[sub].vertexOffset += delta;
+			}
+
+			m_UnloadedVertices.emplace_back(geometry.vertices);
+			geometry.vertices = allocation;
+		}
+		else
+		{
+			m_GeometryPool.MoveIndices(geometry.indices.offset, allocation.offset, count);
+
+			for (uint32_t sub{ meshData.firstSubMesh }; sub < meshData.firstSubMesh + meshData.subMeshCount; ++sub)
+			{
+				m_SubMeshes[sub].firstIndex = m_SubMeshes[sub].firstIndex - geometry.indices.offset + allocation.offset;
 			}
+
+			m_UnloadedIndices.emplace_back(geometry.indices);
+			geometry.indices = allocation;
 		}
+
+		movedMeshes.emplace_back(highestMesh);
+
+		// The draw commands hold the submesh offsets
+		m_ProxiesChanged = true;
+
+		return count * static_cast<uint32_t>(vertices ? sizeof(Vertex) : sizeof(uint32_t));
 	}
 
-	void VulkanMeshManager::Draw(VkCommandBuffer commandBuffer, VkPipelineLayout layout, uint32_t setCount, VkDescriptorSet const* pDescriptorSets, uint32_t frame)
+	void VulkanMeshManager::Cull(VkCommandBuffer commandBuffer, uint32_t frame, ECullPhase phase) const
+	{
+		if (!IsGPUCulled())
+		{
+			return;
+		}
+
+		// Early commands, late commands, compacted early commands, compacted late commands
+		auto const allCommandCount{ static_cast<uint32_t>(m_DrawCommands.size() + m_QueuedDrawCommands.size()) };
+		auto const commandCount{ static_cast<uint32_t>(m_VisibleDrawCommands.size() / 2) };
+		auto const phaseIdx{ static_cast<uint32_t>(phase) };
+
+		m_GPUCulling.Record(commandBuffer, frame, phase,
+			{
+				.instanceCount = static_cast<uint32_t>(m_MeshInstanceData.size() + m_QueuedInstanceData.size()),
+				.firstCommand = allCommandCount + phaseIdx * commandCount,
+				.commandCount = commandCount,
+				.firstCompactedCommand = allCommandCount + (2 + phaseIdx) * commandCount
+			});
+	}
+
+	void VulkanMeshManager::Draw(VkCommandBuffer commandBuffer, VkPipelineLayout layout, uint32_t setCount, VkDescriptorSet const* pDescriptorSets, uint32_t frame, EDrawSet drawSet) const
 	{
 		ME_PROFILE_FUNCTION()
 
 		vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, layout, 0, setCount, pDescriptorSets, 0, nullptr);
-		vkCmdBindIndexBuffer(commandBuffer, m_IndexBuffer[frame].buffer.buffer, 0, VK_INDEX_TYPE_UINT32);
+		vkCmdBindIndexBuffer(commandBuffer, m_GeometryPool.GetIndexBuffer(), 0, VK_INDEX_TYPE_UINT32);
 
 		VkDeviceSize offset{ 0 };
-		vkCmdBindVertexBuffers(commandBuffer, 0, 1, &m_VertexBuffer[frame].buffer.buffer, &offset);
+		VkBuffer const vertexBuffer{ m_GeometryPool.GetVertexBuffer() };
+		vkCmdBindVertexBuffers(commandBuffer, 0, 1, &vertexBuffer, &offset);
+
+		// The culled draw commands follow the persistent & queued ones
+		auto const allCommandCount{ static_cast<uint32_t>(m_DrawCommands.size() + m_QueuedDrawCommands.size()) };
+		if (drawSet == EDrawSet::Disoccluded && !IsGPUCulled())
+		{
+			return;
+		}
+
+		bool const drawVisible{ drawSet == EDrawSet::Visible && m_IsViewCulled };
+
+		if (IsGPUCulled() && drawSet != EDrawSet::All)
+		{
+			// Only the compacted commands of the phase, the GPU wrote how many there are
+			auto const commandCount{ static_cast<uint32_t>(m_VisibleDrawCommands.size() / 2) };
+			uint32_t const phaseIdx{ drawSet == EDrawSet::Disoccluded ? 1u : 0u };
+			vkCmdDrawIndexedIndirectCount(
+				commandBuffer,
+				m_DrawCommandBuffers[frame].buffer.buffer,
+				(allCommandCount + (2 + phaseIdx) * commandCount) * sizeof(DrawCommand),
+				m_GPUCulling.GetDrawCountBuffer(frame),
+				phaseIdx * sizeof(uint32_t),
+				commandCount,
+				sizeof(DrawCommand)
+			);
+			return;
+		}
+
 		vkCmdDrawIndexedIndirect(
 			commandBuffer,
 			m_DrawCommandBuffers[frame].buffer.buffer,               // Indirect buffer that holds the draw command(s)
-			0,														 // Offset into the indirect buffer
-			static_cast<uint32_t>(m_DrawCommands.size()),			 // Number of draw commands to execute
+			drawVisible ? allCommandCount * sizeof(DrawCommand) : 0, // Offset into the indirect buffer
+			drawVisible ? static_cast<uint32_t>(m_VisibleDrawCommands.size()) : allCommandCount, // Number of draw commands to execute
 			sizeof(DrawCommand)
 		);
 	}
@@ -309,11 +967,11 @@ namespace MauRen
 		{
 			ME_PROFILE_SCOPE("Clearing the data")
 
-			// not optimal, good enough for now - just rebuild all draw commands every frame and queue them
-			m_DrawCommands.resize(0);
-			m_MeshInstanceData.resize(0);
-
-			m_BatchedDrawCommands.assign(MAX_MESHES + 1, INVALID_MESH_ID);
+			// Persistent instances stay, only the ones queued for this frame are cleared
+			m_QueuedDrawCommands.clear();
+			m_QueuedDrawCommandSubMeshes.clear();
+			m_QueuedInstanceData.clear();
+			m_QueuedInstanceBounds.Clear();
 		}
 	}
 
@@ -352,35 +1010,4 @@ namespace MauRen
 			vmaMapMemory(VulkanMemoryAllocator::GetInstance().GetAllocator(), m_DrawCommandBuffers[i].buffer.alloc, &m_DrawCommandBuffers[i].mapped);
 		}
 	}
-
-	void VulkanMeshManager::CreateVertexAndIndexBuffers() noexcept
-	{
-		for (size_t i { 0 }; i < MAX_FRAMES_IN_FLIGHT; ++i)
-		{
-			VkDeviceSize constexpr BUFFER_SIZE{ sizeof(Vertex) * MAX_VERTICES };
-
-			m_VertexBuffer.emplace_back(VulkanMappedBuffer{
-												VulkanBuffer{BUFFER_SIZE,
-																	VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
-																	VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT },
-												nullptr });
-
-			// Persistent mapping
-			vmaMapMemory(VulkanMemoryAllocator::GetInstance().GetAllocator(), m_VertexBuffer.back().buffer.alloc, &m_VertexBuffer.back().mapped);
-		}
-
-		for (size_t i{ 0 }; i < MAX_FRAMES_IN_FLIGHT; ++i)
-		{
-			VkDeviceSize constexpr BUFFER_SIZE{ sizeof(uint32_t) * MAX_INDICES };
-
-			m_IndexBuffer.emplace_back(VulkanMappedBuffer{
-												VulkanBuffer{BUFFER_SIZE,
-																	VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
-																	VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT },
-												nullptr });
-
-			// Persistent mapping
-			vmaMapMemory(VulkanMemoryAllocator::GetInstance().GetAllocator(), m_IndexBuffer.back().buffer.alloc, &m_IndexBuffer.back().mapped);
-		}
-	}
 }
@@ -5,6 +5,11 @@
 #include "RendererPCH.h"
 #include "../VulkanBuffer.h"
 #include "BindlessData.h"
+#include "../Passes/GPUCullingPass.h"
+#include "VulkanGeometryPool.h"
+
+#include "Math/AABBSoA.h"
+#include "Math/OffsetAllocator.h"
 
 namespace MauRen
 {
@@ -14,45 +19,82 @@ namespace MauRen
 	class VulkanMeshManager final : public MauCor::Singleton<VulkanMeshManager>
 	{
 	public:
+		enum class EDrawSet : uint8_t
+		{
+			// Every instance, for passes that see more than the camera (shadows)
+			All,
+			// Only the instances inside the culling frustum, every instance when no frustum was set this frame
+			// Culled on the GPU when supported, Cull has to be recorded before the draws
+			// With GPU culling these are only the instances that weren't occluded in last frame's depth pyramid
+			Visible,
+			// Instances the early GPU cull found occluded that turned out visible in this frame's depth pyramid
+			// Only filled with GPU culling, after the late Cull; empty otherwise
+			Disoccluded
+		};
+
 		bool Initialize(VulkanCommandPoolManager const * CmdPoolManager);
 		bool Destroy();
 		[[nodiscard]] std::pair<std::unordered_map<std::string, LoadedMeshes_PathInfo> const&, std::vector<MeshData>const&> GetLoadedMeshesPathMap() const noexcept { return { m_LoadedMeshes_Path, m_MeshData }; }
 
-		void UnloadMesh(uint32_t meshID) noexcept;
-		[[nodiscard]] uint32_t LoadMesh(char const* path, VulkanCommandPoolManager& cmdPoolManager, VulkanDescriptorContext& descriptorContext) noexcept;
+		// Releases useCount references, the mesh is destroyed once none are left
+		void UnloadMesh(uint32_t meshID, uint32_t useCount = 1) noexcept;
+		// Adds useCount references, so a batch of users only has to look the mesh up once
+		[[nodiscard]] uint32_t LoadMesh(char const* path, VulkanCommandPoolManager& cmdPoolManager, VulkanDescriptorContext& descriptorContext, uint32_t useCount = 1) noexcept;
 		[[nodiscard]] MeshData const& GetMeshData(uint32_t meshID) const;
+		// Path as it was passed to LoadMesh, empty if the mesh is not loaded
+		[[nodiscard]] std::string GetMeshPath(uint32_t meshID) const;
+		// Model space bounds, invalid if the mesh is not loaded
+		[[nodiscard]] MauCor::AABB GetMeshBounds(uint32_t meshID) const noexcept;
 
+		// Draw a mesh this frame only, queued instances are placed after the persistent ones
+		// Meshes can be queued in any order, PreDraw sorts the instances into one contiguous range per draw command
 		void QueueDraw(glm::mat4 const& transformMat, uint32_t meshID) noexcept
 		{
 			auto const it{ m_LoadedMeshes.find(meshID) };
 			ME_ASSERT(it != end(m_LoadedMeshes));
 
+			// Drawn once its geometry finished uploading
+			if (!m_MeshGeometry[it->second].isResident)
+			{
+				return;
+			}
+
 			auto const& meshData{ m_MeshData[it->second] };
 
 			for (uint32_t sub{ meshData.firstSubMesh }; sub < meshData.firstSubMesh + meshData.subMeshCount; ++ sub)
 			{
-				auto const& subMesh{ m_SubMeshes[sub] };
-
-				m_MeshInstanceData.emplace_back(transformMat, sub, subMesh.materialID, meshData.flags);
-
-				if (m_BatchedDrawCommands[sub] != INVALID_DRAW_COMMAND)
-				{
-					// Already added this mesh this frame; just increment instance count
-					m_DrawCommands[m_BatchedDrawCommands[sub]].instanceCount++;
-				}
-				else
-				{
-					// First time seeing this mesh this frame; create a new draw command
-					uint32_t const instanceOffset{ static_cast<uint32_t>(m_MeshInstanceData.size() - 1) };
-
-					m_BatchedDrawCommands[sub] = static_cast<uint32_t>(m_DrawCommands.size());
-					m_DrawCommands.emplace_back(subMesh.indexCount, 1, subMesh.firstIndex, subMesh.vertexOffset, instanceOffset);
-				}
+				m_QueuedInstanceData.emplace_back(transformMat, sub, m_SubMeshes[sub].materialID, meshData.flags);
 			}
 		}
 
+		// Persistent instances, only rebuilt when instances are added or removed & only patched when a transform changes
+		[[nodiscard]] uint32_t CreateMeshInstance(glm::mat4 const& transformMat, uint32_t meshID) noexcept;
+		void UpdateMeshInstance(uint32_t instanceID, glm::mat4 const& transformMat) noexcept;
+		void DestroyMeshInstance(uint32_t instanceID) noexcept;
+
+		// Instances outside the view's frustum are left out of the Visible draw set this frame
+		void SetCullingView(glm::mat4 const& viewProj) noexcept
+		{
+			m_CullingFrustum = MauCor::Frustum::FromViewProjection(viewProj);
+			m_CullingViewProj = viewProj;
+			m_HasCullingFrustum = true;
+		}
+
+		[[nodiscard]] bool UsesGPUCulling() const noexcept { return m_UseGPUCulling; }
+		// The Visible & Disoccluded draw sets of this frame are culled on the GPU, Cull has to be recorded for both phases
+		[[nodiscard]] bool IsGPUCulled() const noexcept { return m_UseGPUCulling && m_IsViewCulled; }
+
+		// Depth pyramid the GPU culling tests occlusion against, has to be set again whenever it is recreated
+		// The device has to be idle, the next frame is culled without occlusion
+		void SetDepthPyramid(VkImageView view, VkSampler sampler, VkExtent2D extent, uint32_t mipLevels);
+
 		void PreDraw(VulkanDescriptorContext& descriptorContext, uint32_t frame);
-		void Draw(VkCommandBuffer commandBuffer, VkPipelineLayout layout, uint32_t setCount, VkDescriptorSet const* pDescriptorSets, uint32_t frame);
+		// Records the geometry moved by the compaction, has to be after the upload acquires, before any draws & outside of rendering
+		void RecordGeometryMoves(VkCommandBuffer commandBuffer) { m_GeometryPool.RecordMoves(commandBuffer); }
+		// Records the GPU culling of the Visible (early) or Disoccluded (late) draw set, does nothing when it is culled on the CPU
+		void Cull(VkCommandBuffer commandBuffer, uint32_t frame, ECullPhase phase) const;
+		// Only reads, so it can be recorded from several threads at once
+		void Draw(VkCommandBuffer commandBuffer, VkPipelineLayout layout, uint32_t setCount, VkDescriptorSet const* pDescriptorSets, uint32_t frame, EDrawSet drawSet = EDrawSet::All) const;
 		void PostDraw(VkCommandBuffer commandBuffer, VkPipelineLayout layout, uint32_t setCount, VkDescriptorSet const* pDescriptorSets, uint32_t frame);
 
 		VulkanMeshManager(VulkanMeshManager const&) = delete;
@@ -67,132 +109,170 @@ namespace MauRen
 
 		VulkanCommandPoolManager const* m_CmdPoolManager{ nullptr };
 
-		// 1:1 copy w/ GPU buffers
+		// Instances of the persistent mesh instances, grouped per submesh
+		// GPU buffers hold these first, followed by m_QueuedInstanceData
 		std::vector<MeshInstanceData> m_MeshInstanceData;
 		std::vector<VulkanMappedBuffer> m_MeshInstanceDataBuffers;
 
-		// Data for each mesh
+		// Instances queued for this frame only, in submission order until BatchQueuedInstances sorts them
+		std::vector<MeshInstanceData> m_QueuedInstanceData;
+
+		// Scratch buffers for the batching, sort key & queued instance index per instance
+		std::vector<uint64_t> m_BatchKeys;
+		std::vector<uint32_t> m_BatchIndices;
+		std::vector<uint64_t> m_BatchKeyScratch;
+		std::vector<uint32_t> m_BatchIndexScratch;
+		std::vector<MeshInstanceData> m_SortedQueuedInstanceData;
+
+		// World bounds of the persistent & queued instances, same order as their instance data
+		MauCor::AABBSoA m_InstanceBounds;
+		MauCor::AABBSoA m_QueuedInstanceBounds;
+
+		MauCor::Frustum m_CullingFrustum{};
+		glm::mat4 m_CullingViewProj{ 1.f };
+		bool m_HasCullingFrustum{ false };
+
+		// Visible instances compacted per submesh, GPU buffers hold these after the queued instances & draw commands
+		// Rebuilt every frame, so the persistent data above never has to be touched for culling
+		std::vector<uint32_t> m_VisibleIndices;
+		std::vector<MeshInstanceData> m_VisibleInstanceData;
+		std::vector<DrawCommand> m_VisibleDrawCommands;
+		// Scratch buffer for the compaction, visible instance count & write cursor per submesh
+		std::vector<uint32_t> m_VisibleCursors;
+		// The Visible draw set of this frame was culled, otherwise it falls back to all instances
+		bool m_IsViewCulled{ false };
+
+		// Culls the Visible draw set instead of CullInstances, m_VisibleDrawCommands then holds one empty command per submesh for each phase, early first
+		// The pass fills those in & compacts them after both, the instances are written after the persistent & queued ones, early first
+		GPUCullingPass m_GPUCulling{};
+		bool m_UseGPUCulling{ false };
+		// View the depth pyramid was last built with, only valid while m_HasLastPyramid
+		glm::mat4 m_LastCullingViewProj{ 1.f };
+		bool m_HasLastPyramid{ false };
+
+		// Data for each mesh, slots of unloaded meshes are reused
 		std::vector<MeshData> m_MeshData;
+		// Grows up to the highest allocated range, ranges of unloaded meshes are zeroed until reused
 		std::vector<SubMeshData> m_SubMeshes;
 
-		// 1:1 copy w/ GPU buffers
+		// Draw commands of the persistent mesh instances, one per used submesh
+		// GPU buffers hold these first, followed by m_QueuedDrawCommands
 		std::vector<DrawCommand> m_DrawCommands;
 		std::vector<VulkanMappedBuffer> m_DrawCommandBuffers;
+		// Submesh of each persistent draw command
+		std::vector<uint32_t> m_DrawCommandSubMeshes;
 
-		// All vertices in one big buffer
-		std::vector<VulkanMappedBuffer> m_VertexBuffer;
-		// All indices in one big buffer
-		std::vector<VulkanMappedBuffer> m_IndexBuffer;
-
-		// Maps SubMeshID -> index into m_DrawCommands
-		// DrawCommands[SubMeshID] == uint max -> no batch yet; else it's the idx into the vec
-		std::vector<uint32_t> m_BatchedDrawCommands;
-
-		// maps mesh ID -> index into m_MeshData
-		std::unordered_map<uint32_t, uint32_t> m_LoadedMeshes;
-
-		// map model/mesh path into m_MeshData
-		std::unordered_map<std::string, LoadedMeshes_PathInfo> m_LoadedMeshes_Path;
-
-		std::unordered_map<uint32_t, std::string> m_MeshID_path;
+		// Draw commands queued for this frame only, one per batch
+		std::vector<DrawCommand> m_QueuedDrawCommands;
+		// Submesh of each queued draw command
+		std::vector<uint32_t> m_QueuedDrawCommandSubMeshes;
 
-		uint32_t m_CurrentVertexOffset{ 0 }; // current vertex offset in the "global" vertex buffer
-		uint32_t m_CurrentIndexOffset{ 0 }; // current index offset in the "global" index buffer
-		uint32_t m_NextID{ 0 }; // next available mesh ID
+		// All vertices & indices, one copy shared by the frames in flight
+		VulkanGeometryPool m_GeometryPool{};
 
-		struct PendingMeshUpload final
+		struct MeshInstanceProxy final
 		{
+			glm::mat4 transformMat;
 			uint32_t meshID;
+
+			// Range in m_ProxyInstanceSlots, one slot per submesh holding the index into m_MeshInstanceData
+			uint32_t firstSlot;
+			uint32_t slotCount;
 		};
 
-		struct CPUModelDataCache final
-		{
-			std::vector<Vertex> vertices;
-			std::vector<uint32_t> indices;
+		// Dense array of the persistent instances
+		std::vector<MeshInstanceProxy> m_Proxies;
+		// Dense index -> instance ID
+		std::vector<uint32_t> m_ProxyIDs;
+		// Instance ID -> dense index, INVALID_MESH_INSTANCE_ID when the ID is free
+		std::vector<uint32_t> m_ProxyIndices;
+		std::vector<uint32_t> m_FreeProxyIDs;
 
-			uint32_t vertexOffset;
-			uint32_t indexOffset;
+		std::vector<uint32_t> m_ProxyInstanceSlots;
+		// Scratch buffer for the rebuild, instance count & write cursor per submesh
+		std::vector<uint32_t> m_SubMeshInstanceCursors;
 
-			uint32_t uses;
-		};
-		std::unordered_map<uint32_t, CPUModelDataCache> m_CPUModelData;
+		// Instances were added or removed, the persistent instances & draw commands have to be rebuilt
+		bool m_ProxiesChanged{ false };
 
-		std::vector<PendingMeshUpload> m_PendingUploads[MAX_FRAMES_IN_FLIGHT];
+		// Per frame in flight, the GPU copy is stale & has to be copied fully
+		std::array<bool, MAX_FRAMES_IN_FLIGHT> m_UploadAllInstances{};
+		// Per frame in flight, the persistent instances that were patched since the frame's last upload
+		std::vector<uint32_t> m_DirtyInstances[MAX_FRAMES_IN_FLIGHT];
+		// Per frame in flight, the instance count the descriptor was last bound with
+		std::array<uint32_t, MAX_FRAMES_IN_FLIGHT> m_BoundInstanceCount{};
 
-		struct FreeRange
-		{
-			uint32_t offset;
-			uint32_t size;
+		// maps mesh ID -> index into m_MeshData
+		std::unordered_map<uint32_t, uint32_t> m_LoadedMeshes;
 
-			uint32_t End() const { return offset + size; }
+		// map model/mesh path into m_MeshData
+		std::unordered_map<std::string, LoadedMeshes_PathInfo> m_LoadedMeshes_Path;
 
-			bool operator<(FreeRange const& other) const
-			{
-				return offset < other.offset;
-			}
+		std::unordered_map<uint32_t, std::string> m_MeshID_path;
+		// MeshID -> path the mesh was loaded from, m_MeshID_path has the model prefix stripped
+		std::unordered_map<uint32_t, std::string> m_MeshID_sourcePath;
 
-			static void MergeFreeRanges(std::vector<FreeRange>& ranges)
-			{
-				if (ranges.empty())
-					return;
-
-				std::sort(ranges.begin(), ranges.end());
-
-				std::vector<FreeRange> merged;
-				merged.reserve(ranges.size());
-				merged.push_back(ranges[0]);
-
-				for (size_t i{ 1 }; i < ranges.size(); ++i)
-				{
-					FreeRange& last{ merged.back() };
-					FreeRange const& current{ ranges[i] };
-
-					if (last.End() >= current.offset)
-					{
-						ME_RENDERER_ASSERT(last.End() == current.offset, "Overlapping free ranges detected!");
-						last.size = std::max(last.End(), current.End()) - last.offset;
-					}
-					else
-					{
-						merged.push_back(current);
-					}
-				}
-
-				ranges = std::move(merged);
-			}
+		uint32_t m_NextID{ 0 }; // next available mesh ID
 
-			static std::pair<bool, uint32_t> TryUseFreeRange(std::vector<FreeRange>& ranges, uint32_t size)
-			{
-				for (auto it{ ranges.begin() }; it != end(ranges); ++it)
-				{
-					if (it->size >= size)
-					{
-						uint32_t const offset{ it->offset };
-						if (it->size == size)
-						{
-							// Exact fit, remove range
-							ranges.erase(it);
-						}
-						else
-						{
-							// Partial use, shrink the range
-							it->offset += size;
-							it->size -= size;
-						}
-						return { true, offset };
-					}
-				}
-				return { false, 0 };
-			}
+		// Ranges of m_GeometryPool, in vertices & indices
+		MauCor::OffsetAllocator m_VertexAllocator{ MAX_VERTICES, 4 * MAX_MESHES };
+		MauCor::OffsetAllocator m_IndexAllocator{ MAX_INDICES, 4 * MAX_MESHES };
+		// Ranges of m_SubMeshes, the submesh IDs stay below MAX_MESHES
+		MauCor::OffsetAllocator m_SubMeshAllocator{ MAX_MESHES, 2 * MAX_MESHES };
+
+		// Where a mesh's geometry lives, submesh offsets are relative to the pool & include these
+		struct MeshGeometry final
+		{
+			MauCor::OffsetAllocator::Allocation vertices;
+			MauCor::OffsetAllocator::Allocation indices;
+			MauCor::OffsetAllocator::Allocation subMeshes;
+			uint32_t vertexCount;
+			uint32_t indexCount;
+
+			// The upload completed, the mesh is only drawn & moved from then on
+			bool isResident;
+			// Unloaded before its upload completed, the allocations are released once it does
+			bool isUnloaded;
 		};
 
-		std::vector<FreeRange> m_FreeIndices{};
-		std::vector<FreeRange> m_FreeVertices{};
+		// Same order as m_MeshData, invalid allocations once the mesh is unloaded
+		std::vector<MeshGeometry> m_MeshGeometry;
+
+		// Ranges of meshes unloaded or moved since the last PreDraw, frames in flight may still draw them
+		std::vector<MauCor::OffsetAllocator::Allocation> m_UnloadedIndices{};
+		std::vector<MauCor::OffsetAllocator::Allocation> m_UnloadedVertices{};
+		// Per frame in flight, the unloaded ranges that are freed the next time the frame starts
+		std::vector<MauCor::OffsetAllocator::Allocation> m_RetiredIndices[MAX_FRAMES_IN_FLIGHT];
+		std::vector<MauCor::OffsetAllocator::Allocation> m_RetiredVertices[MAX_FRAMES_IN_FLIGHT];
+
+		// Slots of unloaded meshes & their submesh ranges, retired together with their geometry
+		std::vector<uint32_t> m_UnloadedMeshSlots{};
+		std::vector<MauCor::OffsetAllocator::Allocation> m_UnloadedSubMeshes{};
+		std::vector<uint32_t> m_RetiredMeshSlots[MAX_FRAMES_IN_FLIGHT];
+		std::vector<MauCor::OffsetAllocator::Allocation> m_RetiredSubMeshes[MAX_FRAMES_IN_FLIGHT];
+		// Slots in m_MeshData that LoadMesh reuses before appending
+		std::vector<uint32_t> m_FreeMeshSlots{};
+
+		// Ranges were freed or an allocation failed, cleared once compaction can't move anything lower
+		bool m_CompactVertices{ false };
+		bool m_CompactIndices{ false };
+
+		void RebuildPersistentInstances() noexcept;
+		// Sorts the queued instances by pipeline, submesh & material & emits one draw command per pipeline & submesh
+		void BatchQueuedInstances() noexcept;
+		void CullInstances(uint32_t frame) noexcept;
+		void PrepareGPUCulling(uint32_t frame) noexcept;
 
 		void InitializeMeshInstanceDataBuffers() noexcept;
 		void InitializeDrawCommandBuffers() noexcept;
-
-		void CreateVertexAndIndexBuffers() noexcept;
+		// Frees the ranges the frame retired last time it started & retires the ones unloaded since
+		void RetireUnloadedRanges(uint32_t frame) noexcept;
+		// Queues the ranges & slot of an unloaded mesh for retirement, its upload has to be complete
+		void UnloadGeometry(uint32_t internalIndex) noexcept;
+		// Moves the meshes at the end of the pools into lower free ranges, up to MESH_COMPACTION_BUDGET bytes a frame
+		void CompactGeometry() noexcept;
+		// Moves the geometry of the highest live mesh lower when there is room, returns the bytes moved or 0 when nothing moved
+		[[nodiscard]] uint32_t CompactHighestMesh(bool vertices, std::vector<uint32_t>& movedMeshes) noexcept;
 	};
 }
 
@@ -4,10 +4,10 @@
 
 #include "../VulkanCommandPoolManager.h"
 #include "../VulkanDescriptorContext.h"
+#include "../VulkanUploadManager.h"
 
 
 #include "Assets/ImageLoader.h"
-#include "Vulkan/VulkanMemoryAllocator.h"
 
 namespace MauRen
 {
@@ -20,7 +20,10 @@ namespace MauRen
 	void VulkanTextureManager::InitializeTextures(VulkanCommandPoolManager& cmdPoolManager,
 		VulkanDescriptorContext& descriptorContext)
 	{
-		CreateDefaultTextures(cmdPoolManager, descriptorContext);
+		CreateDefaultTextures(descriptorContext);
+
+		// Everything else falls back on these while it uploads, so they have to be usable right away
+		VulkanUploadManager::GetInstance().Flush(cmdPoolManager);
 	}
 
 	VulkanTextureManager::~VulkanTextureManager()
@@ -39,6 +42,13 @@ namespace MauRen
 	{
 		for (auto it{ m_TexturesToDestroyWhen3frames.begin() }; it != m_TexturesToDestroyWhen3frames.end(); )
 		{
+			// The transfer queue may still write to it, frames only count once the upload completed
+			if (m_UploadingTextures.contains(it->first))
+			{
+				++it;
+				continue;
+			}
+
 			// increment frame count
 			it->second++;
 
@@ -136,18 +146,7 @@ namespace MauRen
 			(m_FreeTextureSlots.empty() ? static_cast<uint32_t>(m_Textures.size()) : m_FreeTextureSlots.front())
 		};
 
-		VulkanImage textureImage{ CreateTextureImage(cmdPoolManager, textureName, isNorm)};
-		descriptorContext.BindTexture(ID, textureImage.imageViews[0], VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
-
-		if (!m_FreeTextureSlots.empty())
-		{
-			m_Textures[ID] = (std::move(textureImage));
-			m_FreeTextureSlots.pop_front();
-		}
-		else
-		{
-			m_Textures.emplace_back(std::move(textureImage));
-		}
+		AddUploadingTexture(descriptorContext, ID, CreateTextureImage(textureName, isNorm, MakeBindCallback(descriptorContext, ID)));
 
 		m_TextureIDMap[cleanPath] = { ID, 1 };
 		m_TextureID_PathMap[ID] = cleanPath;
@@ -182,8 +181,18 @@ namespace MauRen
 			(m_FreeTextureSlots.empty() ? static_cast<uint32_t>(m_Textures.size()) : m_FreeTextureSlots.front())
 		};
 
-		VulkanImage textureImage{ CreateTextureImage(cmdPoolManager, embTex, isNorm) };
-		descriptorContext.BindTexture(ID, textureImage.imageViews[0], VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+		AddUploadingTexture(descriptorContext, ID, CreateTextureImage(embTex, isNorm, MakeBindCallback(descriptorContext, ID)));
+
+		m_TextureIDMap[cleanPath] = { ID, 1 };
+		m_TextureID_PathMap[ID] = cleanPath;
+
+		return ID;
+	}
+
+	void VulkanTextureManager::AddUploadingTexture(VulkanDescriptorContext& descriptorContext, uint32_t ID, VulkanImage&& textureImage)
+	{
+		uint32_t const placeholderID{ m_TextureIDMap.at("__DefaultGray").textureID };
+		descriptorContext.BindTexture(ID, m_Textures[placeholderID].imageViews[0], VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
 
 		if (!m_FreeTextureSlots.empty())
 		{
@@ -195,10 +204,21 @@ namespace MauRen
 			m_Textures.emplace_back(std::move(textureImage));
 		}
 
-		m_TextureIDMap[cleanPath] = { ID, 1 };
-		m_TextureID_PathMap[ID] = cleanPath;
+		m_UploadingTextures.emplace(ID);
+	}
 
-		return ID;
+	VulkanUploadManager::CompletionCallback VulkanTextureManager::MakeBindCallback(VulkanDescriptorContext& descriptorContext, uint32_t ID)
+	{
+		return [this, &descriptorContext, ID]
+		{
+			m_UploadingTextures.erase(ID);
+
+			// The slot isn't reused while uploading, so the ID is only gone when the texture got unloaded in the meantime
+			if (m_TextureID_PathMap.contains(ID))
+			{
+				descriptorContext.BindTexture(ID, m_Textures[ID].imageViews[0], VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+			}
+		};
 	}
 
 	void VulkanTextureManager::CreateTextureSampler()
@@ -238,44 +258,44 @@ namespace MauRen
 		}
 	}
 
-	void VulkanTextureManager::CreateDefaultTextures(VulkanCommandPoolManager& cmdPoolManager, VulkanDescriptorContext& descriptorContext)
+	void VulkanTextureManager::CreateDefaultTextures(VulkanDescriptorContext& descriptorContext)
 	{
 		// 0
-		auto defaultWhiteTexture{ Create1x1Texture(cmdPoolManager, glm::vec4(1.0f), false) };
+		auto defaultWhiteTexture{ Create1x1Texture(glm::vec4(1.0f), false) };
 		descriptorContext.BindTexture(static_cast<uint32_t>(std::size(m_Textures)), defaultWhiteTexture.imageViews[0], VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
 
 		m_Textures.emplace_back(std::move(defaultWhiteTexture));
 		m_TextureIDMap["__DefaultWhite"] = { static_cast<uint32_t>(std::size(m_Textures) - 1) , 0};
 
 		// 1
-		auto defaultGrayTexture{ Create1x1Texture(cmdPoolManager, glm::vec4(.5f), false) };
+		auto defaultGrayTexture{ Create1x1Texture(glm::vec4(.5f), false) };
 		descriptorContext.BindTexture(static_cast<uint32_t>(std::size(m_Textures)), defaultGrayTexture.imageViews[0], VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
 		m_Textures.emplace_back(std::move(defaultGrayTexture));
 		m_TextureIDMap["__DefaultGray"] = { static_cast<uint32_t>(std::size(m_Textures) - 1) , 0 };
 		
 		// 2
-		auto defaultNormalTexture{ Create1x1Texture(cmdPoolManager, glm::vec4(0.5f, 0.5f, 1.0f, 1.0f), false) };
+		auto defaultNormalTexture{ Create1x1Texture(glm::vec4(0.5f, 0.5f, 1.0f, 1.0f), false) };
 		descriptorContext.BindTexture(static_cast<uint32_t>(std::size(m_Textures)), defaultNormalTexture.imageViews[0], VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
 
 		m_Textures.emplace_back(std::move(defaultNormalTexture));
 		m_TextureIDMap["__DefaultNormal"] = { static_cast<uint32_t>(std::size(m_Textures) - 1) , 0 };
 
 		// 3
-		auto defaultBlackTexture{ Create1x1Texture(cmdPoolManager, glm::vec4(0.0f), false) };
+		auto defaultBlackTexture{ Create1x1Texture(glm::vec4(0.0f), false) };
 		descriptorContext.BindTexture(static_cast<uint32_t>(std::size(m_Textures)), defaultBlackTexture.imageViews[0], VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
 
 		m_Textures.emplace_back(std::move(defaultBlackTexture));
 		m_TextureIDMap["__DefaultBlack"] = { static_cast<uint32_t>(std::size(m_Textures) - 1) , 0 };
 
 		// 4
-		auto defaultMetalnessTexture{ Create1x1Texture(cmdPoolManager, glm::vec4(1.0f, 1.0f, 0.f, 1.0f), false) };
+		auto defaultMetalnessTexture{ Create1x1Texture(glm::vec4(1.0f, 1.0f, 0.f, 1.0f), false) };
 		descriptorContext.BindTexture(static_cast<uint32_t>(std::size(m_Textures)), defaultMetalnessTexture.imageViews[0], VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
 
 		m_Textures.emplace_back(std::move(defaultMetalnessTexture));
 		m_TextureIDMap["__DefaultMetalness"] = { static_cast<uint32_t>(std::size(m_Textures) - 1) , 0 };
 
 		// 5
-		auto invalidTexture{ Create1x1Texture(cmdPoolManager, glm::vec4(1.0f, 0.0f, 1.0f, 1.0f), false) };
+		auto invalidTexture{ Create1x1Texture(glm::vec4(1.0f, 0.0f, 1.0f, 1.0f), false) };
 		descriptorContext.BindTexture(static_cast<uint32_t>(std::size(m_Textures)), invalidTexture.imageViews[0], VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
 
 		m_Textures.emplace_back(std::move(invalidTexture));
@@ -283,7 +303,7 @@ namespace MauRen
 
 	}
 
-	VulkanImage VulkanTextureManager::CreateTextureImage(VulkanCommandPoolManager& cmdPoolManager, std::string const& path, bool isNorm)
+	VulkanImage VulkanTextureManager::CreateTextureImage(std::string const& path, bool isNorm, VulkanUploadManager::CompletionCallback onComplete)
 	{
 		ME_PROFILE_FUNCTION()
 
@@ -294,15 +314,6 @@ namespace MauRen
 		VkDeviceSize const imageSize{ static_cast<uint32_t>(img.width * img.height * 4) };
 
 
-		VulkanBuffer stagingBuffer{ imageSize,
-									 VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-									 VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT };
-
-		void* data;
-		vmaMapMemory(VulkanMemoryAllocator::GetInstance().GetAllocator(), stagingBuffer.alloc, &data);
-		memcpy(data, img.pixels, static_cast<size_t>(imageSize));
-		vmaUnmapMemory(VulkanMemoryAllocator::GetInstance().GetAllocator(), stagingBuffer.alloc);
-
 		VulkanImage texImage
 		{
 			(isNorm ? VK_FORMAT_R8G8B8A8_UNORM : VK_FORMAT_R8G8B8A8_SRGB),
@@ -315,20 +326,16 @@ namespace MauRen
 			static_cast<uint32_t>(std::floor(std::log2(std::max(img.width, img.height)))) + 1
 		};
 
-		texImage.TransitionImageLayout(cmdPoolManager, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_PIPELINE_STAGE_2_NONE, VK_ACCESS_2_NONE);
-		VulkanBuffer::CopyBufferToImage(cmdPoolManager, stagingBuffer.buffer, texImage.image, static_cast<uint32_t>(img.width), static_cast<uint32_t>(img.height));
-		// is transitioned to VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL while generating mipmaps
-
-		texImage.GenerateMipmaps(cmdPoolManager);
-
-		stagingBuffer.Destroy();
+		// Copied into staging right away, so the pixels don't have to outlive this
+		// Is transitioned to VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL while generating mipmaps on the graphics queue
+		VulkanUploadManager::GetInstance().UploadImage(img.pixels, imageSize, texImage, std::move(onComplete));
 
 		texImage.CreateImageView(VK_IMAGE_ASPECT_COLOR_BIT);
 
 		return texImage;
 	}
 
-	VulkanImage VulkanTextureManager::CreateTextureImage(VulkanCommandPoolManager& cmdPoolManager, EmbeddedTexture const& embTex, bool isNorm)
+	VulkanImage VulkanTextureManager::CreateTextureImage(EmbeddedTexture const& embTex, bool isNorm, VulkanUploadManager::CompletionCallback onComplete)
 	{
 		ME_PROFILE_FUNCTION()
 
@@ -346,15 +353,6 @@ namespace MauRen
 
 		VkDeviceSize const imageSize{ static_cast<uint32_t>(img.width * img.height * 4) };
 
-		VulkanBuffer stagingBuffer{ imageSize,
-									 VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-									 VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT };
-
-		void* data;
-		vmaMapMemory(VulkanMemoryAllocator::GetInstance().GetAllocator(), stagingBuffer.alloc, &data);
-		memcpy(data, img.pixels, static_cast<size_t>(imageSize));
-		vmaUnmapMemory(VulkanMemoryAllocator::GetInstance().GetAllocator(), stagingBuffer.alloc);
-
 		VulkanImage texImage
 		{
 			isNorm ? VK_FORMAT_R8G8B8A8_UNORM : VK_FORMAT_R8G8B8A8_SRGB,
@@ -367,20 +365,16 @@ namespace MauRen
 			static_cast<uint32_t>(std::floor(std::log2(std::max(img.width, img.height)))) + 1
 		};
 
-		texImage.TransitionImageLayout(cmdPoolManager, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_PIPELINE_STAGE_2_NONE, VK_ACCESS_2_NONE);
-		VulkanBuffer::CopyBufferToImage(cmdPoolManager, stagingBuffer.buffer, texImage.image, static_cast<uint32_t>(img.width), static_cast<uint32_t>(img.height));
-		// is transitioned to VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL while generating mipmaps
-
-		texImage.GenerateMipmaps(cmdPoolManager);
-
-		stagingBuffer.Destroy();
+		// Copied into staging right away, so the pixels don't have to outlive this
+		// Is transitioned to VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL while generating mipmaps on the graphics queue
+		VulkanUploadManager::GetInstance().UploadImage(img.pixels, imageSize, texImage, std::move(onComplete));
 
 		texImage.CreateImageView(VK_IMAGE_ASPECT_COLOR_BIT);
 
 		return texImage;
 	}
 
-	VulkanImage VulkanTextureManager::Create1x1Texture(VulkanCommandPoolManager& cmdPoolManager, glm::vec4 const& color, bool isNorm)
+	VulkanImage VulkanTextureManager::Create1x1Texture(glm::vec4 const& color, bool isNorm)
 	{
 		auto const deviceContext{ VulkanDeviceContextManager::GetInstance().GetDeviceContext() };
 
@@ -392,16 +386,6 @@ namespace MauRen
 
 		VkDeviceSize imageSize{ sizeof(uint32_t) };
 
-		VulkanBuffer stagingBuffer{ imageSize,
-									 VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-									 VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT };
-
-		void* data;
-		vmaMapMemory(VulkanMemoryAllocator::GetInstance().GetAllocator(), stagingBuffer.alloc, &data);
-		memcpy(data, &pixel, static_cast<size_t>(imageSize));
-		vmaUnmapMemory(VulkanMemoryAllocator::GetInstance().GetAllocator(), stagingBuffer.alloc);
-
-
 		VulkanImage texImage
 		{
 			isNorm ? VK_FORMAT_R8G8B8A8_UNORM : VK_FORMAT_R8G8B8A8_SRGB,
@@ -415,13 +399,8 @@ namespace MauRen
 		};
 
 
-		texImage.TransitionImageLayout(cmdPoolManager, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_PIPELINE_STAGE_2_NONE, VK_ACCESS_2_NONE);
-		VulkanBuffer::CopyBufferToImage(cmdPoolManager, stagingBuffer.buffer, texImage.image, static_cast<uint32_t>(1), static_cast<uint32_t>(1));
-		// is transitioned to VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL while generating mipmaps
-
-		texImage.GenerateMipmaps(cmdPoolManager);
-
-		stagingBuffer.Destroy();
+		// Usable once the upload manager is flushed
+		VulkanUploadManager::GetInstance().UploadImage(&pixel, imageSize, texImage);
 
 		texImage.CreateImageView(VK_IMAGE_ASPECT_COLOR_BIT);
 
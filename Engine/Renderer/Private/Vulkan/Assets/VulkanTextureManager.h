@@ -2,9 +2,11 @@
 #define MAUREN_VULKANTEXTUREMANAGER_H
 
 #include <unordered_map>
+#include <unordered_set>
 
 #include "BindlessData.h"
 #include "VulkanImage.h"
+#include "../VulkanUploadManager.h"
 #include "Assets/Material.h"
 
 namespace MauRen
@@ -52,15 +54,21 @@ namespace MauRen
 		std::deque<uint32_t> m_FreeTextureSlots;
 
 		std::vector<std::pair<uint32_t, uint32_t>> m_TexturesToDestroyWhen3frames;
+		// Still being written by the transfer queue, a placeholder is bound until the upload completes
+		std::unordered_set<uint32_t> m_UploadingTextures;
 
 		void CreateTextureSampler();
 
-		void CreateDefaultTextures(VulkanCommandPoolManager& cmdPoolManager, VulkanDescriptorContext& descriptorContext);
+		void CreateDefaultTextures(VulkanDescriptorContext& descriptorContext);
 
-		[[nodiscard]] VulkanImage CreateTextureImage(VulkanCommandPoolManager& cmdPoolManager, std::string const& path, bool isNorm);
-		[[nodiscard]] VulkanImage CreateTextureImage(VulkanCommandPoolManager& cmdPoolManager, EmbeddedTexture const& embTex, bool isNorm);
+		// The image can only be sampled once onComplete ran
+		[[nodiscard]] VulkanImage CreateTextureImage(std::string const& path, bool isNorm, VulkanUploadManager::CompletionCallback onComplete);
+		[[nodiscard]] VulkanImage CreateTextureImage(EmbeddedTexture const& embTex, bool isNorm, VulkanUploadManager::CompletionCallback onComplete);
+		// Binds the placeholder until the upload completes
+		void AddUploadingTexture(VulkanDescriptorContext& descriptorContext, uint32_t ID, VulkanImage&& textureImage);
+		[[nodiscard]] VulkanUploadManager::CompletionCallback MakeBindCallback(VulkanDescriptorContext& descriptorContext, uint32_t ID);
 
-		[[nodiscard]] VulkanImage Create1x1Texture(VulkanCommandPoolManager& cmdPoolManager, glm::vec4 const& color, bool isNorm);
+		[[nodiscard]] VulkanImage Create1x1Texture(glm::vec4 const& color, bool isNorm);
 	};
 }
 
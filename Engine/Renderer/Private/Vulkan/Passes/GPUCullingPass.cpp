@@ -0,0 +1,308 @@
+#include "GPUCullingPass.h"
+#include "GlobalBarrier.h"
+
+#include "Vulkan/VulkanDeviceContextManager.h"
+#include "Vulkan/VulkanGraphicsPipelineContext.h"
+#include "Vulkan/VulkanMemoryAllocator.h"
+#include "Vulkan/VulkanUtils.h"
+
+namespace MauRen
+{
+	void GPUCullingPass::Initialize(std::vector<VulkanMappedBuffer> const& instanceBuffers, std::vector<VulkanMappedBuffer> const& drawCommandBuffers)
+	{
+		for (size_t i{ 0 }; i < MAX_FRAMES_IN_FLIGHT; ++i)
+		{
+			m_SubMeshBuffers.emplace_back(VulkanMappedBuffer{
+												VulkanBuffer{sizeof(GPUCullSubMesh) * MAX_MESHES,
+																	VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+																	VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT },
+												nullptr });
+
+			// Persistent mapping
+			vmaMapMemory(VulkanMemoryAllocator::GetInstance().GetAllocator(), m_SubMeshBuffers[i].buffer.alloc, &m_SubMeshBuffers[i].mapped);
+
+			// Only ever written by the GPU, reset with a fill at the start of the early pass
+			m_DrawCountBuffers.emplace_back(VulkanBuffer{ 2 * sizeof(uint32_t),
+															VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+															VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT });
+
+			m_ViewBuffers.emplace_back(VulkanMappedBuffer{
+												VulkanBuffer{sizeof(CullView),
+																	VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+																	VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT },
+												nullptr });
+
+			vmaMapMemory(VulkanMemoryAllocator::GetInstance().GetAllocator(), m_ViewBuffers[i].buffer.alloc, &m_ViewBuffers[i].mapped);
+		}
+
+		m_VisibilityBuffer = VulkanBuffer{ sizeof(uint32_t) * MAX_MESH_INSTANCES, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT };
+
+		CreateDescriptors(instanceBuffers, drawCommandBuffers);
+		CreatePipeline();
+	}
+
+	void GPUCullingPass::Destroy()
+	{
+		auto const deviceContext{ VulkanDeviceContextManager::GetInstance().GetDeviceContext() };
+
+		VulkanUtils::SafeDestroy(deviceContext->GetLogicalDevice(), m_Pipeline, nullptr);
+		VulkanUtils::SafeDestroy(deviceContext->GetLogicalDevice(), m_PipelineLayout, nullptr);
+
+		// Destroying the pool frees its sets
+		VulkanUtils::SafeDestroy(deviceContext->GetLogicalDevice(), m_DescriptorPool, nullptr);
+		VulkanUtils::SafeDestroy(deviceContext->GetLogicalDevice(), m_DescriptorSetLayout, nullptr);
+		m_DescriptorSets.clear();
+
+		for (auto& b : m_SubMeshBuffers)
+		{
+			b.UnMap();
+			b.buffer.Destroy();
+		}
+		m_SubMeshBuffers.clear();
+
+		for (auto& b : m_DrawCountBuffers)
+		{
+			b.Destroy();
+		}
+		m_DrawCountBuffers.clear();
+
+		for (auto& b : m_ViewBuffers)
+		{
+			b.UnMap();
+			b.buffer.Destroy();
+		}
+		m_ViewBuffers.clear();
+
+		m_VisibilityBuffer.Destroy();
+	}
+
+	void GPUCullingPass::SetPyramid(VkImageView view, VkSampler sampler, VkExtent2D extent, uint32_t mipLevels)
+	{
+		auto const deviceContext{ VulkanDeviceContextManager::GetInstance().GetDeviceContext() };
+
+		m_PyramidExtent = extent;
+		m_PyramidLevels = mipLevels;
+
+		VkDescriptorImageInfo const imageInfo{ sampler, view, VK_IMAGE_LAYOUT_GENERAL };
+
+		std::vector<VkWriteDescriptorSet> writes(MAX_FRAMES_IN_FLIGHT);
+		for (uint32_t frame{ 0 }; frame < MAX_FRAMES_IN_FLIGHT; ++frame)
+		{
+			writes[frame].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+			writes[frame].dstSet = m_DescriptorSets[frame];
+			writes[frame].dstBinding = 4;
+			writes[frame].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+			writes[frame].descriptorCount = 1;
+			writes[frame].pImageInfo = &imageInfo;
+		}
+
+		vkUpdateDescriptorSets(deviceContext->GetLogicalDevice(), static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+	}
+
+	void GPUCullingPass::SetView(uint32_t frame, MauCor::Frustum const& frustum, glm::mat4 const& lastViewProj, glm::mat4 const& viewProj, bool useLastPyramid) const noexcept
+	{
+		CullView const view
+		{
+			.planes = frustum.planes,
+			.viewProjs = { lastViewProj, viewProj },
+			.pyramidSize = { static_cast<float>(m_PyramidExtent.width), static_cast<float>(m_PyramidExtent.height) },
+			.pyramidLevels = m_PyramidLevels,
+			.useLastPyramid = useLastPyramid ? 1u : 0u
+		};
+
+		memcpy(m_ViewBuffers[frame].mapped, &view, sizeof(CullView));
+	}
+
+	void GPUCullingPass::Record(VkCommandBuffer commandBuffer, uint32_t frame, ECullPhase phase, CullInfo const& info) const
+	{
+		ME_PROFILE_FUNCTION()
+
+		if (ECullPhase::Early == phase)
+		{
+			// Also resets the counts when there is nothing to cull, the draws still read them
+			// The visibility flags & pyramid may still be in use by the previous frame's late pass
+			vkCmdFillBuffer(commandBuffer, m_DrawCountBuffers[frame].buffer, 0, 2 * sizeof(uint32_t), 0);
+			GlobalBarrier(commandBuffer,
+				VK_PIPELINE_STAGE_2_TRANSFER_BIT | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT,
+				VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_STORAGE_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT | VK_ACCESS_2_SHADER_SAMPLED_READ_BIT);
+		}
+		else
+		{
+			// Visibility flags of the early pass
+			GlobalBarrier(commandBuffer,
+				VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT,
+				VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_STORAGE_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT);
+		}
+
+		vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_Pipeline);
+		vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_PipelineLayout, 0, 1, &m_DescriptorSets[frame], 0, nullptr);
+
+		PushConstants pushConstants
+		{
+			.step = 0,
+			.pass = static_cast<uint32_t>(phase),
+			.count = info.instanceCount,
+			.firstCommand = info.firstCommand,
+			.firstCompactedCommand = info.firstCompactedCommand
+		};
+
+		if (info.instanceCount > 0)
+		{
+			vkCmdPushConstants(commandBuffer, m_PipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(PushConstants), &pushConstants);
+			vkCmdDispatch(commandBuffer, (info.instanceCount + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE, 1, 1);
+
+			// The compaction reads the instance counts of the first step
+			GlobalBarrier(commandBuffer,
+				VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT,
+				VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_STORAGE_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT);
+
+			pushConstants.step = 1;
+			pushConstants.count = info.commandCount;
+			vkCmdPushConstants(commandBuffer, m_PipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(PushConstants), &pushConstants);
+			vkCmdDispatch(commandBuffer, (info.commandCount + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE, 1, 1);
+		}
+
+		// Commands & count are read by the indirect draws, the compacted instances by the vertex shaders
+		GlobalBarrier(commandBuffer,
+			VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT,
+			VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT, VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_READ_BIT);
+	}
+
+	void GPUCullingPass::CreateDescriptors(std::vector<VulkanMappedBuffer> const& instanceBuffers, std::vector<VulkanMappedBuffer> const& drawCommandBuffers)
+	{
+		auto const deviceContext{ VulkanDeviceContextManager::GetInstance().GetDeviceContext() };
+
+		// Instances, draw commands, submesh bounds, draw counts, depth pyramid, visibility, view
+		uint32_t constexpr BINDING_COUNT{ 7 };
+		uint32_t constexpr PYRAMID_BINDING{ 4 };
+		uint32_t constexpr VIEW_BINDING{ 6 };
+
+		std::array<VkDescriptorSetLayoutBinding, BINDING_COUNT> bindings{};
+		for (uint32_t i{ 0 }; i < BINDING_COUNT; ++i)
+		{
+			bindings[i].binding = i;
+			bindings[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+			bindings[i].descriptorCount = 1;
+			bindings[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+		}
+		bindings[PYRAMID_BINDING].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+		bindings[VIEW_BINDING].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+
+		VkDescriptorSetLayoutCreateInfo layoutInfo{};
+		layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+		layoutInfo.bindingCount = BINDING_COUNT;
+		layoutInfo.pBindings = bindings.data();
+
+		if (VK_SUCCESS != vkCreateDescriptorSetLayout(deviceContext->GetLogicalDevice(), &layoutInfo, nullptr, &m_DescriptorSetLayout))
+		{
+			throw std::runtime_error("Failed to create culling descriptor set layout!");
+		}
+
+		std::array<VkDescriptorPoolSize, 3> const poolSizes
+		{
+			VkDescriptorPoolSize{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, (BINDING_COUNT - 2) * MAX_FRAMES_IN_FLIGHT },
+			VkDescriptorPoolSize{ VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, MAX_FRAMES_IN_FLIGHT },
+			VkDescriptorPoolSize{ VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, MAX_FRAMES_IN_FLIGHT }
+		};
+
+		VkDescriptorPoolCreateInfo poolInfo{};
+		poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+		poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
+		poolInfo.pPoolSizes = poolSizes.data();
+		poolInfo.maxSets = MAX_FRAMES_IN_FLIGHT;
+
+		if (VK_SUCCESS != vkCreateDescriptorPool(deviceContext->GetLogicalDevice(), &poolInfo, nullptr, &m_DescriptorPool))
+		{
+			throw std::runtime_error("Failed to create culling descriptor pool!");
+		}
+
+		std::vector<VkDescriptorSetLayout> const layouts(MAX_FRAMES_IN_FLIGHT, m_DescriptorSetLayout);
+
+		VkDescriptorSetAllocateInfo allocInfo{};
+		allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+		allocInfo.descriptorPool = m_DescriptorPool;
+		allocInfo.descriptorSetCount = MAX_FRAMES_IN_FLIGHT;
+		allocInfo.pSetLayouts = layouts.data();
+
+		m_DescriptorSets.resize(MAX_FRAMES_IN_FLIGHT);
+		if (VK_SUCCESS != vkAllocateDescriptorSets(deviceContext->GetLogicalDevice(), &allocInfo, m_DescriptorSets.data()))
+		{
+			throw std::runtime_error("Failed to allocate culling descriptor sets!");
+		}
+
+		// The buffers never change, so the sets are written once, the pyramid is written by SetPyramid
+		for (uint32_t frame{ 0 }; frame < MAX_FRAMES_IN_FLIGHT; ++frame)
+		{
+			std::array<VkDescriptorBufferInfo, BINDING_COUNT> const bufferInfos
+			{
+				VkDescriptorBufferInfo{ instanceBuffers[frame].buffer.buffer, 0, VK_WHOLE_SIZE },
+				VkDescriptorBufferInfo{ drawCommandBuffers[frame].buffer.buffer, 0, VK_WHOLE_SIZE },
+				VkDescriptorBufferInfo{ m_SubMeshBuffers[frame].buffer.buffer, 0, VK_WHOLE_SIZE },
+				VkDescriptorBufferInfo{ m_DrawCountBuffers[frame].buffer, 0, VK_WHOLE_SIZE },
+				VkDescriptorBufferInfo{ },
+				VkDescriptorBufferInfo{ m_VisibilityBuffer.buffer, 0, VK_WHOLE_SIZE },
+				VkDescriptorBufferInfo{ m_ViewBuffers[frame].buffer.buffer, 0, VK_WHOLE_SIZE }
+			};
+
+			std::array<VkWriteDescriptorSet, BINDING_COUNT - 1> writes{};
+			uint32_t writeIdx{ 0 };
+			for (uint32_t i{ 0 }; i < BINDING_COUNT; ++i)
+			{
+				if (PYRAMID_BINDING == i)
+				{
+					continue;
+				}
+
+				auto& write{ writes[writeIdx++] };
+				write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+				write.dstSet = m_DescriptorSets[frame];
+				write.dstBinding = i;
+				write.descriptorType = bindings[i].descriptorType;
+				write.descriptorCount = 1;
+				write.pBufferInfo = &bufferInfos[i];
+			}
+
+			vkUpdateDescriptorSets(deviceContext->GetLogicalDevice(), static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+		}
+	}
+
+	void GPUCullingPass::CreatePipeline()
+	{
+		auto const deviceContext{ VulkanDeviceContextManager::GetInstance().GetDeviceContext() };
+
+		VkPushConstantRange pushConstantRange{};
+		pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+		pushConstantRange.offset = 0;
+		pushConstantRange.size = sizeof(PushConstants);
+
+		VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+		pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+		pipelineLayoutInfo.setLayoutCount = 1;
+		pipelineLayoutInfo.pSetLayouts = &m_DescriptorSetLayout;
+		pipelineLayoutInfo.pushConstantRangeCount = 1;
+		pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+
+		if (VK_SUCCESS != vkCreatePipelineLayout(deviceContext->GetLogicalDevice(), &pipelineLayoutInfo, nullptr, &m_PipelineLayout))
+		{
+			throw std::runtime_error("Failed to create culling pipeline layout!");
+		}
+
+		auto const shaderCode{ VulkanGraphicsPipelineContext::ReadFile("Resources/Shaders/cull.comp.spv") };
+		VkShaderModule shaderModule{ VulkanGraphicsPipelineContext::CreateShaderModule(shaderCode) };
+
+		VkComputePipelineCreateInfo pipelineInfo{};
+		pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+		pipelineInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+		pipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+		pipelineInfo.stage.module = shaderModule;
+		pipelineInfo.stage.pName = "main";
+		pipelineInfo.layout = m_PipelineLayout;
+
+		if (VK_SUCCESS != vkCreateComputePipelines(deviceContext->GetLogicalDevice(), VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &m_Pipeline))
+		{
+			throw std::runtime_error("Failed to create culling pipeline!");
+		}
+
+		vkDestroyShaderModule(deviceContext->GetLogicalDevice(), shaderModule, nullptr);
+	}
+}
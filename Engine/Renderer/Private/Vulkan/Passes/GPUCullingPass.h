@@ -0,0 +1,124 @@
+#ifndef MAUREN_GPUCULLINGPASS_H
+#define MAUREN_GPUCULLINGPASS_H
+
+#include "RendererPCH.h"
+#include "Vulkan/VulkanBuffer.h"
+
+#include "Math/Frustum.h"
+
+namespace MauRen
+{
+	// Matches SubMeshCullData in cull.comp
+	struct alignas(16) GPUCullSubMesh final
+	{
+		glm::vec3 center;
+		uint32_t commandIdx;
+		glm::vec3 extents;
+		uint32_t padding;
+	};
+	static_assert(sizeof(GPUCullSubMesh) == 32);
+
+	enum class ECullPhase : uint8_t
+	{
+		// Frustum & last frame's depth pyramid, drawn into the depth prepass
+		Early,
+		// What the early pass found occluded against this frame's pyramid
+		Late
+	};
+
+	/**
+	 * @brief Frustum & occlusion culls instances in a compute pass.
+	 *
+	 * Every instance in [0, instanceCount) of the instance buffer is tested against its submesh's bounds.
+	 * Visible instances are appended to their submesh's draw command, whose firstInstance has to point at a free range of the instance buffer.
+	 * The non empty draw commands are then compacted & counted, so the result can be drawn with vkCmdDrawIndexedIndirectCount.
+	 *
+	 * Runs twice a frame. The early pass tests against the depth pyramid of last frame,
+	 * the late pass retests the instances it rejected against the pyramid built from the early pass' depth. Each pass has its own draw count.
+	 */
+	class GPUCullingPass final
+	{
+	public:
+		struct CullInfo final
+		{
+			uint32_t instanceCount;
+			// Per submesh commands, written by the CPU with an instanceCount of 0
+			uint32_t firstCommand;
+			uint32_t commandCount;
+			// Where the compacted commands go, needs room for commandCount commands
+			uint32_t firstCompactedCommand;
+		};
+
+		GPUCullingPass() = default;
+		~GPUCullingPass() = default;
+
+		// The buffers are per frame in flight & have to outlive the pass
+		void Initialize(std::vector<VulkanMappedBuffer> const& instanceBuffers, std::vector<VulkanMappedBuffer> const& drawCommandBuffers);
+		void Destroy();
+
+		// Has to be set before the first Record & again whenever the pyramid is recreated, the device has to be idle
+		void SetPyramid(VkImageView view, VkSampler sampler, VkExtent2D extent, uint32_t mipLevels);
+		// lastViewProj has to be the view projection the current pyramid was built with
+		void SetView(uint32_t frame, MauCor::Frustum const& frustum, glm::mat4 const& lastViewProj, glm::mat4 const& viewProj, bool useLastPyramid) const noexcept;
+
+		// Indexed by submesh ID, only the submeshes with a draw command are read
+		[[nodiscard]] GPUCullSubMesh* GetSubMeshes(uint32_t frame) const noexcept { return static_cast<GPUCullSubMesh*>(m_SubMeshBuffers[frame].mapped); }
+		// One uint32_t per phase, early first
+		[[nodiscard]] VkBuffer GetDrawCountBuffer(uint32_t frame) const noexcept { return m_DrawCountBuffers[frame].buffer; }
+
+		// Has to be recorded outside of rendering, before the draws that use the result
+		// The late pass reuses the instances of the early pass, info.instanceCount has to match
+		void Record(VkCommandBuffer commandBuffer, uint32_t frame, ECullPhase phase, CullInfo const& info) const;
+
+		GPUCullingPass(GPUCullingPass const&) = delete;
+		GPUCullingPass(GPUCullingPass&&) = delete;
+		GPUCullingPass& operator=(GPUCullingPass const&) = delete;
+		GPUCullingPass& operator=(GPUCullingPass&&) = delete;
+
+	private:
+		// Matches the push constants in cull.comp
+		struct PushConstants final
+		{
+			uint32_t step;
+			uint32_t pass;
+			uint32_t count;
+			uint32_t firstCommand;
+			uint32_t firstCompactedCommand;
+		};
+
+		// Matches CullView in cull.comp (std140)
+		struct alignas(16) CullView final
+		{
+			std::array<glm::vec4, 6> planes;
+			std::array<glm::mat4, 2> viewProjs;
+
+			glm::vec2 pyramidSize;
+			uint32_t pyramidLevels;
+			uint32_t useLastPyramid;
+		};
+		static_assert(sizeof(CullView) == 240);
+
+		uint32_t static constexpr WORKGROUP_SIZE{ 64 };
+
+		VkDescriptorSetLayout m_DescriptorSetLayout{ VK_NULL_HANDLE };
+		VkDescriptorPool m_DescriptorPool{ VK_NULL_HANDLE };
+		std::vector<VkDescriptorSet> m_DescriptorSets{};
+
+		VkPipelineLayout m_PipelineLayout{ VK_NULL_HANDLE };
+		VkPipeline m_Pipeline{ VK_NULL_HANDLE };
+
+		std::vector<VulkanMappedBuffer> m_SubMeshBuffers{};
+		std::vector<VulkanBuffer> m_DrawCountBuffers{};
+		std::vector<VulkanMappedBuffer> m_ViewBuffers{};
+		// Only lives from the early to the late pass of a frame, so it's shared between the frames
+		VulkanBuffer m_VisibilityBuffer{};
+
+		VkExtent2D m_PyramidExtent{ 0, 0 };
+		uint32_t m_PyramidLevels{ 0 };
+
+		void CreateDescriptors(std::vector<VulkanMappedBuffer> const& instanceBuffers, std::vector<VulkanMappedBuffer> const& drawCommandBuffers);
+		void CreatePipeline();
+	};
+}
+
+#endif
@@ -0,0 +1,27 @@
+#ifndef MAUREN_GLOBALBARRIER_H
+#define MAUREN_GLOBALBARRIER_H
+
+#include "RendererPCH.h"
+
+namespace MauRen
+{
+	// Memory barrier over every resource, for compute passes that hand buffers & images in the GENERAL layout to each other
+	inline void GlobalBarrier(VkCommandBuffer commandBuffer, VkPipelineStageFlags2 srcStage, VkAccessFlags2 srcAccess, VkPipelineStageFlags2 dstStage, VkAccessFlags2 dstAccess)
+	{
+		VkMemoryBarrier2 barrier{};
+		barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2;
+		barrier.srcStageMask = srcStage;
+		barrier.srcAccessMask = srcAccess;
+		barrier.dstStageMask = dstStage;
+		barrier.dstAccessMask = dstAccess;
+
+		VkDependencyInfo dependencyInfo{};
+		dependencyInfo.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+		dependencyInfo.memoryBarrierCount = 1;
+		dependencyInfo.pMemoryBarriers = &barrier;
+
+		vkCmdPipelineBarrier2(commandBuffer, &dependencyInfo);
+	}
+}
+
+#endif
@@ -0,0 +1,248 @@
+#include "HiZPass.h"
+#include "GlobalBarrier.h"
+
+#include "Vulkan/VulkanCommandPoolManager.h"
+#include "Vulkan/VulkanDeviceContextManager.h"
+#include "Vulkan/VulkanGraphicsPipelineContext.h"
+#include "Vulkan/VulkanUtils.h"
+
+#include <bit>
+
+namespace MauRen
+{
+	void HiZPass::Initialize(VulkanCommandPoolManager const& cmdPoolManager, VulkanImage const& depthImage)
+	{
+		auto const deviceContext{ VulkanDeviceContextManager::GetInstance().GetDeviceContext() };
+
+		VkExtent2D const extent{ depthImage.width, depthImage.height };
+		// Halve until 1x1
+		auto const mipLevels{ static_cast<uint32_t>(std::bit_width(std::max(extent.width, extent.height))) };
+
+		m_Pyramid = VulkanImage
+		{
+			VK_FORMAT_R32_SFLOAT,
+			VK_IMAGE_TILING_OPTIMAL,
+			VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+			VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+			VK_SAMPLE_COUNT_1_BIT,
+			extent.width,
+			extent.height,
+			mipLevels,
+			1.f
+		};
+
+		// Full chain for the culling, then one view per level to build it
+		m_Pyramid.CreateImageView(VK_IMAGE_ASPECT_COLOR_BIT);
+		for (uint32_t level{ 0 }; level < mipLevels; ++level)
+		{
+			m_Pyramid.CreateImageView(VK_IMAGE_ASPECT_COLOR_BIT, level, 1);
+		}
+
+		m_Pyramid.TransitionImageLayout(cmdPoolManager,
+			VK_IMAGE_LAYOUT_GENERAL,
+			VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+			VK_ACCESS_2_SHADER_SAMPLED_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT);
+
+		// Only read with texelFetch, no filtering
+		VkSamplerCreateInfo samplerInfo{};
+		samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+		samplerInfo.magFilter = VK_FILTER_NEAREST;
+		samplerInfo.minFilter = VK_FILTER_NEAREST;
+		samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+		samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+		samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+		samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+		samplerInfo.maxLod = VK_LOD_CLAMP_NONE;
+
+		if (VK_SUCCESS != vkCreateSampler(deviceContext->GetLogicalDevice(), &samplerInfo, nullptr, &m_Sampler))
+		{
+			throw std::runtime_error("Failed to create depth pyramid sampler!");
+		}
+
+		CreateDescriptors(depthImage);
+		CreatePipeline();
+	}
+
+	void HiZPass::Destroy()
+	{
+		auto const deviceContext{ VulkanDeviceContextManager::GetInstance().GetDeviceContext() };
+
+		VulkanUtils::SafeDestroy(deviceContext->GetLogicalDevice(), m_Pipeline, nullptr);
+		VulkanUtils::SafeDestroy(deviceContext->GetLogicalDevice(), m_PipelineLayout, nullptr);
+
+		// Destroying the pool frees its sets
+		VulkanUtils::SafeDestroy(deviceContext->GetLogicalDevice(), m_DescriptorPool, nullptr);
+		VulkanUtils::SafeDestroy(deviceContext->GetLogicalDevice(), m_DescriptorSetLayout, nullptr);
+		m_DescriptorSets.clear();
+
+		VulkanUtils::SafeDestroy(deviceContext->GetLogicalDevice(), m_Sampler, nullptr);
+
+		m_Pyramid.Destroy();
+		m_Pyramid = {};
+	}
+
+	void HiZPass::Build(VkCommandBuffer commandBuffer) const
+	{
+		ME_PROFILE_FUNCTION()
+
+		// The previous frame's culling still reads the pyramid
+		GlobalBarrier(commandBuffer,
+			VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_SAMPLED_READ_BIT,
+			VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT);
+
+		vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_Pipeline);
+
+		glm::ivec2 srcSize{ static_cast<int32_t>(m_Pyramid.width), static_cast<int32_t>(m_Pyramid.height) };
+		for (uint32_t level{ 0 }; level < m_Pyramid.mipLevels; ++level)
+		{
+			glm::ivec2 const dstSize{ std::max(srcSize.x >> (level > 0 ? 1 : 0), 1), std::max(srcSize.y >> (level > 0 ? 1 : 0), 1) };
+
+			vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_PipelineLayout, 0, 1, &m_DescriptorSets[level], 0, nullptr);
+
+			PushConstants const pushConstants{ srcSize, dstSize };
+			vkCmdPushConstants(commandBuffer, m_PipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(PushConstants), &pushConstants);
+
+			vkCmdDispatch(commandBuffer,
+				(static_cast<uint32_t>(dstSize.x) + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE,
+				(static_cast<uint32_t>(dstSize.y) + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE,
+				1);
+
+			// The next level reads this one, the culling reads all of them
+			GlobalBarrier(commandBuffer,
+				VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT,
+				VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_SAMPLED_READ_BIT);
+
+			srcSize = dstSize;
+		}
+	}
+
+	void HiZPass::CreateDescriptors(VulkanImage const& depthImage)
+	{
+		auto const deviceContext{ VulkanDeviceContextManager::GetInstance().GetDeviceContext() };
+
+		std::array<VkDescriptorSetLayoutBinding, 2> bindings{};
+		bindings[0].binding = 0;
+		bindings[0].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+		bindings[0].descriptorCount = 1;
+		bindings[0].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+		bindings[1].binding = 1;
+		bindings[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+		bindings[1].descriptorCount = 1;
+		bindings[1].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+		VkDescriptorSetLayoutCreateInfo layoutInfo{};
+		layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+		layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+		layoutInfo.pBindings = bindings.data();
+
+		if (VK_SUCCESS != vkCreateDescriptorSetLayout(deviceContext->GetLogicalDevice(), &layoutInfo, nullptr, &m_DescriptorSetLayout))
+		{
+			throw std::runtime_error("Failed to create depth pyramid descriptor set layout!");
+		}
+
+		uint32_t const setCount{ m_Pyramid.mipLevels };
+
+		std::array<VkDescriptorPoolSize, 2> const poolSizes
+		{
+			VkDescriptorPoolSize{ VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, setCount },
+			VkDescriptorPoolSize{ VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, setCount }
+		};
+
+		VkDescriptorPoolCreateInfo poolInfo{};
+		poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+		poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
+		poolInfo.pPoolSizes = poolSizes.data();
+		poolInfo.maxSets = setCount;
+
+		if (VK_SUCCESS != vkCreateDescriptorPool(deviceContext->GetLogicalDevice(), &poolInfo, nullptr, &m_DescriptorPool))
+		{
+			throw std::runtime_error("Failed to create depth pyramid descriptor pool!");
+		}
+
+		std::vector<VkDescriptorSetLayout> const layouts(setCount, m_DescriptorSetLayout);
+
+		VkDescriptorSetAllocateInfo allocInfo{};
+		allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+		allocInfo.descriptorPool = m_DescriptorPool;
+		allocInfo.descriptorSetCount = setCount;
+		allocInfo.pSetLayouts = layouts.data();
+
+		m_DescriptorSets.resize(setCount);
+		if (VK_SUCCESS != vkAllocateDescriptorSets(deviceContext->GetLogicalDevice(), &allocInfo, m_DescriptorSets.data()))
+		{
+			throw std::runtime_error("Failed to allocate depth pyramid descriptor sets!");
+		}
+
+		// imageViews[0] views the full chain, imageViews[1 + level] a single level
+		for (uint32_t level{ 0 }; level < setCount; ++level)
+		{
+			bool const isDepthSet{ level == 0 };
+
+			VkDescriptorImageInfo const srcInfo
+			{
+				m_Sampler,
+				isDepthSet ? depthImage.imageViews[0] : m_Pyramid.imageViews[level],
+				isDepthSet ? VK_IMAGE_LAYOUT_DEPTH_READ_ONLY_OPTIMAL : VK_IMAGE_LAYOUT_GENERAL
+			};
+			VkDescriptorImageInfo const dstInfo{ VK_NULL_HANDLE, m_Pyramid.imageViews[1 + level], VK_IMAGE_LAYOUT_GENERAL };
+
+			std::array<VkWriteDescriptorSet, 2> writes{};
+			writes[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+			writes[0].dstSet = m_DescriptorSets[level];
+			writes[0].dstBinding = 0;
+			writes[0].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+			writes[0].descriptorCount = 1;
+			writes[0].pImageInfo = &srcInfo;
+
+			writes[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+			writes[1].dstSet = m_DescriptorSets[level];
+			writes[1].dstBinding = 1;
+			writes[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+			writes[1].descriptorCount = 1;
+			writes[1].pImageInfo = &dstInfo;
+
+			vkUpdateDescriptorSets(deviceContext->GetLogicalDevice(), static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+		}
+	}
+
+	void HiZPass::CreatePipeline()
+	{
+		auto const deviceContext{ VulkanDeviceContextManager::GetInstance().GetDeviceContext() };
+
+		VkPushConstantRange pushConstantRange{};
+		pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+		pushConstantRange.offset = 0;
+		pushConstantRange.size = sizeof(PushConstants);
+
+		VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+		pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+		pipelineLayoutInfo.setLayoutCount = 1;
+		pipelineLayoutInfo.pSetLayouts = &m_DescriptorSetLayout;
+		pipelineLayoutInfo.pushConstantRangeCount = 1;
+		pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+
+		if (VK_SUCCESS != vkCreatePipelineLayout(deviceContext->GetLogicalDevice(), &pipelineLayoutInfo, nullptr, &m_PipelineLayout))
+		{
+			throw std::runtime_error("Failed to create depth pyramid pipeline layout!");
+		}
+
+		auto const shaderCode{ VulkanGraphicsPipelineContext::ReadFile("Resources/Shaders/hiz.comp.spv") };
+		VkShaderModule shaderModule{ VulkanGraphicsPipelineContext::CreateShaderModule(shaderCode) };
+
+		VkComputePipelineCreateInfo pipelineInfo{};
+		pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+		pipelineInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+		pipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+		pipelineInfo.stage.module = shaderModule;
+		pipelineInfo.stage.pName = "main";
+		pipelineInfo.layout = m_PipelineLayout;
+
+		if (VK_SUCCESS != vkCreateComputePipelines(deviceContext->GetLogicalDevice(), VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &m_Pipeline))
+		{
+			throw std::runtime_error("Failed to create depth pyramid pipeline!");
+		}
+
+		vkDestroyShaderModule(deviceContext->GetLogicalDevice(), shaderModule, nullptr);
+	}
+}
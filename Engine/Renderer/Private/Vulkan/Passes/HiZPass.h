@@ -0,0 +1,69 @@
+#ifndef MAUREN_HIZPASS_H
+#define MAUREN_HIZPASS_H
+
+#include "RendererPCH.h"
+#include "Vulkan/Assets/VulkanImage.h"
+
+#include <glm/glm.hpp>
+
+namespace MauRen
+{
+	class VulkanCommandPoolManager;
+
+	/**
+	 * @brief Builds a hierarchical depth pyramid from the depth prepass, used by the GPU culling to skip occluded instances.
+	 *
+	 * Every level holds the furthest depth of the texels it covers one level down, level 0 matches the depth image.
+	 * The pyramid stays in VK_IMAGE_LAYOUT_GENERAL & is kept around, the next frame tests against it before it has any depth of its own.
+	 */
+	class HiZPass final
+	{
+	public:
+		HiZPass() = default;
+		~HiZPass() = default;
+
+		// Sized after the depth image, has to be destroyed & initialized again when it is recreated
+		void Initialize(VulkanCommandPoolManager const& cmdPoolManager, VulkanImage const& depthImage);
+		void Destroy();
+
+		// The depth image has to be in VK_IMAGE_LAYOUT_DEPTH_READ_ONLY_OPTIMAL & readable by compute shaders
+		void Build(VkCommandBuffer commandBuffer) const;
+
+		// View of the full mip chain
+		[[nodiscard]] VkImageView GetPyramidView() const noexcept { return m_Pyramid.imageViews[0]; }
+		[[nodiscard]] VkSampler GetSampler() const noexcept { return m_Sampler; }
+		[[nodiscard]] VkExtent2D GetExtent() const noexcept { return { m_Pyramid.width, m_Pyramid.height }; }
+		[[nodiscard]] uint32_t GetMipLevels() const noexcept { return m_Pyramid.mipLevels; }
+
+		HiZPass(HiZPass const&) = delete;
+		HiZPass(HiZPass&&) = delete;
+		HiZPass& operator=(HiZPass const&) = delete;
+		HiZPass& operator=(HiZPass&&) = delete;
+
+	private:
+		// Matches the push constants in hiz.comp
+		struct PushConstants final
+		{
+			glm::ivec2 srcSize;
+			glm::ivec2 dstSize;
+		};
+
+		uint32_t static constexpr WORKGROUP_SIZE{ 8 };
+
+		VulkanImage m_Pyramid{};
+		VkSampler m_Sampler{ VK_NULL_HANDLE };
+
+		VkDescriptorSetLayout m_DescriptorSetLayout{ VK_NULL_HANDLE };
+		VkDescriptorPool m_DescriptorPool{ VK_NULL_HANDLE };
+		// Depth image -> level 0, followed by level i - 1 -> level i
+		std::vector<VkDescriptorSet> m_DescriptorSets{};
+
+		VkPipelineLayout m_PipelineLayout{ VK_NULL_HANDLE };
+		VkPipeline m_Pipeline{ VK_NULL_HANDLE };
+
+		void CreateDescriptors(VulkanImage const& depthImage);
+		void CreatePipeline();
+	};
+}
+
+#endif
@@ -6,6 +6,7 @@ namespace MauRen
 	{
 		CreateCommandPool();
 		CreateCommandBuffers();
+		CreateThreadCommandPools();
 	}
 
 	void VulkanCommandPoolManager::Destroy()
@@ -18,6 +19,12 @@ namespace MauRen
 		}
 
 		VulkanUtils::SafeDestroy(deviceContext->GetLogicalDevice(), m_SingleTimeCommandPool, nullptr);
+
+		for (auto& threadPool : m_ThreadCommandPools)
+		{
+			VulkanUtils::SafeDestroy(deviceContext->GetLogicalDevice(), threadPool.pool, nullptr);
+		}
+		m_ThreadCommandPools.clear();
 	}
 
 	void VulkanCommandPoolManager::CreateCommandBuffers()
@@ -41,6 +48,87 @@ namespace MauRen
 		}
 	}
 
+	void VulkanCommandPoolManager::CreateThreadCommandPools()
+	{
+		auto const deviceContext{ VulkanDeviceContextManager::GetInstance().GetDeviceContext() };
+
+		m_ThreadCount = JOB_SYSTEM.NumThreadIndices();
+		m_ThreadCommandPools.resize(MAX_FRAMES_IN_FLIGHT * m_ThreadCount);
+
+		VkCommandPoolCreateInfo poolInfo{};
+		poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+		// Reset as a whole once a frame
+		poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+		poolInfo.queueFamilyIndex = deviceContext->GetQueueFamilyIndices().graphicsFamily.value();
+
+		for (auto& threadPool : m_ThreadCommandPools)
+		{
+			if (VK_SUCCESS != vkCreateCommandPool(deviceContext->GetLogicalDevice(), &poolInfo, nullptr, &threadPool.pool))
+			{
+				throw std::runtime_error("Failed to create thread command pool!");
+			}
+		}
+	}
+
+	void VulkanCommandPoolManager::PrepareSecondaryCommandBuffers(uint32_t frame, uint32_t count)
+	{
+		ME_PROFILE_FUNCTION()
+
+		auto const deviceContext{ VulkanDeviceContextManager::GetInstance().GetDeviceContext() };
+
+		// Any thread can end up recording all of them, the job system decides who takes what
+		for (uint32_t thread{ 0 }; thread < m_ThreadCount; ++thread)
+		{
+			auto& threadPool{ m_ThreadCommandPools[frame * m_ThreadCount + thread] };
+
+			if (threadPool.usedCount > 0)
+			{
+				vkResetCommandPool(deviceContext->GetLogicalDevice(), threadPool.pool, 0);
+				threadPool.usedCount = 0;
+			}
+
+			if (threadPool.secondaryBuffers.size() >= count)
+			{
+				continue;
+			}
+
+			uint32_t const firstNew{ static_cast<uint32_t>(threadPool.secondaryBuffers.size()) };
+			threadPool.secondaryBuffers.resize(count);
+
+			VkCommandBufferAllocateInfo allocInfo{};
+			allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+			allocInfo.commandPool = threadPool.pool;
+			allocInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+			allocInfo.commandBufferCount = count - firstNew;
+
+			if (VK_SUCCESS != vkAllocateCommandBuffers(deviceContext->GetLogicalDevice(), &allocInfo, &threadPool.secondaryBuffers[firstNew]))
+			{
+				throw std::runtime_error("Failed to allocate secondary command buffers!");
+			}
+		}
+	}
+
+	VkCommandBuffer VulkanCommandPoolManager::BeginSecondaryCommandBuffer(uint32_t frame) noexcept
+	{
+		auto& threadPool{ m_ThreadCommandPools[frame * m_ThreadCount + JOB_SYSTEM.ThreadIndex()] };
+		ME_RENDERER_ASSERT(threadPool.usedCount < threadPool.secondaryBuffers.size(), "More secondary command buffers than prepared for");
+
+		VkCommandBuffer const commandBuffer{ threadPool.secondaryBuffers[threadPool.usedCount++] };
+
+		// Not continuing a render pass, each buffer begins & ends its own rendering
+		VkCommandBufferInheritanceInfo inheritanceInfo{};
+		inheritanceInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+
+		VkCommandBufferBeginInfo beginInfo{};
+		beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+		beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+		beginInfo.pInheritanceInfo = &inheritanceInfo;
+
+		vkBeginCommandBuffer(commandBuffer, &beginInfo);
+
+		return commandBuffer;
+	}
+
 	VkCommandPool VulkanCommandPoolManager::GetCommandPool(uint32_t index) noexcept
 	{
 		return m_CommandPools[index];
@@ -80,25 +168,31 @@ namespace MauRen
 		return commandBuffer;
 	}
 
-	void VulkanCommandPoolManager::EndSingleTimeCommands(VkCommandBuffer commandBuffer) const
+	void VulkanCommandPoolManager::EndSingleTimeCommands(VkCommandBuffer commandBuffer, std::span<VkSemaphoreSubmitInfo const> waitSemaphores) const
 	{
 		auto const deviceContext{ VulkanDeviceContextManager::GetInstance().GetDeviceContext() };
 
 		vkEndCommandBuffer(commandBuffer);
 
-		VkSubmitInfo submitInfo{};
-		submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-		submitInfo.commandBufferCount = 1;
-		submitInfo.pCommandBuffers = &commandBuffer;
+		VkCommandBufferSubmitInfo const commandBufferInfo{
+			.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO,
+			.commandBuffer = commandBuffer
+		};
+
+		VkSubmitInfo2 const submitInfo{
+			.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO_2,
+			.waitSemaphoreInfoCount = static_cast<uint32_t>(waitSemaphores.size()),
+			.pWaitSemaphoreInfos = waitSemaphores.data(),
+			.commandBufferInfoCount = 1,
+			.pCommandBufferInfos = &commandBufferInfo
+		};
 
-		vkQueueSubmit(deviceContext->GetGraphicsQueue(), 1, &submitInfo, VK_NULL_HANDLE);
+		vkQueueSubmit2(deviceContext->GetGraphicsQueue(), 1, &submitInfo, VK_NULL_HANDLE);
 		vkQueueWaitIdle(deviceContext->GetGraphicsQueue());
 
 		vkFreeCommandBuffers(deviceContext->GetLogicalDevice(), m_SingleTimeCommandPool, 1, &commandBuffer);
 
-		// TODO 
-		// A fence would allow you to schedule multiple transfers simultaneously and wait for all of them complete, instead of executing one at a time.
-		// That may give the driver more opportunities to optimize.
+		// Only meant for setup, textures & mesh geometry are uploaded in batches through the VulkanUploadManager
 	}
 
 	void VulkanCommandPoolManager::CreateCommandPool()
@@ -23,7 +23,15 @@ namespace MauRen
 		[[nodiscard]] VkCommandBuffer& GetCommandBuffer(uint32_t index) noexcept;
 
 		[[nodiscard]] VkCommandBuffer BeginSingleTimeCommands() const;
-		void EndSingleTimeCommands(VkCommandBuffer commandBuffer) const;
+		// Blocks until the commands finished, waitSemaphores are waited on before they start
+		void EndSingleTimeCommands(VkCommandBuffer commandBuffer, std::span<VkSemaphoreSubmitInfo const> waitSemaphores = {}) const;
+
+		// Secondary command buffers come from one pool per frame in flight per job system thread, so they can be recorded in parallel
+		// Resets the frame's pools & makes sure every thread can begin count buffers, the frame's fence has to be waited on
+		void PrepareSecondaryCommandBuffers(uint32_t frame, uint32_t count);
+		// Begins the calling thread's next secondary command buffer, recorded outside of rendering & ended by the caller
+		// Threads outside the job system share a pool, only one of them may record at a time
+		[[nodiscard]] VkCommandBuffer BeginSecondaryCommandBuffer(uint32_t frame) noexcept;
 
 		VulkanCommandPoolManager(VulkanCommandPoolManager const&) = delete;
 		VulkanCommandPoolManager(VulkanCommandPoolManager&&) = delete;
@@ -37,8 +45,21 @@ namespace MauRen
 		// Are automatically freed when their pool is destroyed
 		std::vector<VkCommandBuffer> m_CommandBuffers{};
 
+		// Aligned, so threads don't write to the same cache line when taking a buffer
+		struct alignas(MauCor::CACHE_LINE_SIZE) ThreadCommandPool final
+		{
+			VkCommandPool pool{ VK_NULL_HANDLE };
+			std::vector<VkCommandBuffer> secondaryBuffers{};
+			uint32_t usedCount{ 0 };
+		};
+
+		// frame * m_ThreadCount + thread index
+		std::vector<ThreadCommandPool> m_ThreadCommandPools{};
+		uint32_t m_ThreadCount{ 0 };
+
 		void CreateCommandPool();
 		void CreateCommandBuffers();
+		void CreateThreadCommandPools();
 	};
 }
 
@@ -229,6 +229,7 @@ namespace MauRen
 
 		uniqueQueueFamilies.insert(m_FamilyIndices.graphicsFamily.value());
 		uniqueQueueFamilies.insert(m_FamilyIndices.presentFamily.value());
+		uniqueQueueFamilies.insert(m_FamilyIndices.transferFamily.value());
 
 		float constexpr queuePriority{ 1.0f };
 
@@ -260,19 +261,36 @@ namespace MauRen
 		pageableFeatures.pageableDeviceLocalMemory = VK_TRUE;
 		pageableFeatures.pNext = &memoryPriorityFeatures;
 
-		VkPhysicalDeviceDescriptorIndexingFeatures indexingFeatures{};
-		indexingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES;
-		indexingFeatures.runtimeDescriptorArray = VK_TRUE;
-		indexingFeatures.descriptorBindingPartiallyBound = VK_TRUE;
-		indexingFeatures.descriptorBindingVariableDescriptorCount = VK_TRUE;
-		indexingFeatures.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
-		indexingFeatures.shaderSampledImageArrayNonUniformIndexing = VK_TRUE;
-		indexingFeatures.pNext = &pageableFeatures;
+		// Optional, GPU culling falls back to the CPU path without it
+		{
+			VkPhysicalDeviceVulkan12Features supported12{};
+			supported12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+
+			VkPhysicalDeviceFeatures2 supported{};
+			supported.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+			supported.pNext = &supported12;
+			vkGetPhysicalDeviceFeatures2(m_PhysicalDevice, &supported);
+
+			m_SupportsDrawIndirectCount = (VK_TRUE == supported12.drawIndirectCount);
+		}
+
+		// The 1.2 struct replaces VkPhysicalDeviceDescriptorIndexingFeatures, both can't be in the same chain
+		VkPhysicalDeviceVulkan12Features features12{};
+		features12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+		features12.runtimeDescriptorArray = VK_TRUE;
+		features12.descriptorBindingPartiallyBound = VK_TRUE;
+		features12.descriptorBindingVariableDescriptorCount = VK_TRUE;
+		features12.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+		features12.shaderSampledImageArrayNonUniformIndexing = VK_TRUE;
+		features12.drawIndirectCount = m_SupportsDrawIndirectCount ? VK_TRUE : VK_FALSE;
+		// Tracks the async uploads, required by 1.2
+		features12.timelineSemaphore = VK_TRUE;
+		features12.pNext = &pageableFeatures;
 
 		VkPhysicalDeviceVulkan13Features features13
 		{
 			.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES,
-			.pNext = &indexingFeatures
+			.pNext = &features12
 		};
 		features13.synchronization2 = VK_TRUE;
 		features13.dynamicRendering = VK_TRUE;
@@ -331,6 +349,12 @@ namespace MauRen
 			vkGetDeviceQueue(m_LogicalDevice, m_FamilyIndices.graphicsFamily.value(), 0, &m_GraphicsQueue);
 			vkGetDeviceQueue(m_LogicalDevice, m_FamilyIndices.presentFamily.value(), 0, &m_PresentQueue);
 		}
+
+		if (HasDedicatedTransferQueue())
+		{
+			LOGGER.Log(MauCor::ELogPriority::Trace, LogRenderer, "Using a dedicated transfer queue");
+			vkGetDeviceQueue(m_LogicalDevice, m_FamilyIndices.transferFamily.value(), 0, &m_TransferQueue);
+		}
 	}
 
 	bool VulkanDeviceContext::CheckPhysicalDeviceExtensionSupport(VkPhysicalDevice device)
@@ -473,6 +497,24 @@ namespace MauRen
 				break;
 			}
 		}
+
+		// Prefer a family that can only copy (the DMA engines), then one without graphics
+		for (VkQueueFlags const excluded : std::array<VkQueueFlags, 2>{ VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT, VK_QUEUE_GRAPHICS_BIT })
+		{
+			for (uint32_t i{ 0 }; i < static_cast<uint32_t>(queueFamilies.size()) && !indices.transferFamily.has_value(); ++i)
+			{
+				if ((queueFamilies[i].queueFlags & VK_QUEUE_TRANSFER_BIT) && !(queueFamilies[i].queueFlags & excluded))
+				{
+					indices.transferFamily = i;
+				}
+			}
+		}
+
+		if (!indices.transferFamily.has_value())
+		{
+			indices.transferFamily = indices.graphicsFamily;
+		}
+
 		return indices;
 	}
 }
@@ -11,6 +11,8 @@ namespace MauRen
 	{
 		std::optional<uint32_t> graphicsFamily;
 		std::optional<uint32_t> presentFamily;
+		// Dedicated transfer family when there is one, the graphics family otherwise
+		std::optional<uint32_t> transferFamily;
 
 		[[nodiscard]] bool IsComplete() const noexcept
 		{
@@ -42,12 +44,18 @@ namespace MauRen
 		[[nodiscard]] VkQueue GetGraphicsQueue() const noexcept { return m_IsUsingUnifiedGraphicsPresentQueue ? m_UnifiedGraphicsPresentQueue : m_GraphicsQueue; }
 		[[nodiscard]] VkQueue GetPresentQueue() const noexcept { return m_IsUsingUnifiedGraphicsPresentQueue ? m_UnifiedGraphicsPresentQueue : m_PresentQueue; }
 		[[nodiscard]] QueueFamilyIndices GetQueueFamilyIndices() const noexcept { return m_FamilyIndices; }
+		// Can be the graphics queue, check HasDedicatedTransferQueue
+		[[nodiscard]] VkQueue GetTransferQueue() const noexcept { return HasDedicatedTransferQueue() ? m_TransferQueue : GetGraphicsQueue(); }
+		[[nodiscard]] bool HasDedicatedTransferQueue() const noexcept { return m_FamilyIndices.transferFamily != m_FamilyIndices.graphicsFamily; }
 
 		[[nodiscard]] VkSampleCountFlagBits GetSampleCount() const noexcept { return m_MsaaSamples; }
 
 		[[nodiscard]] uint32_t GetMaxSampledImages() const noexcept { return MAX_SAMPLED_IMAGES; }
 		[[nodiscard]] uint32_t GetMaxDescriptorSets() const noexcept { return MAX_DESCRIPTORS_STAGE; }
 
+		// vkCmdDrawIndexedIndirectCount can be used
+		[[nodiscard]] bool SupportsDrawIndirectCount() const noexcept { return m_SupportsDrawIndirectCount; }
+
 		VulkanDeviceContext(VulkanDeviceContext const&) = delete;
 		VulkanDeviceContext(VulkanDeviceContext&&) = delete;
 		VulkanDeviceContext& operator=(VulkanDeviceContext const&) = delete;
@@ -68,8 +76,12 @@ namespace MauRen
 		bool m_IsUsingUnifiedGraphicsPresentQueue{ false };
 		VkQueue m_UnifiedGraphicsPresentQueue{ VK_NULL_HANDLE };
 
+		VkQueue m_TransferQueue{ VK_NULL_HANDLE };
+
 		VkSampleCountFlagBits m_MsaaSamples;
 
+		bool m_SupportsDrawIndirectCount{ false };
+
 		uint32_t const MAX_SAMPLED_IMAGES{ 0 };
 		uint32_t const MAX_DESCRIPTORS_SET{ 0 };
 		uint32_t const MAX_DESCRIPTORS_STAGE{ 0 };
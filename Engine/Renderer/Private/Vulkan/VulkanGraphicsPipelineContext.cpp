@@ -2,23 +2,65 @@
 
 #include "VulkanUtils.h"
 
+#include <cstring>
+#include <exception>
+
 namespace MauRen
 {
+	namespace
+	{
+		// Drivers reject data of another device or driver version, but not all of them do so gracefully
+		[[nodiscard]] bool IsPipelineCacheCompatible(std::vector<char> const& data, VkPhysicalDeviceProperties const& properties) noexcept
+		{
+			VkPipelineCacheHeaderVersionOne header{};
+			if (data.size() < sizeof(header))
+			{
+				return false;
+			}
+
+			std::memcpy(&header, data.data(), sizeof(header));
+
+			return header.headerSize >= sizeof(header)
+				and header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE
+				and header.vendorID == properties.vendorID
+				and header.deviceID == properties.deviceID
+				and 0 == std::memcmp(header.pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE);
+		}
+	}
+
 	void VulkanGraphicsPipelineContext::Initialize(VulkanSwapchainContext* pSwapChainContext, VkDescriptorSetLayout descriptorSetLayout, uint32_t descriptorSetLayoutCount)
 	{
-		//CreateForwardPipeline(pSwapChainContext, descriptorSetLayout, descriptorSetLayoutCount);
-		CreateDepthPrePassPipeline(pSwapChainContext, descriptorSetLayout, descriptorSetLayoutCount);
-		CreateShadowPassPipeline(pSwapChainContext, descriptorSetLayout, descriptorSetLayoutCount);
-		CreateDebugGraphicsPipeline(pSwapChainContext, descriptorSetLayout, descriptorSetLayoutCount);
-		CreateGBufferPipeline(pSwapChainContext, descriptorSetLayout, descriptorSetLayoutCount);
-		CreateLightPassPipeline(pSwapChainContext, descriptorSetLayout, descriptorSetLayoutCount);
-		CreateToneMapPipeline(pSwapChainContext, descriptorSetLayout, descriptorSetLayoutCount);
+		ME_PROFILE_FUNCTION()
+
+		CreatePipelineCache();
+		m_IsPipelineCacheOwner = true;
+
+		CreatePipelines(pSwapChainContext, descriptorSetLayout, descriptorSetLayoutCount, true);
+	}
+
+	void VulkanGraphicsPipelineContext::InitializeShared(VkPipelineCache pipelineCache, VulkanSwapchainContext* pSwapChainContext, VkDescriptorSetLayout descriptorSetLayout, uint32_t descriptorSetLayoutCount)
+	{
+		ME_PROFILE_FUNCTION()
+
+		m_PipelineCache = pipelineCache;
+		m_IsPipelineCacheOwner = false;
+
+		// Waiting on jobs from a thread outside the pool would share the main thread's thread index
+		CreatePipelines(pSwapChainContext, descriptorSetLayout, descriptorSetLayoutCount, false);
 	}
 
 	void VulkanGraphicsPipelineContext::Destroy()
 	{
 		auto const deviceContext{ VulkanDeviceContextManager::GetInstance().GetDeviceContext() };
 
+		if (m_IsPipelineCacheOwner)
+		{
+			SavePipelineCache();
+			VulkanUtils::SafeDestroy(deviceContext->GetLogicalDevice(), m_PipelineCache, nullptr);
+			m_IsPipelineCacheOwner = false;
+		}
+		m_PipelineCache = VK_NULL_HANDLE;
+
 		VulkanUtils::SafeDestroy(deviceContext->GetLogicalDevice(), m_ForwardPipeline, nullptr);
 		VulkanUtils::SafeDestroy(deviceContext->GetLogicalDevice(), m_ForwardPipelineLayout, nullptr);
 
@@ -41,6 +83,152 @@ namespace MauRen
 		VulkanUtils::SafeDestroy(deviceContext->GetLogicalDevice(), m_ToneMapPipelineLayout, nullptr);
 	}
 
+	void VulkanGraphicsPipelineContext::SwapPipelines(VulkanGraphicsPipelineContext& other) noexcept
+	{
+		std::swap(m_ForwardPipelineLayout, other.m_ForwardPipelineLayout);
+		std::swap(m_ForwardPipeline, other.m_ForwardPipeline);
+
+		std::swap(m_DepthPrePassPipelineLayout, other.m_DepthPrePassPipelineLayout);
+		std::swap(m_DepthPrePassPipeline, other.m_DepthPrePassPipeline);
+
+		std::swap(m_ShadowPassPipelineLayout, other.m_ShadowPassPipelineLayout);
+		std::swap(m_ShadowPassPipeline, other.m_ShadowPassPipeline);
+
+		std::swap(m_DebugPipelineLayout, other.m_DebugPipelineLayout);
+		std::swap(m_DebugPipeline, other.m_DebugPipeline);
+
+		std::swap(m_GBufferPipelineLayout, other.m_GBufferPipelineLayout);
+		std::swap(m_GBufferPipeline, other.m_GBufferPipeline);
+
+		std::swap(m_LightPassPipelineLayout, other.m_LightPassPipelineLayout);
+		std::swap(m_LightPassPipeline, other.m_LightPassPipeline);
+
+		std::swap(m_ToneMapPipelineLayout, other.m_ToneMapPipelineLayout);
+		std::swap(m_ToneMapPipeline, other.m_ToneMapPipeline);
+	}
+
+	void VulkanGraphicsPipelineContext::CreatePipelines(VulkanSwapchainContext* pSwapChainContext, VkDescriptorSetLayout descriptorSetLayout, uint32_t descriptorSetLayoutCount, bool isParallel)
+	{
+		// The pipelines don't depend on each other & compiling them is most of the startup time
+		std::array<std::function<void()>, 6> const createFunctions
+		{
+			[&]() { CreateDepthPrePassPipeline(pSwapChainContext, descriptorSetLayout, descriptorSetLayoutCount); },
+			[&]() { CreateShadowPassPipeline(pSwapChainContext, descriptorSetLayout, descriptorSetLayoutCount); },
+			[&]() { CreateDebugGraphicsPipeline(pSwapChainContext, descriptorSetLayout, descriptorSetLayoutCount); },
+			[&]() { CreateGBufferPipeline(pSwapChainContext, descriptorSetLayout, descriptorSetLayoutCount); },
+			[&]() { CreateLightPassPipeline(pSwapChainContext, descriptorSetLayout, descriptorSetLayoutCount); },
+			[&]() { CreateToneMapPipeline(pSwapChainContext, descriptorSetLayout, descriptorSetLayoutCount); }
+		};
+		//CreateForwardPipeline(pSwapChainContext, descriptorSetLayout, descriptorSetLayoutCount);
+
+		if (not isParallel)
+		{
+			for (auto const& createFunction : createFunctions)
+			{
+				createFunction();
+			}
+			return;
+		}
+
+		// Jobs can't throw, the first failure is rethrown once every job finished
+		std::array<std::exception_ptr, createFunctions.size()> exceptions{};
+		JOB_SYSTEM.ParallelFor(createFunctions.size(), 1, [&](std::size_t begin, std::size_t end)
+			{
+				for (std::size_t i{ begin }; i < end; ++i)
+				{
+					try
+					{
+						createFunctions[i]();
+					}
+					catch (...)
+					{
+						exceptions[i] = std::current_exception();
+					}
+				}
+			});
+
+		for (auto const& exception : exceptions)
+		{
+			if (exception)
+			{
+				std::rethrow_exception(exception);
+			}
+		}
+	}
+
+	void VulkanGraphicsPipelineContext::CreatePipelineCache()
+	{
+		auto const deviceContext{ VulkanDeviceContextManager::GetInstance().GetDeviceContext() };
+
+		std::vector<char> cacheData{};
+		if (std::filesystem::exists(PIPELINE_CACHE_PATH))
+		{
+			cacheData = ReadFile(PIPELINE_CACHE_PATH);
+
+			VkPhysicalDeviceProperties properties{};
+			vkGetPhysicalDeviceProperties(deviceContext->GetPhysicalDevice(), &properties);
+
+			if (not IsPipelineCacheCompatible(cacheData, properties))
+			{
+				ME_LOG_WARN(LogRenderer, "Pipeline cache {} was written by another device or driver, starting with an empty one", PIPELINE_CACHE_PATH);
+				cacheData.clear();
+			}
+		}
+
+		VkPipelineCacheCreateInfo cacheInfo{};
+		cacheInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+		cacheInfo.initialDataSize = cacheData.size();
+		cacheInfo.pInitialData = cacheData.data();
+
+		if (VK_SUCCESS != vkCreatePipelineCache(deviceContext->GetLogicalDevice(), &cacheInfo, nullptr, &m_PipelineCache))
+		{
+			throw std::runtime_error("Failed to create pipeline cache!");
+		}
+
+		ME_LOG_INFO(LogRenderer, "Pipeline cache created with {} bytes of initial data", cacheData.size());
+	}
+
+	void VulkanGraphicsPipelineContext::SavePipelineCache() const
+	{
+		auto const deviceContext{ VulkanDeviceContextManager::GetInstance().GetDeviceContext() };
+
+		std::size_t dataSize{ 0 };
+		if (VK_SUCCESS != vkGetPipelineCacheData(deviceContext->GetLogicalDevice(), m_PipelineCache, &dataSize, nullptr))
+		{
+			ME_LOG_WARN(LogRenderer, "Failed to get the pipeline cache data, it is not saved");
+			return;
+		}
+
+		std::vector<char> data(dataSize);
+		if (VK_SUCCESS != vkGetPipelineCacheData(deviceContext->GetLogicalDevice(), m_PipelineCache, &dataSize, data.data()))
+		{
+			ME_LOG_WARN(LogRenderer, "Failed to get the pipeline cache data, it is not saved");
+			return;
+		}
+
+		// Written next to the cache & renamed, a run that is killed while saving can't leave a torn file behind
+		std::filesystem::path const cachePath{ PIPELINE_CACHE_PATH };
+		std::filesystem::path const tempPath{ cachePath.string() + ".tmp" };
+
+		std::error_code error{};
+		std::filesystem::create_directories(cachePath.parent_path(), error);
+
+		{
+			std::ofstream file{ tempPath, std::ios::binary | std::ios::trunc };
+			if (not file.write(data.data(), static_cast<std::streamsize>(dataSize)))
+			{
+				ME_LOG_WARN(LogRenderer, "Failed to write pipeline cache {}", tempPath.string());
+				return;
+			}
+		}
+
+		std::filesystem::rename(tempPath, cachePath, error);
+		if (error)
+		{
+			ME_LOG_WARN(LogRenderer, "Failed to replace pipeline cache {}: {}", cachePath.string(), error.message());
+		}
+	}
+
 	void VulkanGraphicsPipelineContext::CreateForwardPipeline(VulkanSwapchainContext* pSwapChainContext, VkDescriptorSetLayout descriptorSetLayout, uint32_t descriptorSetLayoutCount)
 	{
 		auto const deviceContext{ VulkanDeviceContextManager::GetInstance().GetDeviceContext() };
@@ -224,7 +412,7 @@ namespace MauRen
 		pipelineInfo.basePipelineHandle = VK_NULL_HANDLE; // Optional
 		pipelineInfo.basePipelineIndex = -1; // Optional
 
-		if (vkCreateGraphicsPipelines(deviceContext->GetLogicalDevice(), VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &m_ForwardPipeline) != VK_SUCCESS)
+		if (vkCreateGraphicsPipelines(deviceContext->GetLogicalDevice(), m_PipelineCache, 1, &pipelineInfo, nullptr, &m_ForwardPipeline) != VK_SUCCESS)
 		{
 			throw std::runtime_error("Failed to create graphics pipeline!");
 		}
@@ -403,7 +591,7 @@ namespace MauRen
 		pipelineInfo.basePipelineHandle = VK_NULL_HANDLE; // Optional
 		pipelineInfo.basePipelineIndex = -1; // Optional
 
-		if (VK_SUCCESS != vkCreateGraphicsPipelines(deviceContext->GetLogicalDevice(), VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &m_DepthPrePassPipeline))
+		if (VK_SUCCESS != vkCreateGraphicsPipelines(deviceContext->GetLogicalDevice(), m_PipelineCache, 1, &pipelineInfo, nullptr, &m_DepthPrePassPipeline))
 		{
 			throw std::runtime_error("Failed to create graphics pipeline!");
 		}
@@ -569,7 +757,7 @@ namespace MauRen
 		pipelineInfo.basePipelineHandle = VK_NULL_HANDLE; // Optional
 		pipelineInfo.basePipelineIndex = -1; // Optional
 
-		if (VK_SUCCESS != vkCreateGraphicsPipelines(deviceContext->GetLogicalDevice(), VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &m_ShadowPassPipeline))
+		if (VK_SUCCESS != vkCreateGraphicsPipelines(deviceContext->GetLogicalDevice(), m_PipelineCache, 1, &pipelineInfo, nullptr, &m_ShadowPassPipeline))
 		{
 			throw std::runtime_error("Failed to create graphics pipeline!");
 		}
@@ -749,7 +937,7 @@ namespace MauRen
 
 		debugPipelineInfo.pNext = &renderingCreate;
 
-		if (vkCreateGraphicsPipelines(deviceContext->GetLogicalDevice(), VK_NULL_HANDLE, 1, &debugPipelineInfo, nullptr, &m_DebugPipeline) != VK_SUCCESS)
+		if (vkCreateGraphicsPipelines(deviceContext->GetLogicalDevice(), m_PipelineCache, 1, &debugPipelineInfo, nullptr, &m_DebugPipeline) != VK_SUCCESS)
 		{
 			throw std::runtime_error("Failed to create debug graphics pipeline!");
 		}
@@ -926,7 +1114,7 @@ namespace MauRen
 		pipelineInfo.basePipelineHandle = VK_NULL_HANDLE; // Optional
 		pipelineInfo.basePipelineIndex = -1; // Optional
 
-		if (vkCreateGraphicsPipelines(deviceContext->GetLogicalDevice(), VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &m_GBufferPipeline) != VK_SUCCESS)
+		if (vkCreateGraphicsPipelines(deviceContext->GetLogicalDevice(), m_PipelineCache, 1, &pipelineInfo, nullptr, &m_GBufferPipeline) != VK_SUCCESS)
 		{
 			throw std::runtime_error("Failed to create graphics pipeline!");
 		}
@@ -1115,7 +1303,7 @@ namespace MauRen
 		pipelineInfo.basePipelineHandle = VK_NULL_HANDLE; // Optional
 		pipelineInfo.basePipelineIndex = -1; // Optional
 
-		if (VK_SUCCESS != vkCreateGraphicsPipelines(deviceContext->GetLogicalDevice(), VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &m_LightPassPipeline))
+		if (VK_SUCCESS != vkCreateGraphicsPipelines(deviceContext->GetLogicalDevice(), m_PipelineCache, 1, &pipelineInfo, nullptr, &m_LightPassPipeline))
 		{
 			throw std::runtime_error("Failed to create graphics pipeline!");
 		}
@@ -1308,7 +1496,7 @@ namespace MauRen
 		pipelineInfo.basePipelineHandle = VK_NULL_HANDLE; // Optional
 		pipelineInfo.basePipelineIndex = -1; // Optional
 
-		if (VK_SUCCESS != vkCreateGraphicsPipelines(deviceContext->GetLogicalDevice(), VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &m_ToneMapPipeline))
+		if (VK_SUCCESS != vkCreateGraphicsPipelines(deviceContext->GetLogicalDevice(), m_PipelineCache, 1, &pipelineInfo, nullptr, &m_ToneMapPipeline))
 		{
 			throw std::runtime_error("Failed to create graphics pipeline!");
 		}
@@ -15,9 +15,16 @@ namespace MauRen
 		VulkanGraphicsPipelineContext() = default;
 		~VulkanGraphicsPipelineContext() = default;
 
+		// Creates the pipelines in parallel on the job system, using the pipeline cache stored on disk
 		void Initialize(VulkanSwapchainContext* pSwapChainContext, VkDescriptorSetLayout descriptorSetLayout, uint32_t descriptorSetLayoutCount);
+		// Creates the pipelines on the calling thread with another context's cache, for threads outside the job system (shader hot reload)
+		void InitializeShared(VkPipelineCache pipelineCache, VulkanSwapchainContext* pSwapChainContext, VkDescriptorSetLayout descriptorSetLayout, uint32_t descriptorSetLayoutCount);
+		// Writes the pipeline cache back to disk when this context owns it
 		void Destroy();
 
+		// Swaps every pipeline & layout with the other context, the pipeline caches stay where they are
+		void SwapPipelines(VulkanGraphicsPipelineContext& other) noexcept;
+
 		[[nodiscard]] VkPipeline GetForwardPipeline() const noexcept { return m_ForwardPipeline; }
 		[[nodiscard]] VkPipelineLayout GetForwardPipelineLayout() const noexcept { return m_ForwardPipelineLayout; }
 
@@ -39,12 +46,22 @@ namespace MauRen
 		[[nodiscard]] VkPipeline GetToneMapPipeline() const noexcept { return m_ToneMapPipeline; }
 		[[nodiscard]] VkPipelineLayout GetToneMapPipelineLayout() const noexcept { return m_ToneMapPipelineLayout; }
 
+		[[nodiscard]] VkPipelineCache GetPipelineCache() const noexcept { return m_PipelineCache; }
+
+		// Also used by the compute passes
+		static [[nodiscard]] std::vector<char> ReadFile(std::filesystem::path const& filepath);
+		static [[nodiscard]] VkShaderModule CreateShaderModule(std::vector<char> const& code);
+
 		VulkanGraphicsPipelineContext(VulkanGraphicsPipelineContext const&) = delete;
 		VulkanGraphicsPipelineContext(VulkanGraphicsPipelineContext&&) = delete;
 		VulkanGraphicsPipelineContext& operator=(VulkanGraphicsPipelineContext const&) = delete;
 		VulkanGraphicsPipelineContext& operator=(VulkanGraphicsPipelineContext&&) = delete;
 
 	private:
+		// Internally synchronized, shared by all pipeline creation threads
+		VkPipelineCache m_PipelineCache{ VK_NULL_HANDLE };
+		bool m_IsPipelineCacheOwner{ false };
+
 		VkPipelineLayout m_ForwardPipelineLayout{ VK_NULL_HANDLE };
 		VkPipeline m_ForwardPipeline{ VK_NULL_HANDLE };
 
@@ -66,6 +83,11 @@ namespace MauRen
 		VkPipelineLayout m_ToneMapPipelineLayout{ VK_NULL_HANDLE };
 		VkPipeline m_ToneMapPipeline{ VK_NULL_HANDLE };
 
+		void CreatePipelineCache();
+		void SavePipelineCache() const;
+
+		void CreatePipelines(VulkanSwapchainContext* pSwapChainContext, VkDescriptorSetLayout descriptorSetLayout, uint32_t descriptorSetLayoutCount, bool isParallel);
+
 		void CreateForwardPipeline(VulkanSwapchainContext* pSwapChainContext, VkDescriptorSetLayout descriptorSetLayout, uint32_t descriptorSetLayoutCount);
 		void CreateDepthPrePassPipeline(VulkanSwapchainContext* pSwapChainContext, VkDescriptorSetLayout descriptorSetLayout, uint32_t descriptorSetLayoutCount);
 		void CreateShadowPassPipeline(VulkanSwapchainContext* pSwapChainContext, VkDescriptorSetLayout descriptorSetLayout, uint32_t descriptorSetLayoutCount);
@@ -73,9 +95,6 @@ namespace MauRen
 		void CreateGBufferPipeline(VulkanSwapchainContext* pSwapChainContext, VkDescriptorSetLayout descriptorSetLayout, uint32_t descriptorSetLayoutCount);
 		void CreateLightPassPipeline(VulkanSwapchainContext* pSwapChainContext, VkDescriptorSetLayout descriptorSetLayout, uint32_t descriptorSetLayoutCount);
 		void CreateToneMapPipeline(VulkanSwapchainContext* pSwapChainContext, VkDescriptorSetLayout descriptorSetLayout, uint32_t descriptorSetLayoutCount);
-
-		static [[nodiscard]] std::vector<char> ReadFile(std::filesystem::path const& filepath);
-		static [[nodiscard]] VkShaderModule CreateShaderModule(std::vector<char> const& code);
 	};
 }
 
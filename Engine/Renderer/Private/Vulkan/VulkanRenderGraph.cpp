@@ -0,0 +1,439 @@
+#include "VulkanRenderGraph.h"
+
+#include "VulkanDeviceContextManager.h"
+#include "VulkanMemoryAllocator.h"
+#include "VulkanUtils.h"
+
+namespace MauRen
+{
+	namespace
+	{
+		struct AccessInfo final
+		{
+			VkImageLayout layout;
+			VkPipelineStageFlags2 stage;
+			VkAccessFlags2 readAccess;
+			VkAccessFlags2 writeAccess;
+		};
+
+		[[nodiscard]] AccessInfo GetAccessInfo(ERenderGraphAccess access, bool isDepth) noexcept
+		{
+			VkImageLayout const readOnlyLayout{ isDepth ? VK_IMAGE_LAYOUT_DEPTH_READ_ONLY_OPTIMAL : VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL };
+
+			switch (access)
+			{
+			case ERenderGraphAccess::ColorAttachment:
+				return { VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT,
+					VK_ACCESS_2_COLOR_ATTACHMENT_READ_BIT, VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT };
+			case ERenderGraphAccess::DepthAttachment:
+				return { VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL, VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT,
+					VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT, VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT };
+			case ERenderGraphAccess::SampledFragment:
+				return { readOnlyLayout, VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT, VK_ACCESS_2_SHADER_SAMPLED_READ_BIT, VK_ACCESS_2_NONE };
+			case ERenderGraphAccess::SampledCompute:
+				return { readOnlyLayout, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_SAMPLED_READ_BIT, VK_ACCESS_2_NONE };
+			case ERenderGraphAccess::Present:
+				return { VK_IMAGE_LAYOUT_PRESENT_SRC_KHR, VK_PIPELINE_STAGE_2_BOTTOM_OF_PIPE_BIT, VK_ACCESS_2_NONE, VK_ACCESS_2_NONE };
+			}
+
+			return {};
+		}
+
+		// Only writes have to be made available, reads just need the execution dependency
+		VkAccessFlags2 constexpr WRITE_ACCESS_MASK
+		{
+			VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT |
+			VK_ACCESS_2_SHADER_WRITE_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT |
+			VK_ACCESS_2_TRANSFER_WRITE_BIT | VK_ACCESS_2_MEMORY_WRITE_BIT
+		};
+
+		[[nodiscard]] VkImageAspectFlags GetAspectMask(VkFormat format) noexcept
+		{
+			switch (format)
+			{
+			case VK_FORMAT_D16_UNORM:
+			case VK_FORMAT_X8_D24_UNORM_PACK32:
+			case VK_FORMAT_D32_SFLOAT:
+				return VK_IMAGE_ASPECT_DEPTH_BIT;
+			case VK_FORMAT_D16_UNORM_S8_UINT:
+			case VK_FORMAT_D24_UNORM_S8_UINT:
+			case VK_FORMAT_D32_SFLOAT_S8_UINT:
+				return VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT;
+			default:
+				return VK_IMAGE_ASPECT_COLOR_BIT;
+			}
+		}
+	}
+
+	void VulkanRenderGraph::Destroy()
+	{
+		auto const deviceContext{ VulkanDeviceContextManager::GetInstance().GetDeviceContext() };
+
+		// The memory is shared, so the images are destroyed without it
+		for (auto& image : m_Images)
+		{
+			if (not image.isImported)
+			{
+				image.transient.DestroyAllImageViews();
+				VulkanUtils::SafeDestroy(deviceContext->GetLogicalDevice(), image.transient.image, nullptr);
+			}
+		}
+
+		for (auto const& slot : m_MemorySlots)
+		{
+			vmaFreeMemory(VulkanMemoryAllocator::GetInstance().GetAllocator(), slot.alloc);
+		}
+
+		m_Passes.clear();
+		m_Images.clear();
+		m_MemorySlots.clear();
+		m_IsTouched.clear();
+	}
+
+	VulkanRenderGraph::ImageHandle VulkanRenderGraph::CreateImage(std::string_view name, TransientImageInfo const& info)
+	{
+		m_Images.emplace_back(Image{ .name = std::string{ name }, .info = info, .aspect = GetAspectMask(info.format) });
+		return static_cast<ImageHandle>(m_Images.size() - 1);
+	}
+
+	VulkanRenderGraph::ImageHandle VulkanRenderGraph::ImportImage(std::string_view name)
+	{
+		m_Images.emplace_back(Image{ .name = std::string{ name }, .isImported = true });
+		return static_cast<ImageHandle>(m_Images.size() - 1);
+	}
+
+	void VulkanRenderGraph::SetImportedImage(ImageHandle image, VulkanImage& vulkanImage) noexcept
+	{
+		ME_RENDERER_ASSERT(m_Images[image].isImported);
+
+		m_Images[image].pImported = &vulkanImage;
+		m_Images[image].aspect = GetAspectMask(vulkanImage.format);
+	}
+
+	VulkanRenderGraph::PassHandle VulkanRenderGraph::AddPass(std::string_view name, PassCallback&& callback, bool hasSideEffects)
+	{
+		m_Passes.emplace_back(Pass{ .name = std::string{ name }, .callback = std::move(callback), .hasSideEffects = hasSideEffects });
+		return static_cast<PassHandle>(m_Passes.size() - 1);
+	}
+
+	void VulkanRenderGraph::Read(PassHandle pass, ImageHandle image, ERenderGraphAccess access)
+	{
+		AddUse(pass, image, access, true, false);
+	}
+
+	void VulkanRenderGraph::Write(PassHandle pass, ImageHandle image, ERenderGraphAccess access)
+	{
+		ME_RENDERER_ASSERT(ERenderGraphAccess::ColorAttachment == access or ERenderGraphAccess::DepthAttachment == access, "Only attachments can be written");
+		AddUse(pass, image, access, false, true);
+	}
+
+	void VulkanRenderGraph::Compile()
+	{
+		ME_PROFILE_FUNCTION()
+
+		CullPasses();
+		CreateTransientImages();
+
+		m_IsTouched.assign(m_Images.size(), false);
+
+		auto const livePasses{ std::ranges::count_if(m_Passes, [](Pass const& pass) { return pass.isLive; }) };
+
+		VkDeviceSize allocatedSize{ 0 };
+		for (auto const& slot : m_MemorySlots)
+		{
+			allocatedSize += slot.requirements.size;
+		}
+
+		ME_LOG_INFO(LogRenderer, "Render graph: {} of {} passes kept, {} transient allocations ({} MiB)", livePasses, m_Passes.size(), m_MemorySlots.size(), allocatedSize / (1024 * 1024));
+	}
+
+	void VulkanRenderGraph::SetPassEnabled(PassHandle pass, bool isEnabled) noexcept
+	{
+		m_Passes[pass].isEnabled = isEnabled;
+	}
+
+	void VulkanRenderGraph::Execute(VkCommandBuffer commandBuffer)
+	{
+		ME_PROFILE_FUNCTION()
+
+		std::fill(begin(m_IsTouched), end(m_IsTouched), false);
+
+		for (auto const& pass : m_Passes)
+		{
+			if (not pass.isLive or not pass.isEnabled)
+			{
+				continue;
+			}
+
+			m_Barriers.clear();
+			for (auto const& use : pass.uses)
+			{
+				AddBarrier(use);
+			}
+
+			if (not m_Barriers.empty())
+			{
+				VkDependencyInfo dependencyInfo{};
+				dependencyInfo.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+				dependencyInfo.imageMemoryBarrierCount = static_cast<uint32_t>(std::size(m_Barriers));
+				dependencyInfo.pImageMemoryBarriers = m_Barriers.data();
+
+				vkCmdPipelineBarrier2(commandBuffer, &dependencyInfo);
+			}
+
+			if (pass.callback)
+			{
+				pass.callback(commandBuffer);
+			}
+		}
+	}
+
+	VulkanImage const& VulkanRenderGraph::GetImage(ImageHandle image) const noexcept
+	{
+		Image const& graphImage{ m_Images[image] };
+		ME_RENDERER_ASSERT(not graphImage.isImported or graphImage.pImported);
+
+		return graphImage.isImported ? *graphImage.pImported : graphImage.transient;
+	}
+
+	void VulkanRenderGraph::AddUse(PassHandle pass, ImageHandle image, ERenderGraphAccess access, bool isRead, bool isWritten)
+	{
+		auto& uses{ m_Passes[pass].uses };
+
+		// A read & a write of the same image are one use, so the pass only needs one barrier for it
+		auto const it{ std::ranges::find(uses, image, &ImageUse::image) };
+		if (it != end(uses))
+		{
+			ME_RENDERER_ASSERT(it->access == access, "An image can only be used one way per pass");
+
+			it->isRead |= isRead;
+			it->isWritten |= isWritten;
+			return;
+		}
+
+		uses.emplace_back(ImageUse{ image, access, isRead, isWritten });
+	}
+
+	void VulkanRenderGraph::CullPasses()
+	{
+		// Walk back from the passes that have to run, an image is needed from its reader back to the pass that last wrote it
+		std::vector<bool> isNeeded(m_Images.size(), false);
+
+		for (auto it{ m_Passes.rbegin() }; it != m_Passes.rend(); ++it)
+		{
+			Pass& pass{ *it };
+
+			pass.isLive = pass.hasSideEffects or std::ranges::any_of(pass.uses, [&](ImageUse const& use)
+				{
+					return use.isWritten and (isNeeded[use.image] or m_Images[use.image].isImported);
+				});
+
+			if (not pass.isLive)
+			{
+				continue;
+			}
+
+			for (auto const& use : pass.uses)
+			{
+				if (use.isWritten)
+				{
+					isNeeded[use.image] = false;
+				}
+			}
+			for (auto const& use : pass.uses)
+			{
+				if (use.isRead)
+				{
+					isNeeded[use.image] = true;
+				}
+			}
+		}
+
+		for (uint32_t passIndex{ 0 }; passIndex < m_Passes.size(); ++passIndex)
+		{
+			if (not m_Passes[passIndex].isLive)
+			{
+				continue;
+			}
+
+			for (auto const& use : m_Passes[passIndex].uses)
+			{
+				Image& image{ m_Images[use.image] };
+				if (UINT32_MAX == image.firstUse)
+				{
+					ME_RENDERER_ASSERT(image.isImported or not use.isRead, "Transient images have to be written before they are read");
+					image.firstUse = passIndex;
+				}
+
+				image.lastUse = passIndex;
+			}
+		}
+	}
+
+	void VulkanRenderGraph::CreateTransientImages()
+	{
+		auto const deviceContext{ VulkanDeviceContextManager::GetInstance().GetDeviceContext() };
+		VmaAllocator const allocator{ VulkanMemoryAllocator::GetInstance().GetAllocator() };
+
+		std::vector<ImageHandle> transients{};
+		std::vector<VkMemoryRequirements> requirements(m_Images.size());
+
+		for (ImageHandle handle{ 0 }; handle < m_Images.size(); ++handle)
+		{
+			Image& image{ m_Images[handle] };
+			// Only used by culled passes
+			if (image.isImported or UINT32_MAX == image.firstUse)
+			{
+				continue;
+			}
+
+			VkImageCreateInfo imageInfo{};
+			imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+			imageInfo.imageType = VK_IMAGE_TYPE_2D;
+			imageInfo.extent = { image.info.extent.width, image.info.extent.height, 1 };
+			imageInfo.mipLevels = 1;
+			imageInfo.arrayLayers = 1;
+			imageInfo.format = image.info.format;
+			imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+			imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+			imageInfo.usage = image.info.usage;
+			imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+			imageInfo.samples = image.info.samples;
+
+			if (VK_SUCCESS != vkCreateImage(deviceContext->GetLogicalDevice(), &imageInfo, nullptr, &image.transient.image))
+			{
+				throw std::runtime_error("Failed to create render graph image!");
+			}
+
+			image.transient.format = image.info.format;
+			image.transient.width = image.info.extent.width;
+			image.transient.height = image.info.extent.height;
+			image.transient.memPriority = 1.f;
+
+			vkGetImageMemoryRequirements(deviceContext->GetLogicalDevice(), image.transient.image, &requirements[handle]);
+			transients.emplace_back(handle);
+		}
+
+		// Largest first, the smaller images then fill up the slots of the larger ones
+		std::ranges::sort(transients, std::greater{}, [&](ImageHandle handle) { return requirements[handle].size; });
+
+		auto const overlaps{ [this](ImageHandle lhs, ImageHandle rhs)
+			{
+				return m_Images[lhs].firstUse <= m_Images[rhs].lastUse and m_Images[rhs].firstUse <= m_Images[lhs].lastUse;
+			} };
+
+		for (ImageHandle const handle : transients)
+		{
+			VkMemoryRequirements const& imageRequirements{ requirements[handle] };
+
+			auto slotIt{ std::ranges::find_if(m_MemorySlots, [&](MemorySlot const& slot)
+				{
+					return 0 != (slot.requirements.memoryTypeBits & imageRequirements.memoryTypeBits)
+						and std::ranges::none_of(slot.images, [&](ImageHandle other) { return overlaps(handle, other); });
+				}) };
+
+			if (slotIt == end(m_MemorySlots))
+			{
+				m_MemorySlots.emplace_back();
+				m_MemorySlots.back().requirements = imageRequirements;
+				slotIt = std::prev(end(m_MemorySlots));
+			}
+
+			MemorySlot& slot{ *slotIt };
+			slot.requirements.size = std::max(slot.requirements.size, imageRequirements.size);
+			slot.requirements.alignment = std::max(slot.requirements.alignment, imageRequirements.alignment);
+			slot.requirements.memoryTypeBits &= imageRequirements.memoryTypeBits;
+			slot.images.emplace_back(handle);
+
+			m_Images[handle].memorySlot = static_cast<uint32_t>(std::distance(begin(m_MemorySlots), slotIt));
+		}
+
+		VmaAllocationCreateInfo allocCreateInfo{};
+		allocCreateInfo.usage = VulkanMemoryAllocator::GetMemoryUsageFromVkProperties(VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+		allocCreateInfo.priority = 1.f;
+
+		for (auto& slot : m_MemorySlots)
+		{
+			if (VK_SUCCESS != vmaAllocateMemory(allocator, &slot.requirements, &allocCreateInfo, &slot.alloc, nullptr))
+			{
+				throw std::runtime_error("Failed to allocate render graph memory!");
+			}
+
+			for (ImageHandle const handle : slot.images)
+			{
+				Image& image{ m_Images[handle] };
+				if (VK_SUCCESS != vmaBindImageMemory(allocator, slot.alloc, image.transient.image))
+				{
+					throw std::runtime_error("Failed to bind render graph image memory!");
+				}
+
+				// Sampling a depth stencil image only reads the depth
+				image.transient.CreateImageView((image.aspect & VK_IMAGE_ASPECT_DEPTH_BIT) ? VK_IMAGE_ASPECT_DEPTH_BIT : image.aspect);
+			}
+		}
+	}
+
+	void VulkanRenderGraph::AddBarrier(ImageUse const& use)
+	{
+		Image& image{ m_Images[use.image] };
+		ME_RENDERER_ASSERT(not image.isImported or image.pImported, "Imported images have to be set before Execute");
+
+		VulkanImage& vulkanImage{ GetVulkanImage(image) };
+
+		AccessInfo const info{ GetAccessInfo(use.access, 0 != (image.aspect & VK_IMAGE_ASPECT_DEPTH_BIT)) };
+		VkAccessFlags2 const access{ (use.isRead ? info.readAccess : VK_ACCESS_2_NONE) | (use.isWritten ? info.writeAccess : VK_ACCESS_2_NONE) };
+
+		bool const isFirstUse{ not image.isImported and not m_IsTouched[use.image] };
+		m_IsTouched[use.image] = true;
+
+		VkImageMemoryBarrier2 barrier{};
+		barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2;
+		barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.image = vulkanImage.image;
+		barrier.subresourceRange = { image.aspect, 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS };
+		barrier.dstStageMask = info.stage;
+		barrier.dstAccessMask = access;
+		barrier.newLayout = info.layout;
+
+		if (isFirstUse)
+		{
+			// The contents are discarded, only whatever used the memory last has to be done (the previous frame or an aliased image)
+			MemorySlot const& slot{ m_MemorySlots[image.memorySlot] };
+			barrier.srcStageMask = slot.lastStage;
+			barrier.srcAccessMask = slot.lastAccess & WRITE_ACCESS_MASK;
+			barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+		}
+		else if (vulkanImage.layout == info.layout and not use.isWritten and 0 == (vulkanImage.lastAccess & WRITE_ACCESS_MASK))
+		{
+			// Read after read in the same layout, a later write has to wait on this read too
+			vulkanImage.lastStage |= info.stage;
+			vulkanImage.lastAccess |= access;
+
+			if (not image.isImported)
+			{
+				m_MemorySlots[image.memorySlot].lastStage = vulkanImage.lastStage;
+				m_MemorySlots[image.memorySlot].lastAccess = vulkanImage.lastAccess;
+			}
+			return;
+		}
+		else
+		{
+			barrier.srcStageMask = vulkanImage.lastStage;
+			barrier.srcAccessMask = vulkanImage.lastAccess & WRITE_ACCESS_MASK;
+			barrier.oldLayout = vulkanImage.layout;
+		}
+
+		m_Barriers.emplace_back(barrier);
+
+		vulkanImage.layout = info.layout;
+		vulkanImage.lastStage = info.stage;
+		vulkanImage.lastAccess = access;
+
+		if (not image.isImported)
+		{
+			m_MemorySlots[image.memorySlot].lastStage = info.stage;
+			m_MemorySlots[image.memorySlot].lastAccess = access;
+		}
+	}
+}
@@ -0,0 +1,150 @@
+#ifndef MAUREN_VULKANRENDERGRAPH_H
+#define MAUREN_VULKANRENDERGRAPH_H
+
+#include "RendererPCH.h"
+#include "Assets/VulkanImage.h"
+
+#include <functional>
+
+namespace MauRen
+{
+	// How a pass uses an image, decides the layout, stages & accesses the graph synchronizes
+	enum class ERenderGraphAccess : uint8_t
+	{
+		ColorAttachment,
+		DepthAttachment,
+		// VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_LAYOUT_DEPTH_READ_ONLY_OPTIMAL for depth formats
+		SampledFragment,
+		SampledCompute,
+		// Read only, the last use of a swapchain image
+		Present
+	};
+
+	/**
+	 * @brief Records the frame's passes in order & places the barriers between them.
+	 *
+	 * Images & passes are declared once, in execution order, every pass declares how it reads & writes the images.
+	 * Compile culls the passes nothing depends on: a pass is kept when it has side effects, writes an imported image,
+	 * or writes an image a later kept pass reads. The transient images are then created, those whose lifetimes don't overlap share memory.
+	 *
+	 * Execute records the enabled passes with one batched barrier in front of each, only where a layout changes or a write is involved.
+	 * Transient images are shared by the frames in flight, their contents are discarded at the first use of a frame.
+	 * The queue orders the barriers against the previous frame's use, so only one copy is needed.
+	 * Imported images keep their contents, their layout & last use are tracked in the VulkanImage so code outside the graph sees the same state.
+	 */
+	class VulkanRenderGraph final
+	{
+	public:
+		using ImageHandle = uint32_t;
+		using PassHandle = uint32_t;
+		using PassCallback = std::function<void(VkCommandBuffer)>;
+
+		struct TransientImageInfo final
+		{
+			VkFormat format;
+			VkExtent2D extent;
+			VkImageUsageFlags usage;
+			VkSampleCountFlagBits samples{ VK_SAMPLE_COUNT_1_BIT };
+		};
+
+		VulkanRenderGraph() = default;
+		~VulkanRenderGraph() = default;
+
+		// Destroys the transient images & forgets every pass, the device has to be idle
+		void Destroy();
+
+		[[nodiscard]] ImageHandle CreateImage(std::string_view name, TransientImageInfo const& info);
+		// The image has to be set before Execute, can be changed every frame (e.g. the acquired swapchain image)
+		[[nodiscard]] ImageHandle ImportImage(std::string_view name);
+		void SetImportedImage(ImageHandle image, VulkanImage& vulkanImage) noexcept;
+
+		// Passes with side effects write something outside the graph (buffers, shadow maps, ...) & are never culled
+		PassHandle AddPass(std::string_view name, PassCallback&& callback, bool hasSideEffects = false);
+		void Read(PassHandle pass, ImageHandle image, ERenderGraphAccess access);
+		// Writing an attachment the pass loads needs a Read with the same access too
+		void Write(PassHandle pass, ImageHandle image, ERenderGraphAccess access);
+
+		// Culls the passes, creates & aliases the transient images, has to be called after the last pass is added
+		void Compile();
+		// Disabled passes are skipped by Execute, their barriers too
+		void SetPassEnabled(PassHandle pass, bool isEnabled) noexcept;
+		void Execute(VkCommandBuffer commandBuffer);
+
+		// Valid after Compile, the views are kept until Destroy
+		[[nodiscard]] VulkanImage const& GetImage(ImageHandle image) const noexcept;
+		[[nodiscard]] bool IsPassCulled(PassHandle pass) const noexcept { return not m_Passes[pass].isLive; }
+
+		VulkanRenderGraph(VulkanRenderGraph const&) = delete;
+		VulkanRenderGraph(VulkanRenderGraph&&) = delete;
+		VulkanRenderGraph& operator=(VulkanRenderGraph const&) = delete;
+		VulkanRenderGraph& operator=(VulkanRenderGraph&&) = delete;
+
+	private:
+		struct ImageUse final
+		{
+			ImageHandle image;
+			ERenderGraphAccess access;
+			bool isRead;
+			bool isWritten;
+		};
+
+		struct Pass final
+		{
+			std::string name;
+			PassCallback callback;
+			std::vector<ImageUse> uses{};
+			bool hasSideEffects{ false };
+			bool isLive{ false };
+			bool isEnabled{ true };
+		};
+
+		struct Image final
+		{
+			std::string name;
+			TransientImageInfo info{};
+			bool isImported{ false };
+
+			// Transient images own theirs, imported ones point at the caller's
+			VulkanImage transient{};
+			VulkanImage* pImported{ nullptr };
+
+			VkImageAspectFlags aspect{ VK_IMAGE_ASPECT_COLOR_BIT };
+			// Index into m_MemorySlots, UINT32_MAX when no live pass uses the image
+			uint32_t memorySlot{ UINT32_MAX };
+			// Live passes, in m_Passes order
+			uint32_t firstUse{ UINT32_MAX };
+			uint32_t lastUse{ 0 };
+		};
+
+		// Memory shared by transient images that are never used at the same time
+		struct MemorySlot final
+		{
+			VmaAllocation alloc{ VK_NULL_HANDLE };
+			VkMemoryRequirements requirements{};
+			std::vector<ImageHandle> images{};
+
+			// Last use by any of its images, the next image's first use has to wait on it
+			VkPipelineStageFlags2 lastStage{ VK_PIPELINE_STAGE_2_NONE };
+			VkAccessFlags2 lastAccess{ VK_ACCESS_2_NONE };
+		};
+
+		std::vector<Pass> m_Passes{};
+		std::vector<Image> m_Images{};
+		std::vector<MemorySlot> m_MemorySlots{};
+
+		// Scratch, reset every Execute
+		std::vector<VkImageMemoryBarrier2> m_Barriers{};
+		std::vector<bool> m_IsTouched{};
+
+		[[nodiscard]] VulkanImage& GetVulkanImage(Image& image) noexcept { return image.isImported ? *image.pImported : image.transient; }
+		void AddUse(PassHandle pass, ImageHandle image, ERenderGraphAccess access, bool isRead, bool isWritten);
+
+		void CullPasses();
+		void CreateTransientImages();
+
+		// Adds the barrier the use needs, if any, & moves the image's tracked state to the use
+		void AddBarrier(ImageUse const& use);
+	};
+}
+
+#endif
@@ -11,6 +11,7 @@
 #include "../../../MauEng/Public/Scene/Camera.h"
 
 #include "VulkanMemoryAllocator.h"
+#include "VulkanUploadManager.h"
 
 #include "imgui.h"
 #include "backends/imgui_impl_sdl3.h"
@@ -54,6 +55,10 @@ namespace MauRen
 
 		m_DescriptorContext.CreateDescriptorSetLayout();
 		m_GraphicsPipelineContext.Initialize(&m_SwapChainContext, m_DescriptorContext.GetDescriptorSetLayout(), 1u);
+		if constexpr (ENABLE_SHADER_HOT_RELOAD)
+		{
+			m_ShaderHotReloader.Initialize(m_GraphicsPipelineContext.GetPipelineCache(), &m_SwapChainContext, m_DescriptorContext.GetDescriptorSetLayout(), 1u);
+		}
 
 		CreateUniformBuffers();
 		VulkanMaterialManager::GetInstance().Initialize();
@@ -76,13 +81,16 @@ namespace MauRen
 			VulkanMaterialManager::GetInstance().GetTextureSampler(),
 			tempUniformBuffersCamSett, 0, sizeof(CamSettingsUBO));
 
-		m_SwapChainContext.Initialize(m_pWindow, &m_SurfaceContext, m_CommandPoolManager, m_DescriptorContext);
-		
+		m_SwapChainContext.Initialize(m_pWindow, &m_SurfaceContext);
+		BuildRenderGraph();
+
 		CreateSyncObjects();
 
+		VulkanUploadManager::GetInstance().Initialize();
 		VulkanMaterialManager::GetInstance().InitializeTextureManager(m_CommandPoolManager, m_DescriptorContext);
 		VulkanLightManager::GetInstance().Initialize(m_CommandPoolManager, m_DescriptorContext);
 		VulkanMeshManager::GetInstance().Initialize(&m_CommandPoolManager);
+		CreateDepthPyramid();
 
 		if (m_DebugRenderer)
 		{
@@ -184,6 +192,9 @@ namespace MauRen
 	{
 		auto const deviceContext{ VulkanDeviceContextManager::GetInstance().GetDeviceContext() };
 
+		// Stops creating pipelines before anything they use is destroyed
+		m_ShaderHotReloader.Destroy();
+
 		// Wait for GPU to finish everything
 		vkDeviceWaitIdle(deviceContext->GetLogicalDevice());
 
@@ -194,9 +205,13 @@ namespace MauRen
 			vkDestroyFence(deviceContext->GetLogicalDevice(), m_InFlightFences[i], nullptr);
 		}
 
+		m_HiZPass.Destroy();
+		m_RenderGraph.Destroy();
+
 		VulkanMaterialManager::GetInstance().Destroy();
 		VulkanMeshManager::GetInstance().Destroy();
 		VulkanLightManager::GetInstance().Destroy();
+		VulkanUploadManager::GetInstance().Destroy();
 
 		if (m_DebugRenderer)
 		{
@@ -291,9 +306,11 @@ namespace MauRen
 		VulkanLightManager::GetInstance().SetSceneAABBOverride(min, max);
 	}
 
-	void VulkanRenderer::PreLightQueue(glm::mat4 const& viewProj)
+	void VulkanRenderer::PreLightQueue(glm::mat4 const& viewProj, MauCor::AABB const& sceneBounds)
 	{
-		VulkanLightManager::GetInstance().PreQueue(viewProj);
+		VulkanLightManager::GetInstance().PreQueue(viewProj, sceneBounds);
+		// Shadow passes still draw everything, casters outside the view can shadow what is inside it
+		VulkanMeshManager::GetInstance().SetCullingView(viewProj);
 	}
 
 	void VulkanRenderer::QueueLight(MauEng::CLight const& light)
@@ -306,14 +323,39 @@ namespace MauRen
 		VulkanMeshManager::GetInstance().QueueDraw(transformMat, mesh.meshID);
 	}
 
-	void VulkanRenderer::UnloadMesh(uint32_t meshID)
+	uint32_t VulkanRenderer::CreateMeshInstance(glm::mat4 const& transformMat, uint32_t meshID)
+	{
+		return VulkanMeshManager::GetInstance().CreateMeshInstance(transformMat, meshID);
+	}
+
+	void VulkanRenderer::UpdateMeshInstance(uint32_t instanceID, glm::mat4 const& transformMat)
+	{
+		VulkanMeshManager::GetInstance().UpdateMeshInstance(instanceID, transformMat);
+	}
+
+	void VulkanRenderer::DestroyMeshInstance(uint32_t instanceID)
+	{
+		VulkanMeshManager::GetInstance().DestroyMeshInstance(instanceID);
+	}
+
+	void VulkanRenderer::UnloadMesh(uint32_t meshID, uint32_t useCount)
+	{
+		VulkanMeshManager::GetInstance().UnloadMesh(meshID, useCount);
+	}
+
+	uint32_t VulkanRenderer::LoadOrGetMeshID(char const* path, uint32_t useCount)
+	{
+		return VulkanMeshManager::GetInstance().LoadMesh(path, m_CommandPoolManager, m_DescriptorContext, useCount);
+	}
+
+	std::string VulkanRenderer::GetMeshPath(uint32_t meshID) const
 	{
-		VulkanMeshManager::GetInstance().UnloadMesh(meshID);
+		return VulkanMeshManager::GetInstance().GetMeshPath(meshID);
 	}
 
-	uint32_t VulkanRenderer::LoadOrGetMeshID(char const* path)
+	MauCor::AABB VulkanRenderer::GetMeshBounds(uint32_t meshID) const
 	{
-		return VulkanMeshManager::GetInstance().LoadMesh(path, m_CommandPoolManager, m_DescriptorContext);
+		return VulkanMeshManager::GetInstance().GetMeshBounds(meshID);
 	}
 
 	MaterialRendererInfo VulkanRenderer::GetMaterialRendererInfo() const noexcept
@@ -388,400 +430,460 @@ namespace MauRen
 			throw std::runtime_error("Failed to begin recording command buffer!");
 		}
 
-		auto& depth{ m_SwapChainContext.GetDepthImage(m_CurrentFrame) };
-		auto& colour{ m_SwapChainContext.GetColorImage(m_CurrentFrame) };
-		auto& gBufferColor{ m_SwapChainContext.GetGBuffer(m_CurrentFrame).color };
-		auto& gBufferNormal{ m_SwapChainContext.GetGBuffer(m_CurrentFrame).normal };
-		auto& gBufferMetalRough{ m_SwapChainContext.GetGBuffer(m_CurrentFrame).metalnessRoughness };
+		m_RenderGraph.SetImportedImage(m_RenderTargets.swapchain, m_SwapChainContext.GetSwapchainImages()[imageIndex]);
 
-#pragma region DEPTH_PREPASS
+		bool const isGPUCulled{ VulkanMeshManager::GetInstance().IsGPUCulled() };
+		for (auto const pass : m_LateCullingPasses)
+		{
+			m_RenderGraph.SetPassEnabled(pass, isGPUCulled);
+		}
+
+		// Every pass & its barriers, up to the swapchain image's transition for presenting
+		m_RenderGraph.Execute(commandBuffer);
+
+#pragma region POST_DRAW
 		{
-			ME_PROFILE_SCOPE("Depth Prepass")
-			// Depth
-			if (VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL != depth.layout)
+			ME_PROFILE_SCOPE("Post draw")
+
+			VulkanMeshManager::GetInstance().PostDraw(commandBuffer, m_GraphicsPipelineContext.GetForwardPipelineLayout(), 1, &m_DescriptorContext.GetDescriptorSets()[m_CurrentFrame], m_CurrentFrame);
+			VulkanLightManager::GetInstance().PostDraw();
+
+			if (VK_SUCCESS != vkEndCommandBuffer(commandBuffer))
 			{
-				depth.TransitionImageLayout(commandBuffer,
-					VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL,
-					VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT,
-					VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT);
+				throw std::runtime_error("Failed to record command buffer!");
 			}
 
-			VkRenderingAttachmentInfo depthAttachment{};
-			depthAttachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
-			depthAttachment.imageView = depth.imageViews[0];
-			depthAttachment.imageLayout = depth.layout;
-			depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
-			depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
-			depthAttachment.clearValue = CLEAR_VALUES[DEPTH_CLEAR_ID];
-
-			VkRenderingInfo renderInfoDepthPrepass{};
-			renderInfoDepthPrepass.sType = VK_STRUCTURE_TYPE_RENDERING_INFO;
-			renderInfoDepthPrepass.renderArea = VkRect2D{ VkOffset2D{ 0, 0 }, m_SwapChainContext.GetExtent() };
-			renderInfoDepthPrepass.layerCount = 1;
-			renderInfoDepthPrepass.colorAttachmentCount = 0;
-			renderInfoDepthPrepass.pColorAttachments = nullptr;
-			renderInfoDepthPrepass.pDepthAttachment = &depthAttachment;
-			renderInfoDepthPrepass.pStencilAttachment = nullptr;
-
-			VkViewport viewport{};
-			viewport.x = 0.0f;
-			viewport.y = 0.0f;
-			viewport.width = static_cast<float>(m_SwapChainContext.GetExtent().width);
-			viewport.height = static_cast<float>(m_SwapChainContext	.GetExtent().height);
-			viewport.minDepth = 0.0f;
-			viewport.maxDepth = 1.0f;
-
-			VkRect2D scissor{};
-			scissor.offset = { 0, 0 };
-			scissor.extent = m_SwapChainContext.GetExtent();
-
-			vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
-			vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
-			vkCmdBeginRendering(commandBuffer, &renderInfoDepthPrepass);
-				vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_GraphicsPipelineContext.GetDepthPrePassPipeline());
-				VulkanMeshManager::GetInstance().Draw(commandBuffer, m_GraphicsPipelineContext.GetDepthPrePassPipelineLayout(), 1, &m_DescriptorContext.GetDescriptorSets()[m_CurrentFrame], m_CurrentFrame);
-				//RenderDebug(commandBuffer, true);
-			vkCmdEndRendering(commandBuffer);
+			// TODO maybe move to ImGUI layer 
+			if constexpr (USE_IMGUI)
+			{
+				if (ImGui::GetIO().ConfigFlags & ImGuiConfigFlags_ViewportsEnable)
+				{
+					ImGui::UpdatePlatformWindows();
+					ImGui::RenderPlatformWindowsDefault();
+				}
+			}
 		}
 #pragma endregion
-#pragma region SHADOW_PASS
+	}
+
+	void VulkanRenderer::BuildRenderGraph()
+	{
+		ME_PROFILE_FUNCTION()
+
+		m_RenderGraph.Destroy();
+
+		auto const deviceContext{ VulkanDeviceContextManager::GetInstance().GetDeviceContext() };
+		VkExtent2D const extent{ m_SwapChainContext.GetExtent() };
+
+		m_RenderTargets.depth = m_RenderGraph.CreateImage("Depth", {
+			m_SwapChainContext.GetDepthFormat(), extent, VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, deviceContext->GetSampleCount() });
+		m_RenderTargets.colour = m_RenderGraph.CreateImage("Colour", {
+			m_SwapChainContext.GetColorFormat(), extent, VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, deviceContext->GetSampleCount() });
+		m_RenderTargets.gBufferColor = m_RenderGraph.CreateImage("GBuffer colour", {
+			GBuffer::formats[0], extent, VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT });
+		m_RenderTargets.gBufferNormal = m_RenderGraph.CreateImage("GBuffer normal", {
+			GBuffer::formats[1], extent, VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT });
+		m_RenderTargets.gBufferMetalRough = m_RenderGraph.CreateImage("GBuffer metalness roughness", {
+			GBuffer::formats[2], extent, VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT });
+		m_RenderTargets.swapchain = m_RenderGraph.ImportImage("Swapchain");
+
+		auto const depth{ m_RenderTargets.depth };
+		auto const colour{ m_RenderTargets.colour };
+		auto const swapchain{ m_RenderTargets.swapchain };
+		std::array const gBuffer{ m_RenderTargets.gBufferColor, m_RenderTargets.gBufferNormal, m_RenderTargets.gBufferMetalRough };
+
+#pragma region UPLOADS
+		// Ownership acquires & mipmaps of the uploads that completed, has to be before anything uses them
+		m_RenderGraph.AddPass("Uploads", [](VkCommandBuffer commandBuffer)
+			{
+				ME_PROFILE_SCOPE("Uploads")
+				VulkanUploadManager::GetInstance().RecordAcquires(commandBuffer);
+			}, true);
+#pragma endregion
+#pragma region MESH_MOVES
+		m_RenderGraph.AddPass("Mesh moves", [](VkCommandBuffer commandBuffer)
+			{
+				ME_PROFILE_SCOPE("Mesh moves")
+				VulkanMeshManager::GetInstance().RecordGeometryMoves(commandBuffer);
+			}, true);
+#pragma endregion
+#pragma region GPU_CULLING
+		m_RenderGraph.AddPass("GPU culling", [this](VkCommandBuffer commandBuffer)
+			{
+				ME_PROFILE_SCOPE("GPU culling")
+				VulkanMeshManager::GetInstance().Cull(commandBuffer, m_CurrentFrame, ECullPhase::Early);
+			}, true);
+#pragma endregion
+#pragma region DEPTH_PREPASS
 		{
-			ME_PROFILE_SCOPE("Shadow Pass")
-			VulkanLightManager::GetInstance().Draw(commandBuffer, m_GraphicsPipelineContext, m_DescriptorContext, m_SwapChainContext, m_CurrentFrame);
+			auto const pass{ m_RenderGraph.AddPass("Depth prepass", [this](VkCommandBuffer commandBuffer)
+				{
+					ME_PROFILE_SCOPE("Depth Prepass")
+					auto const& depthImage{ m_RenderGraph.GetImage(m_RenderTargets.depth) };
+
+					VkRenderingAttachmentInfo depthAttachment{};
+					depthAttachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
+					depthAttachment.imageView = depthImage.imageViews[0];
+					depthAttachment.imageLayout = depthImage.layout;
+					depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+					depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+					depthAttachment.clearValue = CLEAR_VALUES[DEPTH_CLEAR_ID];
+
+					VkRenderingInfo renderInfoDepthPrepass{};
+					renderInfoDepthPrepass.sType = VK_STRUCTURE_TYPE_RENDERING_INFO;
+					renderInfoDepthPrepass.renderArea = VkRect2D{ VkOffset2D{ 0, 0 }, m_SwapChainContext.GetExtent() };
+					renderInfoDepthPrepass.layerCount = 1;
+					renderInfoDepthPrepass.colorAttachmentCount = 0;
+					renderInfoDepthPrepass.pColorAttachments = nullptr;
+					renderInfoDepthPrepass.pDepthAttachment = &depthAttachment;
+					renderInfoDepthPrepass.pStencilAttachment = nullptr;
+
+					VkViewport viewport{};
+					viewport.x = 0.0f;
+					viewport.y = 0.0f;
+					viewport.width = static_cast<float>(m_SwapChainContext.GetExtent().width);
+					viewport.height = static_cast<float>(m_SwapChainContext.GetExtent().height);
+					viewport.minDepth = 0.0f;
+					viewport.maxDepth = 1.0f;
+
+					VkRect2D scissor{};
+					scissor.offset = { 0, 0 };
+					scissor.extent = m_SwapChainContext.GetExtent();
+
+					vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+					vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+					vkCmdBeginRendering(commandBuffer, &renderInfoDepthPrepass);
+						vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_GraphicsPipelineContext.GetDepthPrePassPipeline());
+						VulkanMeshManager::GetInstance().Draw(commandBuffer, m_GraphicsPipelineContext.GetDepthPrePassPipelineLayout(), 1, &m_DescriptorContext.GetDescriptorSets()[m_CurrentFrame], m_CurrentFrame, VulkanMeshManager::EDrawSet::Visible);
+						//RenderDebug(commandBuffer, true);
+					vkCmdEndRendering(commandBuffer);
+				}) };
+			m_RenderGraph.Write(pass, depth, ERenderGraphAccess::DepthAttachment);
 		}
 #pragma endregion
-#pragma region GBUFFER_PASS
+#pragma region HI_Z
 		{
-			ME_PROFILE_SCOPE("GBuffer pass")
-
-			// GBuffer Colour
-			if (VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL != gBufferColor.layout)
-			{
-				gBufferColor.TransitionImageLayout(commandBuffer,
-					VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
-					VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT,
-					VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT);
-			}
-			// GBuffer Normal
-			if (VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL != gBufferNormal.layout)
-			{
-				gBufferNormal.TransitionImageLayout(commandBuffer,
-					VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
-					VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT,
-					VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT);
-			}
-			// GBuffer Metal
-			if (VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL != gBufferMetalRough.layout)
+			// Also writes the pyramid & the late draw commands
+			auto const hiZPass{ m_RenderGraph.AddPass("Hi-Z & late culling", [this](VkCommandBuffer commandBuffer)
+				{
+					ME_PROFILE_SCOPE("Hi-Z & late culling")
+					m_HiZPass.Build(commandBuffer);
+					VulkanMeshManager::GetInstance().Cull(commandBuffer, m_CurrentFrame, ECullPhase::Late);
+				}, true) };
+			m_RenderGraph.Read(hiZPass, depth, ERenderGraphAccess::SampledCompute);
+
+			// Add the instances that turned out visible to the prepass' depth
+			auto const lateDepthPass{ m_RenderGraph.AddPass("Late depth prepass", [this](VkCommandBuffer commandBuffer)
+				{
+					ME_PROFILE_SCOPE("Late depth prepass")
+					auto const& depthImage{ m_RenderGraph.GetImage(m_RenderTargets.depth) };
+
+					VkRenderingAttachmentInfo depthAttachment{};
+					depthAttachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
+					depthAttachment.imageView = depthImage.imageViews[0];
+					depthAttachment.imageLayout = depthImage.layout;
+					depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+					depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+
+					VkRenderingInfo renderInfoDepthPrepass{};
+					renderInfoDepthPrepass.sType = VK_STRUCTURE_TYPE_RENDERING_INFO;
+					renderInfoDepthPrepass.renderArea = VkRect2D{ VkOffset2D{ 0, 0 }, m_SwapChainContext.GetExtent() };
+					renderInfoDepthPrepass.layerCount = 1;
+					renderInfoDepthPrepass.colorAttachmentCount = 0;
+					renderInfoDepthPrepass.pColorAttachments = nullptr;
+					renderInfoDepthPrepass.pDepthAttachment = &depthAttachment;
+					renderInfoDepthPrepass.pStencilAttachment = nullptr;
+
+					// Viewport & scissor are still set from the prepass
+					vkCmdBeginRendering(commandBuffer, &renderInfoDepthPrepass);
+						vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_GraphicsPipelineContext.GetDepthPrePassPipeline());
+						VulkanMeshManager::GetInstance().Draw(commandBuffer, m_GraphicsPipelineContext.GetDepthPrePassPipelineLayout(), 1, &m_DescriptorContext.GetDescriptorSets()[m_CurrentFrame], m_CurrentFrame, VulkanMeshManager::EDrawSet::Disoccluded);
+					vkCmdEndRendering(commandBuffer);
+				}) };
+			m_RenderGraph.Read(lateDepthPass, depth, ERenderGraphAccess::DepthAttachment);
+			m_RenderGraph.Write(lateDepthPass, depth, ERenderGraphAccess::DepthAttachment);
+
+			// Only when the view is GPU culled, RecordCommandBuffer decides every frame
+			m_LateCullingPasses = { hiZPass, lateDepthPass };
+		}
+#pragma endregion
+#pragma region SHADOW_AND_GBUFFER_PASS
+		{
+			// The shadow maps are owned & transitioned by the light manager, each shadow pass only touches its own
+			auto const pass{ m_RenderGraph.AddPass("Shadow & GBuffer pass", [this](VkCommandBuffer commandBuffer)
+				{
+					ME_PROFILE_SCOPE("Shadow & GBuffer pass")
+
+					// The shadow passes & the GBuffer pass don't depend on each other, so they're recorded in parallel into secondary command buffers
+					// Each one begins its own rendering, the primary only executes them in order
+					uint32_t const shadowPassCount{ VulkanLightManager::GetInstance().GetShadowPassCount() };
+					uint32_t const shadowJobCount{ (shadowPassCount + SHADOW_PASSES_PER_JOB - 1) / SHADOW_PASSES_PER_JOB };
+
+					m_CommandPoolManager.PrepareSecondaryCommandBuffers(m_CurrentFrame, shadowJobCount + 1);
+					m_SecondaryCommandBuffers.assign(shadowJobCount + 1, VK_NULL_HANDLE);
+
+					MauCor::JobCounter gBufferCounter{};
+					JOB_SYSTEM.Schedule([this]()
+						{
+							VkCommandBuffer const secondary{ m_CommandPoolManager.BeginSecondaryCommandBuffer(m_CurrentFrame) };
+							RecordGBufferPass(secondary);
+							vkEndCommandBuffer(secondary);
+							m_SecondaryCommandBuffers.back() = secondary;
+						}, &gBufferCounter);
+
+					// Split per job rather than per pass, a range can hold several jobs when it runs inline without workers
+					JOB_SYSTEM.ParallelFor(shadowJobCount, 1, [this, shadowPassCount](std::size_t firstJob, std::size_t lastJob)
+						{
+							for (std::size_t job{ firstJob }; job < lastJob; ++job)
+							{
+								uint32_t const begin{ static_cast<uint32_t>(job) * SHADOW_PASSES_PER_JOB };
+								uint32_t const end{ std::min(begin + SHADOW_PASSES_PER_JOB, shadowPassCount) };
+
+								VkCommandBuffer const secondary{ m_CommandPoolManager.BeginSecondaryCommandBuffer(m_CurrentFrame) };
+								VulkanLightManager::GetInstance().DrawShadowPasses(secondary, begin, end, m_GraphicsPipelineContext, m_DescriptorContext, m_CurrentFrame);
+								vkEndCommandBuffer(secondary);
+								m_SecondaryCommandBuffers[job] = secondary;
+							}
+						});
+
+					JOB_SYSTEM.Wait(gBufferCounter);
+
+					ME_RENDERER_ASSERT(std::ranges::none_of(m_SecondaryCommandBuffers, [](VkCommandBuffer secondary) { return VK_NULL_HANDLE == secondary; }), "A secondary command buffer was never recorded");
+
+					// Shadow passes first, the same order they had when recorded inline
+					vkCmdExecuteCommands(commandBuffer, static_cast<uint32_t>(std::size(m_SecondaryCommandBuffers)), m_SecondaryCommandBuffers.data());
+				}, true) };
+
+			for (auto const image : gBuffer)
 			{
-				gBufferMetalRough.TransitionImageLayout(commandBuffer,
-					VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
-					VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT,
-					VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT);
+				m_RenderGraph.Write(pass, image, ERenderGraphAccess::ColorAttachment);
 			}
-
-			VkViewport viewport{};
-			viewport.x = 0.0f;
-			viewport.y = 0.0f;
-			viewport.width = static_cast<float>(m_SwapChainContext.GetExtent().width);
-			viewport.height = static_cast<float>(m_SwapChainContext.GetExtent().height);
-			viewport.minDepth = 0.0f;
-			viewport.maxDepth = 1.0f;
-
-			VkRect2D scissor{};
-			scissor.offset = { 0, 0 };
-			scissor.extent = m_SwapChainContext.GetExtent();
-
-			vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
-			vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
-
-			VkRenderingAttachmentInfo colorAttachment = {};
-			colorAttachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
-			colorAttachment.imageView = gBufferColor.imageViews[0];
-			colorAttachment.imageLayout = gBufferColor.layout;
-			colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
-			colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
-			colorAttachment.clearValue = CLEAR_VALUES[COLOR_CLEAR_ID];
-
-			VkRenderingAttachmentInfo colorAttachment02 = {};
-			colorAttachment02.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
-			colorAttachment02.imageView = gBufferNormal.imageViews[0];
-			colorAttachment02.imageLayout = gBufferNormal.layout;
-			colorAttachment02.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
-			colorAttachment02.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
-			colorAttachment02.clearValue = CLEAR_VALUES[COLOR_CLEAR_ID];
-
-			VkRenderingAttachmentInfo colorAttachment03 = {};
-			colorAttachment03.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
-			colorAttachment03.imageView = gBufferMetalRough.imageViews[0];
-			colorAttachment03.imageLayout = gBufferMetalRough.layout;
-			colorAttachment03.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
-			colorAttachment03.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
-			colorAttachment03.clearValue = CLEAR_VALUES[COLOR_CLEAR_ID];
-
-			std::array<VkRenderingAttachmentInfo, 3> ColourAtt{ colorAttachment , colorAttachment02,colorAttachment03 };
-
-			VkRenderingAttachmentInfo depthAttachment{};
-			depthAttachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
-			depthAttachment.imageView = depth.imageViews[0];
-			depthAttachment.imageLayout = depth.layout;
-			depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
-			depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
-			depthAttachment.clearValue = CLEAR_VALUES[DEPTH_CLEAR_ID];
-
-			VkRenderingInfo renderInfoGBuffer{};
-			renderInfoGBuffer.sType = VK_STRUCTURE_TYPE_RENDERING_INFO;
-			renderInfoGBuffer.renderArea = VkRect2D{ VkOffset2D{ 0, 0 }, m_SwapChainContext.GetExtent() };
-			renderInfoGBuffer.layerCount = 1;
-			renderInfoGBuffer.colorAttachmentCount = static_cast<uint32_t>(std::size(ColourAtt));
-			renderInfoGBuffer.pColorAttachments = ColourAtt.data();
-			renderInfoGBuffer.pDepthAttachment = &depthAttachment;
-			renderInfoGBuffer.pStencilAttachment = nullptr;
-
-			vkCmdBeginRendering(commandBuffer, &renderInfoGBuffer);
-				vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_GraphicsPipelineContext.GetGBufferPipeline());
-				VulkanMeshManager::GetInstance().Draw(commandBuffer, m_GraphicsPipelineContext.GetGBufferPipelineLayout(), 1, &m_DescriptorContext.GetDescriptorSets()[m_CurrentFrame], m_CurrentFrame);
-			vkCmdEndRendering(commandBuffer);
+			m_RenderGraph.Read(pass, depth, ERenderGraphAccess::DepthAttachment);
+			m_RenderGraph.Write(pass, depth, ERenderGraphAccess::DepthAttachment);
 		}
 #pragma endregion
 #pragma region LIGHTING_PASS
 		{
-			ME_PROFILE_SCOPE("lighting pass")
-			if (VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL != colour.layout)
-			{
-				colour.TransitionImageLayout(commandBuffer,
-					VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
-					VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT,
-					VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT);
-			}
-			if (VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL != gBufferColor.layout)
-			{
-				gBufferColor.TransitionImageLayout(commandBuffer,
-					VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
-					VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT,
-					VK_ACCESS_2_SHADER_READ_BIT);
-			}
-			if (VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL != gBufferNormal.layout)
-			{
-				gBufferNormal.TransitionImageLayout(commandBuffer,
-					VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
-					VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT,
-					VK_ACCESS_2_SHADER_READ_BIT);
-			}
-			if (VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL != gBufferMetalRough.layout)
-			{
-				gBufferMetalRough.TransitionImageLayout(commandBuffer,
-					VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
-					VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT,
-					VK_ACCESS_2_SHADER_READ_BIT);
-			}
-			if (VK_IMAGE_LAYOUT_DEPTH_READ_ONLY_OPTIMAL != depth.layout)
+			auto const pass{ m_RenderGraph.AddPass("Lighting pass", [this](VkCommandBuffer commandBuffer)
+				{
+					ME_PROFILE_SCOPE("lighting pass")
+					auto const& colourImage{ m_RenderGraph.GetImage(m_RenderTargets.colour) };
+
+					VkRenderingAttachmentInfo colorAttachment{};
+					colorAttachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
+					colorAttachment.imageView = colourImage.imageViews[0];
+					colorAttachment.imageLayout = colourImage.layout;
+					colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+					colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+					colorAttachment.clearValue = CLEAR_VALUES[COLOR_CLEAR_ID];
+
+					VkRenderingInfo renderInfo{};
+					renderInfo.sType = VK_STRUCTURE_TYPE_RENDERING_INFO;
+					renderInfo.renderArea = VkRect2D{ VkOffset2D{ 0, 0 }, m_SwapChainContext.GetExtent() };
+					renderInfo.layerCount = 1;
+					renderInfo.colorAttachmentCount = 1;
+					renderInfo.pColorAttachments = &colorAttachment;
+					renderInfo.pDepthAttachment = nullptr;
+					renderInfo.pStencilAttachment = nullptr;
+
+					VkViewport viewport{};
+					viewport.x = 0.0f;
+					viewport.y = 0.0f;
+					viewport.width = static_cast<float>(m_SwapChainContext.GetExtent().width);
+					viewport.height = static_cast<float>(m_SwapChainContext.GetExtent().height);
+					viewport.minDepth = 0.0f;
+					viewport.maxDepth = 1.0f;
+
+					VkRect2D scissor{};
+					scissor.offset = { 0, 0 };
+					scissor.extent = m_SwapChainContext.GetExtent();
+
+					// Dynamic state is undefined after the secondary command buffers
+					vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+					vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+
+					vkCmdBeginRendering(commandBuffer, &renderInfo);
+						VkDeviceSize constexpr offset{ 0 };
+						vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_GraphicsPipelineContext.GetLightingPipeline());
+
+						vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_GraphicsPipelineContext.GetLightingPipelineLayout(), 0, 1,&m_DescriptorContext.GetDescriptorSets()[m_CurrentFrame], 0, nullptr);
+						vkCmdBindVertexBuffers(commandBuffer, 0, 1, &m_QuadVertexBuffer.buffer, &offset);
+						vkCmdDraw(commandBuffer, 6, 1, 0, 0);
+					vkCmdEndRendering(commandBuffer);
+				}) };
+
+			for (auto const image : gBuffer)
 			{
-				depth.TransitionImageLayout(commandBuffer,
-					VK_IMAGE_LAYOUT_DEPTH_READ_ONLY_OPTIMAL,
-					VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT,
-					VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT);
+				m_RenderGraph.Read(pass, image, ERenderGraphAccess::SampledFragment);
 			}
-
-			VkRenderingAttachmentInfo colorAttachment{};
-			colorAttachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
-			colorAttachment.imageView = colour.imageViews[0];
-			colorAttachment.imageLayout = colour.layout;
-			colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
-			colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
-			colorAttachment.clearValue = CLEAR_VALUES[COLOR_CLEAR_ID];
-
-			VkRenderingInfo renderInfo{};
-			renderInfo.sType = VK_STRUCTURE_TYPE_RENDERING_INFO;
-			renderInfo.renderArea = VkRect2D{ VkOffset2D{ 0, 0 }, m_SwapChainContext.GetExtent() };
-			renderInfo.layerCount = 1;
-			renderInfo.colorAttachmentCount = 1;
-			renderInfo.pColorAttachments = &colorAttachment;
-			renderInfo.pDepthAttachment = nullptr;
-			renderInfo.pStencilAttachment = nullptr;
-
-			VkViewport viewport{};
-			viewport.x = 0.0f;
-			viewport.y = 0.0f;
-			viewport.width = static_cast<float>(m_SwapChainContext.GetExtent().width);
-			viewport.height = static_cast<float>(m_SwapChainContext.GetExtent().height);
-			viewport.minDepth = 0.0f;
-			viewport.maxDepth = 1.0f;
-
-			VkRect2D scissor{};
-			scissor.offset = { 0, 0 };
-			scissor.extent = m_SwapChainContext.GetExtent();
-
-			vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
-			vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
-
-			vkCmdBeginRendering(commandBuffer, &renderInfo);
-				VkDeviceSize constexpr offset{ 0 };
-				vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_GraphicsPipelineContext.GetLightingPipeline());
-
-				vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_GraphicsPipelineContext.GetLightingPipelineLayout(), 0, 1,&m_DescriptorContext.GetDescriptorSets()[m_CurrentFrame], 0, nullptr);
-				vkCmdBindVertexBuffers(commandBuffer, 0, 1, &m_QuadVertexBuffer.buffer, &offset);
-				vkCmdDraw(commandBuffer, 6, 1, 0, 0);
-			vkCmdEndRendering(commandBuffer);
-}
+			m_RenderGraph.Read(pass, depth, ERenderGraphAccess::SampledFragment);
+			m_RenderGraph.Write(pass, colour, ERenderGraphAccess::ColorAttachment);
+		}
 #pragma endregion
 #pragma region TONEMAP
 		{
-			//  Colour
-			if (VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL != colour.layout)
-			{
-				colour.TransitionImageLayout(commandBuffer,
-					VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
-					VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT,
-					VK_ACCESS_2_SHADER_READ_BIT);
-			}
-
-			// Swapchain Colour
-			auto& swapColor{ m_SwapChainContext.GetSwapchainImages()[imageIndex] };
-			if (VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL != swapColor.layout)
-			{
-				swapColor.TransitionImageLayout(commandBuffer,
-					VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
-					VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT,
-					VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT);
-			}
-
-			ME_PROFILE_SCOPE("Tone Map pass")
-
-
-			VkRenderingAttachmentInfo colorAttachment{};
-			colorAttachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
-			colorAttachment.imageView = swapColor.imageViews[0];
-			colorAttachment.imageLayout = swapColor.layout;
-			colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
-			colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
-			colorAttachment.clearValue = CLEAR_VALUES[COLOR_CLEAR_ID];
-
-			VkRenderingInfo renderInfo{};
-			renderInfo.sType = VK_STRUCTURE_TYPE_RENDERING_INFO;
-			renderInfo.renderArea = VkRect2D{ VkOffset2D{ 0, 0 }, m_SwapChainContext.GetExtent() };
-			renderInfo.layerCount = 1;
-			renderInfo.colorAttachmentCount = 1;
-			renderInfo.pColorAttachments = &colorAttachment;
-			renderInfo.pDepthAttachment = nullptr;
-			renderInfo.pStencilAttachment = nullptr;
-
-			vkCmdBeginRendering(commandBuffer, &renderInfo);
-				VkDeviceSize constexpr offset{ 0 };
-				vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_GraphicsPipelineContext.GetToneMapPipeline());
-				vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_GraphicsPipelineContext.GetToneMapPipelineLayout(), 0, 1, &m_DescriptorContext.GetDescriptorSets()[m_CurrentFrame], 0, nullptr);
-				vkCmdBindVertexBuffers(commandBuffer, 0, 1, &m_QuadVertexBuffer.buffer, &offset);
-				vkCmdDraw(commandBuffer, 6, 1, 0, 0);
-			vkCmdEndRendering(commandBuffer);
+			auto const pass{ m_RenderGraph.AddPass("Tone map pass", [this](VkCommandBuffer commandBuffer)
+				{
+					ME_PROFILE_SCOPE("Tone Map pass")
+					auto const& swapColor{ m_RenderGraph.GetImage(m_RenderTargets.swapchain) };
+
+					VkRenderingAttachmentInfo colorAttachment{};
+					colorAttachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
+					colorAttachment.imageView = swapColor.imageViews[0];
+					colorAttachment.imageLayout = swapColor.layout;
+					colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+					colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+					colorAttachment.clearValue = CLEAR_VALUES[COLOR_CLEAR_ID];
+
+					VkRenderingInfo renderInfo{};
+					renderInfo.sType = VK_STRUCTURE_TYPE_RENDERING_INFO;
+					renderInfo.renderArea = VkRect2D{ VkOffset2D{ 0, 0 }, m_SwapChainContext.GetExtent() };
+					renderInfo.layerCount = 1;
+					renderInfo.colorAttachmentCount = 1;
+					renderInfo.pColorAttachments = &colorAttachment;
+					renderInfo.pDepthAttachment = nullptr;
+					renderInfo.pStencilAttachment = nullptr;
+
+					vkCmdBeginRendering(commandBuffer, &renderInfo);
+						VkDeviceSize constexpr offset{ 0 };
+						vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_GraphicsPipelineContext.GetToneMapPipeline());
+						vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_GraphicsPipelineContext.GetToneMapPipelineLayout(), 0, 1, &m_DescriptorContext.GetDescriptorSets()[m_CurrentFrame], 0, nullptr);
+						vkCmdBindVertexBuffers(commandBuffer, 0, 1, &m_QuadVertexBuffer.buffer, &offset);
+						vkCmdDraw(commandBuffer, 6, 1, 0, 0);
+					vkCmdEndRendering(commandBuffer);
+				}) };
+			m_RenderGraph.Read(pass, colour, ERenderGraphAccess::SampledFragment);
+			m_RenderGraph.Write(pass, swapchain, ERenderGraphAccess::ColorAttachment);
 		}
 #pragma endregion
 #pragma region DEBUG_RENDER_PASS
 		{
-			ME_PROFILE_SCOPE("Debug render pass")
-			auto& swapColor{ m_SwapChainContext.GetSwapchainImages()[imageIndex] };
-
-			// Depth
-			if (VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL != depth.layout)
-			{
-				depth.TransitionImageLayout(commandBuffer,
-					VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL,
-					VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT,
-					VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT);
-			}
-
-			VkRenderingAttachmentInfo colorAttachment{};
-			colorAttachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
-			colorAttachment.imageView = swapColor.imageViews[0];
-			colorAttachment.imageLayout = swapColor.layout;
-			colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
-			colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
-			colorAttachment.clearValue = CLEAR_VALUES[COLOR_CLEAR_ID];
-
-			VkRenderingAttachmentInfo depthAttachment{};
-			depthAttachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
-			depthAttachment.imageView = depth.imageViews[0];
-			depthAttachment.imageLayout = depth.layout;
-			depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
-			depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
-			depthAttachment.clearValue = CLEAR_VALUES[DEPTH_CLEAR_ID];
-
-			VkRenderingInfo renderInfo{};
-			renderInfo.sType = VK_STRUCTURE_TYPE_RENDERING_INFO;
-			renderInfo.renderArea = VkRect2D{ VkOffset2D{ 0, 0 }, m_SwapChainContext.GetExtent() };
-			renderInfo.layerCount = 1;
-			renderInfo.colorAttachmentCount = 1;
-			renderInfo.pColorAttachments = &colorAttachment;
-			renderInfo.pDepthAttachment = &depthAttachment;
-			renderInfo.pStencilAttachment = nullptr;
-			vkCmdBeginRendering(commandBuffer, &renderInfo);
-			RenderDebug(commandBuffer, false);
-			vkCmdEndRendering(commandBuffer);
+			auto const pass{ m_RenderGraph.AddPass("Debug render pass", [this](VkCommandBuffer commandBuffer)
+				{
+					ME_PROFILE_SCOPE("Debug render pass")
+					auto const& swapColor{ m_RenderGraph.GetImage(m_RenderTargets.swapchain) };
+					auto const& depthImage{ m_RenderGraph.GetImage(m_RenderTargets.depth) };
+
+					VkRenderingAttachmentInfo colorAttachment{};
+					colorAttachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
+					colorAttachment.imageView = swapColor.imageViews[0];
+					colorAttachment.imageLayout = swapColor.layout;
+					colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+					colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+					colorAttachment.clearValue = CLEAR_VALUES[COLOR_CLEAR_ID];
+
+					VkRenderingAttachmentInfo depthAttachment{};
+					depthAttachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
+					depthAttachment.imageView = depthImage.imageViews[0];
+					depthAttachment.imageLayout = depthImage.layout;
+					depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+					depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+					depthAttachment.clearValue = CLEAR_VALUES[DEPTH_CLEAR_ID];
+
+					VkRenderingInfo renderInfo{};
+					renderInfo.sType = VK_STRUCTURE_TYPE_RENDERING_INFO;
+					renderInfo.renderArea = VkRect2D{ VkOffset2D{ 0, 0 }, m_SwapChainContext.GetExtent() };
+					renderInfo.layerCount = 1;
+					renderInfo.colorAttachmentCount = 1;
+					renderInfo.pColorAttachments = &colorAttachment;
+					renderInfo.pDepthAttachment = &depthAttachment;
+					renderInfo.pStencilAttachment = nullptr;
+					vkCmdBeginRendering(commandBuffer, &renderInfo);
+					RenderDebug(commandBuffer, false);
+					vkCmdEndRendering(commandBuffer);
+				}) };
+			m_RenderGraph.Read(pass, swapchain, ERenderGraphAccess::ColorAttachment);
+			m_RenderGraph.Write(pass, swapchain, ERenderGraphAccess::ColorAttachment);
+			m_RenderGraph.Read(pass, depth, ERenderGraphAccess::DepthAttachment);
+			m_RenderGraph.Write(pass, depth, ERenderGraphAccess::DepthAttachment);
 		}
 #pragma endregion
 #pragma region ImGUI_PASS
 		if constexpr (USE_IMGUI)
 		{
-			ME_PROFILE_SCOPE("ImGUI Pass")
-			auto& swapColor{ m_SwapChainContext.GetSwapchainImages()[imageIndex] };
-
-			if (swapColor.layout != VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL)
-			{
-				swapColor.TransitionImageLayout(commandBuffer,
-					VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
-					VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT,
-					VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT);
-			}
-
-			VkRenderingAttachmentInfo colorAttachment{};
-			colorAttachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
-			colorAttachment.imageView = swapColor.imageViews[0];
-			colorAttachment.imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
-			colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
-			colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
-
-			VkRenderingInfo renderInfo{};
-			renderInfo.sType = VK_STRUCTURE_TYPE_RENDERING_INFO;
-			renderInfo.renderArea = VkRect2D{ {0, 0}, m_SwapChainContext.GetExtent() };
-			renderInfo.layerCount = 1;
-			renderInfo.colorAttachmentCount = 1;
-			renderInfo.pColorAttachments = &colorAttachment;
-			renderInfo.pDepthAttachment = nullptr;
-			renderInfo.pStencilAttachment = nullptr;
-
-			vkCmdBeginRendering(commandBuffer, &renderInfo);
-				ImGui::Render();
-				ImGui_ImplVulkan_RenderDrawData(ImGui::GetDrawData(), commandBuffer);
-			vkCmdEndRendering(commandBuffer);
+			auto const pass{ m_RenderGraph.AddPass("ImGUI pass", [this](VkCommandBuffer commandBuffer)
+				{
+					ME_PROFILE_SCOPE("ImGUI Pass")
+					auto const& swapColor{ m_RenderGraph.GetImage(m_RenderTargets.swapchain) };
+
+					VkRenderingAttachmentInfo colorAttachment{};
+					colorAttachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
+					colorAttachment.imageView = swapColor.imageViews[0];
+					colorAttachment.imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+					colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+					colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+
+					VkRenderingInfo renderInfo{};
+					renderInfo.sType = VK_STRUCTURE_TYPE_RENDERING_INFO;
+					renderInfo.renderArea = VkRect2D{ {0, 0}, m_SwapChainContext.GetExtent() };
+					renderInfo.layerCount = 1;
+					renderInfo.colorAttachmentCount = 1;
+					renderInfo.pColorAttachments = &colorAttachment;
+					renderInfo.pDepthAttachment = nullptr;
+					renderInfo.pStencilAttachment = nullptr;
+
+					vkCmdBeginRendering(commandBuffer, &renderInfo);
+						ImGui::Render();
+						ImGui_ImplVulkan_RenderDrawData(ImGui::GetDrawData(), commandBuffer);
+					vkCmdEndRendering(commandBuffer);
+				}) };
+			m_RenderGraph.Read(pass, swapchain, ERenderGraphAccess::ColorAttachment);
+			m_RenderGraph.Write(pass, swapchain, ERenderGraphAccess::ColorAttachment);
 		}
 #pragma endregion
-#pragma region POST_DRAW
+#pragma region PRESENT
 		{
-			ME_PROFILE_SCOPE("Post draw")
+			// Only the transition
+			auto const pass{ m_RenderGraph.AddPass("Present", {}, true) };
+			m_RenderGraph.Read(pass, swapchain, ERenderGraphAccess::Present);
+		}
+#pragma endregion
 
-			VulkanMeshManager::GetInstance().PostDraw(commandBuffer, m_GraphicsPipelineContext.GetForwardPipelineLayout(), 1, &m_DescriptorContext.GetDescriptorSets()[m_CurrentFrame], m_CurrentFrame);
-			VulkanLightManager::GetInstance().PostDraw();
+		m_RenderGraph.Compile();
+		WriteRenderTargetDescriptors();
+	}
 
-			m_SwapChainContext.GetSwapchainImages()[imageIndex].TransitionImageLayout(
-				commandBuffer,
-				VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
-				VK_PIPELINE_STAGE_2_BOTTOM_OF_PIPE_BIT,
-				VK_ACCESS_2_NONE);
+	void VulkanRenderer::WriteRenderTargetDescriptors()
+	{
+		auto const deviceContext{ VulkanDeviceContextManager::GetInstance().GetDeviceContext() };
 
-			if (VK_SUCCESS != vkEndCommandBuffer(commandBuffer))
-			{
-				throw std::runtime_error("Failed to record command buffer!");
-			}
+		// Target & binding
+		std::array const targets
+		{
+			std::pair{ m_RenderTargets.gBufferColor, 6u },
+			std::pair{ m_RenderTargets.gBufferNormal, 7u },
+			std::pair{ m_RenderTargets.gBufferMetalRough, 8u },
+			std::pair{ m_RenderTargets.depth, 9u },
+			std::pair{ m_RenderTargets.colour, 10u }
+		};
 
-			// TODO maybe move to ImGUI layer 
-			if constexpr (USE_IMGUI)
+		std::array<VkDescriptorImageInfo, std::size(targets)> imageInfos{};
+		for (uint32_t i{ 0 }; i < std::size(targets); ++i)
+		{
+			imageInfos[i].imageView = m_RenderGraph.GetImage(targets[i].first).imageViews[0];
+			// The layout the render graph gives the target when it's sampled
+			imageInfos[i].imageLayout = targets[i].first == m_RenderTargets.depth ? VK_IMAGE_LAYOUT_DEPTH_READ_ONLY_OPTIMAL : VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+		}
+
+		// The targets are shared by the frames in flight
+		std::vector<VkWriteDescriptorSet> descriptorWrites{};
+		for (uint32_t frame{ 0 }; frame < MAX_FRAMES_IN_FLIGHT; ++frame)
+		{
+			for (uint32_t i{ 0 }; i < std::size(targets); ++i)
 			{
-				if (ImGui::GetIO().ConfigFlags & ImGuiConfigFlags_ViewportsEnable)
-				{
-					ImGui::UpdatePlatformWindows();
-					ImGui::RenderPlatformWindowsDefault();
-				}
+				VkWriteDescriptorSet descriptorWrite{};
+				descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+				descriptorWrite.dstSet = m_DescriptorContext.GetDescriptorSets()[frame];
+				descriptorWrite.dstBinding = targets[i].second;
+				descriptorWrite.dstArrayElement = 0;
+				descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+				descriptorWrite.descriptorCount = 1;
+				descriptorWrite.pImageInfo = &imageInfos[i];
+				descriptorWrites.emplace_back(descriptorWrite);
 			}
 		}
-#pragma endregion
+
+		vkUpdateDescriptorSets(deviceContext->GetLogicalDevice(), static_cast<uint32_t>(std::size(descriptorWrites)), descriptorWrites.data(), 0, nullptr);
 	}
 
 	void VulkanRenderer::CreateSyncObjects()
@@ -817,6 +919,9 @@ namespace MauRen
 
 		auto const deviceContext{ VulkanDeviceContextManager::GetInstance().GetDeviceContext() };
 
+		// Runs the callbacks of the completed uploads first, they bind textures & make meshes drawable
+		VulkanUploadManager::GetInstance().BeginFrame();
+
 		UpdateUniformBuffer(cam->GetViewMatrix(), cam->GetProjectionMatrix());
 		UpdateCamSettings(cam);
 		UpdateDebugVertexBuffer();
@@ -833,6 +938,12 @@ namespace MauRen
 	{
 		auto const deviceContext{ VulkanDeviceContextManager::GetInstance().GetDeviceContext() };
 
+		if constexpr (ENABLE_SHADER_HOT_RELOAD)
+		{
+			// Nothing is being recorded in between frames
+			m_ShaderHotReloader.ApplyReloadedPipelines(m_GraphicsPipelineContext);
+		}
+
 		{
 			ME_PROFILE_SCOPE("Wait for GPU")
 			// At the start of the frame, we want to wait until the previous frame has finished, so that the command buffer and semaphores are available to use.
@@ -873,24 +984,50 @@ namespace MauRen
 
 		RecordCommandBuffer(m_CommandPoolManager.GetCommandBuffer(m_CurrentFrame), imageIndex, cam->GetProjectionMatrix() * cam->GetViewMatrix());
 
-		VkSubmitInfo submitInfo{};
-		submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+		// Everything queued for upload this frame goes out as one batch
+		auto& uploadManager{ VulkanUploadManager::GetInstance() };
+		uploadManager.Submit();
+
+		std::array<VkSemaphoreSubmitInfo, 2> const waitSemaphores
+		{
+			VkSemaphoreSubmitInfo{
+				.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO,
+				.semaphore = m_ImageAvailableSemaphores[m_CurrentFrame],
+				.stageMask = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT
+			},
+			// The transfer writes of the batches acquired in this command buffer
+			VkSemaphoreSubmitInfo{
+				.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO,
+				.semaphore = uploadManager.GetTimelineSemaphore(),
+				.value = uploadManager.GetAcquiredValue(),
+				.stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT
+			}
+		};
 
-		VkSemaphore const waitSemaphores[] { m_ImageAvailableSemaphores[m_CurrentFrame] };
-		VkPipelineStageFlags constexpr waitStages[] { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT };
-		submitInfo.waitSemaphoreCount = 1;
-		submitInfo.pWaitSemaphores = waitSemaphores;
-		submitInfo.pWaitDstStageMask = waitStages;
+		VkCommandBufferSubmitInfo const commandBufferInfo{
+			.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO,
+			.commandBuffer = m_CommandPoolManager.GetCommandBuffer(m_CurrentFrame)
+		};
 
-		submitInfo.commandBufferCount = 1;
-		submitInfo.pCommandBuffers = &m_CommandPoolManager.GetCommandBuffer(m_CurrentFrame);
+		VkSemaphoreSubmitInfo const signalSemaphore{
+			.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO,
+			.semaphore = m_RenderFinishedSemaphores[m_CurrentFrame],
+			.stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT
+		};
+
+		VkSubmitInfo2 const submitInfo{
+			.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO_2,
+			.waitSemaphoreInfoCount = uploadManager.GetAcquiredValue() > 0 ? 2u : 1u,
+			.pWaitSemaphoreInfos = waitSemaphores.data(),
+			.commandBufferInfoCount = 1,
+			.pCommandBufferInfos = &commandBufferInfo,
+			.signalSemaphoreInfoCount = 1,
+			.pSignalSemaphoreInfos = &signalSemaphore
+		};
 
 		VkSemaphore const signalSemaphores[] { m_RenderFinishedSemaphores[m_CurrentFrame] };
-		submitInfo.signalSemaphoreCount = 1;
-		submitInfo.pSignalSemaphores = signalSemaphores;
-		//vkQueueSubmit2();
 		// m_InFlightFences here effectively means, this submit must be finished before our next render may start
-		if (VK_SUCCESS != vkQueueSubmit(deviceContext->GetGraphicsQueue(), 1, &submitInfo, m_InFlightFences[m_CurrentFrame]))
+		if (VK_SUCCESS != vkQueueSubmit2(deviceContext->GetGraphicsQueue(), 1, &submitInfo, m_InFlightFences[m_CurrentFrame]))
 		{
 			throw std::runtime_error("Failed to submit draw command buffer!");
 		}
@@ -929,6 +1066,81 @@ namespace MauRen
 		m_CurrentFrame = (m_CurrentFrame + 1) % MAX_FRAMES_IN_FLIGHT;
 	}
 
+	void VulkanRenderer::RecordGBufferPass(VkCommandBuffer commandBuffer)
+	{
+		ME_PROFILE_FUNCTION()
+
+		auto const& depth{ m_RenderGraph.GetImage(m_RenderTargets.depth) };
+		auto const& gBufferColor{ m_RenderGraph.GetImage(m_RenderTargets.gBufferColor) };
+		auto const& gBufferNormal{ m_RenderGraph.GetImage(m_RenderTargets.gBufferNormal) };
+		auto const& gBufferMetalRough{ m_RenderGraph.GetImage(m_RenderTargets.gBufferMetalRough) };
+
+		// Dynamic state isn't inherited by secondary command buffers
+		VkViewport viewport{};
+		viewport.x = 0.0f;
+		viewport.y = 0.0f;
+		viewport.width = static_cast<float>(m_SwapChainContext.GetExtent().width);
+		viewport.height = static_cast<float>(m_SwapChainContext.GetExtent().height);
+		viewport.minDepth = 0.0f;
+		viewport.maxDepth = 1.0f;
+
+		VkRect2D scissor{};
+		scissor.offset = { 0, 0 };
+		scissor.extent = m_SwapChainContext.GetExtent();
+
+		vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+		vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+
+		VkRenderingAttachmentInfo colorAttachment = {};
+		colorAttachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
+		colorAttachment.imageView = gBufferColor.imageViews[0];
+		colorAttachment.imageLayout = gBufferColor.layout;
+		colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+		colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+		colorAttachment.clearValue = CLEAR_VALUES[COLOR_CLEAR_ID];
+
+		VkRenderingAttachmentInfo colorAttachment02 = {};
+		colorAttachment02.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
+		colorAttachment02.imageView = gBufferNormal.imageViews[0];
+		colorAttachment02.imageLayout = gBufferNormal.layout;
+		colorAttachment02.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+		colorAttachment02.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+		colorAttachment02.clearValue = CLEAR_VALUES[COLOR_CLEAR_ID];
+
+		VkRenderingAttachmentInfo colorAttachment03 = {};
+		colorAttachment03.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
+		colorAttachment03.imageView = gBufferMetalRough.imageViews[0];
+		colorAttachment03.imageLayout = gBufferMetalRough.layout;
+		colorAttachment03.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+		colorAttachment03.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+		colorAttachment03.clearValue = CLEAR_VALUES[COLOR_CLEAR_ID];
+
+		std::array<VkRenderingAttachmentInfo, 3> ColourAtt{ colorAttachment , colorAttachment02,colorAttachment03 };
+
+		VkRenderingAttachmentInfo depthAttachment{};
+		depthAttachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
+		depthAttachment.imageView = depth.imageViews[0];
+		depthAttachment.imageLayout = depth.layout;
+		depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+		depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+		depthAttachment.clearValue = CLEAR_VALUES[DEPTH_CLEAR_ID];
+
+		VkRenderingInfo renderInfoGBuffer{};
+		renderInfoGBuffer.sType = VK_STRUCTURE_TYPE_RENDERING_INFO;
+		renderInfoGBuffer.renderArea = VkRect2D{ VkOffset2D{ 0, 0 }, m_SwapChainContext.GetExtent() };
+		renderInfoGBuffer.layerCount = 1;
+		renderInfoGBuffer.colorAttachmentCount = static_cast<uint32_t>(std::size(ColourAtt));
+		renderInfoGBuffer.pColorAttachments = ColourAtt.data();
+		renderInfoGBuffer.pDepthAttachment = &depthAttachment;
+		renderInfoGBuffer.pStencilAttachment = nullptr;
+
+		vkCmdBeginRendering(commandBuffer, &renderInfoGBuffer);
+			vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_GraphicsPipelineContext.GetGBufferPipeline());
+			VulkanMeshManager::GetInstance().Draw(commandBuffer, m_GraphicsPipelineContext.GetGBufferPipelineLayout(), 1, &m_DescriptorContext.GetDescriptorSets()[m_CurrentFrame], m_CurrentFrame, VulkanMeshManager::EDrawSet::Visible);
+			VulkanMeshManager::GetInstance().Draw(commandBuffer, m_GraphicsPipelineContext.GetGBufferPipelineLayout(), 1, &m_DescriptorContext.GetDescriptorSets()[m_CurrentFrame], m_CurrentFrame, VulkanMeshManager::EDrawSet::Disoccluded);
+		vkCmdEndRendering(commandBuffer);
+	}
+
 	void VulkanRenderer::UpdateUniformBuffer(glm::mat4 const& view, glm::mat4 const& proj)
 	{
 		ME_PROFILE_FUNCTION()
@@ -994,11 +1206,35 @@ namespace MauRen
 
 		m_FramebufferResized = false;
 
-		m_SwapChainContext.ReCreate(m_pWindow, &m_GraphicsPipelineContext, &m_SurfaceContext, m_CommandPoolManager, m_DescriptorContext);
+		// Reloaded pipelines are created from the swapchain context
+		auto const rebuildLock{ m_ShaderHotReloader.PauseRebuilds() };
+
+		// The render targets, the pyramid & the culling's descriptors may still be in use
+		vkDeviceWaitIdle(deviceContext->GetLogicalDevice());
+
+		m_SwapChainContext.ReCreate(m_pWindow, &m_GraphicsPipelineContext, &m_SurfaceContext);
+		BuildRenderGraph();
+
+		if (VulkanMeshManager::GetInstance().UsesGPUCulling())
+		{
+			m_HiZPass.Destroy();
+			CreateDepthPyramid();
+		}
 
 		return true;
 	}
 
+	void VulkanRenderer::CreateDepthPyramid()
+	{
+		if (!VulkanMeshManager::GetInstance().UsesGPUCulling())
+		{
+			return;
+		}
+
+		m_HiZPass.Initialize(m_CommandPoolManager, m_RenderGraph.GetImage(m_RenderTargets.depth));
+		VulkanMeshManager::GetInstance().SetDepthPyramid(m_HiZPass.GetPyramidView(), m_HiZPass.GetSampler(), m_HiZPass.GetExtent(), m_HiZPass.GetMipLevels());
+	}
+
 	void VulkanRenderer::UpdateDebugVertexBuffer()
 	{
 		ME_PROFILE_FUNCTION()
@@ -13,11 +13,14 @@
 #include "VulkanSwapchainContext.h"
 #include "VulkanGraphicsPipelineContext.h"
 #include "VulkanCommandPoolManager.h"
+#include "VulkanRenderGraph.h"
+#include "VulkanShaderHotReloader.h"
 
 #include "VulkanBuffer.h"
 #include "../../../MauEng/Public/Components/CLight.h"
 
 #include "Assets/VulkanImage.h"
+#include "Passes/HiZPass.h"
 
 #include "DebugRenderer/DebugVertex.h"
 
@@ -58,11 +61,16 @@ namespace MauRen
 		virtual uint32_t CreateLight() override;
 
 		virtual void SetSceneAABBOverride(glm::vec3 const& min, glm::vec3 const& max) override;
-		virtual void PreLightQueue(glm::mat4 const& viewProj) override;
+		virtual void PreLightQueue(glm::mat4 const& viewProj, MauCor::AABB const& sceneBounds) override;
 		virtual void QueueLight(MauEng::CLight const& light) override;
 		virtual void QueueDraw(glm::mat4 const& transformMat, MauEng::CStaticMesh const& mesh) override;
-		virtual void UnloadMesh(uint32_t meshID) override;
-		virtual [[nodiscard]] uint32_t LoadOrGetMeshID(char const* path) override;
+		virtual [[nodiscard]] uint32_t CreateMeshInstance(glm::mat4 const& transformMat, uint32_t meshID) override;
+		virtual void UpdateMeshInstance(uint32_t instanceID, glm::mat4 const& transformMat) override;
+		virtual void DestroyMeshInstance(uint32_t instanceID) override;
+		virtual void UnloadMesh(uint32_t meshID, uint32_t useCount) override;
+		virtual [[nodiscard]] uint32_t LoadOrGetMeshID(char const* path, uint32_t useCount) override;
+		virtual [[nodiscard]] std::string GetMeshPath(uint32_t meshID) const override;
+		virtual [[nodiscard]] MauCor::AABB GetMeshBounds(uint32_t meshID) const override;
 
 		virtual [[nodiscard]] std::pair<std::unordered_map<std::string, struct LoadedMeshes_PathInfo> const&, std::vector<struct MeshData>const&> GetRendererMeshInfo() override;
 		virtual [[nodiscard]] MaterialRendererInfo GetMaterialRendererInfo() const noexcept override;
@@ -85,9 +93,34 @@ namespace MauRen
 		VulkanDescriptorContext m_DescriptorContext{};
 		VulkanSwapchainContext m_SwapChainContext{};
 		VulkanGraphicsPipelineContext m_GraphicsPipelineContext{};
+		// Only runs with ENABLE_SHADER_HOT_RELOAD
+		VulkanShaderHotReloader m_ShaderHotReloader{};
 
 		VulkanCommandPoolManager m_CommandPoolManager{};
 
+		// Only used with GPU culling, sized after the swapchain
+		HiZPass m_HiZPass{};
+
+		// Every pass of the frame, rebuilt with the swapchain, owns the render targets
+		VulkanRenderGraph m_RenderGraph{};
+		struct RenderTargets final
+		{
+			VulkanRenderGraph::ImageHandle depth;
+			VulkanRenderGraph::ImageHandle colour;
+			VulkanRenderGraph::ImageHandle gBufferColor;
+			VulkanRenderGraph::ImageHandle gBufferNormal;
+			VulkanRenderGraph::ImageHandle gBufferMetalRough;
+			VulkanRenderGraph::ImageHandle swapchain;
+		};
+		RenderTargets m_RenderTargets{};
+		// Hi-Z & the late depth prepass, only run when the view is GPU culled
+		std::array<VulkanRenderGraph::PassHandle, 2> m_LateCullingPasses{};
+
+		// Shadow passes recorded by one job, the GBuffer pass gets a job of its own
+		uint32_t static constexpr SHADOW_PASSES_PER_JOB{ 4 };
+		// Recorded this frame, shadow passes followed by the GBuffer pass
+		std::vector<VkCommandBuffer> m_SecondaryCommandBuffers{};
+
 		// Signal that an image has been acquired from the swapchain and is ready for rendering
 		std::vector<VkSemaphore> m_ImageAvailableSemaphores{};
 
@@ -164,11 +197,19 @@ namespace MauRen
 
 		void DrawFrame(MauEng::Camera const* cam);
 		void RecordCommandBuffer(VkCommandBuffer commandBuffer, uint32_t imageIndex, glm::mat4 const& viewProj);
+		// Records into a secondary command buffer, the GBuffer images have to be in VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL
+		void RecordGBufferPass(VkCommandBuffer commandBuffer);
+		// Declares the passes & render targets, sized after the swapchain
+		void BuildRenderGraph();
+		// The lighting & tone map passes sample the render targets
+		void WriteRenderTargetDescriptors();
 		void UpdateUniformBuffer(glm::mat4 const& view, glm::mat4 const& proj);
 		void UpdateCamSettings(MauEng::Camera const* cam);
 
 		// Recreate the swapchain on e.g a window resize
 		bool RecreateSwapchain();
+		// Creates the depth pyramid for the GPU culling's occlusion test
+		void CreateDepthPyramid();
 
 		// Update the buffer for debug drawing
 		void UpdateDebugVertexBuffer();
@@ -0,0 +1,235 @@
+#include "VulkanShaderHotReloader.h"
+
+#include "VulkanDeviceContextManager.h"
+
+#include <cstdio>
+#include <format>
+
+namespace MauRen
+{
+	namespace
+	{
+		// Where the pipelines read the SPIR-V from, relative to the working directory
+		auto constexpr SPIRV_DIR{ "Resources/Shaders" };
+
+		[[nodiscard]] bool IsShaderSource(std::filesystem::path const& path) noexcept
+		{
+			auto const extension{ path.extension() };
+			return extension == ".vert" or extension == ".frag" or extension == ".comp";
+		}
+
+		// Runs the command & returns its exit code, stdout & stderr are appended to output
+		[[nodiscard]] int RunCommand(std::string command, std::string& output)
+		{
+#ifdef _WIN32
+			// cmd.exe strips the outer quotes of a command that starts with one
+			command = "\"" + command + "\"";
+			FILE* pPipe{ _popen(command.c_str(), "r") };
+#else
+			FILE* pPipe{ popen(command.c_str(), "r") };
+#endif
+			if (not pPipe)
+			{
+				return -1;
+			}
+
+			std::array<char, 256> buffer{};
+			while (fgets(buffer.data(), static_cast<int>(buffer.size()), pPipe))
+			{
+				output += buffer.data();
+			}
+
+#ifdef _WIN32
+			return _pclose(pPipe);
+#else
+			return pclose(pPipe);
+#endif
+		}
+	}
+
+	void VulkanShaderHotReloader::Initialize(VkPipelineCache pipelineCache, VulkanSwapchainContext* pSwapChainContext, VkDescriptorSetLayout descriptorSetLayout, uint32_t descriptorSetLayoutCount)
+	{
+		m_PipelineCache = pipelineCache;
+		m_pSwapChainContext = pSwapChainContext;
+		m_DescriptorSetLayout = descriptorSetLayout;
+		m_DescriptorSetLayoutCount = descriptorSetLayoutCount;
+
+		if (not std::filesystem::is_directory(SHADER_SOURCE_DIR))
+		{
+			ME_LOG_WARN(LogRenderer, "Shader hot reload is disabled, {} doesn't exist", SHADER_SOURCE_DIR);
+			return;
+		}
+
+		// The build compiled the current sources, only later changes are reloaded
+		CollectChangedShaders();
+
+		m_Thread = std::jthread{ [this](std::stop_token stopToken) { Run(stopToken); } };
+
+		ME_LOG_INFO(LogRenderer, "Shader hot reload is watching {}", SHADER_SOURCE_DIR);
+	}
+
+	void VulkanShaderHotReloader::Destroy()
+	{
+		if (m_Thread.joinable())
+		{
+			m_Thread.request_stop();
+			m_Thread.join();
+		}
+
+		std::scoped_lock const lock{ m_ReloadedMutex };
+		if (m_pReloaded)
+		{
+			m_pReloaded->Destroy();
+			m_pReloaded.reset();
+		}
+	}
+
+	bool VulkanShaderHotReloader::ApplyReloadedPipelines(VulkanGraphicsPipelineContext& pipelineContext)
+	{
+		std::unique_ptr<VulkanGraphicsPipelineContext> pReloaded{};
+		{
+			std::scoped_lock const lock{ m_ReloadedMutex };
+			pReloaded = std::move(m_pReloaded);
+		}
+
+		if (not pReloaded)
+		{
+			return false;
+		}
+
+		ME_PROFILE_FUNCTION()
+
+		// The frames in flight still use the old pipelines, a stall is fine for a reload
+		auto const deviceContext{ VulkanDeviceContextManager::GetInstance().GetDeviceContext() };
+		vkDeviceWaitIdle(deviceContext->GetLogicalDevice());
+
+		pipelineContext.SwapPipelines(*pReloaded);
+		pReloaded->Destroy();
+
+		ME_LOG_INFO(LogRenderer, "Reloaded the graphics pipelines");
+		return true;
+	}
+
+	void VulkanShaderHotReloader::Run(std::stop_token stopToken)
+	{
+		ME_PROFILE_THREAD("Shader Hot Reload")
+
+		while (not stopToken.stop_requested())
+		{
+			{
+				// Wakes up early when the thread is stopped
+				std::unique_lock lock{ m_SleepMutex };
+				if (m_SleepCondition.wait_for(lock, stopToken, std::chrono::milliseconds{ SHADER_HOT_RELOAD_POLL_MS }, [&stopToken] { return stopToken.stop_requested(); }))
+				{
+					return;
+				}
+			}
+
+			auto const changedShaders{ CollectChangedShaders() };
+			if (changedShaders.empty())
+			{
+				continue;
+			}
+
+			bool isGraphicsChanged{ false };
+			for (auto const& source : changedShaders)
+			{
+				if (CompileShader(source) and source.extension() != ".comp")
+				{
+					isGraphicsChanged = true;
+				}
+			}
+
+			if (isGraphicsChanged and not stopToken.stop_requested())
+			{
+				RebuildPipelines();
+			}
+		}
+	}
+
+	std::vector<std::filesystem::path> VulkanShaderHotReloader::CollectChangedShaders()
+	{
+		std::vector<std::filesystem::path> changedShaders{};
+
+		std::error_code error{};
+		for (auto const& entry : std::filesystem::directory_iterator{ SHADER_SOURCE_DIR, error })
+		{
+			if (not entry.is_regular_file(error) or not IsShaderSource(entry.path()))
+			{
+				continue;
+			}
+
+			// Editors may replace the file while it is read, it is picked up by the next poll
+			auto const writeTime{ std::filesystem::last_write_time(entry.path(), error) };
+			if (error)
+			{
+				continue;
+			}
+
+			auto const [it, isInserted] { m_WriteTimes.try_emplace(entry.path(), writeTime) };
+			if (isInserted or it->second != writeTime)
+			{
+				it->second = writeTime;
+				changedShaders.emplace_back(entry.path());
+			}
+		}
+
+		return changedShaders;
+	}
+
+	bool VulkanShaderHotReloader::CompileShader(std::filesystem::path const& source)
+	{
+		ME_PROFILE_FUNCTION()
+
+		// Compiled next to the SPIR-V & renamed, pipeline creation never reads a partially written file
+		std::filesystem::path const spirvPath{ std::filesystem::path{ SPIRV_DIR } / (source.filename().string() + ".spv") };
+		std::filesystem::path const tempPath{ spirvPath.string() + ".tmp" };
+
+		std::string output{};
+		int const result{ RunCommand(std::format("\"{}\" \"{}\" -o \"{}\" 2>&1", GLSLC_PATH, source.string(), tempPath.string()), output) };
+
+		std::error_code error{};
+		if (0 != result)
+		{
+			ME_LOG_ERROR(LogRenderer, "Failed to compile shader {}, keeping the previous version:\n{}", source.filename().string(), output);
+			std::filesystem::remove(tempPath, error);
+			return false;
+		}
+
+		std::filesystem::rename(tempPath, spirvPath, error);
+		if (error)
+		{
+			ME_LOG_ERROR(LogRenderer, "Failed to replace {}: {}", spirvPath.string(), error.message());
+			return false;
+		}
+
+		ME_LOG_INFO(LogRenderer, "Compiled shader {}", source.filename().string());
+		return true;
+	}
+
+	void VulkanShaderHotReloader::RebuildPipelines()
+	{
+		ME_PROFILE_FUNCTION()
+
+		auto pPipelines{ std::make_unique<VulkanGraphicsPipelineContext>() };
+		try
+		{
+			std::scoped_lock const lock{ m_RebuildMutex };
+			pPipelines->InitializeShared(m_PipelineCache, m_pSwapChainContext, m_DescriptorSetLayout, m_DescriptorSetLayoutCount);
+		}
+		catch (std::exception const& exception)
+		{
+			ME_LOG_ERROR(LogRenderer, "Failed to reload the graphics pipelines, keeping the running ones: {}", exception.what());
+			pPipelines->Destroy();
+			return;
+		}
+
+		std::scoped_lock const lock{ m_ReloadedMutex };
+		// Replaces a set that was never swapped in, the GPU never used it
+		if (m_pReloaded)
+		{
+			m_pReloaded->Destroy();
+		}
+		m_pReloaded = std::move(pPipelines);
+	}
+}
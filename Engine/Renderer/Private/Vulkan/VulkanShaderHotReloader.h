@@ -0,0 +1,80 @@
+#ifndef MAUREN_VULKANSHADERHOTRELOADER_H
+#define MAUREN_VULKANSHADERHOTRELOADER_H
+
+#include "RendererPCH.h"
+#include "VulkanGraphicsPipelineContext.h"
+
+#include <condition_variable>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace MauRen
+{
+	class VulkanSwapchainContext;
+
+	/**
+	 * @brief Recompiles the GLSL shaders when they change on disk & swaps in pipelines created from them, no restart needed to iterate on a shader.
+	 *
+	 * A background thread polls SHADER_SOURCE_DIR. A changed shader is compiled with glslc over its SPIR-V in Resources/Shaders,
+	 * the graphics pipelines are then created again on that same thread. They share the running pipelines' cache, so only the changed stages are compiled.
+	 * The renderer swaps them in with ApplyReloadedPipelines at a frame boundary.
+	 *
+	 * A shader that fails to compile logs glslc's output & the running pipelines are kept.
+	 * Compute shaders are compiled as well, but their passes only load them at startup.
+	 */
+	class VulkanShaderHotReloader final
+	{
+	public:
+		VulkanShaderHotReloader() = default;
+		~VulkanShaderHotReloader() = default;
+
+		// The pipeline cache, swapchain context & layout have to outlive the reloader
+		void Initialize(VkPipelineCache pipelineCache, VulkanSwapchainContext* pSwapChainContext, VkDescriptorSetLayout descriptorSetLayout, uint32_t descriptorSetLayoutCount);
+		// Stops the background thread & destroys the pipelines that were never swapped in
+		void Destroy();
+
+		// Swaps the reloaded pipelines into the context, stalls the device when there are any. Has to be called at a frame boundary
+		// Returns whether the pipelines were swapped
+		bool ApplyReloadedPipelines(VulkanGraphicsPipelineContext& pipelineContext);
+
+		// The pipelines read the swapchain context while they are created, hold the lock while it is recreated
+		[[nodiscard]] std::unique_lock<std::mutex> PauseRebuilds() { return std::unique_lock{ m_RebuildMutex }; }
+
+		VulkanShaderHotReloader(VulkanShaderHotReloader const&) = delete;
+		VulkanShaderHotReloader(VulkanShaderHotReloader&&) = delete;
+		VulkanShaderHotReloader& operator=(VulkanShaderHotReloader const&) = delete;
+		VulkanShaderHotReloader& operator=(VulkanShaderHotReloader&&) = delete;
+
+	private:
+		VkPipelineCache m_PipelineCache{ VK_NULL_HANDLE };
+		VulkanSwapchainContext* m_pSwapChainContext{ nullptr };
+		VkDescriptorSetLayout m_DescriptorSetLayout{ VK_NULL_HANDLE };
+		uint32_t m_DescriptorSetLayoutCount{ 0 };
+
+		std::jthread m_Thread{};
+		// Only used to sleep between polls, wakes up when the thread is stopped
+		std::mutex m_SleepMutex{};
+		std::condition_variable_any m_SleepCondition{};
+
+		std::mutex m_RebuildMutex{};
+
+		// Created by the background thread, waiting to be swapped in
+		std::mutex m_ReloadedMutex{};
+		std::unique_ptr<VulkanGraphicsPipelineContext> m_pReloaded{};
+
+		// Last write time of every shader source, only used by the background thread
+		std::map<std::filesystem::path, std::filesystem::file_time_type> m_WriteTimes{};
+
+		void Run(std::stop_token stopToken);
+
+		// Sources that were added or written since the last call
+		std::vector<std::filesystem::path> CollectChangedShaders();
+		[[nodiscard]] static bool CompileShader(std::filesystem::path const& source);
+		void RebuildPipelines();
+	};
+}
+
+#endif
@@ -1,12 +1,9 @@
 #include "RendererPCH.h"
-#include "VulkanCommandPoolManager.h"
-#include "VulkanDescriptorContext.h"
 
 #include "VulkanSwapchainContext.h"
 #include "VulkanSurfaceContext.h"
 #include "VulkanDeviceContext.h"
 #include "VulkanGraphicsPipelineContext.h"
-#include "Passes/ClearAttachments.h"
 
 namespace MauRen
 {
@@ -21,43 +18,24 @@ namespace MauRen
 		m_SwapChainImageFormat = format.format;
 	}
 
-	void VulkanSwapchainContext::Initialize(SDL_Window* pWindow, VulkanSurfaceContext const * pVulkanSurfaceContext, VulkanCommandPoolManager& commandPoolManager, VulkanDescriptorContext& descriptorContext)
+	void VulkanSwapchainContext::Initialize(SDL_Window* pWindow, VulkanSurfaceContext const * pVulkanSurfaceContext)
 	{
 		CreateSwapchain(pWindow, pVulkanSurfaceContext);
 		CreateImageViews();
-
-		CreateColorResources(commandPoolManager, descriptorContext);
-		CreateDepthResources(commandPoolManager, descriptorContext);
-		CreateGBuffers(commandPoolManager, descriptorContext);
 	}
 
-	void VulkanSwapchainContext::ReCreate(SDL_Window* pWindow, VulkanGraphicsPipelineContext const* pGraphicsPipeline, VulkanSurfaceContext const* pVulkanSurfaceContext, VulkanCommandPoolManager& commandPoolManager, VulkanDescriptorContext& descriptorContext)
+	void VulkanSwapchainContext::ReCreate(SDL_Window* pWindow, VulkanGraphicsPipelineContext const* pGraphicsPipeline, VulkanSurfaceContext const* pVulkanSurfaceContext)
 	{
 		Destroy();
 
 		CreateSwapchain(pWindow, pVulkanSurfaceContext);
 		CreateImageViews();
-		CreateColorResources(commandPoolManager , descriptorContext);
-		CreateDepthResources(commandPoolManager, descriptorContext);
-		CreateGBuffers(commandPoolManager, descriptorContext);
 	}	
 
 	void VulkanSwapchainContext::Destroy()
 	{
 		auto const deviceContext{ VulkanDeviceContextManager::GetInstance().GetDeviceContext() };
 
-		for (auto& image : m_DepthImages)
-		{
-			image.Destroy();
-		}
-		m_DepthImages.clear();
-
-		for (auto& image : m_ColorImages)
-		{
-			image.Destroy();
-		}
-		m_ColorImages.clear();
-
 		// Img destroyed when swapchain is destroyed
 		for (auto& image : m_SwapChainImages)
 		{
@@ -65,12 +43,6 @@ namespace MauRen
 		}
 		m_SwapChainImages.clear();
 
-		for (auto& b : m_GBuffers)
-		{
-			b.Destroy();
-		}
-		m_GBuffers.clear();
-
 		VulkanUtils::SafeDestroy(deviceContext->GetLogicalDevice(), m_SwapChain, nullptr);
 	}
 
@@ -248,355 +220,4 @@ namespace MauRen
 
 		return actualExtent;
 	}
-
-	void VulkanSwapchainContext::CreateColorResources(VulkanCommandPoolManager& commandPoolManager, VulkanDescriptorContext& descriptorContext)
-	{
-		auto const deviceContext{ VulkanDeviceContextManager::GetInstance().GetDeviceContext() };
-
-		auto buffer{ commandPoolManager.BeginSingleTimeCommands() };
-
-		for (size_t i{ 0 }; i< MAX_FRAMES_IN_FLIGHT; ++i)
-		{
-			m_ColorImages.emplace_back(
-				VulkanImage{
-					m_ColorFormat,
-					VK_IMAGE_TILING_OPTIMAL,
-					VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT ,
-					VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-					deviceContext->GetSampleCount(),
-					GetExtent().width,
-					GetExtent().height,
-					1,
-					1.f
-				});
-			m_ColorImages.back().CreateImageView(VK_IMAGE_ASPECT_COLOR_BIT);
-
-			m_ColorImages.back().TransitionImageLayout
-			(
-				buffer,
-				VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
-				VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT,
-				VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_2_COLOR_ATTACHMENT_READ_BIT
-			);
-		}
-
-		std::vector<VkClearValue> colorClears;
-		VkClearValue constexpr clearVal{ .color = {{0, 0, 0, 0}} };
-		for (size_t i{ 0 }; i < MAX_FRAMES_IN_FLIGHT; ++i)
-		{
-			colorClears.emplace_back(clearVal);
-		}
-
-		ClearAttachments(buffer, m_ColorImages, colorClears, GetExtent(), {}, {});
-
-		for (size_t i{ 0 }; i < MAX_FRAMES_IN_FLIGHT; ++i)
-		{
-			m_ColorImages[i].TransitionImageLayout
-			(
-				buffer,
-				VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
-				VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT,
-				VK_ACCESS_2_SHADER_READ_BIT
-			);
-		}
-
-		commandPoolManager.EndSingleTimeCommands(buffer);
-
-		std::vector<VkWriteDescriptorSet> descriptorWrites;
-		std::vector<VkDescriptorImageInfo> imageInfos;
-		descriptorWrites.resize(m_ColorImages.size());
-		imageInfos.resize(m_ColorImages.size());
-
-		for (uint32_t i{ 0 }; i < m_ColorImages.size(); ++i)
-		{
-			VkDescriptorImageInfo imageInfo{};
-			imageInfo.imageView = m_ColorImages[i].imageViews[0];
-			imageInfo.imageLayout = m_ColorImages[i].layout;
-			imageInfos[i] = imageInfo;
-
-			VkWriteDescriptorSet descriptorWriteColor{};
-			descriptorWriteColor.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-			descriptorWriteColor.dstSet = descriptorContext.GetDescriptorSets()[i];
-			descriptorWriteColor.dstBinding = 10;
-			descriptorWriteColor.dstArrayElement = 0;
-			descriptorWriteColor.descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
-			descriptorWriteColor.descriptorCount = 1;
-			descriptorWriteColor.pImageInfo = &imageInfos[i];
-			descriptorWrites[i] = descriptorWriteColor;
-		}
-
-		vkUpdateDescriptorSets(deviceContext->GetLogicalDevice(), static_cast<uint32_t>(std::size(descriptorWrites)), descriptorWrites.data(), 0, nullptr);
-	}
-
-	void VulkanSwapchainContext::CreateDepthResources(VulkanCommandPoolManager& commandPoolManager, VulkanDescriptorContext& descriptorContext)
-	{
-		auto const deviceContext{ VulkanDeviceContextManager::GetInstance().GetDeviceContext() };
-
-		auto buffer{ commandPoolManager.BeginSingleTimeCommands() };
-
-		for (size_t i{ 0 }; i < MAX_FRAMES_IN_FLIGHT; ++i)
-		{
-			m_DepthImages.emplace_back(VulkanImage
-			{
-				m_DepthFormat,
-				VK_IMAGE_TILING_OPTIMAL,
-				VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
-				VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-				deviceContext->GetSampleCount(),
-				GetExtent().width,
-				GetExtent().height,
-				1,
-				1.f
-			});
-
-			m_DepthImages.back().CreateImageView(VK_IMAGE_ASPECT_DEPTH_BIT);
-
-			m_DepthImages.back().TransitionImageLayout
-			(
-				buffer,
-				VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL,
-				VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT,
-				VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT
-			);
-		}
-
-
-		VkClearValue clearVal{ };
-		clearVal.depthStencil.depth = 1.f;
-		clearVal.depthStencil.stencil = 0.f;
-		for (size_t i{ 0 }; i < m_DepthImages.size(); ++i)
-		{
-			ClearAttachments(buffer, {}, {}, GetExtent(), m_DepthImages[i], clearVal);
-		}
-
-		for (size_t i{ 0 }; i < MAX_FRAMES_IN_FLIGHT; ++i)
-		{
-			m_DepthImages[i].TransitionImageLayout
-			(
-				buffer,
-				VK_IMAGE_LAYOUT_DEPTH_READ_ONLY_OPTIMAL,
-				VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT,
-				VK_ACCESS_2_SHADER_READ_BIT
-			);
-		}
-
-		commandPoolManager.EndSingleTimeCommands(buffer);
-
-		std::vector<VkWriteDescriptorSet> descriptorWrites;
-		std::vector<VkDescriptorImageInfo> imageInfos;
-		descriptorWrites.resize(m_DepthImages.size());
-		imageInfos.resize(m_DepthImages.size());
-
-		for (uint32_t i{ 0 }; i < m_DepthImages.size(); ++i)
-		{
-			VkDescriptorImageInfo imageInfo{};
-			imageInfo.imageView = m_DepthImages[i].imageViews[0];
-			imageInfo.imageLayout = m_DepthImages[i].layout;
-			imageInfos[i] = imageInfo;
-
-			VkWriteDescriptorSet descriptorWriteDepth{};
-			descriptorWriteDepth.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-			descriptorWriteDepth.dstSet = descriptorContext.GetDescriptorSets()[i];
-			descriptorWriteDepth.dstBinding = 9;
-			descriptorWriteDepth.dstArrayElement = 0;
-			descriptorWriteDepth.descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
-			descriptorWriteDepth.descriptorCount = 1;
-			descriptorWriteDepth.pImageInfo = &imageInfos[i];
-			descriptorWrites[i] = descriptorWriteDepth;
-		}
-
-		vkUpdateDescriptorSets(deviceContext->GetLogicalDevice(), static_cast<uint32_t>(std::size(descriptorWrites)), descriptorWrites.data(), 0, nullptr);
-	}
-
-	void VulkanSwapchainContext::CreateGBuffers(VulkanCommandPoolManager& commandPoolManager, VulkanDescriptorContext& descriptorContext)
-	{
-		auto const deviceContext{ VulkanDeviceContextManager::GetInstance().GetDeviceContext() };
-		VkSampleCountFlagBits const samples{ deviceContext->GetSampleCount() };
-
-		auto buffer{ commandPoolManager.BeginSingleTimeCommands() };
-
-		for (size_t i{ 0 }; i < MAX_FRAMES_IN_FLIGHT; ++i)
-		{
-			GBuffer g{};
-			g.color = VulkanImage
-			{
-				GBuffer::formats[0],
-				VK_IMAGE_TILING_OPTIMAL,
-				VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT ,
-				VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-				VK_SAMPLE_COUNT_1_BIT,
-				GetExtent().width,
-				GetExtent().height,
-				1,
-				1.f
-			};
-			g.color.CreateImageView(VK_IMAGE_ASPECT_COLOR_BIT);
-
-			g.color.TransitionImageLayout
-			(
-				buffer,
-				VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
-				VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT,
-				VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_2_COLOR_ATTACHMENT_READ_BIT
-			);
-
-			g.normal = VulkanImage
-			{
-				GBuffer::formats[1],
-				VK_IMAGE_TILING_OPTIMAL,
-				VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT ,
-				VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-				VK_SAMPLE_COUNT_1_BIT,
-				GetExtent().width,
-				GetExtent().height,
-				1,
-				1.f
-			};
-			g.normal.CreateImageView(VK_IMAGE_ASPECT_COLOR_BIT);
-
-			g.normal.TransitionImageLayout
-			(
-				buffer,
-				VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
-				VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT,
-				VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_2_COLOR_ATTACHMENT_READ_BIT
-			);
-
-			g.metalnessRoughness = VulkanImage
-			{
-				GBuffer::formats[2],
-				VK_IMAGE_TILING_OPTIMAL,
-				VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT ,
-				VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-				VK_SAMPLE_COUNT_1_BIT,
-				GetExtent().width,
-				GetExtent().height,
-				1,
-				1.f
-			};
-			g.metalnessRoughness.CreateImageView(VK_IMAGE_ASPECT_COLOR_BIT);
-
-			g.metalnessRoughness.TransitionImageLayout
-			(
-				buffer,
-				VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
-				VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT,
-				VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_2_COLOR_ATTACHMENT_READ_BIT
-			);
-
-			m_GBuffers.emplace_back(g);
-		}
-
-		std::vector<VulkanImage> allColour;
-		std::vector<VkClearValue> colorClears;
-		VkClearValue constexpr clearVal{ .color = {{0, 0, 0, 0}} };
-
-		for (auto& g : m_GBuffers)
-		{
-			allColour.clear();
-			colorClears.clear();
-
-			allColour.emplace_back(g.color);
-			allColour.emplace_back(g.metalnessRoughness);
-			allColour.emplace_back(g.normal);
-			colorClears.emplace_back(clearVal);
-			colorClears.emplace_back(clearVal);
-			colorClears.emplace_back(clearVal);
-
-			ClearAttachments(buffer, allColour, colorClears, GetExtent(), {}, {});
-		}
-
-
-		for (auto& g : m_GBuffers)
-		{
-			g.color.TransitionImageLayout
-			(
-				buffer,
-				VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
-				VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT,
-				VK_ACCESS_2_SHADER_READ_BIT
-			);
-
-			g.normal.TransitionImageLayout
-			(
-				buffer,
-				VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
-				VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT,
-				VK_ACCESS_2_SHADER_READ_BIT
-			);
-
-			g.metalnessRoughness.TransitionImageLayout
-			(
-				buffer,
-				VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
-				VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT,
-				VK_ACCESS_2_SHADER_READ_BIT
-			);
-		}
-
-		commandPoolManager.EndSingleTimeCommands(buffer);
-
-		std::vector<VkWriteDescriptorSet> descriptorWrites;
-		std::vector<VkDescriptorImageInfo> imageInfos;
-		descriptorWrites.resize(m_GBuffers.size() * std::size(GBuffer::formats));
-		imageInfos.resize(m_GBuffers.size() * std::size(GBuffer::formats));
-
-		for (uint32_t i{ 0 }; i < m_GBuffers.size(); ++i)
-		{
-			uint32_t const baseIndex{ i * static_cast<uint32_t>(std::size(GBuffer::formats)) };
-
-			{
-				VkDescriptorImageInfo imageInfo{};
-				imageInfo.imageView = m_GBuffers[i].color.imageViews[0];
-				imageInfo.imageLayout = m_GBuffers[i].color.layout;
-				imageInfos[baseIndex + 0] = imageInfo;
-
-				VkWriteDescriptorSet descriptorWriteColor = {};
-				descriptorWriteColor.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-				descriptorWriteColor.dstSet = descriptorContext.GetDescriptorSets()[i];
-				descriptorWriteColor.dstBinding = 6;
-				descriptorWriteColor.dstArrayElement = 0;
-				descriptorWriteColor.descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
-				descriptorWriteColor.descriptorCount = 1;
-				descriptorWriteColor.pImageInfo = &imageInfos[baseIndex + 0];
-				descriptorWrites[baseIndex + 0] = descriptorWriteColor;
-			}
-
-			{
-				VkDescriptorImageInfo imageInfo{};
-				imageInfo.imageView = m_GBuffers[i].normal.imageViews[0];
-				imageInfo.imageLayout = m_GBuffers[i].normal.layout;
-				imageInfos[baseIndex + 1] = imageInfo;
-
-				VkWriteDescriptorSet descriptorWriteNormal = {};
-				descriptorWriteNormal.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-				descriptorWriteNormal.dstSet = descriptorContext.GetDescriptorSets()[i];
-				descriptorWriteNormal.dstBinding = 7;
-				descriptorWriteNormal.dstArrayElement = 0;
-				descriptorWriteNormal.descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
-				descriptorWriteNormal.descriptorCount = 1;
-				descriptorWriteNormal.pImageInfo = &imageInfos[baseIndex + 1];
-				descriptorWrites[baseIndex + 1] = descriptorWriteNormal;
-			}
-
-			{
-				VkDescriptorImageInfo imageInfo{};
-				imageInfo.imageView = m_GBuffers[i].metalnessRoughness.imageViews[0];
-				imageInfo.imageLayout = m_GBuffers[i].metalnessRoughness.layout;
-				imageInfos[baseIndex + 2] = imageInfo;
-
-				VkWriteDescriptorSet descriptorWriteMetal = {};
-				descriptorWriteMetal.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-				descriptorWriteMetal.dstSet = descriptorContext.GetDescriptorSets()[i];
-				descriptorWriteMetal.dstBinding = 8;
-				descriptorWriteMetal.dstArrayElement = 0;
-				descriptorWriteMetal.descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
-				descriptorWriteMetal.descriptorCount = 1;
-				descriptorWriteMetal.pImageInfo = &imageInfos[baseIndex + 2];
-				descriptorWrites[baseIndex + 2] = descriptorWriteMetal;
-			}
-		}
-
-		vkUpdateDescriptorSets(deviceContext->GetLogicalDevice(), static_cast<uint32_t>(std::size(descriptorWrites)), descriptorWrites.data(), 0, nullptr);
-	}
 }
@@ -0,0 +1,545 @@
+#include "VulkanUploadManager.h"
+
+#include "VulkanCommandPoolManager.h"
+#include "VulkanMemoryAllocator.h"
+
+namespace MauRen
+{
+	void VulkanUploadManager::Initialize()
+	{
+		auto const deviceContext{ VulkanDeviceContextManager::GetInstance().GetDeviceContext() };
+
+		QueueFamilyIndices const familyIndices{ deviceContext->GetQueueFamilyIndices() };
+		m_GraphicsFamily = familyIndices.graphicsFamily.value();
+		m_TransferFamily = familyIndices.transferFamily.value();
+		m_IsDedicated = deviceContext->HasDedicatedTransferQueue();
+
+		VkCommandPoolCreateInfo poolInfo{};
+		poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+		poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT | VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+		poolInfo.queueFamilyIndex = m_TransferFamily;
+
+		if (VK_SUCCESS != vkCreateCommandPool(deviceContext->GetLogicalDevice(), &poolInfo, nullptr, &m_CommandPool))
+		{
+			throw std::runtime_error("Failed to create upload command pool!");
+		}
+
+		VkSemaphoreTypeCreateInfo typeInfo{};
+		typeInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+		typeInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+		typeInfo.initialValue = 0;
+
+		VkSemaphoreCreateInfo semaphoreInfo{};
+		semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+		semaphoreInfo.pNext = &typeInfo;
+
+		if (VK_SUCCESS != vkCreateSemaphore(deviceContext->GetLogicalDevice(), &semaphoreInfo, nullptr, &m_TimelineSemaphore))
+		{
+			throw std::runtime_error("Failed to create upload timeline semaphore!");
+		}
+
+		m_StagingBuffer = VulkanMappedBuffer{ VulkanBuffer{ UPLOAD_STAGING_RING_SIZE,
+															VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+															VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT },
+											nullptr };
+
+		// Persistent mapping
+		vmaMapMemory(VulkanMemoryAllocator::GetInstance().GetAllocator(), m_StagingBuffer.buffer.alloc, &m_StagingBuffer.mapped);
+
+		ME_LOG_INFO(LogRenderer, "Uploading on queue family {} ({})", m_TransferFamily, m_IsDedicated ? "dedicated" : "shared with graphics");
+	}
+
+	void VulkanUploadManager::Destroy()
+	{
+		auto const deviceContext{ VulkanDeviceContextManager::GetInstance().GetDeviceContext() };
+
+		auto const destroyStaging{ [](Batch& batch)
+		{
+			for (auto& b : batch.dedicatedStaging)
+			{
+				b.Destroy();
+			}
+		} };
+
+		destroyStaging(m_Recording);
+		std::ranges::for_each(m_InFlight, destroyStaging);
+		std::ranges::for_each(m_Finished, destroyStaging);
+		std::ranges::for_each(m_Acquiring, destroyStaging);
+
+		m_Recording = {};
+		m_InFlight.clear();
+		m_Finished.clear();
+		m_Acquiring.clear();
+
+		// Frees the command buffers as well
+		VulkanUtils::SafeDestroy(deviceContext->GetLogicalDevice(), m_CommandPool, nullptr);
+		m_FreeCommandBuffers.clear();
+
+		vkDestroySemaphore(deviceContext->GetLogicalDevice(), m_TimelineSemaphore, nullptr);
+		m_TimelineSemaphore = VK_NULL_HANDLE;
+
+		m_StagingBuffer.UnMap();
+		m_StagingBuffer.buffer.Destroy();
+	}
+
+	void VulkanUploadManager::UploadBuffer(void const* pData, VkDeviceSize size, VkBuffer dstBuffer, VkDeviceSize dstOffset,
+		VkPipelineStageFlags2 dstStage, VkAccessFlags2 dstAccess, CompletionCallback onComplete)
+	{
+		ME_PROFILE_FUNCTION()
+
+		if (size > 0)
+		{
+			// Can submit the recording batch, so before its command buffer is fetched
+			auto const [srcBuffer, srcOffset] { Stage(pData, size) };
+
+			VkBufferCopy const region{ srcOffset, dstOffset, size };
+			vkCmdCopyBuffer(GetRecordingCommandBuffer(), srcBuffer, dstBuffer, 1, &region);
+
+			if (m_IsDedicated)
+			{
+				m_Recording.bufferReleases.emplace_back(VkBufferMemoryBarrier2{
+					.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2,
+					.srcStageMask = VK_PIPELINE_STAGE_2_TRANSFER_BIT,
+					.srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT,
+					.dstStageMask = VK_PIPELINE_STAGE_2_NONE,
+					.dstAccessMask = VK_ACCESS_2_NONE,
+					.srcQueueFamilyIndex = m_TransferFamily,
+					.dstQueueFamilyIndex = m_GraphicsFamily,
+					.buffer = dstBuffer,
+					.offset = dstOffset,
+					.size = size
+				});
+			}
+
+			m_Recording.bufferAcquires.emplace_back(dstBuffer, dstOffset, size, dstStage, dstAccess);
+		}
+
+		if (onComplete)
+		{
+			m_Recording.callbacks.emplace_back(std::move(onComplete));
+		}
+	}
+
+	void VulkanUploadManager::UploadImage(void const* pPixels, VkDeviceSize size, VulkanImage& image, CompletionCallback onComplete)
+	{
+		ME_PROFILE_FUNCTION()
+
+		ME_RENDERER_ASSERT(VK_IMAGE_LAYOUT_UNDEFINED == image.layout);
+
+		auto const [srcBuffer, srcOffset] { Stage(pPixels, size) };
+		VkCommandBuffer const commandBuffer{ GetRecordingCommandBuffer() };
+
+		VkImageSubresourceRange const allMips{ VK_IMAGE_ASPECT_COLOR_BIT, 0, image.mipLevels, 0, 1 };
+
+		VkImageMemoryBarrier2 const toTransferDst{
+			.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2,
+			.srcStageMask = VK_PIPELINE_STAGE_2_NONE,
+			.srcAccessMask = VK_ACCESS_2_NONE,
+			.dstStageMask = VK_PIPELINE_STAGE_2_TRANSFER_BIT,
+			.dstAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT,
+			.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+			.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+			.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+			.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+			.image = image.image,
+			.subresourceRange = allMips
+		};
+
+		VkDependencyInfo const depInfo{
+			.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+			.imageMemoryBarrierCount = 1,
+			.pImageMemoryBarriers = &toTransferDst
+		};
+		vkCmdPipelineBarrier2(commandBuffer, &depInfo);
+
+		VkBufferImageCopy region{};
+		region.bufferOffset = srcOffset;
+		region.imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1 };
+		region.imageExtent = { image.width, image.height, 1 };
+
+		vkCmdCopyBufferToImage(commandBuffer, srcBuffer, image.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+
+		if (m_IsDedicated)
+		{
+			// The layout stays, the graphics queue still has to blit the mips
+			m_Recording.imageReleases.emplace_back(VkImageMemoryBarrier2{
+				.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2,
+				.srcStageMask = VK_PIPELINE_STAGE_2_TRANSFER_BIT,
+				.srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT,
+				.dstStageMask = VK_PIPELINE_STAGE_2_NONE,
+				.dstAccessMask = VK_ACCESS_2_NONE,
+				.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+				.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+				.srcQueueFamilyIndex = m_TransferFamily,
+				.dstQueueFamilyIndex = m_GraphicsFamily,
+				.image = image.image,
+				.subresourceRange = allMips
+			});
+		}
+
+		VulkanImage acquire{ image };
+		acquire.imageViews.clear();
+		acquire.layout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+		acquire.lastStage = VK_PIPELINE_STAGE_2_TRANSFER_BIT;
+		acquire.lastAccess = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+		m_Recording.imageAcquires.emplace_back(std::move(acquire));
+
+		// Where RecordAcquires leaves it
+		image.layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+		image.lastStage = VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT;
+		image.lastAccess = VK_ACCESS_2_SHADER_SAMPLED_READ_BIT;
+
+		if (onComplete)
+		{
+			m_Recording.callbacks.emplace_back(std::move(onComplete));
+		}
+	}
+
+	void VulkanUploadManager::Submit()
+	{
+		ME_PROFILE_FUNCTION()
+
+		if (VK_NULL_HANDLE == m_Recording.commandBuffer)
+		{
+			// Nothing to wait for
+			if (!m_Recording.callbacks.empty())
+			{
+				m_Finished.emplace_back(std::move(m_Recording));
+			}
+
+			m_Recording = {};
+			return;
+		}
+
+		auto const deviceContext{ VulkanDeviceContextManager::GetInstance().GetDeviceContext() };
+		VkCommandBuffer const commandBuffer{ m_Recording.commandBuffer };
+
+		if (!m_Recording.bufferReleases.empty() || !m_Recording.imageReleases.empty())
+		{
+			VkDependencyInfo const depInfo{
+				.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+				.bufferMemoryBarrierCount = static_cast<uint32_t>(m_Recording.bufferReleases.size()),
+				.pBufferMemoryBarriers = m_Recording.bufferReleases.data(),
+				.imageMemoryBarrierCount = static_cast<uint32_t>(m_Recording.imageReleases.size()),
+				.pImageMemoryBarriers = m_Recording.imageReleases.data()
+			};
+			vkCmdPipelineBarrier2(commandBuffer, &depInfo);
+		}
+
+		if (VK_SUCCESS != vkEndCommandBuffer(commandBuffer))
+		{
+			throw std::runtime_error("Failed to record upload command buffer!");
+		}
+
+		m_Recording.timelineValue = ++m_SubmittedValue;
+		m_Recording.stagingEnd = m_StagingHead;
+
+		VkCommandBufferSubmitInfo const commandBufferInfo{
+			.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO,
+			.commandBuffer = commandBuffer
+		};
+
+		VkSemaphoreSubmitInfo const signalInfo{
+			.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO,
+			.semaphore = m_TimelineSemaphore,
+			.value = m_SubmittedValue,
+			.stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT
+		};
+
+		VkSubmitInfo2 const submitInfo{
+			.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO_2,
+			.commandBufferInfoCount = 1,
+			.pCommandBufferInfos = &commandBufferInfo,
+			.signalSemaphoreInfoCount = 1,
+			.pSignalSemaphoreInfos = &signalInfo
+		};
+
+		if (VK_SUCCESS != vkQueueSubmit2(deviceContext->GetTransferQueue(), 1, &submitInfo, VK_NULL_HANDLE))
+		{
+			throw std::runtime_error("Failed to submit upload command buffer!");
+		}
+
+		m_InFlight.emplace_back(std::move(m_Recording));
+		m_Recording = {};
+	}
+
+	void VulkanUploadManager::BeginFrame()
+	{
+		ME_PROFILE_FUNCTION()
+
+		RetireFinishedBatches(false);
+
+		// Batches that finish later in the frame wait for the next one, their callbacks have to run before their acquires are recorded
+		for (auto& batch : m_Finished)
+		{
+			for (auto const& callback : batch.callbacks)
+			{
+				callback();
+			}
+			batch.callbacks.clear();
+
+			m_Acquiring.emplace_back(std::move(batch));
+		}
+		m_Finished.clear();
+	}
+
+	void VulkanUploadManager::RecordAcquires(VkCommandBuffer commandBuffer)
+	{
+		ME_PROFILE_FUNCTION()
+
+		if (m_Acquiring.empty())
+		{
+			return;
+		}
+
+		// Without a dedicated family there is no ownership to transfer, the barriers only order the copies before their use
+		VkPipelineStageFlags2 const srcStage{ m_IsDedicated ? VK_PIPELINE_STAGE_2_NONE : VK_PIPELINE_STAGE_2_TRANSFER_BIT };
+		VkAccessFlags2 const srcAccess{ m_IsDedicated ? VK_ACCESS_2_NONE : VK_ACCESS_2_TRANSFER_WRITE_BIT };
+		uint32_t const srcFamily{ m_IsDedicated ? m_TransferFamily : VK_QUEUE_FAMILY_IGNORED };
+		uint32_t const dstFamily{ m_IsDedicated ? m_GraphicsFamily : VK_QUEUE_FAMILY_IGNORED };
+
+		m_BufferBarriers.clear();
+		m_ImageBarriers.clear();
+
+		for (auto const& batch : m_Acquiring)
+		{
+			for (auto const& acquire : batch.bufferAcquires)
+			{
+				m_BufferBarriers.emplace_back(VkBufferMemoryBarrier2{
+					.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2,
+					.srcStageMask = srcStage,
+					.srcAccessMask = srcAccess,
+					.dstStageMask = acquire.dstStage,
+					.dstAccessMask = acquire.dstAccess,
+					.srcQueueFamilyIndex = srcFamily,
+					.dstQueueFamilyIndex = dstFamily,
+					.buffer = acquire.buffer,
+					.offset = acquire.offset,
+					.size = acquire.size
+				});
+			}
+
+			for (auto const& image : batch.imageAcquires)
+			{
+				m_ImageBarriers.emplace_back(VkImageMemoryBarrier2{
+					.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2,
+					.srcStageMask = srcStage,
+					.srcAccessMask = srcAccess,
+					.dstStageMask = VK_PIPELINE_STAGE_2_TRANSFER_BIT,
+					.dstAccessMask = VK_ACCESS_2_TRANSFER_READ_BIT | VK_ACCESS_2_TRANSFER_WRITE_BIT,
+					.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+					.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+					.srcQueueFamilyIndex = srcFamily,
+					.dstQueueFamilyIndex = dstFamily,
+					.image = image.image,
+					.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, image.mipLevels, 0, 1 }
+				});
+			}
+
+			m_AcquiredValue = std::max(m_AcquiredValue, batch.timelineValue);
+		}
+
+		VkDependencyInfo const depInfo{
+			.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+			.bufferMemoryBarrierCount = static_cast<uint32_t>(m_BufferBarriers.size()),
+			.pBufferMemoryBarriers = m_BufferBarriers.data(),
+			.imageMemoryBarrierCount = static_cast<uint32_t>(m_ImageBarriers.size()),
+			.pImageMemoryBarriers = m_ImageBarriers.data()
+		};
+		vkCmdPipelineBarrier2(commandBuffer, &depInfo);
+
+		// Blits need a graphics queue, so the mips are only generated now
+		for (auto& batch : m_Acquiring)
+		{
+			for (auto& image : batch.imageAcquires)
+			{
+				if (image.mipLevels > 1)
+				{
+					image.GenerateMipmaps(commandBuffer);
+				}
+				else
+				{
+					image.TransitionImageLayout(commandBuffer, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT, VK_ACCESS_2_SHADER_SAMPLED_READ_BIT);
+				}
+			}
+		}
+
+		m_Acquiring.clear();
+	}
+
+	void VulkanUploadManager::Flush(VulkanCommandPoolManager const& cmdPoolManager)
+	{
+		ME_PROFILE_FUNCTION()
+
+		Submit();
+		while (!m_InFlight.empty())
+		{
+			RetireFinishedBatches(true);
+		}
+
+		BeginFrame();
+
+		VkCommandBuffer const commandBuffer{ cmdPoolManager.BeginSingleTimeCommands() };
+		RecordAcquires(commandBuffer);
+
+		VkSemaphoreSubmitInfo const waitInfo{
+			.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO,
+			.semaphore = m_TimelineSemaphore,
+			.value = m_AcquiredValue,
+			.stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT
+		};
+		cmdPoolManager.EndSingleTimeCommands(commandBuffer, { &waitInfo, 1 });
+	}
+
+	VkCommandBuffer VulkanUploadManager::GetRecordingCommandBuffer()
+	{
+		if (VK_NULL_HANDLE != m_Recording.commandBuffer)
+		{
+			return m_Recording.commandBuffer;
+		}
+
+		auto const deviceContext{ VulkanDeviceContextManager::GetInstance().GetDeviceContext() };
+
+		VkCommandBuffer commandBuffer{ VK_NULL_HANDLE };
+		if (!m_FreeCommandBuffers.empty())
+		{
+			commandBuffer = m_FreeCommandBuffers.back();
+			m_FreeCommandBuffers.pop_back();
+		}
+		else
+		{
+			VkCommandBufferAllocateInfo allocInfo{};
+			allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+			allocInfo.commandPool = m_CommandPool;
+			allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+			allocInfo.commandBufferCount = 1;
+
+			if (VK_SUCCESS != vkAllocateCommandBuffers(deviceContext->GetLogicalDevice(), &allocInfo, &commandBuffer))
+			{
+				throw std::runtime_error("Failed to allocate upload command buffer!");
+			}
+		}
+
+		// Begin resets it, the pool allows that per buffer
+		VkCommandBufferBeginInfo beginInfo{};
+		beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+		beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+		if (VK_SUCCESS != vkBeginCommandBuffer(commandBuffer, &beginInfo))
+		{
+			throw std::runtime_error("Failed to begin upload command buffer!");
+		}
+
+		m_Recording.commandBuffer = commandBuffer;
+		return commandBuffer;
+	}
+
+	std::pair<VkBuffer, VkDeviceSize> VulkanUploadManager::Stage(void const* pData, VkDeviceSize size)
+	{
+		auto const copyToRing{ [this, pData, size](VkDeviceSize offset)
+		{
+			memcpy(static_cast<uint8_t*>(m_StagingBuffer.mapped) + offset, pData, size);
+			return std::pair{ m_StagingBuffer.buffer.buffer, offset };
+		} };
+
+		if (VkDeviceSize offset{ 0 }; TryAllocateStaging(size, offset))
+		{
+			return copyToRing(offset);
+		}
+
+		// The ring is full, hand what is queued to the GPU & wait for the oldest batches until there is room
+		if (VK_NULL_HANDLE != m_Recording.commandBuffer)
+		{
+			Submit();
+		}
+
+		while (!m_InFlight.empty())
+		{
+			RetireFinishedBatches(true);
+
+			if (VkDeviceSize offset{ 0 }; TryAllocateStaging(size, offset))
+			{
+				return copyToRing(offset);
+			}
+		}
+
+		// Larger than the whole ring, lives until the batch finished
+		VulkanBuffer& stagingBuffer{ m_Recording.dedicatedStaging.emplace_back(size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) };
+
+		void* pMapped{ nullptr };
+		vmaMapMemory(VulkanMemoryAllocator::GetInstance().GetAllocator(), stagingBuffer.alloc, &pMapped);
+		memcpy(pMapped, pData, size);
+		vmaUnmapMemory(VulkanMemoryAllocator::GetInstance().GetAllocator(), stagingBuffer.alloc);
+
+		return { stagingBuffer.buffer, 0 };
+	}
+
+	bool VulkanUploadManager::TryAllocateStaging(VkDeviceSize size, VkDeviceSize& outOffset) noexcept
+	{
+		// Covers the texel size of the image copies
+		VkDeviceSize constexpr ALIGNMENT{ 16 };
+		size = (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+
+		VkDeviceSize const capacity{ m_StagingBuffer.buffer.size };
+
+		// Allocations don't wrap, the rest of the ring is skipped instead
+		VkDeviceSize const ringOffset{ m_StagingHead % capacity };
+		VkDeviceSize const padding{ ringOffset + size > capacity ? capacity - ringOffset : 0 };
+
+		if (m_StagingHead + padding + size - m_StagingTail > capacity)
+		{
+			return false;
+		}
+
+		m_StagingHead += padding;
+		outOffset = m_StagingHead % capacity;
+		m_StagingHead += size;
+
+		return true;
+	}
+
+	void VulkanUploadManager::RetireFinishedBatches(bool wait)
+	{
+		if (m_InFlight.empty())
+		{
+			return;
+		}
+
+		auto const deviceContext{ VulkanDeviceContextManager::GetInstance().GetDeviceContext() };
+
+		if (wait)
+		{
+			ME_PROFILE_SCOPE("Wait for upload batch")
+
+			VkSemaphoreWaitInfo waitInfo{};
+			waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+			waitInfo.semaphoreCount = 1;
+			waitInfo.pSemaphores = &m_TimelineSemaphore;
+			waitInfo.pValues = &m_InFlight.front().timelineValue;
+
+			vkWaitSemaphores(deviceContext->GetLogicalDevice(), &waitInfo, UINT64_MAX);
+		}
+
+		uint64_t completedValue{ 0 };
+		vkGetSemaphoreCounterValue(deviceContext->GetLogicalDevice(), m_TimelineSemaphore, &completedValue);
+
+		// Batches finish in submission order
+		while (!m_InFlight.empty() && m_InFlight.front().timelineValue <= completedValue)
+		{
+			Batch& batch{ m_InFlight.front() };
+
+			m_StagingTail = std::max(m_StagingTail, batch.stagingEnd);
+			for (auto& b : batch.dedicatedStaging)
+			{
+				b.Destroy();
+			}
+			batch.dedicatedStaging.clear();
+
+			m_FreeCommandBuffers.emplace_back(batch.commandBuffer);
+			batch.commandBuffer = VK_NULL_HANDLE;
+
+			m_Finished.emplace_back(std::move(batch));
+			m_InFlight.pop_front();
+		}
+	}
+}
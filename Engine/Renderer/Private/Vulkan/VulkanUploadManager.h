@@ -0,0 +1,132 @@
+#ifndef MAUREN_VULKANUPLOADMANAGER_H
+#define MAUREN_VULKANUPLOADMANAGER_H
+
+#include "RendererPCH.h"
+#include "VulkanBuffer.h"
+#include "Assets/VulkanImage.h"
+
+#include <deque>
+#include <functional>
+
+namespace MauRen
+{
+	class VulkanCommandPoolManager;
+
+	/**
+	 * @brief Uploads buffers & textures on the transfer queue without stalling the CPU or the graphics queue.
+	 *
+	 * Data is copied into a persistent staging ring, the copies of a frame are recorded into one command buffer & submitted once as a batch.
+	 * Each batch signals the next value of a timeline semaphore. Once it is reached the staging space is reused
+	 * & the graphics side of the batch is recorded at the start of the next frame: queue family ownership acquires, mipmaps & final layouts.
+	 * The completion callbacks run right before that, whatever they bind can be used by anything recorded after RecordAcquires.
+	 *
+	 * Without a dedicated transfer family the graphics queue does the copies, the flow stays the same.
+	 */
+	class VulkanUploadManager final : public MauCor::Singleton<VulkanUploadManager>
+	{
+	public:
+		using CompletionCallback = std::function<void()>;
+
+		void Initialize();
+		// The device has to be idle, pending callbacks are dropped
+		void Destroy();
+
+		// dstStage & dstAccess are the first use on the graphics queue, the buffer has to be VK_SHARING_MODE_EXCLUSIVE
+		void UploadBuffer(void const* pData, VkDeviceSize size, VkBuffer dstBuffer, VkDeviceSize dstOffset,
+			VkPipelineStageFlags2 dstStage, VkAccessFlags2 dstAccess, CompletionCallback onComplete = {});
+		// Fills mip 0 with tightly packed pixels, the other mips are generated on the graphics queue
+		// The image has to be freshly created, its layout is tracked as VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL from here on
+		void UploadImage(void const* pPixels, VkDeviceSize size, VulkanImage& image, CompletionCallback onComplete = {});
+
+		// Submits the uploads queued since the last submit as one batch, called once a frame
+		void Submit();
+		// Collects the batches the transfer queue finished & runs their callbacks, the frame's fence has to be waited on
+		void BeginFrame();
+		// Records the graphics side of the batches BeginFrame collected, has to be before anything uses them & outside of rendering
+		void RecordAcquires(VkCommandBuffer commandBuffer);
+
+		// The frame's graphics submit waits on this semaphore for the value, makes the transfer writes visible
+		[[nodiscard]] VkSemaphore GetTimelineSemaphore() const noexcept { return m_TimelineSemaphore; }
+		[[nodiscard]] uint64_t GetAcquiredValue() const noexcept { return m_AcquiredValue; }
+
+		// Blocks until everything queued so far can be used, only meant for resources that are needed right away (default textures)
+		void Flush(VulkanCommandPoolManager const& cmdPoolManager);
+
+		VulkanUploadManager(VulkanUploadManager const&) = delete;
+		VulkanUploadManager(VulkanUploadManager&&) = delete;
+		VulkanUploadManager& operator=(VulkanUploadManager const&) = delete;
+		VulkanUploadManager& operator=(VulkanUploadManager const&&) = delete;
+
+	private:
+		friend class MauCor::Singleton<VulkanUploadManager>;
+		VulkanUploadManager() = default;
+		virtual ~VulkanUploadManager() override = default;
+
+		struct BufferAcquire final
+		{
+			VkBuffer buffer;
+			VkDeviceSize offset;
+			VkDeviceSize size;
+			VkPipelineStageFlags2 dstStage;
+			VkAccessFlags2 dstAccess;
+		};
+
+		struct Batch final
+		{
+			VkCommandBuffer commandBuffer{ VK_NULL_HANDLE };
+			uint64_t timelineValue{ 0 };
+			// Ring head after the batch's copies, everything before it is free once the batch finished
+			VkDeviceSize stagingEnd{ 0 };
+			// Uploads that didn't fit in the ring
+			std::vector<VulkanBuffer> dedicatedStaging{};
+
+			// Release barriers, recorded at the end of the transfer command buffer
+			std::vector<VkBufferMemoryBarrier2> bufferReleases{};
+			std::vector<VkImageMemoryBarrier2> imageReleases{};
+
+			std::vector<BufferAcquire> bufferAcquires{};
+			// Copies, views aren't used
+			std::vector<VulkanImage> imageAcquires{};
+			std::vector<CompletionCallback> callbacks{};
+		};
+
+		uint32_t m_GraphicsFamily{ 0 };
+		uint32_t m_TransferFamily{ 0 };
+		bool m_IsDedicated{ false };
+
+		VkCommandPool m_CommandPool{ VK_NULL_HANDLE };
+		std::vector<VkCommandBuffer> m_FreeCommandBuffers{};
+
+		VkSemaphore m_TimelineSemaphore{ VK_NULL_HANDLE };
+		uint64_t m_SubmittedValue{ 0 };
+		uint64_t m_AcquiredValue{ 0 };
+
+		VulkanMappedBuffer m_StagingBuffer{};
+		// Total bytes ever allocated & reclaimed, the ring offset is the value modulo the buffer size
+		VkDeviceSize m_StagingHead{ 0 };
+		VkDeviceSize m_StagingTail{ 0 };
+
+		// Being recorded, only has a command buffer once something was queued
+		Batch m_Recording{};
+		// Submitted, oldest first
+		std::deque<Batch> m_InFlight{};
+		// Finished on the transfer queue, waiting for the next BeginFrame
+		std::vector<Batch> m_Finished{};
+		// Collected by BeginFrame, waiting for RecordAcquires
+		std::vector<Batch> m_Acquiring{};
+
+		// Scratch buffers for RecordAcquires
+		std::vector<VkBufferMemoryBarrier2> m_BufferBarriers{};
+		std::vector<VkImageMemoryBarrier2> m_ImageBarriers{};
+
+		[[nodiscard]] VkCommandBuffer GetRecordingCommandBuffer();
+		// Copies the data into staging memory, returns the buffer & offset to copy from
+		[[nodiscard]] std::pair<VkBuffer, VkDeviceSize> Stage(void const* pData, VkDeviceSize size);
+		[[nodiscard]] bool TryAllocateStaging(VkDeviceSize size, VkDeviceSize& outOffset) noexcept;
+
+		// Moves the finished batches out of m_InFlight, waits for the oldest one first when wait is set
+		void RetireFinishedBatches(bool wait);
+	};
+}
+
+#endif
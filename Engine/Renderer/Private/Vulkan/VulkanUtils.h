@@ -77,6 +77,17 @@ namespace MauRen
 			pipelineLayout = VK_NULL_HANDLE;
 			return true;
 		}
+		inline bool SafeDestroy(VkDevice device, VkPipelineCache& pipelineCache, VkAllocationCallbacks const* pAllocator)
+		{
+			if (pipelineCache == VK_NULL_HANDLE)
+			{
+				return false;
+			}
+
+			vkDestroyPipelineCache(device, pipelineCache, pAllocator);
+			pipelineCache = VK_NULL_HANDLE;
+			return true;
+		}
 		inline bool SafeDestroy(VkDevice device, VkRenderPass& renderPass, VkAllocationCallbacks const* pAllocator)
 		{
 			if (renderPass == VK_NULL_HANDLE)
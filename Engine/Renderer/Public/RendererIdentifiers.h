@@ -17,6 +17,7 @@ namespace MauRen
 	uint32_t constexpr DEFAULT_MATERIAL_ID{ 0 };
 	uint32_t constexpr INVALID_MATERIAL_ID{ UINT32_MAX };
 	uint32_t constexpr INVALID_DRAW_COMMAND{ UINT32_MAX };
+	uint32_t constexpr INVALID_MESH_INSTANCE_ID{ UINT32_MAX };
 
 	uint32_t constexpr INVALID_SHADOW_MAP_ID{ 0 };
 }
@@ -4,6 +4,7 @@
 #include <glm/glm.hpp>
 
 #include "RendererIdentifiers.h"
+#include "Math/Bounds.h"
 
 /*
 DrawCommands
@@ -65,6 +66,8 @@ namespace MauRen
 
         uint32_t meshID;    // Easier to link back to the array that way (todo - could probably remove this)
         uint32_t flags;     // Unused for now (todo)
+
+        MauCor::AABB bounds; // Model space bounds of all submeshes
     };
 
 	// SubMesh data - on CPU onnly currently
@@ -76,6 +79,8 @@ namespace MauRen
         uint32_t  vertexCount;
 
 		uint32_t materialID;   // Material for this submesh
+
+        MauCor::AABB bounds;   // Model space bounds, used for culling
     };
 
     // (GPU-side resource - CPU copy)
@@ -1,6 +1,10 @@
 #ifndef MAUREN_RENDERER_H
 #define MAUREN_RENDERER_H
 
+#include <string>
+
+#include "Math/Bounds.h"
+
 namespace MauEng
 {
 	class Camera;
@@ -31,12 +35,26 @@ namespace MauRen
 		virtual void EndImGUIFrame() = 0;
 
 		virtual void ResizeWindow() = 0;
+		// Draw a mesh this frame only
 		virtual void QueueDraw(glm::mat4 const& transformMat, MauEng::CStaticMesh const& mesh) = 0;
-		virtual void UnloadMesh(uint32_t meshID) = 0;
-		virtual [[nodiscard]] uint32_t LoadOrGetMeshID(char const* path) = 0;
+
+		// Persistent mesh instances (render proxies), drawn every frame until they are destroyed
+		virtual [[nodiscard]] uint32_t CreateMeshInstance(glm::mat4 const& transformMat, uint32_t meshID) = 0;
+		virtual void UpdateMeshInstance(uint32_t instanceID, glm::mat4 const& transformMat) = 0;
+		virtual void DestroyMeshInstance(uint32_t instanceID) = 0;
+
+		// Every load adds useCount references to the mesh, UnloadMesh releases useCount of them
+		virtual void UnloadMesh(uint32_t meshID, uint32_t useCount = 1) = 0;
+		virtual [[nodiscard]] uint32_t LoadOrGetMeshID(char const* path, uint32_t useCount = 1) = 0;
+		// Path the mesh was loaded from, empty for unknown meshes
+		virtual [[nodiscard]] std::string GetMeshPath(uint32_t meshID) const = 0;
+		// Model space bounds of the mesh, invalid for unknown meshes
+		virtual [[nodiscard]] MauCor::AABB GetMeshBounds(uint32_t meshID) const = 0;
 
 		virtual void SetSceneAABBOverride(glm::vec3 const& min, glm::vec3 const& max) = 0;
-		virtual void PreLightQueue(glm::mat4 const& viewProj) = 0;
+		// Mesh instances outside the viewProj frustum are skipped by the camera passes this frame
+		// sceneBounds tightens the shadow fit to what is actually in view, ignored when invalid
+		virtual void PreLightQueue(glm::mat4 const& viewProj, MauCor::AABB const& sceneBounds = {}) = 0;
 		virtual uint32_t CreateLight() = 0;
 		virtual void QueueLight(MauEng::CLight const& light) = 0;
 
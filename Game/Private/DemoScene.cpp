@@ -22,6 +22,32 @@ namespace MauGam
 		TestLogCategory2.SetPriority(Debug);
 		ME_LOG(Debug, TestLogCategory2, "TEST CAT 02 - DEBUG");
 		ME_LOG(Warn, TestLogCategory2, "TEST CAT 02 - WARN");
+
+		using namespace MauEng;
+		// Input toggles the rotation, so it is handled first like before the scene had systems
+		AddMainThreadSystem("HandleInput", [this](ECS::ECSWorld&)
+			{
+				HandleInput();
+			});
+		AddSystem<ECS::Read<CStaticMesh>, ECS::Write<CTransform>>("RotateScene", [this](ECS::ECSWorld& world)
+			{
+				bool const shouldSceneRotate{	m_Demo == EDemo::Chess or
+												m_Demo == EDemo::FlightHelmet or
+												m_Demo == EDemo::InstanceTest or
+												m_Demo == EDemo::DebugRendering};
+
+				if (not m_Rotate or not shouldSceneRotate)
+				{
+					return;
+				}
+
+				float const rotationSpeed{ m_Demo == EDemo::InstanceTest ? 90.f : 15.f };
+				MauCor::Rotator const rot{ 0, rotationSpeed * TIME.ElapsedSec() };
+				world.View<CStaticMesh, CTransform>().ParallelEach([&rot](CStaticMesh const&, CTransform& t)
+					{
+						t.Rotate(rot);
+					});
+			});
 	}
 
 	void DemoScene::OnLoad()
@@ -332,16 +358,18 @@ namespace MauGam
 			float constexpr FISH_SCALE_MAX{ 20.f };
 			std::uniform_real_distribution<float> disScale(FISH_SCALE_MIN, FISH_SCALE_MAX);
 
-			for (size_t i{ 0 }; i < NUM_INSTANCES; i++)
+			std::vector<CTransform> fishTransforms(NUM_INSTANCES);
+			for (auto& transform : fishTransforms)
 			{
 				float const fishScale{ disScale(gen) };
-				Entity entFish{ CreateEntity() };
-				auto& transform{ entFish.GetComponent<CTransform>() };
 				transform.Translate({ dis(gen), dis(gen), dis(gen) });
 				transform.Scale({ fishScale, fishScale, fishScale });
-				entFish.AddComponent<CStaticMesh>("Resources/Models/BarramundiFish/glTF/BarramundiFish.gltf");
 			}
 
+			Prefab fishPrefab{};
+			fishPrefab.SetMesh("Resources/Models/BarramundiFish/glTF/BarramundiFish.gltf");
+			Instantiate(fishPrefab, NUM_INSTANCES, fishTransforms);
+
 			{
 				Entity enttDirLight{ CreateEntity() };
 				auto& cLight{ enttDirLight.AddComponent<CLight>() };
@@ -404,41 +432,6 @@ namespace MauGam
 			entFish.Destroy();
 		}
 		didOnce = true;
-
-
-		HandleInput();
-
-		bool const shouldSceneRotate{	m_Demo == EDemo::Chess or
-										m_Demo == EDemo::FlightHelmet or
-										m_Demo == EDemo::InstanceTest or
-										m_Demo == EDemo::DebugRendering};
-
-		if (m_Rotate and shouldSceneRotate)
-		{
-			if (m_Demo == EDemo::InstanceTest)
-			{
-				using namespace MauEng;
-				float constexpr ROTATION_SPEED{ 90.f };
-				MauCor::Rotator const rot{ 0, ROTATION_SPEED * TIME.ElapsedSec() };
-				auto view{ GetECSWorld().View<CStaticMesh, CTransform>() };
-				view.Each([&rot](CStaticMesh const& m, CTransform& t)
-					{
-						t.Rotate(rot);
-					}, std::execution::par_unseq);
-			}
-			else
-			{
-				using namespace MauEng;
-				float constexpr ROTATION_SPEED{ 15.f };
-				MauCor::Rotator const rot{ 0, ROTATION_SPEED * TIME.ElapsedSec() };
-				auto view{ GetECSWorld().View<CStaticMesh, CTransform>() };
-				view.Each([&rot](CStaticMesh const& m, CTransform& t)
-					{
-						t.Rotate(rot);
-					}, std::execution::par_unseq);
-			}
-		}
-
 	}
 
 	void DemoScene::OnRender() const
@@ -0,0 +1,112 @@
+// Compares the AoS CTransform matrix update with the SoA store & its SIMD kernels
+// Run a release build, results are printed per entity count
+
+#include "Components/CTransform.h"
+#include "Math/TransformSoA.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace
+{
+	// Every case builds roughly this many matrices, so small counts are repeated often enough to be measurable
+	std::size_t constexpr MATRICES_PER_CASE{ 20'000'000 };
+
+	// Prevents the compiler from optimising unused results away
+	float g_Sink{ 0.f };
+
+	template<typename Func>
+	void RunCase(char const* name, std::size_t count, Func&& func)
+	{
+		std::size_t const iterations{ std::max<std::size_t>(MATRICES_PER_CASE / count, 5) };
+
+		// Warm up caches & the job system's workers
+		func();
+
+		double bestMs{ std::numeric_limits<double>::max() };
+		for (std::size_t i{ 0 }; i < iterations; ++i)
+		{
+			auto const start{ std::chrono::steady_clock::now() };
+			func();
+			auto const end{ std::chrono::steady_clock::now() };
+
+			bestMs = std::min(bestMs, std::chrono::duration<double, std::milli>(end - start).count());
+		}
+
+		double const nsPerMatrix{ bestMs * 1'000'000.0 / static_cast<double>(count) };
+		std::cout << "  " << name << ": " << bestMs << " ms (" << nsPerMatrix << " ns/matrix)\n";
+	}
+
+	void RunBenchmark(std::size_t count)
+	{
+		std::cout << count << " transforms\n";
+
+		std::mt19937 rng{ 42 };
+		std::uniform_real_distribution<float> position{ -100.f, 100.f };
+		std::uniform_real_distribution<float> angle{ -180.f, 180.f };
+		std::uniform_real_distribution<float> scale{ 0.5f, 2.f };
+
+		std::vector<MauEng::CTransform> aos(count);
+		MauCor::TransformSoA soa;
+		soa.Reserve(count);
+
+		for (auto& t : aos)
+		{
+			t.translation = { position(rng), position(rng), position(rng) };
+			t.rotation = MauCor::Rotator{ angle(rng), angle(rng), angle(rng) };
+			t.scale = { scale(rng), scale(rng), scale(rng) };
+
+			soa.Add(t.translation, t.rotation, t.scale);
+		}
+
+		std::vector<glm::mat4> matrices(count);
+
+		// Current path, every transform dirty
+		RunCase("AoS CTransform::UpdateMatrix", count, [&]()
+			{
+				for (auto& t : aos)
+				{
+					t.isDirty = true;
+					t.UpdateMatrix();
+				}
+				g_Sink += aos.back().mat[3][0];
+			});
+
+		auto const runKernel{ [&](MauCor::ESIMDLevel level)
+			{
+				MauCor::ComposeTRSMatrices(soa.Streams(), reinterpret_cast<float*>(matrices.data()), 0, count, level);
+				g_Sink += matrices.back()[3][0];
+			} };
+
+		RunCase("SoA scalar", count, [&]() { runKernel(MauCor::ESIMDLevel::Scalar); });
+		RunCase("SoA SSE (4 wide)", count, [&]() { runKernel(MauCor::ESIMDLevel::SSE); });
+		if (MauCor::GetSupportedSIMDLevel() >= MauCor::ESIMDLevel::AVX2)
+		{
+			RunCase("SoA AVX2 (8 wide)", count, [&]() { runKernel(MauCor::ESIMDLevel::AVX2); });
+		}
+
+		RunCase("SoA best SIMD + job system", count, [&]()
+			{
+				soa.ComputeMatrices(matrices);
+				g_Sink += matrices.back()[3][0];
+			});
+
+		std::cout << '\n';
+	}
+}
+
+int main()
+{
+	for (std::size_t const count : { 10'000u, 100'000u, 1'000'000u })
+	{
+		RunBenchmark(count);
+	}
+
+	// Print the sink so the work can't be discarded
+	std::cout << "checksum " << g_Sink << '\n';
+	return 0;
+}
@@ -0,0 +1,74 @@
+#include <doctest/doctest.h>
+#include "CommandBuffer.h"
+#include "Entity.h"
+#include "Components/CStaticMesh.h"
+
+namespace
+{
+	struct CTag final
+	{
+		uint32_t value{ 0 };
+	};
+}
+
+TEST_CASE("ECS CommandBuffer Playback")
+{
+	MauEng::ECS::ECSWorld world;
+	MauEng::ECS::CommandBuffer commands;
+
+	auto const existing{ world.CreateEntity() };
+
+	// Record from the job system's workers while nothing touches the world
+	JOB_SYSTEM.ParallelFor(100, 10, [&commands](std::size_t begin, std::size_t end)
+		{
+			for (std::size_t i{ begin }; i < end; ++i)
+			{
+				commands.CreateEntity([i](MauEng::ECS::ECSWorld& w, MauEng::ECS::EntityID id)
+					{
+						w.AddComponent<CTag>(id, static_cast<uint32_t>(i));
+					});
+			}
+		});
+
+	commands.AddComponent<CTag>(existing, 1000u);
+	commands.DestroyEntity(existing);
+	// Skipped, the entity is gone by the time this is played back
+	commands.AddComponent<CTag>(existing, 2000u);
+
+	CHECK(world.ComponentCount<CTag>() == 0);
+	CHECK_FALSE(commands.Empty());
+
+	commands.Playback(world);
+
+	CHECK(commands.Empty());
+	CHECK_FALSE(world.IsValid(existing));
+	CHECK(world.ComponentCount<CTag>() == 100);
+}
+
+TEST_CASE("ECS CommandBuffer Deferred Destroy Teardown")
+{
+	using namespace MauEng;
+
+	ECS::ECSWorld world;
+	// The teardown the scene's command buffer uses
+	ECS::CommandBuffer commands{ [](ECS::ECSWorld& w, ECS::EntityID id) { Entity{ &w, id }.Destroy(); } };
+
+	uint32_t unloadedMeshes{ 0 };
+	world.RegisterPreRemoveCallback<CStaticMesh>([&unloadedMeshes](CStaticMesh const&, ECS::EntityID)
+		{
+			++unloadedMeshes;
+		});
+
+	Entity const parent{ &world, world.CreateEntity() };
+	Entity child{ &world, world.CreateEntity() };
+	world.AddComponent<CStaticMesh>(parent.ID(), 1u);
+	world.AddComponent<CStaticMesh>(child.ID(), 2u);
+	child.SetParent(parent);
+
+	commands.DestroyEntity(parent.ID());
+	commands.Playback(world);
+
+	CHECK_FALSE(world.IsValid(parent.ID()));
+	CHECK_FALSE(world.IsValid(child.ID()));
+	CHECK(unloadedMeshes == 2);
+}
@@ -0,0 +1,61 @@
+#include <doctest/doctest.h>
+#include "ECSWorld.h"
+
+namespace
+{
+	struct CHealth final
+	{
+		int health{ 100 };
+	};
+}
+
+TEST_CASE("ECSWorld Reactive Sets")
+{
+	MauEng::ECS::ECSWorld world;
+
+	auto& constructed{ world.OnConstruct<CHealth>() };
+	auto& updated{ world.OnUpdate<CHealth>() };
+
+	auto const a{ world.CreateEntity() };
+	auto const b{ world.CreateEntity() };
+	world.AddComponent<CHealth>(a);
+	world.AddComponent<CHealth>(b);
+
+	CHECK(constructed.Size() == 2);
+	CHECK(constructed.Contains(a));
+	CHECK(updated.Empty());
+
+	constructed.Clear();
+
+	SUBCASE("Patch and replace are recorded once per entity")
+	{
+		world.Patch<CHealth>(a, [](CHealth& h) { h.health -= 10; });
+		world.Patch<CHealth>(a, [](CHealth& h) { h.health -= 10; });
+		world.ReplaceComponent<CHealth>(b, 50);
+
+		CHECK(world.GetComponent<CHealth>(a).health == 80);
+		CHECK(updated.Size() == 2);
+		CHECK(updated.Contains(a));
+		CHECK(updated.Contains(b));
+		CHECK(constructed.Empty());
+	}
+
+	SUBCASE("Removed components leave the sets")
+	{
+		world.Patch<CHealth>(a, [](CHealth& h) { h.health = 0; });
+		world.DestroyEntity(a);
+
+		CHECK_FALSE(updated.Contains(a));
+		CHECK(updated.Empty());
+	}
+
+	SUBCASE("Clearing the world clears every set")
+	{
+		world.Patch<CHealth>(a, [](CHealth& h) { h.health = 0; });
+		world.AddComponent<CHealth>(world.CreateEntity());
+		world.ClearReactiveSets();
+
+		CHECK(constructed.Empty());
+		CHECK(updated.Empty());
+	}
+}
@@ -0,0 +1,74 @@
+#include <doctest/doctest.h>
+#include "SystemScheduler.h"
+
+#include <atomic>
+
+namespace
+{
+	struct CPosition final
+	{
+		float x{ 0.f };
+	};
+
+	struct CVelocity final
+	{
+		float x{ 0.f };
+	};
+
+	struct CHealth final
+	{
+		uint32_t health{ 100 };
+	};
+}
+
+TEST_CASE("ECS SystemScheduler Ordering")
+{
+	using namespace MauEng::ECS;
+
+	ECSWorld world;
+	std::vector<EntityID> entities(64);
+	world.CreateEntities(entities.size(), entities);
+	world.Insert<CPosition>(entities, CPosition{});
+	world.Insert<CVelocity>(entities, CVelocity{ 1.f });
+	world.Insert<CHealth>(entities, CHealth{});
+
+	SystemScheduler scheduler;
+
+	scheduler.AddSystem<Read<>, Write<CVelocity>>("Accelerate", [](ECSWorld& w)
+		{
+			w.View<CVelocity>().Each([](CVelocity& v) { v.x *= 2.f; });
+		});
+
+	// Conflicts with Accelerate, so it has to see the doubled velocity
+	scheduler.AddSystem<Read<CVelocity>, Write<CPosition>>("Move", [](ECSWorld& w)
+		{
+			w.View<CVelocity, CPosition>().Each([](CVelocity const& v, CPosition& p) { p.x += v.x; });
+		});
+
+	// Independent of both, may run next to them
+	std::atomic<uint32_t> damaged{ 0 };
+	scheduler.AddSystem<Read<>, Write<CHealth>>("Damage", [&damaged](ECSWorld& w)
+		{
+			w.View<CHealth>().Each([&damaged](CHealth& h) { h.health -= 10; ++damaged; });
+		});
+
+	// Barrier, everything before it is done
+	float positionSum{ 0.f };
+	scheduler.AddMainThreadSystem("Gather", [&positionSum](ECSWorld& w)
+		{
+			positionSum = 0.f;
+			w.View<CPosition>().Each([&positionSum](CPosition const& p) { positionSum += p.x; });
+		});
+
+	CHECK(scheduler.SystemCount() == 4);
+
+	scheduler.Run(world);
+	CHECK(positionSum == doctest::Approx(64.f * 2.f));
+	CHECK(damaged == 64);
+
+	scheduler.Run(world);
+	CHECK(positionSum == doctest::Approx(64.f * (2.f + 4.f)));
+	CHECK(damaged == 128);
+
+	world.View<CHealth>().Each([](CHealth const& h) { CHECK(h.health == 80); });
+}
@@ -0,0 +1,173 @@
+#include <doctest/doctest.h>
+#include "WorldSnapshot.h"
+
+#include <cstdio>
+#include <fstream>
+
+namespace
+{
+	struct CVelocity final
+	{
+		float x{ 0.f };
+		float y{ 0.f };
+		float z{ 0.f };
+	};
+
+	struct CTeam final
+	{
+		uint32_t team{ 0 };
+	};
+
+	struct CModel final
+	{
+		std::string path{};
+	};
+}
+
+TEST_CASE("ECS WorldSnapshot Round Trip")
+{
+	char const* path{ "TestWorldSnapshot.bin" };
+
+	MauEng::ECS::WorldSnapshot layout;
+	layout.RegisterComponent<CVelocity>("CVelocity");
+	layout.RegisterComponent<CTeam>("CTeam");
+
+	{
+		MauEng::ECS::ECSWorld world;
+		std::vector<MauEng::ECS::EntityID> entities(3);
+		world.CreateEntities(entities.size(), entities);
+
+		world.AddComponent<CVelocity>(entities[0], 1.f, 2.f, 3.f);
+		world.AddComponent<CVelocity>(entities[1], 4.f, 5.f, 6.f);
+		world.AddComponent<CTeam>(entities[1], 7u);
+		world.AddComponent<CTeam>(entities[2], 8u);
+
+		REQUIRE(layout.Save(world, path));
+	}
+
+	MauEng::ECS::ECSWorld loaded;
+	std::vector<MauEng::ECS::EntityID> entities;
+	REQUIRE(layout.Load(loaded, path, &entities));
+
+	CHECK(entities.size() == 3);
+	CHECK(loaded.ComponentCount<CVelocity>() == 2);
+	CHECK(loaded.ComponentCount<CTeam>() == 2);
+
+	float velocitySum{ 0.f };
+	uint32_t teamSum{ 0 };
+	loaded.View<CVelocity>().Each([&](CVelocity const& v) { velocitySum += v.x + v.y + v.z; });
+	loaded.View<CTeam>().Each([&](CTeam const& t) { teamSum += t.team; });
+
+	CHECK(velocitySum == doctest::Approx(21.f));
+	CHECK(teamSum == 15);
+
+	// Components that were on the same entity still are
+	std::size_t bothCount{ 0 };
+	loaded.View<CVelocity, CTeam>().Each([&](CVelocity const& v, CTeam const& t)
+		{
+			CHECK(v.x == doctest::Approx(4.f));
+			CHECK(t.team == 7);
+			++bothCount;
+		});
+	CHECK(bothCount == 1);
+
+	std::remove(path);
+}
+
+TEST_CASE("ECS WorldSnapshot Prepare & Bulk Destroy")
+{
+	char const* path{ "TestWorldSnapshotPrepared.bin" };
+
+	MauEng::ECS::WorldSnapshot layout;
+	layout.RegisterComponent<CTeam>("CTeam");
+
+	{
+		MauEng::ECS::ECSWorld world;
+		std::vector<MauEng::ECS::EntityID> entities(4);
+		world.CreateEntities(entities.size(), entities);
+		world.Insert<CTeam>(entities, CTeam{ 3u });
+
+		REQUIRE(layout.Save(world, path));
+	}
+
+	MauEng::ECS::PreparedSnapshot prepared;
+	REQUIRE(layout.Prepare(path, prepared));
+	CHECK(prepared.IsValid());
+	CHECK(prepared.EntityCount() == 4);
+
+	// A prepared snapshot can be instantiated more than once
+	MauEng::ECS::ECSWorld world;
+	std::vector<MauEng::ECS::EntityID> first;
+	std::vector<MauEng::ECS::EntityID> second;
+	layout.Instantiate(world, prepared, &first);
+	layout.Instantiate(world, prepared, &second);
+
+	CHECK(world.ComponentCount<CTeam>() == 8);
+
+	world.DestroyEntities(first);
+	CHECK(world.ComponentCount<CTeam>() == 4);
+	for (auto const id : first)
+	{
+		CHECK_FALSE(world.IsValid(id));
+	}
+	for (auto const id : second)
+	{
+		CHECK(world.IsValid(id));
+	}
+
+	MauEng::ECS::PreparedSnapshot missing;
+	CHECK_FALSE(layout.Prepare("DoesNotExist.bin", missing));
+	CHECK_FALSE(missing.IsValid());
+
+	std::remove(path);
+}
+
+TEST_CASE("ECS WorldSnapshot Malformed Asset Block")
+{
+	char const* path{ "TestWorldSnapshotMalformed.bin" };
+
+	MauEng::ECS::WorldSnapshot layout;
+	layout.RegisterAssetComponent<CModel>("CModel",
+		[](CModel const& model) { return model.path; },
+		[](MauEng::ECS::ECSWorld& world, std::string const& assetPath, std::span<MauEng::ECS::EntityID const> entities)
+		{
+			for (auto const id : entities)
+			{
+				world.AddComponent<CModel>(id, assetPath);
+			}
+		});
+
+	{
+		MauEng::ECS::ECSWorld world;
+		std::vector<MauEng::ECS::EntityID> entities(2);
+		world.CreateEntities(entities.size(), entities);
+		world.AddComponent<CModel>(entities[0], "A");
+		world.AddComponent<CModel>(entities[1], "B");
+
+		REQUIRE(layout.Save(world, path));
+	}
+
+	{
+		MauEng::ECS::ECSWorld loaded;
+		REQUIRE(layout.Load(loaded, path));
+		CHECK(loaded.ComponentCount<CModel>() == 2);
+	}
+
+	// The only block's componentSize, after the 32 byte file header, the type hash & the isAsset flag
+	{
+		std::fstream file{ path, std::ios::binary | std::ios::in | std::ios::out };
+		REQUIRE(file);
+		uint32_t const componentSize{ 0 };
+		file.seekp(32 + sizeof(uint64_t) + sizeof(uint32_t));
+		file.write(reinterpret_cast<char const*>(&componentSize), sizeof(componentSize));
+	}
+
+	// The block is skipped instead of reading its path indices past the block
+	MauEng::ECS::ECSWorld loaded;
+	std::vector<MauEng::ECS::EntityID> entities;
+	REQUIRE(layout.Load(loaded, path, &entities));
+	CHECK(entities.size() == 2);
+	CHECK(loaded.ComponentCount<CModel>() == 0);
+
+	std::remove(path);
+}
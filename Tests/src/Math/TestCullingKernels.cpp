@@ -0,0 +1,71 @@
+#include "doctest/doctest.h"
+#include "Math/AABBSoA.h"
+
+#include <random>
+#include <vector>
+
+namespace
+{
+	void CheckMatchesFrustumTest(MauCor::ESIMDLevel level)
+	{
+		std::mt19937 rng{ 3 };
+		std::uniform_real_distribution<float> position{ -50.f, 50.f };
+		std::uniform_real_distribution<float> size{ .01f, 6.f };
+
+		// Not a multiple of 8, so the scalar tail is tested as well
+		std::vector<MauCor::AABB> boxes{};
+		MauCor::AABBSoA soa{};
+		for (uint32_t i{ 0 }; i < 1003; ++i)
+		{
+			glm::vec3 const center{ position(rng), position(rng), position(rng) };
+			glm::vec3 const extents{ size(rng), size(rng), size(rng) };
+			boxes.push_back({ center - extents, center + extents });
+			soa.Add(boxes.back());
+		}
+
+		// Orthographic box, shifted along x so boxes on both sides get culled
+		glm::mat4 viewProj{ 1.f };
+		viewProj[0][0] = .05f;
+		viewProj[1][1] = .08f;
+		viewProj[2][2] = .01f;
+		viewProj[3][0] = .2f;
+		viewProj[3][2] = .5f;
+		MauCor::Frustum const frustum{ MauCor::Frustum::FromViewProjection(viewProj) };
+
+		// Start off the SIMD alignment as well
+		for (std::size_t const begin : { std::size_t{ 0 }, std::size_t{ 3 } })
+		{
+			std::vector<uint32_t> visible(boxes.size());
+			visible.resize(MauCor::CullAABBs(frustum, soa.Streams(), visible.data(), begin, boxes.size(), level));
+
+			std::vector<uint32_t> expected{};
+			for (std::size_t i{ begin }; i < boxes.size(); ++i)
+			{
+				if (frustum.Intersects(boxes[i]))
+				{
+					expected.emplace_back(static_cast<uint32_t>(i));
+				}
+			}
+
+			CHECK(!expected.empty());
+			CHECK(expected.size() < boxes.size() - begin);
+			CHECK(visible == expected);
+		}
+	}
+}
+
+TEST_CASE("Frustum Culling Scalar")
+{
+	CheckMatchesFrustumTest(MauCor::ESIMDLevel::Scalar);
+}
+
+TEST_CASE("Frustum Culling SSE")
+{
+	CheckMatchesFrustumTest(MauCor::ESIMDLevel::SSE);
+}
+
+TEST_CASE("Frustum Culling AVX2")
+{
+	// Falls back to the best supported level on older CPUs
+	CheckMatchesFrustumTest(MauCor::ESIMDLevel::AVX2);
+}
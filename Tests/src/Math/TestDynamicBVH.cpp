@@ -0,0 +1,138 @@
+#include "doctest/doctest.h"
+#include "Math/DynamicBVH.h"
+
+#include <algorithm>
+#include <map>
+#include <random>
+#include <vector>
+
+namespace
+{
+	MauCor::AABB RandomBox(std::mt19937& rng)
+	{
+		std::uniform_real_distribution<float> position{ -100.f, 100.f };
+		std::uniform_real_distribution<float> size{ 0.1f, 5.f };
+
+		glm::vec3 const center{ position(rng), position(rng), position(rng) };
+		glm::vec3 const extents{ size(rng), size(rng), size(rng) };
+		return { center - extents, center + extents };
+	}
+
+	template<typename Query>
+	std::vector<int32_t> Collect(Query&& query)
+	{
+		std::vector<int32_t> result{};
+		query([&result](int32_t proxyID) { result.emplace_back(proxyID); });
+		std::ranges::sort(result);
+		return result;
+	}
+}
+
+TEST_CASE("DynamicBVH Queries Match Brute Force")
+{
+	std::mt19937 rng{ 1 };
+	MauCor::DynamicBVH bvh{};
+	std::map<int32_t, MauCor::AABB> boxes{};
+
+	// Add, move & remove at random so the tree goes through plenty of reinserts & rotations
+	for (uint32_t i{ 0 }; i < 4000; ++i)
+	{
+		uint32_t const op{ rng() % 4 };
+		if (op < 2 || boxes.size() < 10)
+		{
+			MauCor::AABB const box{ RandomBox(rng) };
+			boxes[bvh.CreateProxy(box, i)] = box;
+		}
+		else
+		{
+			auto it{ boxes.begin() };
+			std::advance(it, rng() % boxes.size());
+
+			if (op == 2)
+			{
+				bvh.DestroyProxy(it->first);
+				boxes.erase(it);
+			}
+			else
+			{
+				glm::vec3 const offset{ static_cast<float>(rng() % 5), 0.f, -1.f };
+				it->second = { it->second.min + offset, it->second.max + offset };
+				bvh.MoveProxy(it->first, it->second);
+			}
+		}
+	}
+
+	REQUIRE(bvh.ProxyCount() == boxes.size());
+	// Balanced, a degenerate tree would be as high as it has proxies
+	CHECK(bvh.Height() < 32);
+
+	for (auto const& [proxyID, box] : boxes)
+	{
+		CHECK(bvh.GetFatAABB(proxyID).Contains(box));
+	}
+
+	for (uint32_t q{ 0 }; q < 50; ++q)
+	{
+		MauCor::AABB const queryBox{ RandomBox(rng).Fattened(10.f) };
+		auto const hits{ Collect([&](auto&& func) { bvh.Query(queryBox, func); }) };
+
+		for (auto const& [proxyID, box] : boxes)
+		{
+			if (queryBox.Overlaps(box))
+			{
+				CHECK(std::ranges::binary_search(hits, proxyID));
+			}
+		}
+		// Every proxy is reported once
+		CHECK(std::ranges::adjacent_find(hits) == hits.end());
+
+		MauCor::BoundingSphere const sphere{ queryBox.Center(), 20.f };
+		auto const sphereHits{ Collect([&](auto&& func) { bvh.Query(sphere, func); }) };
+		for (auto const& [proxyID, box] : boxes)
+		{
+			if (sphere.Overlaps(box))
+			{
+				CHECK(std::ranges::binary_search(sphereHits, proxyID));
+			}
+		}
+	}
+}
+
+TEST_CASE("DynamicBVH Frustum & Ray")
+{
+	MauCor::DynamicBVH bvh{};
+	// A row of unit boxes along +x
+	for (int32_t i{ 0 }; i < 20; ++i)
+	{
+		float const x{ static_cast<float>(i) * 4.f };
+		(void)bvh.CreateProxy({ glm::vec3{ x - .5f, -.5f, -.5f }, glm::vec3{ x + .5f, .5f, .5f } }, static_cast<uint32_t>(i));
+	}
+
+	// Orthographic box covering x in [-10, 10], y & z in [-10, 10]
+	glm::mat4 viewProj{ 1.f };
+	viewProj[0][0] = .1f;
+	viewProj[1][1] = .1f;
+	viewProj[2][2] = .05f;
+	viewProj[3][2] = .5f;
+
+	auto const visible{ Collect([&](auto&& func) { bvh.Query(MauCor::Frustum::FromViewProjection(viewProj), func); }) };
+	std::vector<uint32_t> visibleUserData{};
+	for (int32_t const proxyID : visible)
+	{
+		visibleUserData.emplace_back(bvh.GetUserData(proxyID));
+	}
+	std::ranges::sort(visibleUserData);
+	CHECK(visibleUserData == std::vector<uint32_t>{ 0, 1, 2 });
+
+	// Keep only the closest hit
+	MauCor::Ray const ray{ glm::vec3{ 100.f, 0.f, 0.f }, glm::vec3{ -1.f, 0.f, 0.f } };
+	uint32_t closest{ UINT32_MAX };
+	bvh.Raycast(ray, 1000.f, [&](int32_t proxyID, float)
+		{
+			float distance{ 0.f };
+			(void)ray.Intersects(bvh.GetFatAABB(proxyID), 1000.f, distance);
+			closest = bvh.GetUserData(proxyID);
+			return distance;
+		});
+	CHECK(closest == 19);
+}
@@ -0,0 +1,134 @@
+#include "doctest/doctest.h"
+#include "Math/OffsetAllocator.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+TEST_CASE("OffsetAllocator hands out ranges back to back")
+{
+	MauCor::OffsetAllocator allocator{ 1024, 64 };
+
+	auto const a{ allocator.Allocate(100) };
+	auto const b{ allocator.Allocate(200) };
+	auto const c{ allocator.Allocate(300) };
+
+	REQUIRE(a.IsValid());
+	REQUIRE(b.IsValid());
+	REQUIRE(c.IsValid());
+
+	CHECK(a.offset == 0);
+	CHECK(b.offset == 100);
+	CHECK(c.offset == 300);
+	CHECK(allocator.GetAllocationSize(b) == 200);
+	CHECK(allocator.GetStorageReport().totalFreeSpace == 1024 - 600);
+}
+
+TEST_CASE("OffsetAllocator merges freed neighbours")
+{
+	MauCor::OffsetAllocator allocator{ 1024, 64 };
+
+	auto const a{ allocator.Allocate(256) };
+	auto const b{ allocator.Allocate(256) };
+	auto const c{ allocator.Allocate(256) };
+	auto const d{ allocator.Allocate(256) };
+
+	CHECK_FALSE(allocator.Allocate(1).IsValid());
+
+	allocator.Free(a);
+	allocator.Free(c);
+	// Two separate holes, neither fits 512
+	CHECK(allocator.GetStorageReport().largestFreeRegion == 256);
+	CHECK_FALSE(allocator.Allocate(512).IsValid());
+
+	allocator.Free(b);
+	CHECK(allocator.GetStorageReport().largestFreeRegion == 768);
+
+	auto const e{ allocator.Allocate(768) };
+	REQUIRE(e.IsValid());
+	CHECK(e.offset == 0);
+
+	allocator.Free(d);
+	allocator.Free(e);
+
+	auto const report{ allocator.GetStorageReport() };
+	CHECK(report.totalFreeSpace == 1024);
+	CHECK(report.largestFreeRegion == 1024);
+}
+
+TEST_CASE("OffsetAllocator fails without space or nodes")
+{
+	MauCor::OffsetAllocator allocator{ 1000, 4 };
+
+	CHECK_FALSE(allocator.Allocate(0).IsValid());
+	CHECK_FALSE(allocator.Allocate(1001).IsValid());
+
+	std::vector<MauCor::OffsetAllocator::Allocation> allocations{};
+	for (uint32_t i{ 0 }; i < 8; ++i)
+	{
+		if (auto const allocation{ allocator.Allocate(10) }; allocation.IsValid())
+		{
+			allocations.emplace_back(allocation);
+		}
+	}
+	CHECK(allocations.size() <= 4);
+
+	for (auto const& allocation : allocations)
+	{
+		allocator.Free(allocation);
+	}
+	CHECK(allocator.GetStorageReport().largestFreeRegion == 1000);
+
+	CHECK(allocator.Allocate(500).IsValid());
+	allocator.Reset();
+	CHECK(allocator.Allocate(1000).offset == 0);
+}
+
+TEST_CASE("OffsetAllocator never overlaps allocations")
+{
+	uint32_t constexpr SIZE{ 1 << 20 };
+	MauCor::OffsetAllocator allocator{ SIZE, 4096 };
+
+	std::mt19937 rng{ 1337 };
+	std::uniform_int_distribution<uint32_t> sizeDist{ 1, 20000 };
+
+	std::vector<MauCor::OffsetAllocator::Allocation> live{};
+	std::vector<uint8_t> owned(SIZE, 0);
+
+	for (uint32_t i{ 0 }; i < 20000; ++i)
+	{
+		if (live.empty() || rng() % 3 != 0)
+		{
+			uint32_t const size{ sizeDist(rng) };
+			auto const allocation{ allocator.Allocate(size) };
+			if (!allocation.IsValid())
+			{
+				continue;
+			}
+
+			REQUIRE(allocation.offset + size <= SIZE);
+			REQUIRE(std::none_of(begin(owned) + allocation.offset, begin(owned) + allocation.offset + size, [](uint8_t o) { return o != 0; }));
+			std::fill_n(begin(owned) + allocation.offset, size, uint8_t{ 1 });
+			live.emplace_back(allocation);
+		}
+		else
+		{
+			std::size_t const idx{ rng() % live.size() };
+			auto const allocation{ live[idx] };
+			std::fill_n(begin(owned) + allocation.offset, allocator.GetAllocationSize(allocation), uint8_t{ 0 });
+			allocator.Free(allocation);
+
+			live[idx] = live.back();
+			live.pop_back();
+		}
+	}
+
+	uint32_t const used{ static_cast<uint32_t>(std::count(begin(owned), end(owned), uint8_t{ 1 })) };
+	CHECK(allocator.GetStorageReport().totalFreeSpace == SIZE - used);
+
+	for (auto const& allocation : live)
+	{
+		allocator.Free(allocation);
+	}
+	CHECK(allocator.GetStorageReport().largestFreeRegion == SIZE);
+}
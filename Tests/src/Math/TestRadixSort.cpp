@@ -0,0 +1,64 @@
+#include "doctest/doctest.h"
+#include "Math/RadixSort.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+namespace
+{
+	void CheckMatchesStableSort(std::vector<uint64_t> keys)
+	{
+		std::vector<uint32_t> values(keys.size());
+		for (uint32_t i{ 0 }; i < values.size(); ++i)
+		{
+			values[i] = i;
+		}
+
+		// Ties keep their original order, so the values give the exact expected result
+		std::vector<uint32_t> expected{ values };
+		std::stable_sort(begin(expected), end(expected), [&keys](uint32_t a, uint32_t b) { return keys[a] < keys[b]; });
+
+		std::vector<uint64_t> keyScratch{};
+		std::vector<uint32_t> valueScratch{};
+		MauCor::RadixSort(keys, values, keyScratch, valueScratch);
+
+		CHECK(std::is_sorted(begin(keys), end(keys)));
+		CHECK(values == expected);
+	}
+}
+
+TEST_CASE("Radix Sort Full Keys")
+{
+	std::mt19937_64 rng{ 7 };
+
+	std::vector<uint64_t> keys(5000);
+	for (auto& key : keys)
+	{
+		key = rng();
+	}
+
+	CheckMatchesStableSort(keys);
+}
+
+TEST_CASE("Radix Sort Narrow Keys With Ties")
+{
+	std::mt19937_64 rng{ 11 };
+
+	// Only a few distinct keys spread over the high & low bytes, most passes are skipped
+	std::vector<uint64_t> keys(1000);
+	for (auto& key : keys)
+	{
+		uint64_t const value{ rng() % 5 };
+		key = (value << 56) | (value * 3);
+	}
+
+	CheckMatchesStableSort(keys);
+}
+
+TEST_CASE("Radix Sort Trivial Inputs")
+{
+	CheckMatchesStableSort({});
+	CheckMatchesStableSort({ 42 });
+	CheckMatchesStableSort({ 9, 9, 9 });
+}
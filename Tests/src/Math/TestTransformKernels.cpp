@@ -0,0 +1,62 @@
+#include "doctest/doctest.h"
+#include "Math/TransformSoA.h"
+#include <glm/gtc/epsilon.hpp>
+
+namespace
+{
+	void CheckMatchesGLM(MauCor::ESIMDLevel level)
+	{
+		MauCor::TransformSoA soa;
+		// Not a multiple of 8, so the scalar tail is tested as well
+		for (uint32_t i{ 0 }; i < 21; ++i)
+		{
+			float const f{ static_cast<float>(i) };
+			soa.Add(glm::vec3{ f, -2.f * f, 0.5f * f }, MauCor::Rotator{ 10.f * f, 20.f + f, -5.f * f }, glm::vec3{ 1.f + f, 2.f, 0.5f + 0.1f * f });
+		}
+
+		std::vector<glm::mat4> matrices(soa.Size());
+		MauCor::ComposeTRSMatrices(soa.Streams(), reinterpret_cast<float*>(matrices.data()), 0, soa.Size(), level);
+
+		for (uint32_t i{ 0 }; i < soa.Size(); ++i)
+		{
+			glm::mat4 const expected{ glm::translate(glm::mat4{ 1.f }, soa.GetTranslation(i))
+									* glm::toMat4(soa.GetRotation(i).rotation)
+									* glm::scale(glm::mat4{ 1.f }, soa.GetScale(i)) };
+
+			for (int c{ 0 }; c < 4; ++c)
+			{
+				CHECK(glm::all(glm::epsilonEqual(matrices[i][c], expected[c], 0.001f)));
+			}
+		}
+	}
+}
+
+TEST_CASE("TRS Kernel Scalar")
+{
+	CheckMatchesGLM(MauCor::ESIMDLevel::Scalar);
+}
+
+TEST_CASE("TRS Kernel SSE")
+{
+	CheckMatchesGLM(MauCor::ESIMDLevel::SSE);
+}
+
+TEST_CASE("TRS Kernel AVX2")
+{
+	// Falls back to the best supported level on older CPUs
+	CheckMatchesGLM(MauCor::ESIMDLevel::AVX2);
+}
+
+TEST_CASE("TransformSoA Remove Swap Back")
+{
+	MauCor::TransformSoA soa;
+	soa.Add(glm::vec3{ 1.f });
+	soa.Add(glm::vec3{ 2.f });
+	soa.Add(glm::vec3{ 3.f });
+
+	soa.RemoveSwapBack(0);
+
+	REQUIRE(soa.Size() == 2);
+	CHECK(soa.GetTranslation(0) == glm::vec3{ 3.f });
+	CHECK(soa.GetTranslation(1) == glm::vec3{ 2.f });
+}
@@ -40,4 +40,31 @@ TEST_CASE("CTransform Combine Transformations")
     glm::mat4 expectedMatrix = glm::translate(glm::mat4{ 1.0f }, position) * glm::mat4_cast(rotation) * glm::scale(glm::mat4{ 1.0f }, scale);
 
     CHECK(transform.GetMatrix() == expectedMatrix);
-}
\ No newline at end of file
+}
+
+TEST_CASE("CTransform Dirty List Tracking")
+{
+    MauEng::ECS::DirtyList dirtyList;
+    dirtyList.Reserve(1);
+
+    MauEng::CTransform transform;
+    transform.owner = 7;
+    transform.pDirtyList = &dirtyList;
+
+    // Only the first change in a generation adds the entity
+    transform.Translate({ 1.0f, 0.0f, 0.0f });
+    transform.Scale({ 2.0f, 2.0f, 2.0f });
+
+    REQUIRE(dirtyList.Size() == 1);
+    CHECK(dirtyList.Entities()[0] == 7);
+    CHECK(transform.dirtyListIdx == 0);
+    CHECK(transform.dirtyListGeneration == dirtyList.Generation());
+    CHECK(transform.isDirty);
+
+    dirtyList.Clear();
+    CHECK(dirtyList.Empty());
+
+    transform.Rotate(MauCor::Rotator{ 0.0f, 90.0f, 0.0f });
+    CHECK(dirtyList.Size() == 1);
+    CHECK(transform.dirtyListGeneration == dirtyList.Generation());
+}